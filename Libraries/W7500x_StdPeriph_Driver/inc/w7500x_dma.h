@@ -0,0 +1,292 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_dma.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the DMA
+ *          firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_DMA_H
+#define __W7500X_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup DMA
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  DMA channel control data structure (one entry of the control table)
+ */
+typedef struct
+{
+    __IO uint32_t SrcEndPtr;            /*!< Address of the last source item         */
+    __IO uint32_t DstEndPtr;            /*!< Address of the last destination item    */
+    __IO uint32_t Control;              /*!< Channel control word                    */
+    __IO uint32_t User;                 /*!< Unused by the controller                */
+} DMA_DescTypeDef;
+
+/**
+ * @brief  DMA Init Structure definition
+ */
+typedef struct
+{
+    uint32_t DMA_SrcAddr;               /*!< Start address of the source. */
+
+    uint32_t DMA_DstAddr;               /*!< Start address of the destination. */
+
+    uint32_t DMA_SrcInc;                /*!< Source address increment.
+                                             This parameter can be a value of @ref DMA_Increment */
+
+    uint32_t DMA_DstInc;                /*!< Destination address increment.
+                                             This parameter can be a value of @ref DMA_Increment */
+
+    uint32_t DMA_DataSize;              /*!< Size of one transfer item.
+                                             This parameter can be a value of @ref DMA_Data_Size */
+
+    uint32_t DMA_Arbitration;           /*!< Number of transfers before the controller re-arbitrates.
+                                             This parameter can be a value of @ref DMA_Arbitration */
+
+    uint32_t DMA_BufferSize;            /*!< Number of items to transfer, from 1 to 1024. */
+
+    uint32_t DMA_Mode;                  /*!< Cycle type.
+                                             This parameter can be a value of @ref DMA_Mode */
+} DMA_InitTypeDef;
+
+/**
+ * @brief  DMA channel callback, called from DMA_IRQHandler() with the channel
+ *         and one of @ref DMA_Event
+ */
+typedef void (*DMA_CallbackTypeDef)(uint32_t DMA_Channel, uint32_t DMA_Event);
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup DMA_Exported_Constants
+ * @{
+ */
+
+/** @defgroup DMA_Channels
+ * @{
+ */
+#define DMA_CHANNEL_NUM                 6
+
+#define DMA_Channel_0                   ((uint32_t)0)
+#define DMA_Channel_1                   ((uint32_t)1)
+#define DMA_Channel_2                   ((uint32_t)2)
+#define DMA_Channel_3                   ((uint32_t)3)
+#define DMA_Channel_4                   ((uint32_t)4)
+#define DMA_Channel_5                   ((uint32_t)5)
+
+#define IS_DMA_CHANNEL(CHANNEL)         ((CHANNEL) < DMA_CHANNEL_NUM)
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Request_Mapping
+ * @brief  Hardware request line of each peripheral. Override them in
+ *         w7500x_conf.h if the device reference manual maps them differently.
+ * @{
+ */
+#ifndef DMA_Channel_SSP0_TX
+#define DMA_Channel_SSP0_TX             DMA_Channel_0
+#endif
+#ifndef DMA_Channel_SSP0_RX
+#define DMA_Channel_SSP0_RX             DMA_Channel_1
+#endif
+#ifndef DMA_Channel_SSP1_TX
+#define DMA_Channel_SSP1_TX             DMA_Channel_2
+#endif
+#ifndef DMA_Channel_SSP1_RX
+#define DMA_Channel_SSP1_RX             DMA_Channel_3
+#endif
+#ifndef DMA_Channel_UART0_TX
+#define DMA_Channel_UART0_TX            DMA_Channel_4
+#endif
+#ifndef DMA_Channel_UART0_RX
+#define DMA_Channel_UART0_RX            DMA_Channel_5
+#endif
+#ifndef DMA_Channel_UART1_TX
+#define DMA_Channel_UART1_TX            DMA_Channel_4
+#endif
+#ifndef DMA_Channel_UART1_RX
+#define DMA_Channel_UART1_RX            DMA_Channel_5
+#endif
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Increment
+ * @{
+ */
+#define DMA_Inc_Byte                    ((uint32_t)0x0)
+#define DMA_Inc_HalfWord                ((uint32_t)0x1)
+#define DMA_Inc_Word                    ((uint32_t)0x2)
+#define DMA_Inc_None                    ((uint32_t)0x3)
+
+#define IS_DMA_INC(INC)                 ((INC) <= DMA_Inc_None)
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Data_Size
+ * @{
+ */
+#define DMA_DataSize_Byte               ((uint32_t)0x0)
+#define DMA_DataSize_HalfWord           ((uint32_t)0x1)
+#define DMA_DataSize_Word               ((uint32_t)0x2)
+
+#define IS_DMA_DATA_SIZE(SIZE)          ((SIZE) <= DMA_DataSize_Word)
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Arbitration
+ * @{
+ */
+#define DMA_Arbitration_1               ((uint32_t)0x0)
+#define DMA_Arbitration_2               ((uint32_t)0x1)
+#define DMA_Arbitration_4               ((uint32_t)0x2)
+#define DMA_Arbitration_8               ((uint32_t)0x3)
+#define DMA_Arbitration_16              ((uint32_t)0x4)
+#define DMA_Arbitration_32              ((uint32_t)0x5)
+#define DMA_Arbitration_64              ((uint32_t)0x6)
+#define DMA_Arbitration_128             ((uint32_t)0x7)
+#define DMA_Arbitration_256             ((uint32_t)0x8)
+#define DMA_Arbitration_512             ((uint32_t)0x9)
+#define DMA_Arbitration_1024            ((uint32_t)0xA)
+
+#define IS_DMA_ARBITRATION(R)           ((R) <= DMA_Arbitration_1024)
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Mode
+ * @{
+ */
+#define DMA_Mode_Stop                   ((uint32_t)0x0)
+#define DMA_Mode_Basic                  ((uint32_t)0x1)
+#define DMA_Mode_AutoRequest            ((uint32_t)0x2)
+#define DMA_Mode_PingPong               ((uint32_t)0x3)
+#define DMA_Mode_MemScatterGather       ((uint32_t)0x4)
+#define DMA_Mode_MemScatterGatherAlt    ((uint32_t)0x5)
+#define DMA_Mode_PeriphScatterGather    ((uint32_t)0x6)
+#define DMA_Mode_PeriphScatterGatherAlt ((uint32_t)0x7)
+
+#define IS_DMA_MODE(MODE)               ((MODE) <= DMA_Mode_PeriphScatterGatherAlt)
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Descriptor_Select
+ * @{
+ */
+#define DMA_Desc_Primary                ((uint32_t)0x0)
+#define DMA_Desc_Alternate              ((uint32_t)0x1)
+
+#define IS_DMA_DESC(DESC)               (((DESC) == DMA_Desc_Primary) || ((DESC) == DMA_Desc_Alternate))
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Event
+ * @{
+ */
+#define DMA_Event_Done                  ((uint32_t)0x1)     /*!< Channel cycle completed, channel disabled */
+#define DMA_Event_PrimaryDone           ((uint32_t)0x2)     /*!< Ping-pong primary half completed          */
+#define DMA_Event_AlternateDone         ((uint32_t)0x4)     /*!< Ping-pong alternate half completed        */
+#define DMA_Event_Error                 ((uint32_t)0x8)     /*!< Bus error, channel disabled               */
+/**
+ * @}
+ */
+
+/** @defgroup DMA_Limits
+ * @{
+ */
+#define DMA_MAX_TRANSFER                1024
+#define IS_DMA_BUFFER_SIZE(SIZE)        (((SIZE) >= 1) && ((SIZE) <= DMA_MAX_TRANSFER))
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+void DMA_DeInit(void);
+void DMA_Cmd(FunctionalState NewState);
+void DMA_Init(uint32_t DMA_Channel, DMA_InitTypeDef* DMA_InitStruct);
+void DMA_StructInit(DMA_InitTypeDef* DMA_InitStruct);
+void DMA_SetDescriptor(uint32_t DMA_Channel, uint32_t DMA_Desc, DMA_InitTypeDef* DMA_InitStruct);
+void DMA_BuildDescriptor(DMA_DescTypeDef* DMA_Desc, DMA_InitTypeDef* DMA_InitStruct);
+void DMA_ScatterGatherInit(uint32_t DMA_Channel, DMA_DescTypeDef* DMA_TaskList, uint32_t DMA_TaskCount, uint32_t DMA_Mode);
+DMA_DescTypeDef* DMA_GetDescriptor(uint32_t DMA_Channel, uint32_t DMA_Desc);
+
+/* Channel control functions **************************************************/
+void DMA_ChannelCmd(uint32_t DMA_Channel, FunctionalState NewState);
+void DMA_SoftwareRequest(uint32_t DMA_Channel);
+void DMA_PriorityConfig(uint32_t DMA_Channel, FunctionalState NewState);
+void DMA_UseBurstConfig(uint32_t DMA_Channel, FunctionalState NewState);
+void DMA_RequestMaskConfig(uint32_t DMA_Channel, FunctionalState NewState);
+FlagStatus DMA_GetChannelStatus(uint32_t DMA_Channel);
+uint32_t DMA_GetRemaining(uint32_t DMA_Channel, uint32_t DMA_Desc);
+uint32_t DMA_GetActiveDescriptor(uint32_t DMA_Channel);
+
+/* Memory to memory functions *************************************************/
+ErrorStatus DMA_MemCopy(uint32_t DMA_Channel, void* Dst, const void* Src, uint32_t Size);
+ErrorStatus DMA_MemFill(uint32_t DMA_Channel, void* Dst, const uint32_t* Value, uint32_t Size);
+
+/* Interrupts and flags management functions **********************************/
+void DMA_SetCallback(uint32_t DMA_Channel, DMA_CallbackTypeDef Callback);
+FlagStatus DMA_GetErrorStatus(void);
+void DMA_ClearError(void);
+void DMA_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_DMA_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -0,0 +1,118 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_dma_mem.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the DMA
+ *          memory copy service.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_DMA_MEM_H
+#define __W7500X_DMA_MEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_dma.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup DMAMEM
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  Completion callback of a copy or fill request. Called from the DMA
+ *         interrupt, or from the caller for requests below the threshold.
+ *         Status is ERROR if a bus error stopped the request or a block of it
+ *         could not be started; the destination is then partly written.
+ */
+typedef void (*DMAMEM_CallbackTypeDef)(void* Arg, ErrorStatus Status);
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup DMAMEM_Exported_Constants
+ * @{
+ */
+
+/** @defgroup DMAMEM_Config
+ * @{
+ */
+/* Maximum number of requests queued or in flight */
+#ifndef DMAMEM_QUEUE_SIZE
+#define DMAMEM_QUEUE_SIZE               8
+#endif
+
+/* Requests smaller than this size in bytes are done by the CPU.
+ * DMAMEM_Calibrate() replaces it with a measured value. */
+#ifndef DMAMEM_THRESHOLD
+#define DMAMEM_THRESHOLD                64
+#endif
+
+/* Largest block given to the DMA at once, requests are split in blocks */
+#ifndef DMAMEM_BLOCK_SIZE
+#define DMAMEM_BLOCK_SIZE               4096
+#endif
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+void DMAMEM_Init(uint32_t DMA_ChannelMask);
+void DMAMEM_SetThreshold(uint32_t Threshold);
+uint32_t DMAMEM_GetThreshold(void);
+uint32_t DMAMEM_Calibrate(void);
+
+/* Copy and fill functions ****************************************************/
+ErrorStatus DMAMEM_Copy(void* Dst, const void* Src, uint32_t Size, DMAMEM_CallbackTypeDef Callback, void* Arg);
+ErrorStatus DMAMEM_Set(void* Dst, uint8_t Value, uint32_t Size, DMAMEM_CallbackTypeDef Callback, void* Arg);
+FlagStatus DMAMEM_GetStatus(void);
+void DMAMEM_Wait(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_DMA_MEM_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_flash_kv.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the flash
+ *          key/value store firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_FLASH_KV_H
+#define __W7500X_FLASH_KV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_flash.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup FLASHKV
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup FLASHKV_Exported_Constants
+ * @{
+ */
+
+/** @defgroup FLASHKV_Config
+ * @{
+ */
+/* Erase unit of the store, 256 (sector) or a multiple of 4096 (block) */
+#ifndef FLASHKV_SECTOR_SIZE
+#define FLASHKV_SECTOR_SIZE             4096
+#endif
+
+/* Highest number of sectors given to FLASHKV_Init() */
+#ifndef FLASHKV_MAX_SECTORS
+#define FLASHKV_MAX_SECTORS             4
+#endif
+
+/* Keys are 0 to FLASHKV_MAX_KEYS - 1, each takes 4 bytes of RAM */
+#ifndef FLASHKV_MAX_KEYS
+#define FLASHKV_MAX_KEYS                32
+#endif
+
+/* Largest value in bytes */
+#ifndef FLASHKV_MAX_VALUE
+#define FLASHKV_MAX_VALUE               128
+#endif
+/**
+ * @}
+ */
+
+#define IS_FLASHKV_KEY(KEY)             ((KEY) < FLASHKV_MAX_KEYS)
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization functions ***************************************************/
+ErrorStatus FLASHKV_Init(uint32_t Address, uint32_t Sectors);
+
+/* Access functions ***********************************************************/
+ErrorStatus FLASHKV_Read(uint16_t Key, void* Data, uint16_t Size, uint16_t* Length);
+const void* FLASHKV_Get(uint16_t Key, uint16_t* Length);
+ErrorStatus FLASHKV_Write(uint16_t Key, const void* Data, uint16_t Length);
+ErrorStatus FLASHKV_Delete(uint16_t Key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_FLASH_KV_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
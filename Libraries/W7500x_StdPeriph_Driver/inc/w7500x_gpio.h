@@ -137,6 +137,23 @@ typedef struct
                                                  This parameter can be a value of @ref GPIOAf_TypeDef   */
 } GPIO_InitTypeDef;
 
+/**
+ * @brief  GPIO pin configuration table entry, see GPIO_BulkInit()
+ */
+typedef struct
+{
+    GPIO_TypeDef* GPIOx;                    /*!< Specifies the GPIO peripheral, GPIOA..GPIOD */
+
+    uint16_t GPIO_Pin;                      /*!< Specifies the GPIO pins to be configured.
+                                                 This parameter can be any value of @ref GPIO_pins_define */
+
+    GPIODirection_TypeDef GPIO_Direction;   /*!< Specifies the operating Direction for the selected pins */
+
+    uint32_t GPIO_Pad;                      /*!< Specifies the operating Pad type for the selected pins */
+
+    GPIOAf_TypeDef GPIO_AF;                 /*!< Specifies the operating Alternate function for the selected pins */
+} GPIO_PinConfigTypeDef;
+
 /** @defgroup GPIO_Interrupt_Polarity_enumeration
  * @{
  */
@@ -286,6 +303,7 @@ typedef enum
 void GPIO_DeInit(GPIO_TypeDef* GPIOx);
 void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct);
 void GPIO_StructInit(GPIO_InitTypeDef* GPIO_InitStruct);
+void GPIO_BulkInit(const GPIO_PinConfigTypeDef* GPIO_PinConfig, uint32_t Count);
 
 /* GPIO Read and Write functions **********************************************/
 BitAction GPIO_ReadInputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
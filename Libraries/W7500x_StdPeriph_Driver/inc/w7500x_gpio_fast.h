@@ -0,0 +1,220 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_gpio_fast.h
+ * @author  WIZnet
+ * @brief   This file contains the inline functions of the fast GPIO access
+ *          firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_GPIO_FAST_H
+#define __W7500X_GPIO_FAST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_gpio.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup GPIO_FAST
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  Pin handle, resolved once by GPIO_PIN_HANDLE() or GPIO_PinHandleInit()
+ *         so that every access is a single load or store without checks.
+ */
+typedef struct
+{
+    __IO uint32_t* Masked;              /*!< LB_MASKED or UB_MASKED entry of the pin(s) */
+    GPIO_TypeDef* GPIOx;
+    uint16_t Pin;                       /*!< Pin mask, pins of one byte lane */
+} GPIO_PinHandleTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/**
+ * @brief  Masked access entry of pins of one byte lane (GPIO_Pin_0..7 or GPIO_Pin_8..15).
+ */
+#define GPIO_MASKED(GPIOx, PIN)     (((PIN) < 256) ? &(GPIOx)->LB_MASKED[(uint8_t) (PIN)] : \
+                                                     &(GPIOx)->UB_MASKED[(uint8_t) ((PIN) >> 8)])
+
+/**
+ * @brief  Constant initializer of a GPIO_PinHandleTypeDef, the handle can be const
+ *         and stay in flash.
+ */
+#define GPIO_PIN_HANDLE(GPIOx, PIN) { GPIO_MASKED(GPIOx, PIN), (GPIOx), (PIN) }
+
+/* Exported functions ------------------------------------------------------- */
+
+/**
+ * @brief  Fills a pin handle.
+ * @param  Handle: handle to fill.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @param  GPIO_Pin: pins of one byte lane, a combination of @ref GPIO_pins_define.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinHandleInit(GPIO_PinHandleTypeDef* Handle, GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    /* Check the parameters */
+    assert_param(IS_GPIO_ALL_PERIPH(GPIOx));
+    assert_param(((GPIO_Pin & 0xFF00) == 0) || ((GPIO_Pin & 0x00FF) == 0));
+
+    Handle->Masked = GPIO_MASKED(GPIOx, GPIO_Pin);
+    Handle->GPIOx = GPIOx;
+    Handle->Pin = GPIO_Pin;
+}
+
+/**
+ * @brief  Drives the pin(s) high.
+ * @param  Handle: pin handle.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinSet(const GPIO_PinHandleTypeDef* Handle)
+{
+    *Handle->Masked = 0xFFFF;
+}
+
+/**
+ * @brief  Drives the pin(s) low.
+ * @param  Handle: pin handle.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinReset(const GPIO_PinHandleTypeDef* Handle)
+{
+    *Handle->Masked = 0x0000;
+}
+
+/**
+ * @brief  Drives the pin(s) to a level, without a branch.
+ * @param  Handle: pin handle.
+ * @param  BitVal: Bit_RESET or Bit_SET.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinWrite(const GPIO_PinHandleTypeDef* Handle, BitAction BitVal)
+{
+    *Handle->Masked = 0 - (uint32_t) BitVal;
+}
+
+/**
+ * @brief  Inverts the pin(s). Only the pins of the handle are written, other
+ *         pins of the port changed meanwhile by an interrupt are kept.
+ * @param  Handle: pin handle.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinToggle(const GPIO_PinHandleTypeDef* Handle)
+{
+    *Handle->Masked = ~Handle->GPIOx->DATAOUT;
+}
+
+/**
+ * @brief  Reads the input level of a pin.
+ * @param  Handle: pin handle.
+ * @retval Bit_SET when any pin of the handle is high, Bit_RESET otherwise.
+ */
+__STATIC_INLINE BitAction GPIO_PinRead(const GPIO_PinHandleTypeDef* Handle)
+{
+    return (Handle->GPIOx->DATA & Handle->Pin) ? Bit_SET : Bit_RESET;
+}
+
+/**
+ * @brief  Turns the pin(s) into outputs.
+ * @param  Handle: pin handle.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinOutput(const GPIO_PinHandleTypeDef* Handle)
+{
+    Handle->GPIOx->OUTENSET = Handle->Pin;
+}
+
+/**
+ * @brief  Turns the pin(s) into inputs. With the output data at 0, switching
+ *         between GPIO_PinOutput() and GPIO_PinInput() drives an open drain line.
+ * @param  Handle: pin handle.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PinInput(const GPIO_PinHandleTypeDef* Handle)
+{
+    Handle->GPIOx->OUTENCLR = Handle->Pin;
+}
+
+/**
+ * @brief  Writes several pins of a port through the masked access entries,
+ *         one store per byte lane. Each store is atomic, the pins of the two
+ *         lanes change one store apart.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @param  GPIO_Pin: pins to write, any combination of @ref GPIO_pins_define.
+ * @param  PortVal: levels of the pins, other bits are ignored.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PortWriteMasked(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint16_t PortVal)
+{
+    if (GPIO_Pin & 0x00FF) {
+        GPIOx->LB_MASKED[(uint8_t) GPIO_Pin] = PortVal;
+    }
+    if (GPIO_Pin & 0xFF00) {
+        GPIOx->UB_MASKED[(uint8_t) (GPIO_Pin >> 8)] = PortVal;
+    }
+}
+
+/**
+ * @brief  Writes several pins of a port so that they all change at once, for
+ *         parallel buses spanning both byte lanes. The other pins are kept.
+ * @note   Interrupts are disabled for the read-modify-write of DATAOUT.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @param  GPIO_Pin: pins to write, any combination of @ref GPIO_pins_define.
+ * @param  PortVal: levels of the pins, other bits are ignored.
+ * @retval None
+ */
+__STATIC_INLINE void GPIO_PortWriteAtomic(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint16_t PortVal)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    GPIOx->DATAOUT = (GPIOx->DATAOUT & ~(uint32_t) GPIO_Pin) | (PortVal & GPIO_Pin);
+    __set_PRIMASK(primask);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_GPIO_FAST_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_gpio_irq.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the GPIO
+ *          interrupt dispatcher firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_GPIO_IRQ_H
+#define __W7500X_GPIO_IRQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_gpio.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup GPIOIRQ
+ * @{
+ */
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup GPIOIRQ_Exported_Constants
+ * @{
+ */
+
+/** @defgroup GPIOIRQ_Config
+ * @{
+ */
+/* Number of events held by the edge queue, a power of 2, 0 removes the queue */
+#ifndef GPIOIRQ_QUEUE_SIZE
+#define GPIOIRQ_QUEUE_SIZE              32
+#endif
+/**
+ * @}
+ */
+
+/** @defgroup GPIOIRQ_Trigger
+ * @{
+ */
+#define GPIOIRQ_Trigger_Falling         ((uint32_t)0x00000001)
+#define GPIOIRQ_Trigger_Rising          ((uint32_t)0x00000002)
+#define GPIOIRQ_Trigger_Both            ((uint32_t)0x00000003)
+#define IS_GPIOIRQ_TRIGGER(TRIGGER)     (((TRIGGER) == GPIOIRQ_Trigger_Falling) || \
+                                         ((TRIGGER) == GPIOIRQ_Trigger_Rising) || \
+                                         ((TRIGGER) == GPIOIRQ_Trigger_Both))
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  Edge of a pin, called from GPIOIRQ_IRQHandler(), or from
+ *         GPIOIRQ_TimeHandler() for a debounced pin
+ */
+typedef void (*GPIOIRQ_CallbackTypeDef)(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, BitAction Level, uint32_t Timestamp);
+
+/**
+ * @brief  Timestamp source, e.g. a free running timer read
+ */
+typedef uint32_t (*GPIOIRQ_TimestampTypeDef)(void);
+
+/**
+ * @brief  GPIOIRQ Init structure definition
+ */
+typedef struct
+{
+    uint16_t GPIO_Pin;                  /*!< Pins to dispatch, any value of @ref GPIO_pins_define */
+    uint32_t GPIOIRQ_Trigger;           /*!< A value of @ref GPIOIRQ_Trigger */
+    uint16_t GPIOIRQ_Debounce;          /*!< GPIOIRQ_TimeHandler() ticks the level must hold, 0 for none */
+    FunctionalState GPIOIRQ_Queue;      /*!< ENABLE to record the edges in the queue */
+    GPIOIRQ_CallbackTypeDef GPIOIRQ_Callback; /*!< May be NULL */
+} GPIOIRQ_InitTypeDef;
+
+/**
+ * @brief  Recorded edge, see GPIOIRQ_GetEvent()
+ */
+typedef struct
+{
+    uint32_t Timestamp;
+    GPIO_TypeDef* GPIOx;
+    uint16_t GPIO_Pin;
+    uint8_t Level;                      /*!< Bit_SET for a rising edge */
+} GPIOIRQ_EventTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+void GPIOIRQ_Init(GPIO_TypeDef* GPIOx, GPIOIRQ_InitTypeDef* GPIOIRQ_InitStruct);
+void GPIOIRQ_StructInit(GPIOIRQ_InitTypeDef* GPIOIRQ_InitStruct);
+void GPIOIRQ_DeInit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void GPIOIRQ_SetTimestamp(GPIOIRQ_TimestampTypeDef Timestamp);
+
+/* Interrupt handling functions ***********************************************/
+void GPIOIRQ_IRQHandler(GPIO_TypeDef* GPIOx);
+void GPIOIRQ_TimeHandler(void);
+
+/* Edge queue functions *******************************************************/
+ErrorStatus GPIOIRQ_GetEvent(GPIOIRQ_EventTypeDef* Event);
+uint32_t GPIOIRQ_GetOverflows(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_GPIO_IRQ_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -85,6 +85,26 @@ typedef enum
  * @{
  */
 
+/** @defgroup MIIM_MDC_Frequency
+ * @{
+ */
+#ifndef MIIM_MDC_FREQ
+#define MIIM_MDC_FREQ               2500000UL   /*!< Maximum MDC clock frequency in Hz */
+#endif
+/**
+ * @}
+ */
+
+/** @defgroup MIIM_PHY_Registers
+ * @{
+ */
+#define PHY_REG_COUNT               32
+#define IS_PHY_REG(REG)             ((REG) < PHY_REG_COUNT)
+#define PHY_REGS_STANDARD           0x000000FFUL    /*!< Registers 0..7 of IEEE 802.3 clause 22, bit n selects register n */
+/**
+ * @}
+ */
+
 /**
  * @}
  */
@@ -98,6 +118,13 @@ void PHY_Reset(Reset_Type reset);
 FlagStatus PHY_GetLinkStatus(void);
 void PHY_SetLinkType(Link_Type link);
 
+/* Register access functions **************************************************/
+uint16_t PHY_ReadRegister(uint8_t regAddr);
+void PHY_WriteRegister(uint8_t regAddr, uint16_t val);
+void PHY_ReadRegisters(const uint8_t* regAddr, uint16_t* val, uint32_t count);
+void PHY_WriteRegisters(const uint8_t* regAddr, const uint16_t* val, uint32_t count);
+void PHY_GetSnapshot(uint16_t* regs, uint32_t mask);
+
 #ifdef __cplusplus
 }
 #endif
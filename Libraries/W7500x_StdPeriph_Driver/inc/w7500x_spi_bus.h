@@ -0,0 +1,180 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_spi_bus.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the SPI
+ *          bus transaction firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_SPI_BUS_H
+#define __W7500X_SPI_BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_ssp.h"
+#include "w7500x_gpio.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup SPIBUS
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  SPI device Init structure definition
+ */
+typedef struct
+{
+    uint32_t SPIBUS_ClockSpeed;         /*!< Highest SCK frequency of the device in Hz */
+
+    uint32_t SPIBUS_CPOL;               /*!< This parameter can be a value of @ref SSP_Clock_Polarity */
+
+    uint32_t SPIBUS_CPHA;               /*!< This parameter can be a value of @ref SSP_Clock_Phase */
+
+    uint32_t SPIBUS_DataSize;           /*!< This parameter can be a value of @ref SSP_data_size */
+
+    GPIO_TypeDef* SPIBUS_CS_GPIOx;      /*!< Port of the active low chip select pin */
+
+    uint16_t SPIBUS_CS_Pin;             /*!< Chip select pin, a value of @ref GPIO_pins_define */
+} SPIBUS_DeviceInitTypeDef;
+
+/**
+ * @brief  SPI device descriptor, filled by SPIBUS_DeviceInit()
+ */
+typedef struct
+{
+    SSP_TypeDef* SSPx;
+    uint32_t CR0;                       /*!< Clock rate, mode and frame size */
+    uint32_t CPSR;                      /*!< Clock prescaler */
+    GPIO_TypeDef* CS_GPIOx;
+    uint16_t CS_Pin;
+} SPIBUS_DeviceTypeDef;
+
+struct SPIBUS_Transfer;
+
+/**
+ * @brief  Transfer completion callback, called from the SSP interrupt, or
+ *         from SPIBUS_DeInit() for an abandoned transfer
+ */
+typedef void (*SPIBUS_CallbackTypeDef)(struct SPIBUS_Transfer* Transfer);
+
+/**
+ * @brief  SPI transfer descriptor. It belongs to the driver from
+ *         SPIBUS_Submit() until its Status is SPIBUS_Status_Done or
+ *         SPIBUS_Status_Aborted.
+ */
+typedef struct SPIBUS_Transfer
+{
+    SPIBUS_DeviceTypeDef* Device;
+    const void* TxBuffer;               /*!< Frames to send, uint8_t or uint16_t (frames over 8 bits),
+                                             NULL to send SPIBUS_FILL */
+    void* RxBuffer;                     /*!< Received frames, NULL to drop them */
+    uint32_t Length;                    /*!< Number of frames */
+    uint32_t Flags;                     /*!< A combination of @ref SPIBUS_Flags */
+    SPIBUS_CallbackTypeDef Callback;    /*!< Called on completion, may be NULL */
+    void* Context;                      /*!< Free for the callback */
+    __IO uint32_t Status;               /*!< A value of @ref SPIBUS_Status */
+    struct SPIBUS_Transfer* Next;       /*!< Queue link, used by the driver */
+} SPIBUS_TransferTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup SPIBUS_Exported_Constants
+ * @{
+ */
+
+/** @defgroup SPIBUS_Flags
+ * @{
+ */
+#define SPIBUS_Flag_KeepCS              ((uint32_t)0x01)    /*!< Leave the chip select asserted for the next transfer */
+/**
+ * @}
+ */
+
+/** @defgroup SPIBUS_Status
+ * @{
+ */
+#define SPIBUS_Status_Done              ((uint32_t)0x00)
+#define SPIBUS_Status_Queued            ((uint32_t)0x01)
+#define SPIBUS_Status_Busy              ((uint32_t)0x02)
+#define SPIBUS_Status_Aborted           ((uint32_t)0x03)    /*!< Abandoned by SPIBUS_DeInit() */
+/**
+ * @}
+ */
+
+/** @defgroup SPIBUS_Config
+ * @{
+ */
+/* Frame sent by transfers without a transmit buffer */
+#ifndef SPIBUS_FILL
+#define SPIBUS_FILL                     0xFFFF
+#endif
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+void SPIBUS_Init(SSP_TypeDef* SSPx);
+void SPIBUS_DeInit(SSP_TypeDef* SSPx);
+ErrorStatus SPIBUS_DeviceInit(SPIBUS_DeviceTypeDef* Device, SSP_TypeDef* SSPx, SPIBUS_DeviceInitTypeDef* SPIBUS_DeviceInitStruct);
+void SPIBUS_DeviceStructInit(SPIBUS_DeviceInitTypeDef* SPIBUS_DeviceInitStruct);
+
+/* Data transfers functions ***************************************************/
+void SPIBUS_Submit(SPIBUS_TransferTypeDef* Transfer);
+ErrorStatus SPIBUS_Wait(SPIBUS_TransferTypeDef* Transfer);
+ErrorStatus SPIBUS_Transfer(SPIBUS_DeviceTypeDef* Device, const void* TxBuffer, void* RxBuffer, uint32_t Length, uint32_t Flags);
+FlagStatus SPIBUS_GetStatus(SSP_TypeDef* SSPx);
+
+/* Interrupts management functions ********************************************/
+void SPIBUS_IRQHandler(SSP_TypeDef* SSPx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_SPI_BUS_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
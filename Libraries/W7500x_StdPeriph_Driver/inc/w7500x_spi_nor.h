@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_spi_nor.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the SPI NOR
+ *          flash firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_SPI_NOR_H
+#define __W7500X_SPI_NOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_spi_bus.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup SPINOR
+ * @{
+ */
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup SPINOR_Exported_Constants
+ * @{
+ */
+
+/** @defgroup SPINOR_Config
+ * @{
+ */
+/* Number of pages held by the read cache, 0 disables it */
+#ifndef SPINOR_CACHE_PAGES
+#define SPINOR_CACHE_PAGES              4
+#endif
+
+/* Status reads SPINOR_Init() spends on a flash still busy from before the
+   reset, about 1s at 1MHz SCK */
+#ifndef SPINOR_INIT_POLLS
+#define SPINOR_INIT_POLLS               32768
+#endif
+/**
+ * @}
+ */
+
+/** @defgroup SPINOR_Erase_Size
+ * @{
+ */
+#define SPINOR_Erase_4KB                ((uint32_t)0x00001000)
+#define SPINOR_Erase_32KB               ((uint32_t)0x00008000)
+#define SPINOR_Erase_64KB               ((uint32_t)0x00010000)
+#define SPINOR_Erase_Chip               ((uint32_t)0x00000000)
+#define IS_SPINOR_ERASE(SIZE)           (((SIZE) == SPINOR_Erase_4KB) || ((SIZE) == SPINOR_Erase_32KB) || \
+                                         ((SIZE) == SPINOR_Erase_64KB) || ((SIZE) == SPINOR_Erase_Chip))
+/**
+ * @}
+ */
+
+#define SPINOR_PAGE_SIZE                256                 /*!< Program page, also the cache line */
+#define SPINOR_CACHE_EMPTY              ((uint32_t)0xFFFFFFFF)
+
+/**
+ * @}
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+struct SPINOR_Handle;
+
+/**
+ * @brief  End of an erase or a program, called from SPINOR_TimeHandler() or
+ *         from the thread waiting in SPINOR_WaitReady()
+ */
+typedef void (*SPINOR_CallbackTypeDef)(struct SPINOR_Handle* Handle);
+
+/**
+ * @brief  Cached page
+ */
+typedef struct
+{
+    uint32_t Address;                   /*!< Page address, SPINOR_CACHE_EMPTY when unused */
+    uint32_t Stamp;                     /*!< Last use, the lowest stamp is replaced first */
+    uint8_t Data[SPINOR_PAGE_SIZE];
+} SPINOR_CacheTypeDef;
+
+/**
+ * @brief  SPI NOR flash handle, filled by SPINOR_Init()
+ */
+typedef struct SPINOR_Handle
+{
+    SPIBUS_DeviceTypeDef* Device;
+    uint8_t ManufacturerID;             /*!< First byte of the JEDEC ID */
+    uint16_t DeviceID;                  /*!< Memory type and capacity bytes of the JEDEC ID */
+    uint32_t Size;                      /*!< Capacity in bytes */
+    __IO uint8_t Busy;                  /*!< Erase or program running in the flash */
+    SPINOR_CallbackTypeDef Callback;    /*!< May be NULL */
+    SPIBUS_TransferTypeDef Poll;        /*!< Status read of SPINOR_TimeHandler() */
+    uint8_t PollTx[2];
+    uint8_t PollRx[2];
+#if (SPINOR_CACHE_PAGES > 0)
+    SPINOR_CacheTypeDef Cache[SPINOR_CACHE_PAGES];
+    uint32_t Stamp;
+#endif
+    uint32_t CacheHits;
+    uint32_t CacheMisses;
+} SPINOR_HandleTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+ErrorStatus SPINOR_Init(SPINOR_HandleTypeDef* Handle, SPIBUS_DeviceTypeDef* Device);
+void SPINOR_SetCallback(SPINOR_HandleTypeDef* Handle, SPINOR_CallbackTypeDef Callback);
+void SPINOR_InvalidateCache(SPINOR_HandleTypeDef* Handle);
+
+/* Read and write functions ***************************************************/
+ErrorStatus SPINOR_Read(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint8_t* Buffer, uint32_t Length);
+ErrorStatus SPINOR_Program(SPINOR_HandleTypeDef* Handle, uint32_t Address, const uint8_t* Buffer, uint32_t Length);
+ErrorStatus SPINOR_EraseStart(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint32_t Size);
+ErrorStatus SPINOR_Erase(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint32_t Size);
+
+/* Busy polling functions *****************************************************/
+FlagStatus SPINOR_GetBusy(SPINOR_HandleTypeDef* Handle);
+void SPINOR_WaitReady(SPINOR_HandleTypeDef* Handle);
+void SPINOR_TimeHandler(SPINOR_HandleTypeDef* Handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_SPI_NOR_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -87,6 +87,9 @@ typedef struct
 
 #define IS_SSP_CLOCK_RATE(RATE)         (((RATE) > 0) && ((RATE) < 0xFF))
 
+/* Depth of the transmit and receive FIFOs, in frames */
+#define SSP_FIFO_DEPTH                  8
+
 /** @defgroup SSP_Clock_Phase 
  * @{
  */
@@ -309,6 +312,10 @@ void SSP_SSOutputCmd(SSP_TypeDef* SSPx, FunctionalState NewState);
 /* Data transfers functions ***************************************************/
 void SSP_SendData(SSP_TypeDef* SSPx, uint16_t Data);
 uint16_t SSP_ReceiveData(SSP_TypeDef* SSPx);
+void SSP_TransmitReceive8(SSP_TypeDef* SSPx, const uint8_t* TxBuffer, uint8_t* RxBuffer, uint32_t Length);
+void SSP_TransmitReceive16(SSP_TypeDef* SSPx, const uint16_t* TxBuffer, uint16_t* RxBuffer, uint32_t Length);
+void SSP_Transmit8(SSP_TypeDef* SSPx, const uint8_t* TxBuffer, uint32_t Length);
+void SSP_Transmit16(SSP_TypeDef* SSPx, const uint16_t* TxBuffer, uint32_t Length);
 
 /* DMA transfers management functions *****************************************/
 void SSP_DMACmd(SSP_TypeDef* SSPx, uint32_t SSP_DMAReq, FunctionalState NewState);
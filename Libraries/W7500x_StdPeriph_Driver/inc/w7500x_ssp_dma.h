@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_ssp_dma.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the SSP
+ *          DMA transfer firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_SSP_DMA_H
+#define __W7500X_SSP_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_ssp.h"
+#include "w7500x_dma.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup SSPDMA
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  SSP DMA completion callback, called from the DMA interrupt with
+ *         one of @ref SSPDMA_Event
+ */
+typedef void (*SSPDMA_CallbackTypeDef)(SSP_TypeDef* SSPx, uint32_t SSPDMA_Event);
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup SSPDMA_Exported_Constants
+ * @{
+ */
+
+/** @defgroup SSPDMA_Event
+ * @{
+ */
+#define SSPDMA_Event_Done               ((uint32_t)0x01)    /*!< Every frame has been sent and received */
+#define SSPDMA_Event_Error              ((uint32_t)0x02)    /*!< DMA bus error, transfer aborted        */
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+void SSPDMA_Init(SSP_TypeDef* SSPx, SSPDMA_CallbackTypeDef Callback);
+void SSPDMA_DeInit(SSP_TypeDef* SSPx);
+void SSPDMA_SetFillValue(SSP_TypeDef* SSPx, uint16_t Value);
+
+/* Data transfers functions ***************************************************/
+ErrorStatus SSPDMA_TransmitReceive(SSP_TypeDef* SSPx, const void* TxBuffer, void* RxBuffer, uint32_t Length);
+ErrorStatus SSPDMA_Transmit(SSP_TypeDef* SSPx, const void* TxBuffer, uint32_t Length);
+ErrorStatus SSPDMA_Receive(SSP_TypeDef* SSPx, void* RxBuffer, uint32_t Length);
+FlagStatus SSPDMA_GetStatus(SSP_TypeDef* SSPx);
+void SSPDMA_Abort(SSP_TypeDef* SSPx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_SSP_DMA_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -142,13 +142,42 @@ typedef struct
  * @}
  */
 
+/** @defgroup UART_Baud_Rate_Divisor
+ * @brief  Fixed point baud rate divisor, IBRD in bits 21:6 and FBRD in bits 5:0,
+ *         i.e. 64 * CLOCK / (16 * BAUD) rounded. With constant arguments the
+ *         macros are evaluated by the compiler and can be checked by the
+ *         preprocessor, e.g.
+ *           #if UART_BAUD_ERROR_PPM(48000000, 921600) > 20000
+ *           #error "921600 bit/s is not accurate enough"
+ *           #endif
+ *           UART_SetBaudRateDivisor(UART1, UART_BAUD_DIVISOR(48000000, 921600));
+ *         The error is (4 * CLOCK - BAUD * DIVISOR) / (BAUD * DIVISOR), computed
+ *         in 64 bits and rounded, not from the truncated UART_BAUD_ACTUAL().
+ * @{
+ */
+
+#define UART_BAUD_DIVISOR(CLOCK, BAUD)      (((4UL * (CLOCK)) + ((BAUD) / 2)) / (BAUD))
+#define UART_BAUD_IBRD(CLOCK, BAUD)         (UART_BAUD_DIVISOR(CLOCK, BAUD) >> 6)
+#define UART_BAUD_FBRD(CLOCK, BAUD)         (UART_BAUD_DIVISOR(CLOCK, BAUD) & 0x3F)
+#define UART_BAUD_ACTUAL(CLOCK, BAUD)       (((4ULL * (CLOCK)) + (UART_BAUD_DIVISOR(CLOCK, BAUD) / 2)) / UART_BAUD_DIVISOR(CLOCK, BAUD))
+#define UART_BAUD_PERIOD(CLOCK, BAUD)       ((BAUD) * 1ULL * UART_BAUD_DIVISOR(CLOCK, BAUD))
+#define UART_BAUD_ERROR_PPM(CLOCK, BAUD)    (((((4ULL * (CLOCK)) > UART_BAUD_PERIOD(CLOCK, BAUD)) ? \
+                                               ((4ULL * (CLOCK)) - UART_BAUD_PERIOD(CLOCK, BAUD)) : \
+                                               (UART_BAUD_PERIOD(CLOCK, BAUD) - (4ULL * (CLOCK)))) * 1000000ULL + \
+                                              (UART_BAUD_PERIOD(CLOCK, BAUD) / 2)) / UART_BAUD_PERIOD(CLOCK, BAUD))
+
+#define IS_UART_BAUD_DIVISOR(DIVISOR)       (((DIVISOR) >= 0x40) && ((DIVISOR) <= 0x3FFFFF))
+/**
+ * @}
+ */
+
 /** @defgroup UART_DMA_Control
  * @{
  */
 
 #define UART_DMAControl_DMAONERR        UART_DMACR_DMAONERR
-#define UART_DMAControl_RXDMAE          UART_DMACR_TXDMAE
-#define UART_DMAControl_TXDMAE          UART_DMACR_RXDMAE
+#define UART_DMAControl_RXDMAE          UART_DMACR_RXDMAE
+#define UART_DMAControl_TXDMAE          UART_DMACR_TXDMAE
 
 #define IS_UART_DMA_CONTROL(CONTROL)    (((CONTROL) == UART_DMAControl_DMAONERR) || \
                                          ((CONTROL) == UART_DMAControl_TXDMAE) || \
@@ -237,7 +266,7 @@ typedef struct
 #define UART_IFLS_RXIFLSEL3_4   UART_IFLS_RXIFLSEL_0 | UART_IFLS_RXIFLSEL_1
 #define UART_IFLS_RXIFLSEL1_2   UART_IFLS_RXIFLSEL_1
 #define UART_IFLS_RXIFLSEL1_4   UART_IFLS_RXIFLSEL_0
-#define UART_IFLS_RXIFLSEL1_8   ~UART_IFLS_RXIFLSEL
+#define UART_IFLS_RXIFLSEL1_8   0x00UL
 
 #define IS_UART_RX_FIFO(FIFO)   (((FIFO) == UART_IFLS_RXIFLSEL7_8) || \
 		                         ((FIFO) == UART_IFLS_RXIFLSEL3_4) || \
@@ -249,7 +278,7 @@ typedef struct
 #define UART_IFLS_TXIFLSEL3_4   UART_IFLS_TXIFLSEL_0 | UART_IFLS_TXIFLSEL_1
 #define UART_IFLS_TXIFLSEL1_2   UART_IFLS_TXIFLSEL_1
 #define UART_IFLS_TXIFLSEL1_4   UART_IFLS_TXIFLSEL_0
-#define UART_IFLS_TXIFLSEL1_8   ~UART_IFLS_TXIFLSEL
+#define UART_IFLS_TXIFLSEL1_8   0x00UL
 
 #define IS_UART_TX_FIFO(FIFO)   (((FIFO) == UART_IFLS_TXIFLSEL7_8) || \
                                  ((FIFO) == UART_IFLS_TXIFLSEL3_4) || \
@@ -336,6 +365,11 @@ void UART_FIFO_Enable(UART_TypeDef *UARTx, uint32_t RX_FIFONumber, uint32_t TX_F
 void UART_FIFO_Disable(UART_TypeDef *UARTx);
 void UART_SendBreak(UART_TypeDef* UARTx);
 
+ErrorStatus UART_SetBaudRate(UART_TypeDef* UARTx, uint32_t BaudRate);
+void UART_SetBaudRateDivisor(UART_TypeDef* UARTx, uint32_t Divisor);
+int32_t UART_GetBaudRateError(UART_TypeDef* UARTx, uint32_t BaudRate);
+uint32_t UART_AutoBaud(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, DUALTIMER_TypeDef* DUALTIMERn, uint32_t TimerClock, uint32_t Timeout);
+
 void S_UART_DeInit(void);
 void S_UART_Init(uint32_t baud);
 void S_UART_Cmd(FunctionalState NewState);
@@ -363,6 +397,7 @@ void S_UART_ClearITPendingBit(uint32_t S_UART_IT);
 
 /* DMA transfers management functions *****************************************/
 void UART_DMA_Config(UART_TypeDef* UARTx, uint16_t UART_DMA_CONTROL);
+void UART_DMACmd(UART_TypeDef* UARTx, uint16_t UART_DMA_CONTROL, FunctionalState NewState);
 
 #ifdef __cplusplus
 }
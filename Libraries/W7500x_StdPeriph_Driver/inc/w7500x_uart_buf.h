@@ -0,0 +1,161 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_uart_buf.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the
+ *          interrupt driven buffered UART0, UART1 and UART2 firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_UART_BUF_H
+#define __W7500X_UART_BUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_uart.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup UARTBUF
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup UARTBUF_Exported_Constants
+ * @{
+ */
+
+/** @defgroup UARTBUF_Port
+ * @brief  Port identifiers of the unified API, the same UARTPORT_ calls drive
+ *         the PL011 UARTs and the simple UART2.
+ * @{
+ */
+#define UARTPORT_0                      ((uint32_t)0x0)     /*!< UART0                                    */
+#define UARTPORT_1                      ((uint32_t)0x1)     /*!< UART1                                    */
+#define UARTPORT_2                      ((uint32_t)0x2)     /*!< UART2 (S_UART)                           */
+
+#define IS_UARTPORT(PORT)               (((PORT) == UARTPORT_0) || \
+                                         ((PORT) == UARTPORT_1) || \
+                                         ((PORT) == UARTPORT_2))
+
+#define UARTPORT_FROM_UART(UARTx)       (((UARTx) == UART0) ? UARTPORT_0 : UARTPORT_1)
+/**
+ * @}
+ */
+
+/** @defgroup UARTBUF_Overflow_Policy
+ * @brief  What happens to a byte that does not fit in a full ring buffer.
+ *         On reception with UARTBUF_Policy_Block, UART0 and UART1 leave the
+ *         bytes in the FIFO until there is room, so that RTS flow control
+ *         stops the sender; UART2 behaves as UARTBUF_Policy_Drop.
+ * @{
+ */
+#define UARTBUF_Policy_Drop             ((uint32_t)0x0)     /*!< The new byte is dropped                  */
+#define UARTBUF_Policy_Block            ((uint32_t)0x1)     /*!< The writer waits for room                */
+#define UARTBUF_Policy_Overwrite        ((uint32_t)0x2)     /*!< The oldest byte is dropped               */
+
+#define IS_UARTBUF_POLICY(POLICY)       (((POLICY) == UARTBUF_Policy_Drop) || \
+                                         ((POLICY) == UARTBUF_Policy_Block) || \
+                                         ((POLICY) == UARTBUF_Policy_Overwrite))
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Port functions *************************************************************/
+void UARTPORT_Init(uint32_t UARTPORT, uint8_t* TxBuffer, uint16_t TxSize, uint8_t* RxBuffer, uint16_t RxSize);
+void UARTPORT_DeInit(uint32_t UARTPORT);
+void UARTPORT_SetPolicy(uint32_t UARTPORT, uint32_t UARTBUF_Policy);
+uint16_t UARTPORT_Write(uint32_t UARTPORT, const uint8_t* Data, uint16_t Length);
+uint16_t UARTPORT_Read(uint32_t UARTPORT, uint8_t* Data, uint16_t Length);
+uint16_t UARTPORT_TxReserve(uint32_t UARTPORT, uint8_t** Data);
+void UARTPORT_TxCommit(uint32_t UARTPORT, uint16_t Length);
+uint16_t UARTPORT_RxPeek(uint32_t UARTPORT, uint8_t** Data);
+void UARTPORT_RxSkip(uint32_t UARTPORT, uint16_t Length);
+int UARTPORT_PutChar(uint32_t UARTPORT, uint8_t Data);
+int UARTPORT_GetChar(uint32_t UARTPORT);
+uint16_t UARTPORT_GetTxFree(uint32_t UARTPORT);
+uint16_t UARTPORT_GetRxCount(uint32_t UARTPORT);
+uint32_t UARTPORT_GetOverflowCount(uint32_t UARTPORT);
+void UARTPORT_Flush(uint32_t UARTPORT);
+void UARTPORT_IRQHandler(uint32_t UARTPORT);
+
+/* Initialization and Configuration functions *********************************/
+void UARTBUF_Init(UART_TypeDef* UARTx, uint8_t* TxBuffer, uint16_t TxSize, uint8_t* RxBuffer, uint16_t RxSize);
+void UARTBUF_DeInit(UART_TypeDef* UARTx);
+void UARTBUF_SetPolicy(UART_TypeDef* UARTx, uint32_t UARTBUF_Policy);
+
+/* Data transfers functions ***************************************************/
+uint16_t UARTBUF_Write(UART_TypeDef* UARTx, const uint8_t* Data, uint16_t Length);
+uint16_t UARTBUF_Read(UART_TypeDef* UARTx, uint8_t* Data, uint16_t Length);
+int UARTBUF_PutChar(UART_TypeDef* UARTx, uint8_t Data);
+int UARTBUF_GetChar(UART_TypeDef* UARTx);
+uint16_t UARTBUF_GetTxFree(UART_TypeDef* UARTx);
+uint16_t UARTBUF_GetRxCount(UART_TypeDef* UARTx);
+uint32_t UARTBUF_GetOverflowCount(UART_TypeDef* UARTx);
+void UARTBUF_Flush(UART_TypeDef* UARTx);
+
+/* Interrupts management functions ********************************************/
+void UARTBUF_IRQHandler(UART_TypeDef* UARTx);
+
+/* UART2 functions ************************************************************/
+void S_UARTBUF_Init(uint8_t* TxBuffer, uint16_t TxSize, uint8_t* RxBuffer, uint16_t RxSize);
+void S_UARTBUF_DeInit(void);
+void S_UARTBUF_SetPolicy(uint32_t UARTBUF_Policy);
+uint16_t S_UARTBUF_Write(const uint8_t* Data, uint16_t Length);
+uint16_t S_UARTBUF_Read(uint8_t* Data, uint16_t Length);
+int S_UARTBUF_PutChar(uint8_t Data);
+int S_UARTBUF_GetChar(void);
+uint16_t S_UARTBUF_GetTxFree(void);
+uint16_t S_UARTBUF_GetRxCount(void);
+uint32_t S_UARTBUF_GetOverflowCount(void);
+void S_UARTBUF_Flush(void);
+void S_UARTBUF_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_UART_BUF_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
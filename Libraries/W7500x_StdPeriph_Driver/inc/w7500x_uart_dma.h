@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_uart_dma.h
+ * @author  WIZnet
+ * @brief   This file contains all the functions prototypes for the UART
+ *          DMA streaming firmware library.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_UART_DMA_H
+#define __W7500X_UART_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x.h"
+#include "w7500x_uart.h"
+#include "w7500x_dma.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup UARTDMA
+ * @{
+ */
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * @brief  UART DMA event callback, called from interrupt context with one or
+ *         more of @ref UARTDMA_Event
+ */
+typedef void (*UARTDMA_CallbackTypeDef)(UART_TypeDef* UARTx, uint32_t UARTDMA_Event);
+
+/* Exported constants --------------------------------------------------------*/
+
+/** @defgroup UARTDMA_Exported_Constants
+ * @{
+ */
+
+/** @defgroup UARTDMA_Event
+ * @{
+ */
+#define UARTDMA_Event_TxDone            ((uint32_t)0x01)    /*!< The whole transmit buffer has been sent     */
+#define UARTDMA_Event_RxHalf            ((uint32_t)0x02)    /*!< One half of the receive buffer is full      */
+#define UARTDMA_Event_RxIdle            ((uint32_t)0x04)    /*!< The line went idle with data pending        */
+#define UARTDMA_Event_RxOverrun         ((uint32_t)0x08)    /*!< Unread data was overwritten, it is dropped  */
+#define UARTDMA_Event_Error             ((uint32_t)0x10)    /*!< DMA bus error, transfers stopped            */
+/**
+ * @}
+ */
+
+/** @defgroup UARTDMA_Config
+ * @{
+ */
+/* Number of UARTDMA_TimeHandler() ticks without new data before an idle event */
+#ifndef UARTDMA_IDLE_TICKS
+#define UARTDMA_IDLE_TICKS              2
+#endif
+
+#define IS_UARTDMA_RX_SIZE(SIZE)        (((SIZE) >= 2) && ((SIZE) <= (2 * DMA_MAX_TRANSFER)) && (((SIZE) & 1) == 0))
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+/* Initialization and Configuration functions *********************************/
+void UARTDMA_Init(UART_TypeDef* UARTx, uint8_t* RxBuffer, uint16_t RxSize, UARTDMA_CallbackTypeDef Callback);
+void UARTDMA_DeInit(UART_TypeDef* UARTx);
+
+/* Data transfers functions ***************************************************/
+ErrorStatus UARTDMA_Transmit(UART_TypeDef* UARTx, const uint8_t* Buffer, uint32_t Length);
+FlagStatus UARTDMA_GetTxStatus(UART_TypeDef* UARTx);
+uint16_t UARTDMA_Available(UART_TypeDef* UARTx);
+uint16_t UARTDMA_Read(UART_TypeDef* UARTx, uint8_t* Buffer, uint16_t Length);
+
+/* Interrupts management functions ********************************************/
+void UARTDMA_IRQHandler(UART_TypeDef* UARTx);
+void UARTDMA_TimeHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __W7500X_UART_DMA_H */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
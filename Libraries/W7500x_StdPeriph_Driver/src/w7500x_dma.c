@@ -0,0 +1,692 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_dma.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to manage the following
+ *          functionalities of the DMA controller:
+ *           + Control data structure table
+ *           + Basic, auto-request, ping-pong and scatter-gather cycles
+ *           + Memory to memory copy and fill
+ *           + Per channel completion callbacks
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_dma.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup DMA
+ * @brief DMA driver modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define DMA_CTRL_DST_INC_Pos        30
+#define DMA_CTRL_DST_SIZE_Pos       28
+#define DMA_CTRL_SRC_INC_Pos        26
+#define DMA_CTRL_SRC_SIZE_Pos       24
+#define DMA_CTRL_R_POWER_Pos        14
+#define DMA_CTRL_N_MINUS_1_Pos      4
+#define DMA_CTRL_N_MINUS_1          (0x3FFUL << DMA_CTRL_N_MINUS_1_Pos)
+#define DMA_CTRL_CYCLE_CTRL         (0x7UL)
+
+/* The alternate structures start after the primary ones of 8 channels (0x80 bytes) */
+#define DMA_ALT_OFFSET              8
+#define DMA_TABLE_SIZE              (2 * DMA_ALT_OFFSET)
+
+/* Scatter-gather task lists used by the memory helpers */
+#define DMA_MEM_TASKS               4
+#define DMA_MEM_ARBITRATION         DMA_Arbitration_16
+
+#define DMA_CHANNEL_MASK(CH)        ((uint32_t)1 << (CH))
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/* The control table must be aligned on its size rounded up to a power of two */
+#if defined (__CC_ARM)
+__align(256) static DMA_DescTypeDef DMA_ControlTable[DMA_TABLE_SIZE];
+#elif defined (__ICCARM__)
+#pragma data_alignment=256
+static DMA_DescTypeDef DMA_ControlTable[DMA_TABLE_SIZE];
+#else
+static DMA_DescTypeDef DMA_ControlTable[DMA_TABLE_SIZE] __attribute__ ((aligned (256)));
+#endif
+
+static DMA_DescTypeDef DMA_MemTaskList[DMA_CHANNEL_NUM][DMA_MEM_TASKS];
+static DMA_CallbackTypeDef DMA_Callback[DMA_CHANNEL_NUM];
+
+static __IO uint32_t DMA_ActiveMask = 0;
+static __IO uint32_t DMA_PingPongMask = 0;
+static __IO uint32_t DMA_PrimaryArmed = 0;
+static __IO uint32_t DMA_AlternateArmed = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t DMA_EndPointer(uint32_t Start, uint32_t Inc, uint32_t Count);
+static uint32_t DMA_WidthOf(uint32_t Dst, uint32_t Src, uint32_t Size);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup DMA_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Deinitializes the DMA controller and all the channels to their default reset values.
+ * @param  None
+ * @retval None
+ */
+void DMA_DeInit(void)
+{
+    uint32_t i;
+
+    DMA->CFG = 0;
+    DMA->CHNL_ENABLE_CLR = DMA_CHNL_ENABLE_CLR;
+    DMA->CHNL_PRI_ALT_CLR = DMA_CHNL_PRI_ALT_CLR;
+    DMA->CHNL_PRIORITY_CLR = DMA_CHNL_PRIORITY_CLR;
+    DMA->CHNL_USEBURST_CLR = DMA_CHNL_USEBURST_CLR;
+    DMA->CHNL_REQ_MASK_CLR = DMA_CHNL_REQ_MASK_CLR;
+    DMA->ERR_CLR = 1;
+
+    for (i = 0; i < DMA_TABLE_SIZE; i++) {
+        DMA_ControlTable[i].SrcEndPtr = 0;
+        DMA_ControlTable[i].DstEndPtr = 0;
+        DMA_ControlTable[i].Control = 0;
+        DMA_ControlTable[i].User = 0;
+    }
+    for (i = 0; i < DMA_CHANNEL_NUM; i++) {
+        DMA_Callback[i] = 0;
+    }
+
+    DMA_ActiveMask = 0;
+    DMA_PingPongMask = 0;
+    DMA_PrimaryArmed = 0;
+    DMA_AlternateArmed = 0;
+}
+
+/**
+ * @brief  Enables or disables the DMA controller.
+ * @note   The control table base address is programmed when enabling.
+ * @param  NewState: new state of the DMA controller.
+ *          This parameter can be: ENABLE or DISABLE.
+ * @retval None
+ */
+void DMA_Cmd(FunctionalState NewState)
+{
+    /* Check the parameters */
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (NewState != DISABLE) {
+        DMA->CTRL_BASE_PTR = (uint32_t) DMA_ControlTable & DMA_CTRL_BASE_PTR;
+        DMA->CFG = DMA_CFG_ENABLE;
+    } else {
+        DMA->CFG = 0;
+    }
+}
+
+/**
+ * @brief  Initializes the primary control structure of a DMA channel.
+ * @note   The channel is switched back to its primary structure. For ping-pong
+ *         cycles the alternate structure is set with DMA_SetDescriptor().
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  DMA_InitStruct: pointer to a DMA_InitTypeDef structure that contains
+ *         the configuration information for the specified DMA channel.
+ * @retval None
+ */
+void DMA_Init(uint32_t DMA_Channel, DMA_InitTypeDef* DMA_InitStruct)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    DMA->CHNL_PRI_ALT_CLR = DMA_CHANNEL_MASK(DMA_Channel);
+    DMA_PingPongMask &= ~DMA_CHANNEL_MASK(DMA_Channel);
+    DMA_AlternateArmed &= ~DMA_CHANNEL_MASK(DMA_Channel);
+
+    DMA_SetDescriptor(DMA_Channel, DMA_Desc_Primary, DMA_InitStruct);
+}
+
+/**
+ * @brief  Fills each DMA_InitStruct member with its default value.
+ * @param  DMA_InitStruct: pointer to a DMA_InitTypeDef structure which will be initialized.
+ * @retval None
+ */
+void DMA_StructInit(DMA_InitTypeDef* DMA_InitStruct)
+{
+    DMA_InitStruct->DMA_SrcAddr = 0;
+    DMA_InitStruct->DMA_DstAddr = 0;
+    DMA_InitStruct->DMA_SrcInc = DMA_Inc_Byte;
+    DMA_InitStruct->DMA_DstInc = DMA_Inc_Byte;
+    DMA_InitStruct->DMA_DataSize = DMA_DataSize_Byte;
+    DMA_InitStruct->DMA_Arbitration = DMA_Arbitration_1;
+    DMA_InitStruct->DMA_BufferSize = 1;
+    DMA_InitStruct->DMA_Mode = DMA_Mode_Basic;
+}
+
+/**
+ * @brief  Writes the primary or alternate control structure of a DMA channel.
+ * @note   Used to re-arm one half of a ping-pong cycle from the channel callback.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  DMA_Desc: selects the control structure.
+ *          This parameter can be one of the following values:
+ *            @arg DMA_Desc_Primary
+ *            @arg DMA_Desc_Alternate
+ * @param  DMA_InitStruct: pointer to a DMA_InitTypeDef structure.
+ * @retval None
+ */
+void DMA_SetDescriptor(uint32_t DMA_Channel, uint32_t DMA_Desc, DMA_InitTypeDef* DMA_InitStruct)
+{
+    uint32_t mask = DMA_CHANNEL_MASK(DMA_Channel);
+
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param(IS_DMA_DESC(DMA_Desc));
+
+    DMA_BuildDescriptor(DMA_GetDescriptor(DMA_Channel, DMA_Desc), DMA_InitStruct);
+
+    if (DMA_InitStruct->DMA_Mode == DMA_Mode_PingPong) {
+        DMA_PingPongMask |= mask;
+    }
+
+    if (DMA_Desc == DMA_Desc_Primary) {
+        DMA_PrimaryArmed |= mask;
+    } else {
+        DMA_AlternateArmed |= mask;
+    }
+}
+
+/**
+ * @brief  Builds a control structure, e.g. a task of a scatter-gather list.
+ * @param  DMA_Desc: pointer to the control structure to fill.
+ * @param  DMA_InitStruct: pointer to a DMA_InitTypeDef structure.
+ * @retval None
+ */
+void DMA_BuildDescriptor(DMA_DescTypeDef* DMA_Desc, DMA_InitTypeDef* DMA_InitStruct)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_INC(DMA_InitStruct->DMA_SrcInc));
+    assert_param(IS_DMA_INC(DMA_InitStruct->DMA_DstInc));
+    assert_param(IS_DMA_DATA_SIZE(DMA_InitStruct->DMA_DataSize));
+    assert_param(IS_DMA_ARBITRATION(DMA_InitStruct->DMA_Arbitration));
+    assert_param(IS_DMA_BUFFER_SIZE(DMA_InitStruct->DMA_BufferSize));
+    assert_param(IS_DMA_MODE(DMA_InitStruct->DMA_Mode));
+
+    DMA_Desc->SrcEndPtr = DMA_EndPointer(DMA_InitStruct->DMA_SrcAddr, DMA_InitStruct->DMA_SrcInc, DMA_InitStruct->DMA_BufferSize);
+    DMA_Desc->DstEndPtr = DMA_EndPointer(DMA_InitStruct->DMA_DstAddr, DMA_InitStruct->DMA_DstInc, DMA_InitStruct->DMA_BufferSize);
+    DMA_Desc->Control = (DMA_InitStruct->DMA_DstInc << DMA_CTRL_DST_INC_Pos)
+            | (DMA_InitStruct->DMA_DataSize << DMA_CTRL_DST_SIZE_Pos)
+            | (DMA_InitStruct->DMA_SrcInc << DMA_CTRL_SRC_INC_Pos)
+            | (DMA_InitStruct->DMA_DataSize << DMA_CTRL_SRC_SIZE_Pos)
+            | (DMA_InitStruct->DMA_Arbitration << DMA_CTRL_R_POWER_Pos)
+            | ((DMA_InitStruct->DMA_BufferSize - 1) << DMA_CTRL_N_MINUS_1_Pos)
+            | DMA_InitStruct->DMA_Mode;
+}
+
+/**
+ * @brief  Configures a channel for a scatter-gather cycle.
+ * @note   The primary structure copies each task of DMA_TaskList into the
+ *         alternate structure which then performs it. Every task but the last
+ *         one must use DMA_Mode_MemScatterGatherAlt or DMA_Mode_PeriphScatterGatherAlt,
+ *         the last one DMA_Mode_Basic or DMA_Mode_AutoRequest. The list must stay
+ *         valid until the cycle completes.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  DMA_TaskList: array of control structures built with DMA_BuildDescriptor().
+ * @param  DMA_TaskCount: number of tasks, from 1 to 256.
+ * @param  DMA_Mode: DMA_Mode_MemScatterGather or DMA_Mode_PeriphScatterGather.
+ * @retval None
+ */
+void DMA_ScatterGatherInit(uint32_t DMA_Channel, DMA_DescTypeDef* DMA_TaskList, uint32_t DMA_TaskCount, uint32_t DMA_Mode)
+{
+    DMA_DescTypeDef* primary;
+
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param((DMA_TaskCount >= 1) && (DMA_TaskCount <= (DMA_MAX_TRANSFER / 4)));
+    assert_param((DMA_Mode == DMA_Mode_MemScatterGather) || (DMA_Mode == DMA_Mode_PeriphScatterGather));
+
+    DMA->CHNL_PRI_ALT_CLR = DMA_CHANNEL_MASK(DMA_Channel);
+    DMA_PingPongMask &= ~DMA_CHANNEL_MASK(DMA_Channel);
+    DMA_AlternateArmed &= ~DMA_CHANNEL_MASK(DMA_Channel);
+
+    /* Each task is 4 words, copied at once (R_power = 4) into the alternate structure */
+    primary = DMA_GetDescriptor(DMA_Channel, DMA_Desc_Primary);
+    primary->SrcEndPtr = (uint32_t) &DMA_TaskList[DMA_TaskCount - 1].User;
+    primary->DstEndPtr = (uint32_t) &DMA_GetDescriptor(DMA_Channel, DMA_Desc_Alternate)->User;
+    primary->Control = (DMA_Inc_Word << DMA_CTRL_DST_INC_Pos)
+            | (DMA_DataSize_Word << DMA_CTRL_DST_SIZE_Pos)
+            | (DMA_Inc_Word << DMA_CTRL_SRC_INC_Pos)
+            | (DMA_DataSize_Word << DMA_CTRL_SRC_SIZE_Pos)
+            | (DMA_Arbitration_4 << DMA_CTRL_R_POWER_Pos)
+            | (((DMA_TaskCount * 4) - 1) << DMA_CTRL_N_MINUS_1_Pos)
+            | DMA_Mode;
+
+    DMA_PrimaryArmed |= DMA_CHANNEL_MASK(DMA_Channel);
+}
+
+/**
+ * @brief  Returns the control structure of a channel.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  DMA_Desc: DMA_Desc_Primary or DMA_Desc_Alternate.
+ * @retval Pointer to the control structure.
+ */
+DMA_DescTypeDef* DMA_GetDescriptor(uint32_t DMA_Channel, uint32_t DMA_Desc)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param(IS_DMA_DESC(DMA_Desc));
+
+    return &DMA_ControlTable[DMA_Channel + ((DMA_Desc == DMA_Desc_Alternate) ? DMA_ALT_OFFSET : 0)];
+}
+
+/**
+ * @brief  Enables or disables the specified DMA channel.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  NewState: new state of the channel.
+ *          This parameter can be: ENABLE or DISABLE.
+ * @retval None
+ */
+void DMA_ChannelCmd(uint32_t DMA_Channel, FunctionalState NewState)
+{
+    uint32_t mask = DMA_CHANNEL_MASK(DMA_Channel);
+
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (NewState != DISABLE) {
+        DMA_ActiveMask |= mask;
+        DMA->CHNL_ENABLE_SET = mask;
+    } else {
+        DMA->CHNL_ENABLE_CLR = mask;
+        DMA_ActiveMask &= ~mask;
+        DMA_PrimaryArmed &= ~mask;
+        DMA_AlternateArmed &= ~mask;
+    }
+}
+
+/**
+ * @brief  Generates a software request on the specified DMA channel.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @retval None
+ */
+void DMA_SoftwareRequest(uint32_t DMA_Channel)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    DMA->CHNL_SW_REQUEST = DMA_CHANNEL_MASK(DMA_Channel);
+}
+
+/**
+ * @brief  Selects the high or default priority level of a channel.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  NewState: ENABLE for high priority, DISABLE for default priority.
+ * @retval None
+ */
+void DMA_PriorityConfig(uint32_t DMA_Channel, FunctionalState NewState)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (NewState != DISABLE) {
+        DMA->CHNL_PRIORITY_SET = DMA_CHANNEL_MASK(DMA_Channel);
+    } else {
+        DMA->CHNL_PRIORITY_CLR = DMA_CHANNEL_MASK(DMA_Channel);
+    }
+}
+
+/**
+ * @brief  Enables or disables burst-only requests of a channel.
+ * @note   When enabled, single requests (dma_sreq) of the peripheral are ignored.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  NewState: new state of the useburst setting.
+ *          This parameter can be: ENABLE or DISABLE.
+ * @retval None
+ */
+void DMA_UseBurstConfig(uint32_t DMA_Channel, FunctionalState NewState)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (NewState != DISABLE) {
+        DMA->CHNL_USEBURST_SET = DMA_CHANNEL_MASK(DMA_Channel);
+    } else {
+        DMA->CHNL_USEBURST_CLR = DMA_CHANNEL_MASK(DMA_Channel);
+    }
+}
+
+/**
+ * @brief  Masks or unmasks the peripheral requests of a channel.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  NewState: ENABLE to mask the peripheral requests, DISABLE to accept them.
+ * @retval None
+ */
+void DMA_RequestMaskConfig(uint32_t DMA_Channel, FunctionalState NewState)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (NewState != DISABLE) {
+        DMA->CHNL_REQ_MASK_SET = DMA_CHANNEL_MASK(DMA_Channel);
+    } else {
+        DMA->CHNL_REQ_MASK_CLR = DMA_CHANNEL_MASK(DMA_Channel);
+    }
+}
+
+/**
+ * @brief  Checks whether the specified DMA channel is enabled.
+ * @note   The controller disables the channel at the end of the cycle.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @retval The new state of the channel (SET or RESET).
+ */
+FlagStatus DMA_GetChannelStatus(uint32_t DMA_Channel)
+{
+    FlagStatus bitstatus = RESET;
+
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    if ((DMA->CHNL_ENABLE_SET & DMA_CHANNEL_MASK(DMA_Channel)) != (uint32_t) RESET) {
+        bitstatus = SET;
+    } else {
+        bitstatus = RESET;
+    }
+
+    return bitstatus;
+}
+
+/**
+ * @brief  Returns the number of items still to transfer by a control structure.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  DMA_Desc: DMA_Desc_Primary or DMA_Desc_Alternate.
+ * @retval Number of remaining items.
+ */
+uint32_t DMA_GetRemaining(uint32_t DMA_Channel, uint32_t DMA_Desc)
+{
+    uint32_t control = DMA_GetDescriptor(DMA_Channel, DMA_Desc)->Control;
+
+    if ((control & DMA_CTRL_CYCLE_CTRL) == DMA_Mode_Stop) {
+        return 0;
+    }
+
+    return ((control & DMA_CTRL_N_MINUS_1) >> DMA_CTRL_N_MINUS_1_Pos) + 1;
+}
+
+/**
+ * @brief  Returns the control structure the controller uses for the next transfer.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @retval DMA_Desc_Primary or DMA_Desc_Alternate.
+ */
+uint32_t DMA_GetActiveDescriptor(uint32_t DMA_Channel)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    if ((DMA->CHNL_PRI_ALT_SET & DMA_CHANNEL_MASK(DMA_Channel)) != (uint32_t) RESET) {
+        return DMA_Desc_Alternate;
+    }
+
+    return DMA_Desc_Primary;
+}
+
+/**
+ * @brief  Starts a memory to memory copy on the specified channel.
+ * @note   The widest transfer size allowed by the alignment of Dst, Src and
+ *         Size is used. Copies longer than 1024 items are split in a memory
+ *         scatter-gather cycle of up to 4 tasks. Completion is reported by
+ *         DMA_Event_Done or polled with DMA_GetChannelStatus().
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  Dst: destination address.
+ * @param  Src: source address.
+ * @param  Size: number of bytes to copy.
+ * @retval SUCCESS if the copy is started, ERROR if the channel is busy or Size is too large.
+ */
+ErrorStatus DMA_MemCopy(uint32_t DMA_Channel, void* Dst, const void* Src, uint32_t Size)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+    uint32_t width, items, chunk, i, tasks;
+
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    width = DMA_WidthOf((uint32_t) Dst, (uint32_t) Src, Size);
+    items = Size >> width;
+
+    if ((Size == 0) || (items > (DMA_MAX_TRANSFER * DMA_MEM_TASKS)) || (DMA_GetChannelStatus(DMA_Channel) == SET)) {
+        return ERROR;
+    }
+
+    DMA_InitStructure.DMA_SrcInc = width;
+    DMA_InitStructure.DMA_DstInc = width;
+    DMA_InitStructure.DMA_DataSize = width;
+    DMA_InitStructure.DMA_Arbitration = DMA_MEM_ARBITRATION;
+
+    if (items <= DMA_MAX_TRANSFER) {
+        DMA_InitStructure.DMA_SrcAddr = (uint32_t) Src;
+        DMA_InitStructure.DMA_DstAddr = (uint32_t) Dst;
+        DMA_InitStructure.DMA_BufferSize = items;
+        DMA_InitStructure.DMA_Mode = DMA_Mode_AutoRequest;
+        DMA_Init(DMA_Channel, &DMA_InitStructure);
+    } else {
+        tasks = (items + DMA_MAX_TRANSFER - 1) / DMA_MAX_TRANSFER;
+        for (i = 0; i < tasks; i++) {
+            chunk = (items > DMA_MAX_TRANSFER) ? DMA_MAX_TRANSFER : items;
+            DMA_InitStructure.DMA_SrcAddr = (uint32_t) Src + ((i * DMA_MAX_TRANSFER) << width);
+            DMA_InitStructure.DMA_DstAddr = (uint32_t) Dst + ((i * DMA_MAX_TRANSFER) << width);
+            DMA_InitStructure.DMA_BufferSize = chunk;
+            DMA_InitStructure.DMA_Mode = (i == (tasks - 1)) ? DMA_Mode_AutoRequest : DMA_Mode_MemScatterGatherAlt;
+            DMA_BuildDescriptor(&DMA_MemTaskList[DMA_Channel][i], &DMA_InitStructure);
+            items -= chunk;
+        }
+        DMA_ScatterGatherInit(DMA_Channel, DMA_MemTaskList[DMA_Channel], tasks, DMA_Mode_MemScatterGather);
+    }
+
+    DMA_ChannelCmd(DMA_Channel, ENABLE);
+    DMA_SoftwareRequest(DMA_Channel);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Starts a memory fill on the specified channel.
+ * @note   The pattern is read from Value with the transfer size allowed by the
+ *         alignment of Dst and Size, i.e. its low byte, low half-word or word.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  Dst: destination address.
+ * @param  Value: pointer to the fill pattern. Must stay valid until completion.
+ * @param  Size: number of bytes to fill.
+ * @retval SUCCESS if the fill is started, ERROR if the channel is busy or Size is too large.
+ */
+ErrorStatus DMA_MemFill(uint32_t DMA_Channel, void* Dst, const uint32_t* Value, uint32_t Size)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+    uint32_t width, items, chunk, i, tasks;
+
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    width = DMA_WidthOf((uint32_t) Dst, 0, Size);
+    items = Size >> width;
+
+    if ((Size == 0) || (items > (DMA_MAX_TRANSFER * DMA_MEM_TASKS)) || (DMA_GetChannelStatus(DMA_Channel) == SET)) {
+        return ERROR;
+    }
+
+    DMA_InitStructure.DMA_SrcAddr = (uint32_t) Value;
+    DMA_InitStructure.DMA_SrcInc = DMA_Inc_None;
+    DMA_InitStructure.DMA_DstInc = width;
+    DMA_InitStructure.DMA_DataSize = width;
+    DMA_InitStructure.DMA_Arbitration = DMA_MEM_ARBITRATION;
+
+    if (items <= DMA_MAX_TRANSFER) {
+        DMA_InitStructure.DMA_DstAddr = (uint32_t) Dst;
+        DMA_InitStructure.DMA_BufferSize = items;
+        DMA_InitStructure.DMA_Mode = DMA_Mode_AutoRequest;
+        DMA_Init(DMA_Channel, &DMA_InitStructure);
+    } else {
+        tasks = (items + DMA_MAX_TRANSFER - 1) / DMA_MAX_TRANSFER;
+        for (i = 0; i < tasks; i++) {
+            chunk = (items > DMA_MAX_TRANSFER) ? DMA_MAX_TRANSFER : items;
+            DMA_InitStructure.DMA_DstAddr = (uint32_t) Dst + ((i * DMA_MAX_TRANSFER) << width);
+            DMA_InitStructure.DMA_BufferSize = chunk;
+            DMA_InitStructure.DMA_Mode = (i == (tasks - 1)) ? DMA_Mode_AutoRequest : DMA_Mode_MemScatterGatherAlt;
+            DMA_BuildDescriptor(&DMA_MemTaskList[DMA_Channel][i], &DMA_InitStructure);
+            items -= chunk;
+        }
+        DMA_ScatterGatherInit(DMA_Channel, DMA_MemTaskList[DMA_Channel], tasks, DMA_Mode_MemScatterGather);
+    }
+
+    DMA_ChannelCmd(DMA_Channel, ENABLE);
+    DMA_SoftwareRequest(DMA_Channel);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Registers the callback of a DMA channel.
+ * @param  DMA_Channel: where x can be (0..5) to select the DMA channel.
+ * @param  Callback: function called from DMA_IRQHandler(), or 0 to remove it.
+ * @retval None
+ */
+void DMA_SetCallback(uint32_t DMA_Channel, DMA_CallbackTypeDef Callback)
+{
+    /* Check the parameters */
+    assert_param(IS_DMA_CHANNEL(DMA_Channel));
+
+    DMA_Callback[DMA_Channel] = Callback;
+}
+
+/**
+ * @brief  Checks whether a bus error occurred.
+ * @param  None
+ * @retval The new state of the error flag (SET or RESET).
+ */
+FlagStatus DMA_GetErrorStatus(void)
+{
+    FlagStatus bitstatus = RESET;
+
+    if ((DMA->ERR_CLR & DMA_ERR_CLR) != (uint32_t) RESET) {
+        bitstatus = SET;
+    } else {
+        bitstatus = RESET;
+    }
+
+    return bitstatus;
+}
+
+/**
+ * @brief  Clears the bus error flag.
+ * @param  None
+ * @retval None
+ */
+void DMA_ClearError(void)
+{
+    DMA->ERR_CLR = 1;
+}
+
+/**
+ * @brief  Dispatches the DMA interrupt to the channel callbacks.
+ * @note   Call this function from DMA_Handler(). A channel is done when the
+ *         controller has disabled it; a ping-pong half is done when the
+ *         controller has written back a stop cycle type in its structure.
+ * @param  None
+ * @retval None
+ */
+void DMA_IRQHandler(void)
+{
+    uint32_t ch, mask, event;
+    uint32_t enabled = DMA->CHNL_ENABLE_SET;
+    FlagStatus error = DMA_GetErrorStatus();
+
+    if (error == SET) {
+        DMA_ClearError();
+    }
+
+    for (ch = 0; ch < DMA_CHANNEL_NUM; ch++) {
+        mask = DMA_CHANNEL_MASK(ch);
+        if ((DMA_ActiveMask & mask) == 0) {
+            continue;
+        }
+
+        event = 0;
+        if (DMA_PingPongMask & mask) {
+            if ((DMA_PrimaryArmed & mask) && ((DMA_ControlTable[ch].Control & DMA_CTRL_CYCLE_CTRL) == DMA_Mode_Stop)) {
+                DMA_PrimaryArmed &= ~mask;
+                event |= DMA_Event_PrimaryDone;
+            }
+            if ((DMA_AlternateArmed & mask) && ((DMA_ControlTable[ch + DMA_ALT_OFFSET].Control & DMA_CTRL_CYCLE_CTRL) == DMA_Mode_Stop)) {
+                DMA_AlternateArmed &= ~mask;
+                event |= DMA_Event_AlternateDone;
+            }
+        }
+        if ((enabled & mask) == 0) {
+            DMA_ActiveMask &= ~mask;
+            DMA_PrimaryArmed &= ~mask;
+            DMA_AlternateArmed &= ~mask;
+            event |= (error == SET) ? DMA_Event_Error : DMA_Event_Done;
+        }
+
+        if (event && DMA_Callback[ch]) {
+            DMA_Callback[ch](ch, event);
+        }
+    }
+}
+
+static uint32_t DMA_EndPointer(uint32_t Start, uint32_t Inc, uint32_t Count)
+{
+    if (Inc == DMA_Inc_None) {
+        return Start;
+    }
+
+    return Start + ((Count - 1) << Inc);
+}
+
+static uint32_t DMA_WidthOf(uint32_t Dst, uint32_t Src, uint32_t Size)
+{
+    uint32_t align = Dst | Src | Size;
+
+    if ((align & 0x3) == 0) {
+        return DMA_DataSize_Word;
+    } else if ((align & 0x1) == 0) {
+        return DMA_DataSize_HalfWord;
+    }
+
+    return DMA_DataSize_Byte;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -0,0 +1,434 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_dma_mem.c
+ * @author  WIZnet
+ * @brief   This file provides a memory copy and fill service on top of the
+ *          DMA controller:
+ *           + Asynchronous requests queued over a set of DMA channels
+ *           + CPU fallback for requests below a size threshold
+ *           + Threshold calibration against the CPU copy
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "w7500x_dma_mem.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup DMAMEM
+ * @brief DMA memory copy service modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint8_t* Dst;
+    const uint8_t* Src;
+    uint32_t Left;
+    uint32_t Pattern;                   /* Fill value, read by the DMA       */
+    uint32_t Seq;                       /* Submission order of the request   */
+    uint8_t State;
+    uint8_t Fill;
+    DMAMEM_CallbackTypeDef Callback;
+    void* Arg;
+} DMAMEM_RequestTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define DMAMEM_STATE_FREE           0
+#define DMAMEM_STATE_PENDING        1
+#define DMAMEM_STATE_ACTIVE         2
+#define DMAMEM_STATE_FAILED         3
+
+#define DMAMEM_CALIB_MAX            512
+
+/* Private macro -------------------------------------------------------------*/
+#define DMAMEM_LOCK(MASK)           do { (MASK) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define DMAMEM_UNLOCK(MASK)         __set_PRIMASK(MASK)
+
+/* Private variables ---------------------------------------------------------*/
+static DMAMEM_RequestTypeDef DMAMEM_Queue[DMAMEM_QUEUE_SIZE];
+static DMAMEM_RequestTypeDef* DMAMEM_Active[DMA_CHANNEL_NUM];
+static uint32_t DMAMEM_Channels = 0;
+static uint32_t DMAMEM_Seq = 0;
+static uint32_t DMAMEM_Threshold = DMAMEM_THRESHOLD;
+
+/* Private function prototypes -----------------------------------------------*/
+static ErrorStatus DMAMEM_Submit(void* Dst, const void* Src, uint32_t Pattern, uint8_t Fill, uint32_t Size,
+        DMAMEM_CallbackTypeDef Callback, void* Arg);
+static void DMAMEM_Dispatch(void);
+static ErrorStatus DMAMEM_Start(uint32_t DMA_Channel, DMAMEM_RequestTypeDef* request);
+static void DMAMEM_Complete(DMAMEM_RequestTypeDef* request);
+static void DMAMEM_DMACallback(uint32_t DMA_Channel, uint32_t DMA_Event);
+static uint32_t DMAMEM_Elapsed(uint32_t Start);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup DMAMEM_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Initializes the memory copy service.
+ * @note   The selected channels must not be used by peripherals at the same
+ *         time. Enable the DMA interrupt in the NVIC and call DMA_IRQHandler()
+ *         from DMA_Handler.
+ * @param  DMA_ChannelMask: bit mask of the DMA channels the service may use.
+ * @retval None
+ */
+void DMAMEM_Init(uint32_t DMA_ChannelMask)
+{
+    uint32_t i;
+
+    /* Check the parameters */
+    assert_param((DMA_ChannelMask != 0) && (DMA_ChannelMask < (1UL << DMA_CHANNEL_NUM)));
+
+    for (i = 0; i < DMAMEM_QUEUE_SIZE; i++) {
+        DMAMEM_Queue[i].State = DMAMEM_STATE_FREE;
+    }
+
+    DMA_Cmd(ENABLE);
+    DMAMEM_Channels = DMA_ChannelMask;
+    for (i = 0; i < DMA_CHANNEL_NUM; i++) {
+        DMAMEM_Active[i] = 0;
+        if (DMA_ChannelMask & (1UL << i)) {
+            DMA_SetCallback(i, DMAMEM_DMACallback);
+        }
+    }
+}
+
+/**
+ * @brief  Sets the size from which requests are given to the DMA.
+ * @param  Threshold: size in bytes.
+ * @retval None
+ */
+void DMAMEM_SetThreshold(uint32_t Threshold)
+{
+    DMAMEM_Threshold = Threshold;
+}
+
+/**
+ * @brief  Returns the size from which requests are given to the DMA.
+ * @param  None
+ * @retval Size in bytes.
+ */
+uint32_t DMAMEM_GetThreshold(void)
+{
+    return DMAMEM_Threshold;
+}
+
+/**
+ * @brief  Measures the smallest copy size for which the DMA beats the CPU.
+ * @note   SysTick must be running. Sizes from 16 to 512 bytes are timed with
+ *         memcpy() and with a DMA copy waited for by polling, including the
+ *         set-up time. The result becomes the threshold. Nothing is measured
+ *         while requests are in flight.
+ * @param  None
+ * @retval The new threshold in bytes.
+ */
+uint32_t DMAMEM_Calibrate(void)
+{
+    static uint32_t src[DMAMEM_CALIB_MAX / 4], dst[DMAMEM_CALIB_MAX / 4];
+    uint32_t size, start, cpu, dma, ch;
+
+    if (((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0) || (DMAMEM_Channels == 0) || (DMAMEM_GetStatus() == SET)) {
+        return DMAMEM_Threshold;
+    }
+
+    for (ch = 0; (DMAMEM_Channels & (1UL << ch)) == 0; ch++) {
+    }
+
+    for (size = 16; size <= DMAMEM_CALIB_MAX; size <<= 1) {
+        start = SysTick->VAL;
+        memcpy(dst, src, size);
+        cpu = DMAMEM_Elapsed(start);
+
+        start = SysTick->VAL;
+        if (DMA_MemCopy(ch, dst, src, size) != SUCCESS) {
+            /* The channel is taken by someone else, keep the current value */
+            return DMAMEM_Threshold;
+        }
+        while (DMA_GetChannelStatus(ch) == SET) {
+        }
+        dma = DMAMEM_Elapsed(start);
+
+        if (dma < cpu) {
+            break;
+        }
+    }
+
+    DMAMEM_Threshold = size;
+    return size;
+}
+
+/**
+ * @brief  Copies a buffer.
+ * @note   Requests below the threshold are done at once by the CPU and their
+ *         callback is called before returning. Others are queued and started
+ *         as soon as a channel is free; the buffers must not be touched until
+ *         the callback. Overlapping buffers are not supported.
+ * @param  Dst: destination address.
+ * @param  Src: source address.
+ * @param  Size: number of bytes.
+ * @param  Callback: completion callback, may be 0.
+ * @param  Arg: argument of the callback.
+ * @retval SUCCESS, or ERROR if the queue is full or the DMA refused the
+ *         request (e.g. a channel of the service is used by a peripheral).
+ *         The callback is not called on ERROR.
+ */
+ErrorStatus DMAMEM_Copy(void* Dst, const void* Src, uint32_t Size, DMAMEM_CallbackTypeDef Callback, void* Arg)
+{
+    if ((Size < DMAMEM_Threshold) || (DMAMEM_Channels == 0)) {
+        memcpy(Dst, Src, Size);
+        if (Callback) {
+            Callback(Arg, SUCCESS);
+        }
+        return SUCCESS;
+    }
+
+    return DMAMEM_Submit(Dst, Src, 0, 0, Size, Callback, Arg);
+}
+
+/**
+ * @brief  Fills a buffer with a byte value.
+ * @note   Same rules as DMAMEM_Copy().
+ * @param  Dst: destination address.
+ * @param  Value: fill value.
+ * @param  Size: number of bytes.
+ * @param  Callback: completion callback, may be 0.
+ * @param  Arg: argument of the callback.
+ * @retval SUCCESS, or ERROR as for DMAMEM_Copy().
+ */
+ErrorStatus DMAMEM_Set(void* Dst, uint8_t Value, uint32_t Size, DMAMEM_CallbackTypeDef Callback, void* Arg)
+{
+    if ((Size < DMAMEM_Threshold) || (DMAMEM_Channels == 0)) {
+        memset(Dst, Value, Size);
+        if (Callback) {
+            Callback(Arg, SUCCESS);
+        }
+        return SUCCESS;
+    }
+
+    return DMAMEM_Submit(Dst, 0, Value * 0x01010101UL, 1, Size, Callback, Arg);
+}
+
+/**
+ * @brief  Checks whether requests are queued or in flight.
+ * @param  None
+ * @retval SET until every request has completed.
+ */
+FlagStatus DMAMEM_GetStatus(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < DMAMEM_QUEUE_SIZE; i++) {
+        if (DMAMEM_Queue[i].State != DMAMEM_STATE_FREE) {
+            return SET;
+        }
+    }
+
+    return RESET;
+}
+
+/**
+ * @brief  Waits until every request has completed.
+ * @param  None
+ * @retval None
+ */
+void DMAMEM_Wait(void)
+{
+    while (DMAMEM_GetStatus() == SET) {
+    }
+}
+
+static ErrorStatus DMAMEM_Submit(void* Dst, const void* Src, uint32_t Pattern, uint8_t Fill, uint32_t Size,
+        DMAMEM_CallbackTypeDef Callback, void* Arg)
+{
+    DMAMEM_RequestTypeDef* request = 0;
+    uint32_t primask, i;
+
+    DMAMEM_LOCK(primask);
+    for (i = 0; i < DMAMEM_QUEUE_SIZE; i++) {
+        if (DMAMEM_Queue[i].State == DMAMEM_STATE_FREE) {
+            request = &DMAMEM_Queue[i];
+            break;
+        }
+    }
+    if (request == 0) {
+        DMAMEM_UNLOCK(primask);
+        return ERROR;
+    }
+
+    request->Dst = (uint8_t*) Dst;
+    request->Src = (const uint8_t*) Src;
+    request->Left = Size;
+    request->Pattern = Pattern;
+    request->Fill = Fill;
+    request->Callback = Callback;
+    request->Arg = Arg;
+    request->Seq = DMAMEM_Seq++;
+    request->State = DMAMEM_STATE_PENDING;
+
+    DMAMEM_Dispatch();
+    if (request->State == DMAMEM_STATE_FAILED) {
+        /* Nothing was transferred, the caller gets the error instead of the callback */
+        request->State = DMAMEM_STATE_FREE;
+        DMAMEM_UNLOCK(primask);
+        DMAMEM_Complete(0);
+        return ERROR;
+    }
+    DMAMEM_UNLOCK(primask);
+    DMAMEM_Complete(0);
+
+    return SUCCESS;
+}
+
+/* Starts the oldest pending requests on the idle channels, called locked */
+static void DMAMEM_Dispatch(void)
+{
+    DMAMEM_RequestTypeDef* oldest;
+    uint32_t ch, i;
+
+    for (ch = 0; ch < DMA_CHANNEL_NUM; ch++) {
+        if (((DMAMEM_Channels & (1UL << ch)) == 0) || (DMAMEM_Active[ch] != 0)) {
+            continue;
+        }
+
+        oldest = 0;
+        for (i = 0; i < DMAMEM_QUEUE_SIZE; i++) {
+            if ((DMAMEM_Queue[i].State == DMAMEM_STATE_PENDING)
+                    && ((oldest == 0) || ((int32_t) (DMAMEM_Queue[i].Seq - oldest->Seq) < 0))) {
+                oldest = &DMAMEM_Queue[i];
+            }
+        }
+        if (oldest == 0) {
+            return;
+        }
+
+        if (DMAMEM_Start(ch, oldest) == SUCCESS) {
+            oldest->State = DMAMEM_STATE_ACTIVE;
+            DMAMEM_Active[ch] = oldest;
+        } else {
+            /* Completed with ERROR by DMAMEM_Complete() once unlocked */
+            oldest->State = DMAMEM_STATE_FAILED;
+        }
+    }
+}
+
+static ErrorStatus DMAMEM_Start(uint32_t DMA_Channel, DMAMEM_RequestTypeDef* request)
+{
+    uint32_t size = (request->Left > DMAMEM_BLOCK_SIZE) ? DMAMEM_BLOCK_SIZE : request->Left;
+    ErrorStatus status;
+
+    if (request->Fill) {
+        status = DMA_MemFill(DMA_Channel, request->Dst, &request->Pattern, size);
+    } else {
+        status = DMA_MemCopy(DMA_Channel, request->Dst, request->Src, size);
+        if (status == SUCCESS) {
+            request->Src += size;
+        }
+    }
+    if (status == SUCCESS) {
+        request->Dst += size;
+        request->Left -= size;
+    }
+
+    return status;
+}
+
+/* Frees the request, or the failed ones if 0, and calls their callbacks */
+static void DMAMEM_Complete(DMAMEM_RequestTypeDef* request)
+{
+    DMAMEM_CallbackTypeDef callback;
+    ErrorStatus status;
+    void* arg;
+    uint32_t primask, i;
+
+    for (i = 0; i < DMAMEM_QUEUE_SIZE; i++) {
+        DMAMEM_LOCK(primask);
+        if ((request != 0) ? (request != &DMAMEM_Queue[i]) : (DMAMEM_Queue[i].State != DMAMEM_STATE_FAILED)) {
+            DMAMEM_UNLOCK(primask);
+            continue;
+        }
+        status = ((DMAMEM_Queue[i].State == DMAMEM_STATE_FAILED) || DMAMEM_Queue[i].Left) ? ERROR : SUCCESS;
+        callback = DMAMEM_Queue[i].Callback;
+        arg = DMAMEM_Queue[i].Arg;
+        DMAMEM_Queue[i].State = DMAMEM_STATE_FREE;
+        DMAMEM_UNLOCK(primask);
+
+        if (callback) {
+            callback(arg, status);
+        }
+    }
+}
+
+static void DMAMEM_DMACallback(uint32_t DMA_Channel, uint32_t DMA_Event)
+{
+    DMAMEM_RequestTypeDef* request = DMAMEM_Active[DMA_Channel];
+    uint32_t primask;
+
+    if ((request == 0) || ((DMA_Event & (DMA_Event_Done | DMA_Event_Error)) == 0)) {
+        return;
+    }
+
+    if (DMA_Event & DMA_Event_Error) {
+        request->State = DMAMEM_STATE_FAILED;
+    } else if (request->Left && (DMAMEM_Start(DMA_Channel, request) == SUCCESS)) {
+        return;
+    }
+
+    DMAMEM_LOCK(primask);
+    DMAMEM_Active[DMA_Channel] = 0;
+    DMAMEM_Dispatch();
+    DMAMEM_UNLOCK(primask);
+
+    /* Left is still set if the next block could not be started */
+    DMAMEM_Complete(request);
+    DMAMEM_Complete(0);
+}
+
+static uint32_t DMAMEM_Elapsed(uint32_t Start)
+{
+    uint32_t now = SysTick->VAL;
+
+    /* SysTick counts down and reloads from LOAD */
+    if (now <= Start) {
+        return Start - now;
+    }
+
+    return Start + (SysTick->LOAD + 1) - now;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
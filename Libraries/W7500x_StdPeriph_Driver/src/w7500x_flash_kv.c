@@ -0,0 +1,539 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_flash_kv.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to keep small values in
+ *          sectors of the embedded flash reserved for them:
+ *           + Records appended to a log, never rewritten in place
+ *           + CRC checked records, a record cut by a reset is ignored
+ *           + Sectors used in turn and compacted oldest first
+ *           + Index in RAM built by a scan at start up
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_flash_kv.h"
+#include <string.h>
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup FLASHKV
+ * @brief Flash key/value store modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t Magic;
+    uint32_t Sequence;                  /* Order of use of the sector      */
+} FLASHKV_SectorTypeDef;
+
+typedef struct
+{
+    uint16_t Magic;
+    uint16_t Key;
+    uint16_t Length;                    /* FLASHKV_DELETED for a deletion  */
+    uint16_t Crc;                       /* Of the key, length and value    */
+} FLASHKV_RecordTypeDef;
+
+typedef struct
+{
+    uint32_t Base;
+    uint32_t Sectors;
+    uint32_t Sequence[FLASHKV_MAX_SECTORS]; /* FLASHKV_FREE when erased  */
+    uint32_t Active;                    /* Sector appended to              */
+    uint32_t Offset;                    /* Next record in the active sector */
+} FLASHKV_StoreTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define FLASHKV_SECTOR_MAGIC        ((uint32_t)0x3153564B)      /* "KVS1" */
+#define FLASHKV_RECORD_MAGIC        ((uint16_t)0x5AA5)
+#define FLASHKV_DELETED             ((uint16_t)0x8000)
+#define FLASHKV_FREE                ((uint32_t)0xFFFFFFFF)
+#define FLASHKV_NONE                ((uint32_t)0xFFFFFFFF)
+
+#define FLASHKV_RECORD_MAX          (sizeof(FLASHKV_RecordTypeDef) + FLASHKV_MAX_VALUE + 3)
+
+/* Private macro -------------------------------------------------------------*/
+#define FLASHKV_SECTOR(S)           (FLASHKV_Store.Base + ((S) * FLASHKV_SECTOR_SIZE))
+#define FLASHKV_RECORD_SIZE(LEN)    ((sizeof(FLASHKV_RecordTypeDef) + (LEN) + 3) & ~(uint32_t) 3)
+
+/* Private variables ---------------------------------------------------------*/
+static FLASHKV_StoreTypeDef FLASHKV_Store;
+static uint32_t FLASHKV_Index[FLASHKV_MAX_KEYS];        /* Record address, 0 when absent */
+static uint32_t FLASHKV_Buffer[FLASHKV_RECORD_MAX / 4]; /* Data to program, kept in RAM  */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t FLASHKV_Crc(const FLASHKV_RecordTypeDef* Record, const uint8_t* Data);
+static void FLASHKV_Load(void);
+static uint32_t FLASHKV_Scan(uint32_t Sector);
+static FlagStatus FLASHKV_IsErased(uint32_t Address, uint32_t Size);
+static void FLASHKV_EraseSector(uint32_t Sector);
+static ErrorStatus FLASHKV_Program(uint32_t Address, uint32_t Size);
+static ErrorStatus FLASHKV_Open(uint32_t Sector);
+static ErrorStatus FLASHKV_Compact(uint32_t Sector);
+static ErrorStatus FLASHKV_Reserve(uint32_t Size);
+static ErrorStatus FLASHKV_Append(uint16_t Key, uint16_t Length, const void* Data);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup FLASHKV_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Opens the store and builds the index from its records.
+ * @note   The sectors must be left out of the code area by the linker
+ *         script, e.g. the last blocks of the main flash. Sectors holding
+ *         neither a store header nor erased flash are erased. A compaction
+ *         cut by a reset, which leaves no sector erased, is completed.
+ * @param  Address: start of the first sector, aligned on FLASHKV_SECTOR_SIZE.
+ * @param  Sectors: number of consecutive sectors, 2 to FLASHKV_MAX_SECTORS.
+ *         One of them is always kept erased for the compaction.
+ * @retval SUCCESS, or ERROR for a bad address or number of sectors.
+ */
+ErrorStatus FLASHKV_Init(uint32_t Address, uint32_t Sectors)
+{
+    const FLASHKV_SectorTypeDef* header;
+    uint32_t oldest;
+    uint32_t i;
+
+    if ((Address == 0) || ((Address % FLASHKV_SECTOR_SIZE) != 0) || (Sectors < 2) || (Sectors > FLASHKV_MAX_SECTORS)) {
+        return ERROR;
+    }
+
+    FLASHKV_Store.Base = Address;
+    FLASHKV_Store.Sectors = Sectors;
+
+    for (i = 0; i < Sectors; i++) {
+        header = (const FLASHKV_SectorTypeDef*) FLASHKV_SECTOR(i);
+        if ((header->Magic == FLASHKV_SECTOR_MAGIC) && (header->Sequence != FLASHKV_FREE)) {
+            FLASHKV_Store.Sequence[i] = header->Sequence;
+        } else {
+            /* Erase cut by a reset, or foreign data */
+            FLASHKV_Store.Sequence[i] = FLASHKV_FREE;
+            if (FLASHKV_IsErased(FLASHKV_SECTOR(i), FLASHKV_SECTOR_SIZE) == RESET) {
+                FLASHKV_EraseSector(i);
+            }
+        }
+    }
+
+    FLASHKV_Load();
+
+    /* No sector erased: the reset came after FLASHKV_Open() of the last
+       free sector and before the oldest one was compacted into it and
+       erased. The active sector holds only copies of the oldest one's
+       records, the copy is done again from where it stopped. */
+    oldest = 0;
+    for (i = 0; i < Sectors; i++) {
+        if (FLASHKV_Store.Sequence[i] == FLASHKV_FREE) {
+            return SUCCESS;
+        }
+        if (FLASHKV_Store.Sequence[i] < FLASHKV_Store.Sequence[oldest]) {
+            oldest = i;
+        }
+    }
+
+    if (FLASHKV_Compact(oldest) != SUCCESS) {
+        /* A record cut in the active sector hides where to go on, that
+           sector is dropped instead and the oldest one kept */
+        FLASHKV_EraseSector(FLASHKV_Store.Active);
+        FLASHKV_Load();
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Copies the value of a key.
+ * @param  Key: key to look up, lower than FLASHKV_MAX_KEYS.
+ * @param  Data: buffer receiving the value.
+ * @param  Size: size of the buffer, a longer value is cut.
+ * @param  Length: receives the length of the stored value, may be NULL.
+ * @retval SUCCESS, or ERROR when the key has no value.
+ */
+ErrorStatus FLASHKV_Read(uint16_t Key, void* Data, uint16_t Size, uint16_t* Length)
+{
+    const void* value;
+    uint16_t length;
+
+    if ((value = FLASHKV_Get(Key, &length)) == 0) {
+        return ERROR;
+    }
+
+    memcpy(Data, value, (length < Size) ? length : Size);
+    if (Length != 0) {
+        *Length = length;
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief  Finds the value of a key in the flash, without copying it.
+ * @note   The pointer is valid until the next FLASHKV_Write() or
+ *         FLASHKV_Delete(), which may compact its sector.
+ * @param  Key: key to look up, lower than FLASHKV_MAX_KEYS.
+ * @param  Length: receives the length of the value.
+ * @retval Value in the flash, or NULL when the key has no value.
+ */
+const void* FLASHKV_Get(uint16_t Key, uint16_t* Length)
+{
+    const FLASHKV_RecordTypeDef* record;
+
+    /* Check the parameters */
+    assert_param(IS_FLASHKV_KEY(Key));
+
+    if ((Key >= FLASHKV_MAX_KEYS) || (FLASHKV_Index[Key] == 0)) {
+        return 0;
+    }
+
+    record = (const FLASHKV_RecordTypeDef*) FLASHKV_Index[Key];
+    *Length = record->Length;
+    return record + 1;
+}
+
+/**
+ * @brief  Sets the value of a key.
+ * @note   Writing the value already stored does not touch the flash.
+ *         Data must not point into the store.
+ * @param  Key: key to set, lower than FLASHKV_MAX_KEYS.
+ * @param  Data: value.
+ * @param  Length: length of the value, up to FLASHKV_MAX_VALUE.
+ * @retval SUCCESS, or ERROR when the store is full of live values or the
+ *         flash could not be programmed.
+ */
+ErrorStatus FLASHKV_Write(uint16_t Key, const void* Data, uint16_t Length)
+{
+    const void* value;
+    uint16_t length;
+
+    /* Check the parameters */
+    assert_param(IS_FLASHKV_KEY(Key));
+
+    if ((Key >= FLASHKV_MAX_KEYS) || (Length > FLASHKV_MAX_VALUE)) {
+        return ERROR;
+    }
+
+    value = FLASHKV_Get(Key, &length);
+    if ((value != 0) && (length == Length) && (memcmp(value, Data, Length) == 0)) {
+        return SUCCESS;
+    }
+
+    return FLASHKV_Append(Key, Length, Data);
+}
+
+/**
+ * @brief  Removes the value of a key.
+ * @param  Key: key to remove, lower than FLASHKV_MAX_KEYS.
+ * @retval SUCCESS, or ERROR when the flash could not be programmed.
+ */
+ErrorStatus FLASHKV_Delete(uint16_t Key)
+{
+    /* Check the parameters */
+    assert_param(IS_FLASHKV_KEY(Key));
+
+    if (Key >= FLASHKV_MAX_KEYS) {
+        return ERROR;
+    }
+    if (FLASHKV_Index[Key] == 0) {
+        return SUCCESS;
+    }
+
+    return FLASHKV_Append(Key, FLASHKV_DELETED, 0);
+}
+
+/* CRC-16/CCITT of the key, the length and the value of a record */
+static uint16_t FLASHKV_Crc(const FLASHKV_RecordTypeDef* Record, const uint8_t* Data)
+{
+    uint8_t head[4];
+    uint32_t length = (Record->Length == FLASHKV_DELETED) ? 0 : Record->Length;
+    uint32_t i;
+    uint32_t bit;
+    uint16_t crc = 0xFFFF;
+    uint8_t byte;
+
+    head[0] = (uint8_t) Record->Key;
+    head[1] = (uint8_t) (Record->Key >> 8);
+    head[2] = (uint8_t) Record->Length;
+    head[3] = (uint8_t) (Record->Length >> 8);
+
+    for (i = 0; i < (4 + length); i++) {
+        byte = (i < 4) ? head[i] : Data[i - 4];
+        crc ^= (uint16_t) byte << 8;
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* Replays the sectors in order of use into the index, the last record of a key wins */
+static void FLASHKV_Load(void)
+{
+    uint32_t sequence = 0;
+    uint32_t sector;
+    uint32_t next;
+    uint32_t i;
+
+    FLASHKV_Store.Active = FLASHKV_NONE;
+    FLASHKV_Store.Offset = FLASHKV_SECTOR_SIZE;
+    memset(FLASHKV_Index, 0, sizeof(FLASHKV_Index));
+
+    while (1) {
+        sector = FLASHKV_NONE;
+        next = FLASHKV_FREE;
+        for (i = 0; i < FLASHKV_Store.Sectors; i++) {
+            if ((FLASHKV_Store.Sequence[i] >= sequence) && (FLASHKV_Store.Sequence[i] < next)) {
+                next = FLASHKV_Store.Sequence[i];
+                sector = i;
+            }
+        }
+        if (sector == FLASHKV_NONE) {
+            break;
+        }
+
+        FLASHKV_Store.Active = sector;
+        FLASHKV_Store.Offset = FLASHKV_Scan(sector);
+        sequence = next + 1;
+    }
+
+    /* Appending is safe only on erased flash */
+    if ((FLASHKV_Store.Active != FLASHKV_NONE) &&
+        (FLASHKV_IsErased(FLASHKV_SECTOR(FLASHKV_Store.Active) + FLASHKV_Store.Offset,
+                          FLASHKV_SECTOR_SIZE - FLASHKV_Store.Offset) == RESET)) {
+        FLASHKV_Store.Offset = FLASHKV_SECTOR_SIZE;
+    }
+}
+
+/* Applies the records of a sector to the index, returns the offset after the last one */
+static uint32_t FLASHKV_Scan(uint32_t Sector)
+{
+    const FLASHKV_RecordTypeDef* record;
+    uint32_t offset = sizeof(FLASHKV_SectorTypeDef);
+    uint32_t length;
+
+    while ((offset + sizeof(FLASHKV_RecordTypeDef)) <= FLASHKV_SECTOR_SIZE) {
+        record = (const FLASHKV_RecordTypeDef*) (FLASHKV_SECTOR(Sector) + offset);
+        if (FLASHKV_IsErased((uint32_t) record, sizeof(FLASHKV_RecordTypeDef)) == SET) {
+            break;
+        }
+
+        /* A broken header hides where the next record starts, the sector is closed */
+        length = (record->Length == FLASHKV_DELETED) ? 0 : record->Length;
+        if ((record->Magic != FLASHKV_RECORD_MAGIC) || (record->Key >= FLASHKV_MAX_KEYS) ||
+            (length > FLASHKV_MAX_VALUE) || ((offset + FLASHKV_RECORD_SIZE(length)) > FLASHKV_SECTOR_SIZE)) {
+            return FLASHKV_SECTOR_SIZE;
+        }
+
+        /* A record cut by a reset is skipped */
+        if (record->Crc == FLASHKV_Crc(record, (const uint8_t*) (record + 1))) {
+            FLASHKV_Index[record->Key] = (record->Length == FLASHKV_DELETED) ? 0 : (uint32_t) record;
+        }
+
+        offset += FLASHKV_RECORD_SIZE(length);
+    }
+
+    return offset;
+}
+
+static FlagStatus FLASHKV_IsErased(uint32_t Address, uint32_t Size)
+{
+    const uint32_t* word = (const uint32_t*) Address;
+
+    for (Size /= 4; Size != 0; Size--) {
+        if (*word++ != 0xFFFFFFFF) {
+            return RESET;
+        }
+    }
+    return SET;
+}
+
+static void FLASHKV_EraseSector(uint32_t Sector)
+{
+#if (FLASHKV_SECTOR_SIZE == 256)
+    FLASH_IAP(IAP_ERAS_SECT, FLASHKV_SECTOR(Sector), 0, 0);
+#else
+    uint32_t offset;
+
+    for (offset = 0; offset < FLASHKV_SECTOR_SIZE; offset += 4096) {
+        FLASH_IAP(IAP_ERAS_BLCK, FLASHKV_SECTOR(Sector) + offset, 0, 0);
+    }
+#endif
+    FLASHKV_Store.Sequence[Sector] = FLASHKV_FREE;
+}
+
+/* Programs FLASHKV_Buffer and reads it back */
+static ErrorStatus FLASHKV_Program(uint32_t Address, uint32_t Size)
+{
+    FLASH_IAP(IAP_PROG, Address, (uint8_t*) FLASHKV_Buffer, Size);
+
+    return (memcmp((const void*) Address, FLASHKV_Buffer, Size) == 0) ? SUCCESS : ERROR;
+}
+
+/* Makes an erased sector the active one, with the next sequence number */
+static ErrorStatus FLASHKV_Open(uint32_t Sector)
+{
+    FLASHKV_SectorTypeDef* header = (FLASHKV_SectorTypeDef*) FLASHKV_Buffer;
+
+    header->Magic = FLASHKV_SECTOR_MAGIC;
+    header->Sequence = (FLASHKV_Store.Active == FLASHKV_NONE) ? 0 : (FLASHKV_Store.Sequence[FLASHKV_Store.Active] + 1);
+
+    FLASHKV_Store.Active = Sector;
+    FLASHKV_Store.Sequence[Sector] = header->Sequence;
+    FLASHKV_Store.Offset = sizeof(FLASHKV_SectorTypeDef);
+
+    if (FLASHKV_Program(FLASHKV_SECTOR(Sector), sizeof(FLASHKV_SectorTypeDef)) != SUCCESS) {
+        FLASHKV_Store.Offset = FLASHKV_SECTOR_SIZE;
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+/* Copies the live records of a sector into the active one, then erases it */
+static ErrorStatus FLASHKV_Compact(uint32_t Sector)
+{
+    const FLASHKV_RecordTypeDef* record;
+    uint32_t offset = sizeof(FLASHKV_SectorTypeDef);
+    uint32_t size;
+
+    while ((offset + sizeof(FLASHKV_RecordTypeDef)) <= FLASHKV_SECTOR_SIZE) {
+        record = (const FLASHKV_RecordTypeDef*) (FLASHKV_SECTOR(Sector) + offset);
+        if (record->Magic != FLASHKV_RECORD_MAGIC) {
+            break;
+        }
+
+        size = FLASHKV_RECORD_SIZE((record->Length == FLASHKV_DELETED) ? 0 : record->Length);
+        if ((record->Key < FLASHKV_MAX_KEYS) && (FLASHKV_Index[record->Key] == (uint32_t) record)) {
+            if ((FLASHKV_Store.Offset + size) > FLASHKV_SECTOR_SIZE) {
+                return ERROR;
+            }
+            memcpy(FLASHKV_Buffer, record, size);
+            if (FLASHKV_Program(FLASHKV_SECTOR(FLASHKV_Store.Active) + FLASHKV_Store.Offset, size) != SUCCESS) {
+                FLASHKV_Store.Offset = FLASHKV_SECTOR_SIZE;
+                return ERROR;
+            }
+            FLASHKV_Index[record->Key] = FLASHKV_SECTOR(FLASHKV_Store.Active) + FLASHKV_Store.Offset;
+            FLASHKV_Store.Offset += size;
+        }
+        offset += size;
+    }
+
+    FLASHKV_EraseSector(Sector);
+    return SUCCESS;
+}
+
+/* Makes room for a record in the active sector */
+static ErrorStatus FLASHKV_Reserve(uint32_t Size)
+{
+    uint32_t free;
+    uint32_t oldest;
+    uint32_t spare;
+    uint32_t tries;
+    uint32_t i;
+
+    for (tries = 0; tries <= FLASHKV_Store.Sectors; tries++) {
+        if ((FLASHKV_Store.Active != FLASHKV_NONE) && ((FLASHKV_Store.Offset + Size) <= FLASHKV_SECTOR_SIZE)) {
+            return SUCCESS;
+        }
+
+        /* Sectors are taken in turn after the active one, which spreads the erases */
+        free = 0;
+        spare = FLASHKV_NONE;
+        oldest = FLASHKV_NONE;
+        for (i = 1; i <= FLASHKV_Store.Sectors; i++) {
+            uint32_t sector = (FLASHKV_Store.Active == FLASHKV_NONE) ? (i - 1) : ((FLASHKV_Store.Active + i) % FLASHKV_Store.Sectors);
+
+            if (FLASHKV_Store.Sequence[sector] == FLASHKV_FREE) {
+                if (spare == FLASHKV_NONE) {
+                    spare = sector;
+                }
+                free++;
+            } else if ((oldest == FLASHKV_NONE) || (FLASHKV_Store.Sequence[sector] < FLASHKV_Store.Sequence[oldest])) {
+                oldest = sector;
+            }
+        }
+
+        if (spare == FLASHKV_NONE) {
+            return ERROR;
+        }
+        if (FLASHKV_Open(spare) != SUCCESS) {
+            return ERROR;
+        }
+
+        /* Only the spare sector was left, the oldest one is compacted into it */
+        if ((free == 1) && (oldest != FLASHKV_NONE)) {
+            if (FLASHKV_Compact(oldest) != SUCCESS) {
+                return ERROR;
+            }
+        }
+    }
+
+    return ERROR;
+}
+
+/* Writes a record at the end of the log and points the index to it */
+static ErrorStatus FLASHKV_Append(uint16_t Key, uint16_t Length, const void* Data)
+{
+    FLASHKV_RecordTypeDef* record = (FLASHKV_RecordTypeDef*) FLASHKV_Buffer;
+    uint32_t length = (Length == FLASHKV_DELETED) ? 0 : Length;
+    uint32_t size = FLASHKV_RECORD_SIZE(length);
+    uint32_t address;
+
+    if (FLASHKV_Reserve(size) != SUCCESS) {
+        return ERROR;
+    }
+
+    memset(FLASHKV_Buffer, 0xFF, size);
+    record->Magic = FLASHKV_RECORD_MAGIC;
+    record->Key = Key;
+    record->Length = Length;
+    if (length != 0) {
+        memcpy(record + 1, Data, length);
+    }
+    record->Crc = FLASHKV_Crc(record, (const uint8_t*) (record + 1));
+
+    address = FLASHKV_SECTOR(FLASHKV_Store.Active) + FLASHKV_Store.Offset;
+    FLASHKV_Store.Offset += size;
+    if (FLASHKV_Program(address, size) != SUCCESS) {
+        return ERROR;
+    }
+
+    FLASHKV_Index[Key] = (Length == FLASHKV_DELETED) ? 0 : address;
+    return SUCCESS;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
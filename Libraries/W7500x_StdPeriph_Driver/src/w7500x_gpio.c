@@ -38,9 +38,13 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define GPIO_PAD_RESERVED   ((uint32_t) 0x90)   /* PADCON bits kept by GPIO_Init */
+#define GPIO_PORT(GPIOx)    (((uint32_t) (GPIOx) - GPIOA_BASE) >> 24)
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static uint32_t gpio_pad_value(uint32_t GPIO_Pad);
+
 /* Private functions ---------------------------------------------------------*/
 
 /** @defgroup GPIO_Private_Functions
@@ -169,6 +173,62 @@ void GPIO_StructInit(GPIO_InitTypeDef* GPIO_InitStruct)
     GPIO_InitStruct->GPIO_AF = (GPIOAf_TypeDef) (PAD_AF0);
 }
 
+/**
+ * @brief  Applies a table of pin configurations, e.g. the board pin map kept as
+ *         a const array in flash. The result is the same as GPIO_Init() called
+ *         for each entry in order.
+ * @note   The pad value of an entry is computed once for all its pins, each pin
+ *         then takes one AFC and one PADCON write. The directions of all entries
+ *         are merged and written last, at most one OUTENCLR and one OUTENSET
+ *         write per port, so that no pin drives before its pad is configured.
+ * @param  GPIO_PinConfig: pointer to the first GPIO_PinConfigTypeDef entry.
+ * @param  Count: number of entries.
+ * @retval None
+ */
+void GPIO_BulkInit(const GPIO_PinConfigTypeDef* GPIO_PinConfig, uint32_t Count)
+{
+    uint32_t outen_set[4] = { 0, 0, 0, 0 }, outen_clr[4] = { 0, 0, 0, 0 };
+    uint32_t port, pins, pinpos, pad_value;
+    __IO uint32_t* afc;
+    __IO uint32_t* padcon;
+
+    for (; Count > 0; Count--, GPIO_PinConfig++) {
+        /* Check the parameters */
+        assert_param(IS_GPIO_ALL_PERIPH(GPIO_PinConfig->GPIOx));
+        assert_param(IS_GPIO_PIN(GPIO_PinConfig->GPIO_Pin));
+        assert_param(IS_GPIO_DIRECTION(GPIO_PinConfig->GPIO_Direction));
+        assert_param(IS_GPIO_AF(GPIO_PinConfig->GPIO_AF));
+
+        port = GPIO_PORT(GPIO_PinConfig->GPIOx);
+        pins = GPIO_PinConfig->GPIO_Pin;
+        if (GPIO_PinConfig->GPIOx == GPIOD) pins &= 0x001F;
+
+        if (GPIO_PinConfig->GPIO_Direction == GPIO_Direction_OUT) {
+            outen_set[port] |= pins;
+            outen_clr[port] &= ~pins;
+        } else {
+            outen_clr[port] |= pins;
+            outen_set[port] &= ~pins;
+        }
+
+        pad_value = gpio_pad_value(GPIO_PinConfig->GPIO_Pad);
+        afc = AFC_PA[port].REGISTER;
+        padcon = PADCON_PA[port].REGISTER;
+
+        for (pinpos = 0; pins != 0; pinpos++, pins >>= 1) {
+            if (pins & 0x01) {
+                afc[pinpos] = GPIO_PinConfig->GPIO_AF;
+                padcon[pinpos] = (padcon[pinpos] & GPIO_PAD_RESERVED) | pad_value;
+            }
+        }
+    }
+
+    for (port = 0; port < 4; port++) {
+        if (outen_clr[port]) ((GPIO_TypeDef*) (GPIOA_BASE + (port << 24)))->OUTENCLR = outen_clr[port];
+        if (outen_set[port]) ((GPIO_TypeDef*) (GPIOA_BASE + (port << 24)))->OUTENSET = outen_set[port];
+    }
+}
+
 /**
  * @brief  Reads the specified input port pin.
  * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
@@ -560,6 +620,24 @@ uint8_t GPIO_Read_PinPad(GPIO_TypeDef* GPIOx, uint16_t GPIO_PinSource)
     else return (uint8_t) PADCON_PD->REGISTER[GPIO_PinSource];
 }
 
+/* PADCON value of a GPIO_Pad setting, the way GPIO_Init() builds it */
+static uint32_t gpio_pad_value(uint32_t GPIO_Pad)
+{
+    uint32_t pad_value;
+
+    pad_value = GPIO_Pad & (GPIO_LowDrivingStrength | GPIO_OpenDrainEnable | GPIO_InputBufferEnable | GPIO_CMOS);
+
+    if ((GPIO_Pad & GPIO_PuPd_NOPULL) != GPIO_PuPd_NOPULL) {
+        if (GPIO_Pad & GPIO_PuPd_DOWN) {
+            pad_value |= GPIO_PuPd_DOWN;
+        } else if (GPIO_Pad & GPIO_PuPd_UP) {
+            pad_value |= GPIO_PuPd_UP;
+        }
+    }
+
+    return pad_value;
+}
+
 /**
  * @}
  */
@@ -0,0 +1,402 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_gpio_irq.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to dispatch the GPIO port
+ *          interrupts to per pin callbacks:
+ *           + Pending pins resolved by a count trailing zeros table
+ *           + Rising, falling or both edges
+ *           + Debouncing on the GPIOIRQ_TimeHandler() tick
+ *           + Timestamped edge queue
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_gpio_irq.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup GPIOIRQ
+ * @brief GPIO interrupt dispatcher modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    GPIOIRQ_CallbackTypeDef Callback[16];
+    uint32_t Deadline[16];              /* Tick the level of a settling pin is read at */
+    uint16_t Debounce[16];
+    uint16_t Rising;                    /* Pins reporting rising edges */
+    uint16_t Falling;                   /* Pins reporting falling edges */
+    uint16_t Queue;                     /* Pins recorded in the edge queue */
+    uint16_t Level;                     /* Last reported level */
+    __IO uint16_t Settling;             /* Pins waiting for their debounce deadline */
+} GPIOIRQ_PortTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define GPIOIRQ_PORTS               4
+#define GPIOIRQ_PORT(GPIOx)         (((uint32_t) (GPIOx) - GPIOA_BASE) >> 24)
+#define GPIOIRQ_GPIO(PORT)          ((GPIO_TypeDef*) (GPIOA_BASE + ((PORT) << 24)))
+
+/* Private macro -------------------------------------------------------------*/
+#define GPIOIRQ_LOCK(MASK)          do { (MASK) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define GPIOIRQ_UNLOCK(MASK)        __set_PRIMASK(MASK)
+
+/* Index of the lowest set bit: de Bruijn sequence table, Cortex-M0 has no CLZ */
+#define GPIOIRQ_CTZ(BIT)            GPIOIRQ_CtzTable[((uint32_t) (BIT) * 0x077CB531UL) >> 27]
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t GPIOIRQ_CtzTable[32] = {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+static GPIOIRQ_PortTypeDef GPIOIRQ_Ports[GPIOIRQ_PORTS];
+static GPIOIRQ_TimestampTypeDef GPIOIRQ_Timestamp;
+static __IO uint32_t GPIOIRQ_Tick;
+
+#if (GPIOIRQ_QUEUE_SIZE > 0)
+static GPIOIRQ_EventTypeDef GPIOIRQ_Events[GPIOIRQ_QUEUE_SIZE];
+static __IO uint32_t GPIOIRQ_Head;
+static __IO uint32_t GPIOIRQ_Tail;
+#endif
+static __IO uint32_t GPIOIRQ_Overflows;
+
+/* Private function prototypes -----------------------------------------------*/
+static void GPIOIRQ_Report(GPIO_TypeDef* GPIOx, GPIOIRQ_PortTypeDef* Port, uint32_t Pin, uint32_t Level, uint32_t Timestamp);
+static void GPIOIRQ_Settle(GPIO_TypeDef* GPIOx, GPIOIRQ_PortTypeDef* Port, uint32_t Pin);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup GPIOIRQ_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Dispatches edges of pins of a GPIO port.
+ * @note   The pins are set as edge triggered, with the polarity of their trigger.
+ *         Both edges are followed by turning the polarity after each edge.
+ *         Enable the PORTx_IRQn interrupt in the NVIC and call
+ *         GPIOIRQ_IRQHandler() from PORTx_Handler.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @param  GPIOIRQ_InitStruct: pointer to a GPIOIRQ_InitTypeDef structure.
+ * @retval None
+ */
+void GPIOIRQ_Init(GPIO_TypeDef* GPIOx, GPIOIRQ_InitTypeDef* GPIOIRQ_InitStruct)
+{
+    GPIOIRQ_PortTypeDef* port;
+    uint32_t pins, bit, pin, level, primask;
+
+    /* Check the parameters */
+    assert_param(IS_GPIO_ALL_PERIPH(GPIOx));
+    assert_param(IS_GPIO_PIN(GPIOIRQ_InitStruct->GPIO_Pin));
+    assert_param(IS_GPIOIRQ_TRIGGER(GPIOIRQ_InitStruct->GPIOIRQ_Trigger));
+    assert_param(IS_FUNCTIONAL_STATE(GPIOIRQ_InitStruct->GPIOIRQ_Queue));
+
+    port = &GPIOIRQ_Ports[GPIOIRQ_PORT(GPIOx)];
+    pins = GPIOIRQ_InitStruct->GPIO_Pin;
+    if (GPIOx == GPIOD) pins &= 0x001F;
+
+    GPIOx->INTENCLR = pins;
+
+    GPIOIRQ_LOCK(primask);
+    port->Settling &= ~pins;
+    GPIOIRQ_UNLOCK(primask);
+
+    for (bit = pins; bit != 0; bit &= bit - 1) {
+        pin = GPIOIRQ_CTZ(bit & (0 - bit));
+        port->Callback[pin] = GPIOIRQ_InitStruct->GPIOIRQ_Callback;
+        port->Debounce[pin] = GPIOIRQ_InitStruct->GPIOIRQ_Debounce;
+    }
+
+    if (GPIOIRQ_InitStruct->GPIOIRQ_Trigger & GPIOIRQ_Trigger_Rising) port->Rising |= pins;
+    else port->Rising &= ~pins;
+    if (GPIOIRQ_InitStruct->GPIOIRQ_Trigger & GPIOIRQ_Trigger_Falling) port->Falling |= pins;
+    else port->Falling &= ~pins;
+    if (GPIOIRQ_InitStruct->GPIOIRQ_Queue != DISABLE) port->Queue |= pins;
+    else port->Queue &= ~pins;
+
+    /* Both edges wait for the edge leaving the current level */
+    level = GPIOx->DATA;
+    port->Level = (port->Level & ~pins) | (level & pins);
+
+    GPIOx->INTTYPESET = pins;
+    if (GPIOIRQ_InitStruct->GPIOIRQ_Trigger == GPIOIRQ_Trigger_Rising) {
+        GPIOx->INTPOLSET = pins;
+    } else if (GPIOIRQ_InitStruct->GPIOIRQ_Trigger == GPIOIRQ_Trigger_Falling) {
+        GPIOx->INTPOLCLR = pins;
+    } else {
+        GPIOx->INTPOLCLR = pins & level;
+        GPIOx->INTPOLSET = pins & ~level;
+    }
+    GPIOx->Interrupt.INTCLEAR = pins;
+    GPIOx->INTENSET = pins;
+}
+
+/**
+ * @brief  Fills each GPIOIRQ_InitStruct member with its default value.
+ * @param  GPIOIRQ_InitStruct: pointer to a GPIOIRQ_InitTypeDef structure which will be initialized.
+ * @retval None
+ */
+void GPIOIRQ_StructInit(GPIOIRQ_InitTypeDef* GPIOIRQ_InitStruct)
+{
+    GPIOIRQ_InitStruct->GPIO_Pin = GPIO_Pin_All;
+    GPIOIRQ_InitStruct->GPIOIRQ_Trigger = GPIOIRQ_Trigger_Rising;
+    GPIOIRQ_InitStruct->GPIOIRQ_Debounce = 0;
+    GPIOIRQ_InitStruct->GPIOIRQ_Queue = DISABLE;
+    GPIOIRQ_InitStruct->GPIOIRQ_Callback = 0;
+}
+
+/**
+ * @brief  Stops dispatching pins of a GPIO port and disables their interrupts.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @param  GPIO_Pin: any value of @ref GPIO_pins_define.
+ * @retval None
+ */
+void GPIOIRQ_DeInit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOIRQ_PortTypeDef* port;
+    uint32_t primask;
+
+    /* Check the parameters */
+    assert_param(IS_GPIO_ALL_PERIPH(GPIOx));
+    assert_param(IS_GPIO_PIN(GPIO_Pin));
+
+    port = &GPIOIRQ_Ports[GPIOIRQ_PORT(GPIOx)];
+
+    GPIOx->INTENCLR = GPIO_Pin;
+    GPIOx->Interrupt.INTCLEAR = GPIO_Pin;
+
+    GPIOIRQ_LOCK(primask);
+    port->Settling &= ~GPIO_Pin;
+    GPIOIRQ_UNLOCK(primask);
+
+    port->Rising &= ~GPIO_Pin;
+    port->Falling &= ~GPIO_Pin;
+    port->Queue &= ~GPIO_Pin;
+}
+
+/**
+ * @brief  Sets the source of the timestamps of the edges.
+ * @param  Timestamp: timestamp function, called from the interrupt handlers.
+ *         NULL counts GPIOIRQ_TimeHandler() ticks, the default.
+ * @retval None
+ */
+void GPIOIRQ_SetTimestamp(GPIOIRQ_TimestampTypeDef Timestamp)
+{
+    GPIOIRQ_Timestamp = Timestamp;
+}
+
+/**
+ * @brief  Handles the interrupt of a GPIO port, call from its PORTx_Handler.
+ * @note   Each pending pin costs a table lookup, not a scan of the port. An
+ *         edge of a debounced pin disables its interrupt until the deadline,
+ *         its level is then read by GPIOIRQ_TimeHandler(). Pins not set by
+ *         GPIOIRQ_Init() are left pending for the caller.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @retval None
+ */
+void GPIOIRQ_IRQHandler(GPIO_TypeDef* GPIOx)
+{
+    GPIOIRQ_PortTypeDef* port;
+    uint32_t pending, bit, pin, level, stamp, primask;
+
+    port = &GPIOIRQ_Ports[GPIOIRQ_PORT(GPIOx)];
+
+    pending = GPIOx->Interrupt.INTSTATUS & GPIOx->INTENSET & (port->Rising | port->Falling);
+    GPIOx->Interrupt.INTCLEAR = pending;
+    stamp = (GPIOIRQ_Timestamp != 0) ? GPIOIRQ_Timestamp() : GPIOIRQ_Tick;
+
+    for (; pending != 0; pending &= pending - 1) {
+        bit = pending & (0 - pending);
+        pin = GPIOIRQ_CTZ(bit);
+
+        if (port->Debounce[pin] != 0) {
+            GPIOx->INTENCLR = bit;
+            port->Deadline[pin] = GPIOIRQ_Tick + port->Debounce[pin];
+            GPIOIRQ_LOCK(primask);
+            port->Settling |= bit;
+            GPIOIRQ_UNLOCK(primask);
+            continue;
+        }
+
+        if ((port->Rising & port->Falling & bit) == 0) {
+            GPIOIRQ_Report(GPIOx, port, pin, port->Rising & bit, stamp);
+            continue;
+        }
+
+        /* Both edges: the polarity tells the edge taken, turn it for the next one.
+           When the pin already went back, turning the polarity latches that edge. */
+        level = GPIOx->INTPOLSET & bit;
+        if (level) GPIOx->INTPOLCLR = bit;
+        else GPIOx->INTPOLSET = bit;
+        GPIOIRQ_Report(GPIOx, port, pin, level, stamp);
+    }
+}
+
+/**
+ * @brief  Tick of the debounce deadlines and of the default timestamps, call
+ *         from a periodic timer interrupt (e.g. every 1ms).
+ * @note   The level of a debounced pin is read at its deadline; it is reported
+ *         when it is the level of an edge of its trigger, and for both edges
+ *         only when it differs from the last reported level.
+ * @retval None
+ */
+void GPIOIRQ_TimeHandler(void)
+{
+    GPIOIRQ_PortTypeDef* port;
+    uint32_t i, settling, bit, pin, tick;
+
+    tick = ++GPIOIRQ_Tick;
+
+    for (i = 0; i < GPIOIRQ_PORTS; i++) {
+        port = &GPIOIRQ_Ports[i];
+        for (settling = port->Settling; settling != 0; settling &= settling - 1) {
+            bit = settling & (0 - settling);
+            pin = GPIOIRQ_CTZ(bit);
+            if ((int32_t) (tick - port->Deadline[pin]) >= 0) {
+                GPIOIRQ_Settle(GPIOIRQ_GPIO(i), port, pin);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Takes the oldest edge of the queue.
+ * @param  Event: pointer to a GPIOIRQ_EventTypeDef filled with the edge.
+ * @retval SUCCESS, or ERROR when the queue is empty.
+ */
+ErrorStatus GPIOIRQ_GetEvent(GPIOIRQ_EventTypeDef* Event)
+{
+#if (GPIOIRQ_QUEUE_SIZE > 0)
+    uint32_t tail = GPIOIRQ_Tail;
+
+    if (tail == GPIOIRQ_Head) return ERROR;
+
+    *Event = GPIOIRQ_Events[tail & (GPIOIRQ_QUEUE_SIZE - 1)];
+    GPIOIRQ_Tail = tail + 1;
+    return SUCCESS;
+#else
+    return ERROR;
+#endif
+}
+
+/**
+ * @brief  Returns the number of edges lost on a full queue.
+ * @retval Number of lost edges.
+ */
+uint32_t GPIOIRQ_GetOverflows(void)
+{
+    return GPIOIRQ_Overflows;
+}
+
+/**
+ * @}
+ */
+
+/* Calls the callback of a pin and records the edge */
+static void GPIOIRQ_Report(GPIO_TypeDef* GPIOx, GPIOIRQ_PortTypeDef* Port, uint32_t Pin, uint32_t Level, uint32_t Timestamp)
+{
+    uint16_t bit = (uint16_t) (1 << Pin);
+    BitAction value = (Level != 0) ? Bit_SET : Bit_RESET;
+#if (GPIOIRQ_QUEUE_SIZE > 0)
+    GPIOIRQ_EventTypeDef* event;
+    uint32_t head, primask;
+#endif
+
+    Port->Level = (value != Bit_RESET) ? (Port->Level | bit) : (Port->Level & ~bit);
+
+#if (GPIOIRQ_QUEUE_SIZE > 0)
+    if (Port->Queue & bit) {
+        /* Port and timer interrupts may preempt each other */
+        GPIOIRQ_LOCK(primask);
+        head = GPIOIRQ_Head;
+        if ((head - GPIOIRQ_Tail) < GPIOIRQ_QUEUE_SIZE) {
+            event = &GPIOIRQ_Events[head & (GPIOIRQ_QUEUE_SIZE - 1)];
+            event->Timestamp = Timestamp;
+            event->GPIOx = GPIOx;
+            event->GPIO_Pin = bit;
+            event->Level = value;
+            GPIOIRQ_Head = head + 1;
+        } else {
+            GPIOIRQ_Overflows++;
+        }
+        GPIOIRQ_UNLOCK(primask);
+    }
+#endif
+
+    if (Port->Callback[Pin] != 0) {
+        Port->Callback[Pin](GPIOx, bit, value, Timestamp);
+    }
+}
+
+/* Ends the debounce of a pin: reads its level, reports it and rearms the pin */
+static void GPIOIRQ_Settle(GPIO_TypeDef* GPIOx, GPIOIRQ_PortTypeDef* Port, uint32_t Pin)
+{
+    uint32_t bit = 1UL << Pin, level, primask;
+    uint32_t stamp = (GPIOIRQ_Timestamp != 0) ? GPIOIRQ_Timestamp() : GPIOIRQ_Tick;
+
+    level = GPIOx->DATA & bit;
+
+    if ((Port->Rising & Port->Falling & bit) != 0) {
+        if (level) GPIOx->INTPOLCLR = bit;
+        else GPIOx->INTPOLSET = bit;
+    }
+
+    /* Settled before the pin is unmasked: an edge taken by the port interrupt
+       from then on masks the pin and starts a new debounce that stays */
+    GPIOIRQ_LOCK(primask);
+    Port->Settling &= ~bit;
+    GPIOIRQ_UNLOCK(primask);
+    GPIOx->Interrupt.INTCLEAR = bit;
+    GPIOx->INTENSET = bit;
+
+    /* Still moving: wait another debounce period, as the port interrupt would */
+    if ((GPIOx->DATA & bit) != level) {
+        GPIOIRQ_LOCK(primask);
+        GPIOx->INTENCLR = bit;
+        GPIOx->Interrupt.INTCLEAR = bit;
+        Port->Deadline[Pin] = GPIOIRQ_Tick + Port->Debounce[Pin];
+        Port->Settling |= bit;
+        GPIOIRQ_UNLOCK(primask);
+        return;
+    }
+
+    if ((level ? Port->Rising : Port->Falling) & bit) {
+        if (((Port->Rising & Port->Falling & bit) == 0) || ((Port->Level ^ level) & bit)) {
+            GPIOIRQ_Report(GPIOx, Port, Pin, level, stamp);
+            return;
+        }
+    }
+    Port->Level = level ? (Port->Level | bit) : (Port->Level & ~bit);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
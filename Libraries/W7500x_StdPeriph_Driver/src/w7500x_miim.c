@@ -46,14 +46,29 @@
 #define PHYREG_CONTROL_POWER        (0x01UL<<12)
 #define PHYREG_CONTROL_DUPLEX       (0x01UL<< 8)
 #define PHYREG_STATUS               0x1
+#define PHYREG_STATUS_PREAMBLE      (0x01UL<< 6)
 #define PHYREG_STATUS_AUTONEGO      (0x01UL<< 5)
 #define PHYREG_STATUS_LINK          (0x01UL<< 2)
 
+#define MIIM_PREAMBLE_BITS          32
+#define MIIM_SHORT_PREAMBLE_BITS    1   /* Idle '1' before ST when the PHY suppresses the preamble */
+#define MIIM_DELAY_LOOP_CYCLES      4   /* Core cycles spent by one miim_delay() iteration */
+
 /* Private macro -------------------------------------------------------------*/
+#define MDC_HIGH()                  (*miim_MDC_REG = 0xFFFF)
+#define MDC_LOW()                   (*miim_MDC_REG = 0x0000)
+#define MDIO_HIGH()                 (*miim_MDIO_REG = 0xFFFF)
+#define MDIO_LOW()                  (*miim_MDIO_REG = 0x0000)
+#define MDIO_READ()                 ((miim_PORT->DATA & miim_MDIO) ? 1 : 0)
+
 /* Private variables ---------------------------------------------------------*/
 static uint16_t miim_MDIO;
 static uint16_t miim_MDC;
 static GPIO_TypeDef* miim_PORT;
+static __IO uint32_t* miim_MDIO_REG;
+static __IO uint32_t* miim_MDC_REG;
+static uint32_t miim_half_period = 10;
+static uint32_t miim_short_preamble = MIIM_PREAMBLE_BITS;
 static uint32_t PHY_ADDR = 0;
 
 /* Private function prototypes -----------------------------------------------*/
@@ -61,9 +76,11 @@ static void MDIO_Idle(void);
 static uint32_t MDIO_In(void);
 static void MDIO_Out(uint32_t val, uint32_t n);
 static void MDIO_Turnaround(void);
-static void MDIO_SetData(uint32_t regAddr, uint32_t val);
-static uint32_t MDIO_GetData(uint32_t phyAddr, uint32_t regAddr);
+static void MDIO_SetData(uint32_t regAddr, uint32_t val, uint32_t preamble);
+static uint32_t MDIO_GetData(uint32_t phyAddr, uint32_t regAddr, uint32_t preamble);
 static FlagStatus PHY_GetId(void);
+static __IO uint32_t* miim_masked_reg(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+static void miim_calibrate(void);
 static void miim_delay(__O uint32_t count);
 
 /* Private functions ---------------------------------------------------------*/
@@ -88,6 +105,9 @@ FlagStatus PHY_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin_MDC, uint16_t GPIO_Pi
     miim_PORT = GPIOx;
     miim_MDC = GPIO_Pin_MDC;
     miim_MDIO = GPIO_Pin_MDIO;
+    miim_MDC_REG = miim_masked_reg(GPIOx, GPIO_Pin_MDC);
+    miim_MDIO_REG = miim_masked_reg(GPIOx, GPIO_Pin_MDIO);
+    miim_calibrate();
 
 #ifdef W7500
     GPIO_InitStructure.GPIO_Pin = GPIO_Pin_4 | GPIO_Pin_10 | GPIO_Pin_11 | GPIO_Pin_12 | GPIO_Pin_13;
@@ -121,6 +141,13 @@ FlagStatus PHY_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin_MDC, uint16_t GPIO_Pi
     PHY_Reset(0); // phy reset
     bitstatus = PHY_GetId();
 
+    /* PHYs that accept management frames without preamble speed up batched accesses.
+     * One '1' is still sent so that ST always follows an idle bit. */
+    miim_short_preamble = MIIM_PREAMBLE_BITS;
+    if ((bitstatus == SET) && (MDIO_GetData(PHY_ADDR, PHYREG_STATUS, MIIM_PREAMBLE_BITS) & PHYREG_STATUS_PREAMBLE)) {
+        miim_short_preamble = MIIM_SHORT_PREAMBLE_BITS;
+    }
+
     return bitstatus;
 }
 
@@ -149,7 +176,7 @@ if (reset == Hardware) {
 #endif
     } else {
 */
-    MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_RESET);      // PHY Reset
+    MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_RESET, MIIM_PREAMBLE_BITS);      // PHY Reset
 //    }
 }
 
@@ -162,7 +189,7 @@ FlagStatus PHY_GetLinkStatus(void)
 {
     FlagStatus bitstatus = RESET;
 
-    if ((MDIO_GetData(PHY_ADDR, PHYREG_STATUS) & PHYREG_STATUS_LINK) != (FlagStatus) RESET) {
+    if ((MDIO_GetData(PHY_ADDR, PHYREG_STATUS, MIIM_PREAMBLE_BITS) & PHYREG_STATUS_LINK) != (FlagStatus) RESET) {
         bitstatus = SET;
     } else {
         bitstatus = RESET;
@@ -187,38 +214,137 @@ void PHY_SetLinkType(Link_Type link)
     assert_param(IS_LINK_TYPE(link));
 
     if (link == HalfDuplex10) {
-        MDIO_SetData(PHYREG_CONTROL, 0x0000);
+        MDIO_SetData(PHYREG_CONTROL, 0x0000, MIIM_PREAMBLE_BITS);
     } else if (link == FullDuplex10) {
-        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_DUPLEX);
+        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_DUPLEX, MIIM_PREAMBLE_BITS);
     } else if (link == AutoNego) {
-        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_AUTONEGO);
+        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_AUTONEGO, MIIM_PREAMBLE_BITS);
     } else if (link == HalfDuplex100) {
-        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_SPEED);
+        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_SPEED, MIIM_PREAMBLE_BITS);
     } else {
-        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_SPEED | PHYREG_CONTROL_DUPLEX);
+        MDIO_SetData(PHYREG_CONTROL, PHYREG_CONTROL_SPEED | PHYREG_CONTROL_DUPLEX, MIIM_PREAMBLE_BITS);
+    }
+}
+
+/**
+ * @brief  Reads a PHY register
+ * @param  regAddr: PHY register address (0..31).
+ * @retval The register value.
+ */
+uint16_t PHY_ReadRegister(uint8_t regAddr)
+{
+    /* Check the parameters */
+    assert_param(IS_PHY_REG(regAddr));
+
+    return (uint16_t) MDIO_GetData(PHY_ADDR, regAddr, MIIM_PREAMBLE_BITS);
+}
+
+/**
+ * @brief  Writes a PHY register
+ * @param  regAddr: PHY register address (0..31).
+ * @param  val: Value to be written.
+ * @retval None.
+ */
+void PHY_WriteRegister(uint8_t regAddr, uint16_t val)
+{
+    /* Check the parameters */
+    assert_param(IS_PHY_REG(regAddr));
+
+    MDIO_SetData(regAddr, val, MIIM_PREAMBLE_BITS);
+}
+
+/**
+ * @brief  Reads several PHY registers in a single burst
+ * @note   Only the first frame carries the full preamble when the PHY
+ *         supports management frame preamble suppression.
+ * @param  regAddr: Array of PHY register addresses (0..31).
+ * @param  val: Array receiving the register values.
+ * @param  count: Number of registers to read.
+ * @retval None.
+ */
+void PHY_ReadRegisters(const uint8_t* regAddr, uint16_t* val, uint32_t count)
+{
+    uint32_t i;
+    uint32_t preamble = MIIM_PREAMBLE_BITS;
+
+    for (i = 0; i < count; i++) {
+        /* Check the parameters */
+        assert_param(IS_PHY_REG(regAddr[i]));
+
+        val[i] = (uint16_t) MDIO_GetData(PHY_ADDR, regAddr[i], preamble);
+        preamble = miim_short_preamble;
+    }
+}
+
+/**
+ * @brief  Writes several PHY registers in a single burst
+ * @note   Only the first frame carries the full preamble when the PHY
+ *         supports management frame preamble suppression.
+ * @param  regAddr: Array of PHY register addresses (0..31).
+ * @param  val: Array of values to be written.
+ * @param  count: Number of registers to write.
+ * @retval None.
+ */
+void PHY_WriteRegisters(const uint8_t* regAddr, const uint16_t* val, uint32_t count)
+{
+    uint32_t i;
+    uint32_t preamble = MIIM_PREAMBLE_BITS;
+
+    for (i = 0; i < count; i++) {
+        /* Check the parameters */
+        assert_param(IS_PHY_REG(regAddr[i]));
+
+        MDIO_SetData(regAddr[i], val[i], preamble);
+        preamble = miim_short_preamble;
+    }
+}
+
+/**
+ * @brief  Reads a set of PHY registers in a single burst
+ * @note   Vendor registers (16..31) are often cleared on read, e.g. error
+ *         counters and interrupt status: only select the ones the caller owns.
+ * @param  regs: Array of PHY_REG_COUNT entries receiving registers 0..31.
+ * @param  mask: Bit n set reads register n, e.g. PHY_REGS_STANDARD. The
+ *         entries of the other registers are set to 0.
+ * @retval None.
+ */
+void PHY_GetSnapshot(uint16_t* regs, uint32_t mask)
+{
+    uint32_t i;
+    uint32_t preamble = MIIM_PREAMBLE_BITS;
+
+    for (i = 0; i < PHY_REG_COUNT; i++) {
+        if (mask & (1UL << i)) {
+            regs[i] = (uint16_t) MDIO_GetData(PHY_ADDR, i, preamble);
+            preamble = miim_short_preamble;
+        } else {
+            regs[i] = 0;
+        }
     }
 }
 
 static void MDIO_Idle(void)
 {
+    /* Idle level before driving, DATAOUT may still hold the last data bit */
+    MDIO_HIGH();
     miim_PORT->OUTENSET = miim_MDIO;
 
-    GPIO_SetBits(miim_PORT, miim_MDC);
-    miim_delay(10);
-    GPIO_ResetBits(miim_PORT, miim_MDC);
-    miim_delay(10);
+    MDC_HIGH();
+    miim_delay(miim_half_period);
+    MDC_LOW();
+    miim_delay(miim_half_period);
 }
 
 static void MDIO_Out(uint32_t val, uint32_t n)
 {
     for (val <<= (32 - n); n; val <<= 1, n--) {
-        if (val & 0x80000000) GPIO_SetBits(miim_PORT, miim_MDIO);
-        else GPIO_ResetBits(miim_PORT, miim_MDIO);
+        if (val & 0x80000000) MDIO_HIGH();
+        else MDIO_LOW();
 
-        miim_delay(10);
-        GPIO_SetBits(miim_PORT, miim_MDC);
-        miim_delay(10);
-        GPIO_ResetBits(miim_PORT, miim_MDC);
+        miim_delay(miim_half_period);
+        MDC_HIGH();
+        miim_delay(miim_half_period);
+        MDC_LOW();
     }
 }
 
@@ -228,11 +354,11 @@ static uint32_t MDIO_In(void)
 
     for (i = 0; i < 16; i++) {
         val <<= 1;
-        GPIO_SetBits(miim_PORT, miim_MDC);
-        miim_delay(10);
-        GPIO_ResetBits(miim_PORT, miim_MDC);
-        miim_delay(10);
-        val |= GPIO_ReadInputDataBit(miim_PORT, miim_MDIO);
+        MDC_HIGH();
+        miim_delay(miim_half_period);
+        MDC_LOW();
+        miim_delay(miim_half_period);
+        val |= MDIO_READ();
     }
     return (val);
 }
@@ -241,26 +367,22 @@ static void MDIO_Turnaround(void)
 {
     miim_PORT->OUTENCLR = miim_MDIO;
 
-    miim_delay(10);
-    GPIO_SetBits(miim_PORT, miim_MDC);
-    miim_delay(10);
-    GPIO_ResetBits(miim_PORT, miim_MDC);
-    miim_delay(10);
+    miim_delay(miim_half_period);
+    MDC_HIGH();
+    miim_delay(miim_half_period);
+    MDC_LOW();
+    miim_delay(miim_half_period);
 }
 
-static uint32_t MDIO_GetData(uint32_t phyAddr, uint32_t regAddr)
+static uint32_t MDIO_GetData(uint32_t phyAddr, uint32_t regAddr, uint32_t preamble)
 {
     uint32_t val = 0;
 
-    /* 32 Consecutive ones on MDO to establish sync */
-    MDIO_Out(0xFFFFFFFF, 32);
-
-    /* start code 01, read command (10) */
-    MDIO_Out(0x06, 4);
+    /* Consecutive ones on MDO to establish sync */
+    if (preamble) MDIO_Out(0xFFFFFFFF, preamble);
 
-    /* write PHY address */
-    MDIO_Out(phyAddr, 5);
-    MDIO_Out(regAddr, 5);
+    /* start code 01, read command (10), PHY address, register address */
+    MDIO_Out((0x06 << 10) | ((phyAddr & 0x1F) << 5) | (regAddr & 0x1F), 14);
 
     /* turnaround MDO is tristated */
     MDIO_Turnaround();
@@ -274,21 +396,13 @@ static uint32_t MDIO_GetData(uint32_t phyAddr, uint32_t regAddr)
     return val;
 }
 
-static void MDIO_SetData(uint32_t regAddr, uint32_t val)
+static void MDIO_SetData(uint32_t regAddr, uint32_t val, uint32_t preamble)
 {
-    /* 32 Consecutive ones on MDO to establish sync */
-    MDIO_Out(0xFFFFFFFF, 32);
-
-    /* start code 01, write command (01) */
-    MDIO_Out(0x05, 4);
-
-    /* write PHY address */
-    MDIO_Out(PHY_ADDR, 5);
-
-    MDIO_Out(regAddr, 5);
+    /* Consecutive ones on MDO to establish sync */
+    if (preamble) MDIO_Out(0xFFFFFFFF, preamble);
 
-    /* turnaround MDO */
-    MDIO_Out(0x02, 2);
+    /* start code 01, write command (01), PHY address, register address, turnaround (10) */
+    MDIO_Out((0x05 << 12) | ((PHY_ADDR & 0x1F) << 7) | ((regAddr & 0x1F) << 2) | 0x02, 16);
 
     /* Write the data value */
     MDIO_Out(val, 16);
@@ -304,7 +418,7 @@ static FlagStatus PHY_GetId(void)
     uint32_t data;
 
     for (i = 0; i < 8; i++) {
-        data = MDIO_GetData(i, PHYREG_STATUS);
+        data = MDIO_GetData(i, PHYREG_STATUS, MIIM_PREAMBLE_BITS);
 
         if ((data != 0x0) && (data != 0xFFFF)) {
             PHY_ADDR = i;
@@ -316,6 +430,23 @@ static FlagStatus PHY_GetId(void)
     return bitstatus;
 }
 
+static __IO uint32_t* miim_masked_reg(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin < 256)
+        return &(GPIOx->LB_MASKED[(uint8_t) (GPIO_Pin)]);
+    else
+        return &(GPIOx->UB_MASKED[(uint8_t) ((GPIO_Pin) >> 8)]);
+}
+
+static void miim_calibrate(void)
+{
+    uint32_t cycles;
+
+    /* Half MDC period in miim_delay() iterations, rounded up so MDC never exceeds MIIM_MDC_FREQ */
+    cycles = MIIM_DELAY_LOOP_CYCLES * 2 * MIIM_MDC_FREQ;
+    miim_half_period = (GetSystemClock() + cycles - 1) / cycles;
+}
+
 static void miim_delay(__O uint32_t count)
 {
     uint32_t i;
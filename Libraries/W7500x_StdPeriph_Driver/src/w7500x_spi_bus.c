@@ -0,0 +1,490 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_spi_bus.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to share an SSP between
+ *          several SPI devices:
+ *           + Per-device clock, mode, frame size and GPIO chip select
+ *           + Transfer queue run back to back from the SSP interrupt
+ *           + Transmit FIFO kept full during a transfer
+ *           + Completion callback
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_spi_bus.h"
+#include "system_w7500x.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup SPIBUS
+ * @brief SPI bus transaction driver modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    SPIBUS_TransferTypeDef* Head;       /* Transfer on the bus       */
+    SPIBUS_TransferTypeDef* Tail;
+    SPIBUS_DeviceTypeDef* Selected;     /* Chip select asserted      */
+    uint32_t CR0;
+    uint32_t CPSR;
+    uint32_t TxCount;
+    uint32_t RxCount;
+    uint8_t Wide;                       /* Frames over 8 bits        */
+    __IO uint8_t Active;
+} SPIBUS_HandleTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define SPIBUS_NUM                  2
+#define SPIBUS_RCLK                 8000000UL   /* Internal RC oscillator */
+
+/* Private macro -------------------------------------------------------------*/
+#define SPIBUS_HANDLE(SSPx)         (&SPIBUS_Handle[((SSPx) == SSP0) ? 0 : 1])
+
+#define SPIBUS_LOCK(MASK)           do { (MASK) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define SPIBUS_UNLOCK(MASK)         __set_PRIMASK(MASK)
+
+/* Private variables ---------------------------------------------------------*/
+static SPIBUS_HandleTypeDef SPIBUS_Handle[SPIBUS_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+static void SPIBUS_Run(SSP_TypeDef* SSPx, SPIBUS_HandleTypeDef* handle);
+static void SPIBUS_Start(SSP_TypeDef* SSPx, SPIBUS_HandleTypeDef* handle, SPIBUS_TransferTypeDef* Transfer);
+static void SPIBUS_Pump(SSP_TypeDef* SSPx, SPIBUS_HandleTypeDef* handle, SPIBUS_TransferTypeDef* Transfer);
+static void SPIBUS_Finish(SPIBUS_HandleTypeDef* handle, SPIBUS_TransferTypeDef* Transfer);
+static uint32_t SPIBUS_GetSourceClock(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup SPIBUS_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Sets up an SSP as the master of an SPI bus.
+ * @note   The SCK, MOSI and MISO pins must be configured first. Enable the
+ *         SSPx interrupt in the NVIC and call SPIBUS_IRQHandler() from
+ *         SSPx_Handler.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ * @retval None
+ */
+void SPIBUS_Init(SSP_TypeDef* SSPx)
+{
+    SPIBUS_HandleTypeDef* handle = SPIBUS_HANDLE(SSPx);
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    SSPx->IMSC = 0;
+    SSPx->CR1 = SSP_CR1_SSE;
+
+    /* Frames left by a stopped bus are sent with no chip select, and dropped */
+    while (SSPx->SR & SSP_SR_BSY) {
+    }
+    while (SSPx->SR & SSP_SR_RNE) {
+        (void) SSPx->DR;
+    }
+    SSPx->ICR = SSP_IT_RT | SSP_IT_ROR;
+
+    handle->Head = 0;
+    handle->Tail = 0;
+    handle->Selected = 0;
+    handle->CR0 = SSPx->CR0;
+    handle->CPSR = SSPx->CPSR;
+    handle->Active = 0;
+}
+
+/**
+ * @brief  Stops an SPI bus, queued transfers are abandoned.
+ * @note   The running and queued transfers end with SPIBUS_Status_Aborted,
+ *         their callbacks are called from here, in submission order. The
+ *         frames left in the FIFOs are dropped by SPIBUS_Init().
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ * @retval None
+ */
+void SPIBUS_DeInit(SSP_TypeDef* SSPx)
+{
+    SPIBUS_HandleTypeDef* handle = SPIBUS_HANDLE(SSPx);
+    SPIBUS_TransferTypeDef* transfer;
+    SPIBUS_TransferTypeDef* next;
+    uint32_t primask;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    SPIBUS_LOCK(primask);
+    SSPx->IMSC = 0;
+    SSPx->CR1 = 0;
+    if (handle->Selected != 0) {
+        GPIO_SetBits(handle->Selected->CS_GPIOx, handle->Selected->CS_Pin);
+        handle->Selected = 0;
+    }
+    transfer = handle->Head;
+    handle->Head = 0;
+    handle->Tail = 0;
+    handle->Active = 0;
+    SPIBUS_UNLOCK(primask);
+
+    /* The callback may reuse its transfer, the link is read first */
+    while (transfer != 0) {
+        next = transfer->Next;
+        transfer->Status = SPIBUS_Status_Aborted;
+        if (transfer->Callback != 0) {
+            transfer->Callback(transfer);
+        }
+        transfer = next;
+    }
+}
+
+/**
+ * @brief  Fills a device descriptor for an SPI bus.
+ * @note   The SCK frequency is the fastest division of SSPCLK not above
+ *         SPIBUS_ClockSpeed. SSPCLK (CRG_SSPCLK_SourceSelect() and
+ *         CRG_SSPCLK_SetPrescale()) is shared by both SSPs, so each device
+ *         only divides it further. OCLK is usable as its source only when
+ *         OCLK_VALUE is defined. The chip select pin is configured as a GPIO
+ *         output and driven high.
+ * @param  Device: descriptor to fill, it must stay valid while in use.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ * @param  SPIBUS_DeviceInitStruct: pointer to a SPIBUS_DeviceInitTypeDef structure.
+ * @retval SUCCESS, or ERROR if SSPCLK is off or of unknown frequency, or if
+ *         the clock speed cannot be reached.
+ */
+ErrorStatus SPIBUS_DeviceInit(SPIBUS_DeviceTypeDef* Device, SSP_TypeDef* SSPx, SPIBUS_DeviceInitTypeDef* SPIBUS_DeviceInitStruct)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    uint32_t sspclk, divisor, cpsr, scr = 0;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+    assert_param(IS_SSP_CPOL(SPIBUS_DeviceInitStruct->SPIBUS_CPOL));
+    assert_param(IS_SSP_CPHA(SPIBUS_DeviceInitStruct->SPIBUS_CPHA));
+    assert_param(IS_SSP_DATASIZE(SPIBUS_DeviceInitStruct->SPIBUS_DataSize));
+    assert_param(IS_GPIO_ALL_PERIPH(SPIBUS_DeviceInitStruct->SPIBUS_CS_GPIOx));
+
+    sspclk = SPIBUS_GetSourceClock();
+    if ((SPIBUS_DeviceInitStruct->SPIBUS_ClockSpeed == 0) || (sspclk == 0)) {
+        return ERROR;
+    }
+
+    /* SCK = SSPCLK / (CPSDVSR * (1 + SCR)), CPSDVSR even from 2 to 254 */
+    sspclk /= (1 << CRG->SSPCLK_PVSR);
+    divisor = (sspclk + SPIBUS_DeviceInitStruct->SPIBUS_ClockSpeed - 1) / SPIBUS_DeviceInitStruct->SPIBUS_ClockSpeed;
+    for (cpsr = 2; cpsr <= 254; cpsr += 2) {
+        scr = (divisor + cpsr - 1) / cpsr;
+        if (scr <= 256) {
+            break;
+        }
+    }
+    if (cpsr > 254) {
+        return ERROR;
+    }
+    if (scr == 0) {
+        scr = 1;
+    }
+
+    Device->SSPx = SSPx;
+    Device->CPSR = cpsr;
+    Device->CR0 = ((scr - 1) << 8) | SPIBUS_DeviceInitStruct->SPIBUS_DataSize;
+    if (SPIBUS_DeviceInitStruct->SPIBUS_CPOL == SSP_CPOL_High) {
+        Device->CR0 |= SSP_CR0_SPO;
+    }
+    if (SPIBUS_DeviceInitStruct->SPIBUS_CPHA == SSP_CPHA_2Edge) {
+        Device->CR0 |= SSP_CR0_SPH;
+    }
+    Device->CS_GPIOx = SPIBUS_DeviceInitStruct->SPIBUS_CS_GPIOx;
+    Device->CS_Pin = SPIBUS_DeviceInitStruct->SPIBUS_CS_Pin;
+
+    GPIO_SetBits(Device->CS_GPIOx, Device->CS_Pin);
+    GPIO_InitStructure.GPIO_Pin = Device->CS_Pin;
+    GPIO_InitStructure.GPIO_Direction = GPIO_Direction_OUT;
+    GPIO_InitStructure.GPIO_Pad = GPIO_Pad_Default;
+    GPIO_InitStructure.GPIO_AF = PAD_AF1;
+    GPIO_Init(Device->CS_GPIOx, &GPIO_InitStructure);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Fills each SPIBUS_DeviceInitStruct member with its default value.
+ * @param  SPIBUS_DeviceInitStruct: pointer to a SPIBUS_DeviceInitTypeDef structure.
+ * @retval None
+ */
+void SPIBUS_DeviceStructInit(SPIBUS_DeviceInitTypeDef* SPIBUS_DeviceInitStruct)
+{
+    SPIBUS_DeviceInitStruct->SPIBUS_ClockSpeed = 1000000;
+    SPIBUS_DeviceInitStruct->SPIBUS_CPOL = SSP_CPOL_Low;
+    SPIBUS_DeviceInitStruct->SPIBUS_CPHA = SSP_CPHA_1Edge;
+    SPIBUS_DeviceInitStruct->SPIBUS_DataSize = SSP_DataSize_8b;
+    SPIBUS_DeviceInitStruct->SPIBUS_CS_GPIOx = GPIOA;
+    SPIBUS_DeviceInitStruct->SPIBUS_CS_Pin = GPIO_Pin_5;
+}
+
+/**
+ * @brief  Queues a transfer on the bus of its device.
+ * @note   Transfers run in submission order without waiting for the caller.
+ *         A transfer with SPIBUS_Flag_KeepCS leaves the chip select asserted,
+ *         the next transfer should be for the same device.
+ * @param  Transfer: transfer descriptor, Device, TxBuffer, RxBuffer, Length,
+ *         Flags, Callback and Context must be set.
+ * @retval None
+ */
+void SPIBUS_Submit(SPIBUS_TransferTypeDef* Transfer)
+{
+    SSP_TypeDef* SSPx = Transfer->Device->SSPx;
+    SPIBUS_HandleTypeDef* handle = SPIBUS_HANDLE(SSPx);
+    uint32_t primask;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    Transfer->Status = SPIBUS_Status_Queued;
+    Transfer->Next = 0;
+
+    SPIBUS_LOCK(primask);
+    if (handle->Tail != 0) {
+        handle->Tail->Next = Transfer;
+    } else {
+        handle->Head = Transfer;
+    }
+    handle->Tail = Transfer;
+
+    if (handle->Active == 0) {
+        handle->Active = 1;
+        SPIBUS_Run(SSPx, handle);
+    }
+    SPIBUS_UNLOCK(primask);
+}
+
+/**
+ * @brief  Waits for the end of a submitted transfer.
+ * @param  Transfer: transfer descriptor.
+ * @retval SUCCESS, or ERROR if the transfer was abandoned by SPIBUS_DeInit().
+ */
+ErrorStatus SPIBUS_Wait(SPIBUS_TransferTypeDef* Transfer)
+{
+    while ((Transfer->Status == SPIBUS_Status_Queued) || (Transfer->Status == SPIBUS_Status_Busy)) {
+    }
+
+    return (Transfer->Status == SPIBUS_Status_Done) ? SUCCESS : ERROR;
+}
+
+/**
+ * @brief  Runs one transfer and waits for its end.
+ * @param  Device: device descriptor.
+ * @param  TxBuffer: frames to send, NULL to send SPIBUS_FILL.
+ * @param  RxBuffer: received frames, NULL to drop them.
+ * @param  Length: number of frames.
+ * @param  Flags: a combination of @ref SPIBUS_Flags.
+ * @retval SUCCESS, or ERROR if the transfer was abandoned by SPIBUS_DeInit().
+ */
+ErrorStatus SPIBUS_Transfer(SPIBUS_DeviceTypeDef* Device, const void* TxBuffer, void* RxBuffer, uint32_t Length, uint32_t Flags)
+{
+    SPIBUS_TransferTypeDef transfer;
+
+    transfer.Device = Device;
+    transfer.TxBuffer = TxBuffer;
+    transfer.RxBuffer = RxBuffer;
+    transfer.Length = Length;
+    transfer.Flags = Flags;
+    transfer.Callback = 0;
+    transfer.Context = 0;
+
+    SPIBUS_Submit(&transfer);
+    return SPIBUS_Wait(&transfer);
+}
+
+/**
+ * @brief  Checks whether transfers are running on a bus.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ * @retval SET while the queue is not empty, RESET otherwise.
+ */
+FlagStatus SPIBUS_GetStatus(SSP_TypeDef* SSPx)
+{
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    return (SPIBUS_HANDLE(SSPx)->Active != 0) ? SET : RESET;
+}
+
+/**
+ * @brief  Moves frames between the FIFOs and the transfer buffers, and
+ *         starts the next transfer when one completes.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ * @retval None
+ */
+void SPIBUS_IRQHandler(SSP_TypeDef* SSPx)
+{
+    SPIBUS_HandleTypeDef* handle = SPIBUS_HANDLE(SSPx);
+
+    SSPx->ICR = SSP_IT_RT | SSP_IT_ROR;
+
+    if (handle->Active == 0) {
+        SSPx->IMSC = 0;
+        return;
+    }
+
+    SPIBUS_Run(SSPx, handle);
+}
+
+/* Runs the queue until a transfer has to wait for the bus, called with interrupts disabled */
+static void SPIBUS_Run(SSP_TypeDef* SSPx, SPIBUS_HandleTypeDef* handle)
+{
+    SPIBUS_TransferTypeDef* transfer;
+
+    while ((transfer = handle->Head) != 0) {
+        if (transfer->Status == SPIBUS_Status_Queued) {
+            SPIBUS_Start(SSPx, handle, transfer);
+        }
+
+        SPIBUS_Pump(SSPx, handle, transfer);
+        if (handle->RxCount < transfer->Length) {
+            /* Half full receive FIFO, and timeout for the last frames */
+            SSPx->IMSC = SSP_IT_RX | SSP_IT_RT;
+            return;
+        }
+
+        SPIBUS_Finish(handle, transfer);
+    }
+
+    SSPx->IMSC = 0;
+    handle->Active = 0;
+}
+
+static void SPIBUS_Start(SSP_TypeDef* SSPx, SPIBUS_HandleTypeDef* handle, SPIBUS_TransferTypeDef* Transfer)
+{
+    SPIBUS_DeviceTypeDef* device = Transfer->Device;
+
+    Transfer->Status = SPIBUS_Status_Busy;
+    handle->TxCount = 0;
+    handle->RxCount = 0;
+
+    if (handle->Selected != device) {
+        if (handle->Selected != 0) {
+            GPIO_SetBits(handle->Selected->CS_GPIOx, handle->Selected->CS_Pin);
+        }
+
+        /* The clock and frame format are changed with the SSP disabled */
+        if ((handle->CR0 != device->CR0) || (handle->CPSR != device->CPSR)) {
+            SSPx->CR1 &= ~SSP_CR1_SSE;
+            SSPx->CR0 = device->CR0;
+            SSPx->CPSR = device->CPSR;
+            SSPx->CR1 |= SSP_CR1_SSE;
+            handle->CR0 = device->CR0;
+            handle->CPSR = device->CPSR;
+        }
+        handle->Wide = ((device->CR0 & SSP_CR0_DSS) > SSP_DataSize_8b);
+
+        GPIO_ResetBits(device->CS_GPIOx, device->CS_Pin);
+        handle->Selected = device;
+    }
+}
+
+/* Drains the receive FIFO, then refills the transmit FIFO with at most a FIFO depth in flight */
+static void SPIBUS_Pump(SSP_TypeDef* SSPx, SPIBUS_HandleTypeDef* handle, SPIBUS_TransferTypeDef* Transfer)
+{
+    uint32_t length = Transfer->Length;
+    uint32_t tx = handle->TxCount;
+    uint32_t rx = handle->RxCount;
+    uint16_t data;
+
+    while ((rx < length) && (SSPx->SR & SSP_SR_RNE)) {
+        data = (uint16_t) SSPx->DR;
+        if (Transfer->RxBuffer != 0) {
+            if (handle->Wide) {
+                ((uint16_t*) Transfer->RxBuffer)[rx] = data;
+            } else {
+                ((uint8_t*) Transfer->RxBuffer)[rx] = (uint8_t) data;
+            }
+        }
+        rx++;
+    }
+
+    while ((tx < length) && ((tx - rx) < SSP_FIFO_DEPTH) && (SSPx->SR & SSP_SR_TNF)) {
+        if (Transfer->TxBuffer == 0) {
+            data = SPIBUS_FILL;
+        } else if (handle->Wide) {
+            data = ((const uint16_t*) Transfer->TxBuffer)[tx];
+        } else {
+            data = ((const uint8_t*) Transfer->TxBuffer)[tx];
+        }
+        SSPx->DR = data;
+        tx++;
+    }
+
+    handle->TxCount = tx;
+    handle->RxCount = rx;
+}
+
+static void SPIBUS_Finish(SPIBUS_HandleTypeDef* handle, SPIBUS_TransferTypeDef* Transfer)
+{
+    if ((Transfer->Flags & SPIBUS_Flag_KeepCS) == 0) {
+        GPIO_SetBits(handle->Selected->CS_GPIOx, handle->Selected->CS_Pin);
+        handle->Selected = 0;
+    }
+
+    handle->Head = Transfer->Next;
+    if (handle->Head == 0) {
+        handle->Tail = 0;
+    }
+
+    /* The callback may submit the next transfer, it is appended to the queue */
+    Transfer->Status = SPIBUS_Status_Done;
+    if (Transfer->Callback != 0) {
+        Transfer->Callback(Transfer);
+    }
+}
+
+/* Frequency of SSPCLK before its prescaler, 0 when it is off or unknown */
+static uint32_t SPIBUS_GetSourceClock(void)
+{
+    uint32_t source = CRG->SSPCLK_SSR & CRG_SSPCLK_SSR_SSPCSS;
+
+    if (source == CRG_SSPCLK_SSR_SSPCSS_0) {
+        return GetSystemClock();        /* MCLK */
+    } else if (source == CRG_SSPCLK_SSR_SSPCSS_1) {
+        return SPIBUS_RCLK;
+    }
+#ifdef OCLK_VALUE
+    if (source == CRG_SSPCLK_SSR_SSPCSS) {
+        return OCLK_VALUE;
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -0,0 +1,576 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_spi_nor.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to manage a serial NOR
+ *          flash on an SPI bus device:
+ *           + JEDEC ID probe
+ *           + Fast read through a page cache in RAM
+ *           + Page program, sector, block and chip erase
+ *           + Busy polling from a timer interrupt or by the caller
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_spi_nor.h"
+#include <string.h>
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup SPINOR
+ * @brief SPI NOR flash driver modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define SPINOR_CMD_WREN             0x06
+#define SPINOR_CMD_RDSR             0x05
+#define SPINOR_CMD_READ_FAST        0x0B
+#define SPINOR_CMD_PP               0x02
+#define SPINOR_CMD_SE               0x20
+#define SPINOR_CMD_BE32K            0x52
+#define SPINOR_CMD_BE               0xD8
+#define SPINOR_CMD_CE               0xC7
+#define SPINOR_CMD_RDID             0x9F
+#define SPINOR_CMD_RES              0xAB
+
+#define SPINOR_SR_WIP               0x01
+
+/* tRES1 of 3us from deep power down, at 48MHz and 4 cycles per loop */
+#define SPINOR_RESUME_DELAY         200
+
+/* Private macro -------------------------------------------------------------*/
+#define SPINOR_LOCK(MASK)           do { (MASK) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define SPINOR_UNLOCK(MASK)         __set_PRIMASK(MASK)
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void SPINOR_Command(SPINOR_HandleTypeDef* Handle, const uint8_t* Cmd, uint32_t CmdLength, const uint8_t* TxBuffer, uint8_t* RxBuffer, uint32_t Length);
+static void SPINOR_AddressCommand(SPINOR_HandleTypeDef* Handle, uint8_t Cmd, uint32_t Address, const uint8_t* TxBuffer, uint8_t* RxBuffer, uint32_t Length);
+static void SPINOR_WriteEnable(SPINOR_HandleTypeDef* Handle);
+static void SPINOR_ReadID(SPINOR_HandleTypeDef* Handle, uint8_t* ID);
+static void SPINOR_Ready(SPINOR_HandleTypeDef* Handle);
+static void SPINOR_PollCallback(SPIBUS_TransferTypeDef* Transfer);
+#if (SPINOR_CACHE_PAGES > 0)
+static SPINOR_CacheTypeDef* SPINOR_CacheLoad(SPINOR_HandleTypeDef* Handle, uint32_t Page);
+#endif
+static void SPINOR_CacheProgram(SPINOR_HandleTypeDef* Handle, uint32_t Address, const uint8_t* Buffer, uint32_t Length);
+static void SPINOR_CacheErase(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint32_t Length);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup SPINOR_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Wakes up and identifies a SPI NOR flash.
+ * @note   The device must be initialized by SPIBUS_DeviceInit() with
+ *         SSP_CPOL_Low and SSP_CPHA_1Edge, or SSP_CPOL_High and
+ *         SSP_CPHA_2Edge, and SSP_DataSize_8b. Flashes up to 16MB are
+ *         supported, with 3 byte addresses.
+ * @param  Handle: flash handle to fill.
+ * @param  Device: SPI device of the flash.
+ * @retval SUCCESS, or ERROR when no flash answers the JEDEC ID read, also
+ *         after SPINOR_INIT_POLLS status reads when the flash stays busy.
+ */
+ErrorStatus SPINOR_Init(SPINOR_HandleTypeDef* Handle, SPIBUS_DeviceTypeDef* Device)
+{
+    uint8_t cmd = SPINOR_CMD_RES;
+    uint8_t id[3];
+    uint8_t status;
+    uint32_t polls;
+    __IO uint32_t delay;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(Device->SSPx));
+
+    Handle->Device = Device;
+    Handle->Size = 0;
+    Handle->Busy = 0;
+    Handle->Callback = 0;
+
+    Handle->PollTx[0] = SPINOR_CMD_RDSR;
+    Handle->PollTx[1] = 0xFF;
+    Handle->Poll.Device = Device;
+    Handle->Poll.TxBuffer = Handle->PollTx;
+    Handle->Poll.RxBuffer = Handle->PollRx;
+    Handle->Poll.Length = 2;
+    Handle->Poll.Flags = 0;
+    Handle->Poll.Callback = SPINOR_PollCallback;
+    Handle->Poll.Context = Handle;
+    Handle->Poll.Status = SPIBUS_Status_Done;
+
+    SPINOR_InvalidateCache(Handle);
+
+    /* Release from deep power down, a no-op for a flash awake */
+    SPINOR_Command(Handle, &cmd, 1, 0, 0, 0);
+    for (delay = 0; delay < SPINOR_RESUME_DELAY; delay++) {
+    }
+
+    /* The ID comes first: without a flash MISO floats and the status reads
+       as busy for ever */
+    SPINOR_ReadID(Handle, id);
+    if ((id[0] == 0x00) || (id[0] == 0xFF)) {
+        /* An erase or a program still running from before the reset ignores
+           the ID read, but not the status read */
+        cmd = SPINOR_CMD_RDSR;
+        for (polls = 0; polls < SPINOR_INIT_POLLS; polls++) {
+            SPINOR_Command(Handle, &cmd, 1, 0, &status, 1);
+            if ((status == 0xFF) || ((status & SPINOR_SR_WIP) == 0)) {
+                break;
+            }
+        }
+        SPINOR_ReadID(Handle, id);
+    }
+
+    Handle->ManufacturerID = id[0];
+    Handle->DeviceID = ((uint16_t) id[1] << 8) | id[2];
+    if ((id[0] == 0x00) || (id[0] == 0xFF)) {
+        return ERROR;
+    }
+
+    /* Capacity code is log2 of the size, 64KB to 16MB */
+    if ((id[2] < 0x10) || (id[2] > 0x18)) {
+        return ERROR;
+    }
+    Handle->Size = (uint32_t) 1 << id[2];
+
+    /* A flash that answers the ID read while busy is there, wait for it as long */
+    cmd = SPINOR_CMD_RDSR;
+    for (polls = 0; polls < SPINOR_INIT_POLLS; polls++) {
+        SPINOR_Command(Handle, &cmd, 1, 0, &status, 1);
+        if ((status & SPINOR_SR_WIP) == 0) {
+            return SUCCESS;
+        }
+    }
+
+    Handle->Size = 0;
+    return ERROR;
+}
+
+/**
+ * @brief  Sets the function called at the end of each erase and program.
+ * @param  Handle: flash handle.
+ * @param  Callback: end of operation callback, NULL for none.
+ * @retval None
+ */
+void SPINOR_SetCallback(SPINOR_HandleTypeDef* Handle, SPINOR_CallbackTypeDef Callback)
+{
+    Handle->Callback = Callback;
+}
+
+/**
+ * @brief  Empties the read cache.
+ * @note   Needed only when the flash is written by other means than this
+ *         handle.
+ * @param  Handle: flash handle.
+ * @retval None
+ */
+void SPINOR_InvalidateCache(SPINOR_HandleTypeDef* Handle)
+{
+#if (SPINOR_CACHE_PAGES > 0)
+    uint32_t i;
+
+    for (i = 0; i < SPINOR_CACHE_PAGES; i++) {
+        Handle->Cache[i].Address = SPINOR_CACHE_EMPTY;
+        Handle->Cache[i].Stamp = 0;
+    }
+    Handle->Stamp = 0;
+#endif
+    Handle->CacheHits = 0;
+    Handle->CacheMisses = 0;
+}
+
+/**
+ * @brief  Reads data from the flash.
+ * @note   Reads within a page go through the cache, which keeps the
+ *         SPINOR_CACHE_PAGES pages used last. Reads of whole pages go
+ *         straight to the bus and leave the cache as it is.
+ *         Waits for the end of a running erase or program.
+ * @param  Handle: flash handle.
+ * @param  Address: first byte to read.
+ * @param  Buffer: received data.
+ * @param  Length: number of bytes to read.
+ * @retval SUCCESS, or ERROR when the range is outside of the flash.
+ */
+ErrorStatus SPINOR_Read(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint8_t* Buffer, uint32_t Length)
+{
+#if (SPINOR_CACHE_PAGES > 0)
+    SPINOR_CacheTypeDef* entry;
+    uint32_t offset;
+    uint32_t count;
+#endif
+
+    if ((Address > Handle->Size) || (Length > (Handle->Size - Address))) {
+        return ERROR;
+    }
+
+    SPINOR_WaitReady(Handle);
+
+#if (SPINOR_CACHE_PAGES > 0)
+    while (Length != 0) {
+        offset = Address & (SPINOR_PAGE_SIZE - 1);
+
+        if ((offset == 0) && (Length >= SPINOR_PAGE_SIZE)) {
+            count = Length & ~(uint32_t) (SPINOR_PAGE_SIZE - 1);
+            SPINOR_AddressCommand(Handle, SPINOR_CMD_READ_FAST, Address, 0, Buffer, count);
+        } else {
+            count = SPINOR_PAGE_SIZE - offset;
+            if (count > Length) {
+                count = Length;
+            }
+            entry = SPINOR_CacheLoad(Handle, Address - offset);
+            memcpy(Buffer, &entry->Data[offset], count);
+        }
+
+        Address += count;
+        Buffer += count;
+        Length -= count;
+    }
+#else
+    if (Length != 0) {
+        SPINOR_AddressCommand(Handle, SPINOR_CMD_READ_FAST, Address, 0, Buffer, Length);
+    }
+#endif
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Programs data into the flash, one page program per page crossed.
+ * @note   Program only clears bits, the range should be erased first.
+ *         Returns once the last page program is started; the end is
+ *         reported as for SPINOR_EraseStart().
+ * @param  Handle: flash handle.
+ * @param  Address: first byte to program.
+ * @param  Buffer: data to program.
+ * @param  Length: number of bytes to program.
+ * @retval SUCCESS, or ERROR when the range is outside of the flash.
+ */
+ErrorStatus SPINOR_Program(SPINOR_HandleTypeDef* Handle, uint32_t Address, const uint8_t* Buffer, uint32_t Length)
+{
+    uint32_t count;
+
+    if ((Address > Handle->Size) || (Length > (Handle->Size - Address))) {
+        return ERROR;
+    }
+
+    while (Length != 0) {
+        count = SPINOR_PAGE_SIZE - (Address & (SPINOR_PAGE_SIZE - 1));
+        if (count > Length) {
+            count = Length;
+        }
+
+        SPINOR_WaitReady(Handle);
+        SPINOR_WriteEnable(Handle);
+        SPINOR_AddressCommand(Handle, SPINOR_CMD_PP, Address, Buffer, 0, count);
+        SPINOR_CacheProgram(Handle, Address, Buffer, count);
+        Handle->Busy = 1;
+
+        Address += count;
+        Buffer += count;
+        Length -= count;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Starts an erase and returns without waiting for its end.
+ * @note   The end is seen by SPINOR_GetBusy() once SPINOR_TimeHandler()
+ *         or SPINOR_WaitReady() has read the flash status, then the
+ *         callback is called.
+ * @param  Handle: flash handle.
+ * @param  Address: start of the sector or block, aligned on its size.
+ *         Ignored for SPINOR_Erase_Chip.
+ * @param  Size: a value of @ref SPINOR_Erase_Size.
+ * @retval SUCCESS, or ERROR when the address is outside of the flash or
+ *         not aligned.
+ */
+ErrorStatus SPINOR_EraseStart(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint32_t Size)
+{
+    uint8_t cmd = SPINOR_CMD_CE;
+
+    /* Check the parameters */
+    assert_param(IS_SPINOR_ERASE(Size));
+
+    if (Size != SPINOR_Erase_Chip) {
+        if ((Address >= Handle->Size) || ((Address & (Size - 1)) != 0)) {
+            return ERROR;
+        }
+    }
+
+    SPINOR_WaitReady(Handle);
+    SPINOR_WriteEnable(Handle);
+
+    if (Size == SPINOR_Erase_Chip) {
+        SPINOR_Command(Handle, &cmd, 1, 0, 0, 0);
+        SPINOR_CacheErase(Handle, 0, Handle->Size);
+    } else {
+        if (Size == SPINOR_Erase_4KB) {
+            cmd = SPINOR_CMD_SE;
+        } else if (Size == SPINOR_Erase_32KB) {
+            cmd = SPINOR_CMD_BE32K;
+        } else {
+            cmd = SPINOR_CMD_BE;
+        }
+        SPINOR_AddressCommand(Handle, cmd, Address, 0, 0, 0);
+        SPINOR_CacheErase(Handle, Address, Size);
+    }
+    Handle->Busy = 1;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Erases a sector, a block or the whole flash and waits for the end.
+ * @param  Handle: flash handle.
+ * @param  Address: start of the sector or block, aligned on its size.
+ *         Ignored for SPINOR_Erase_Chip.
+ * @param  Size: a value of @ref SPINOR_Erase_Size.
+ * @retval SUCCESS, or ERROR when the address is outside of the flash or
+ *         not aligned.
+ */
+ErrorStatus SPINOR_Erase(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint32_t Size)
+{
+    if (SPINOR_EraseStart(Handle, Address, Size) != SUCCESS) {
+        return ERROR;
+    }
+
+    SPINOR_WaitReady(Handle);
+    return SUCCESS;
+}
+
+/**
+ * @brief  Checks whether an erase or a program is running.
+ * @param  Handle: flash handle.
+ * @retval SET until the end of the operation was seen, RESET otherwise.
+ */
+FlagStatus SPINOR_GetBusy(SPINOR_HandleTypeDef* Handle)
+{
+    return (Handle->Busy != 0) ? SET : RESET;
+}
+
+/**
+ * @brief  Reads the flash status until the running erase or program ends.
+ * @param  Handle: flash handle.
+ * @retval None
+ */
+void SPINOR_WaitReady(SPINOR_HandleTypeDef* Handle)
+{
+    uint8_t cmd = SPINOR_CMD_RDSR;
+    uint8_t status;
+
+    while (Handle->Busy != 0) {
+        SPINOR_Command(Handle, &cmd, 1, 0, &status, 1);
+        if ((status & SPINOR_SR_WIP) == 0) {
+            SPINOR_Ready(Handle);
+        }
+    }
+}
+
+/**
+ * @brief  Polls the flash status without waiting, call it from a timer
+ *         interrupt (e.g. every 1ms) to see the end of erases and programs
+ *         without SPINOR_WaitReady().
+ * @note   The status is read by a queued transfer, completed in the SSP
+ *         interrupt, which calls the callback.
+ * @param  Handle: flash handle.
+ * @retval None
+ */
+void SPINOR_TimeHandler(SPINOR_HandleTypeDef* Handle)
+{
+    if ((Handle->Busy != 0) && (Handle->Poll.Status != SPIBUS_Status_Queued) && (Handle->Poll.Status != SPIBUS_Status_Busy)) {
+        SPIBUS_Submit(&Handle->Poll);
+    }
+}
+
+/* Sends a command, then sends or receives Length data bytes with the chip select kept asserted */
+static void SPINOR_Command(SPINOR_HandleTypeDef* Handle, const uint8_t* Cmd, uint32_t CmdLength, const uint8_t* TxBuffer, uint8_t* RxBuffer, uint32_t Length)
+{
+    SPIBUS_TransferTypeDef head;
+    SPIBUS_TransferTypeDef data;
+    uint32_t primask;
+
+    head.Device = Handle->Device;
+    head.TxBuffer = Cmd;
+    head.RxBuffer = 0;
+    head.Length = CmdLength;
+    head.Flags = (Length != 0) ? SPIBUS_Flag_KeepCS : 0;
+    head.Callback = 0;
+    head.Context = 0;
+
+    if (Length == 0) {
+        SPIBUS_Submit(&head);
+        SPIBUS_Wait(&head);
+        return;
+    }
+
+    data.Device = Handle->Device;
+    data.TxBuffer = TxBuffer;
+    data.RxBuffer = RxBuffer;
+    data.Length = Length;
+    data.Flags = 0;
+    data.Callback = 0;
+    data.Context = 0;
+
+    /* Queued together, so that a status poll cannot come in between */
+    SPINOR_LOCK(primask);
+    SPIBUS_Submit(&head);
+    SPIBUS_Submit(&data);
+    SPINOR_UNLOCK(primask);
+
+    SPIBUS_Wait(&data);
+}
+
+/* Sends a command followed by a 3 byte address, and a dummy byte for the fast read */
+static void SPINOR_AddressCommand(SPINOR_HandleTypeDef* Handle, uint8_t Cmd, uint32_t Address, const uint8_t* TxBuffer, uint8_t* RxBuffer, uint32_t Length)
+{
+    uint8_t cmd[5];
+
+    cmd[0] = Cmd;
+    cmd[1] = (uint8_t) (Address >> 16);
+    cmd[2] = (uint8_t) (Address >> 8);
+    cmd[3] = (uint8_t) Address;
+    cmd[4] = 0xFF;
+
+    SPINOR_Command(Handle, cmd, (Cmd == SPINOR_CMD_READ_FAST) ? 5 : 4, TxBuffer, RxBuffer, Length);
+}
+
+static void SPINOR_WriteEnable(SPINOR_HandleTypeDef* Handle)
+{
+    uint8_t cmd = SPINOR_CMD_WREN;
+
+    SPINOR_Command(Handle, &cmd, 1, 0, 0, 0);
+}
+
+static void SPINOR_ReadID(SPINOR_HandleTypeDef* Handle, uint8_t* ID)
+{
+    uint8_t cmd = SPINOR_CMD_RDID;
+
+    SPINOR_Command(Handle, &cmd, 1, 0, ID, 3);
+}
+
+/* Clears the busy flag once, from the timer poll or from SPINOR_WaitReady() */
+static void SPINOR_Ready(SPINOR_HandleTypeDef* Handle)
+{
+    uint32_t primask;
+    uint8_t busy;
+
+    SPINOR_LOCK(primask);
+    busy = Handle->Busy;
+    Handle->Busy = 0;
+    SPINOR_UNLOCK(primask);
+
+    if ((busy != 0) && (Handle->Callback != 0)) {
+        Handle->Callback(Handle);
+    }
+}
+
+static void SPINOR_PollCallback(SPIBUS_TransferTypeDef* Transfer)
+{
+    SPINOR_HandleTypeDef* handle = (SPINOR_HandleTypeDef*) Transfer->Context;
+
+    if ((Transfer->Status == SPIBUS_Status_Done) && ((handle->PollRx[1] & SPINOR_SR_WIP) == 0)) {
+        SPINOR_Ready(handle);
+    }
+}
+
+#if (SPINOR_CACHE_PAGES > 0)
+/* Returns the cache entry of a page, reading it into the least recently used entry on a miss */
+static SPINOR_CacheTypeDef* SPINOR_CacheLoad(SPINOR_HandleTypeDef* Handle, uint32_t Page)
+{
+    SPINOR_CacheTypeDef* entry = &Handle->Cache[0];
+    uint32_t i;
+
+    for (i = 0; i < SPINOR_CACHE_PAGES; i++) {
+        if (Handle->Cache[i].Address == Page) {
+            entry = &Handle->Cache[i];
+            Handle->CacheHits++;
+            entry->Stamp = ++Handle->Stamp;
+            return entry;
+        }
+        if (Handle->Cache[i].Stamp < entry->Stamp) {
+            entry = &Handle->Cache[i];
+        }
+    }
+
+    Handle->CacheMisses++;
+    entry->Address = SPINOR_CACHE_EMPTY;
+    SPINOR_AddressCommand(Handle, SPINOR_CMD_READ_FAST, Page, 0, entry->Data, SPINOR_PAGE_SIZE);
+    entry->Address = Page;
+    entry->Stamp = ++Handle->Stamp;
+    return entry;
+}
+#endif
+
+/* Applies a page program to the cached copy, the flash only clears bits */
+static void SPINOR_CacheProgram(SPINOR_HandleTypeDef* Handle, uint32_t Address, const uint8_t* Buffer, uint32_t Length)
+{
+#if (SPINOR_CACHE_PAGES > 0)
+    uint32_t page = Address & ~(uint32_t) (SPINOR_PAGE_SIZE - 1);
+    uint32_t offset = Address - page;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < SPINOR_CACHE_PAGES; i++) {
+        if (Handle->Cache[i].Address == page) {
+            for (j = 0; j < Length; j++) {
+                Handle->Cache[i].Data[offset + j] &= Buffer[j];
+            }
+        }
+    }
+#endif
+}
+
+/* Drops the cached pages of an erased range */
+static void SPINOR_CacheErase(SPINOR_HandleTypeDef* Handle, uint32_t Address, uint32_t Length)
+{
+#if (SPINOR_CACHE_PAGES > 0)
+    uint32_t i;
+
+    for (i = 0; i < SPINOR_CACHE_PAGES; i++) {
+        if ((Handle->Cache[i].Address != SPINOR_CACHE_EMPTY) &&
+            ((Handle->Cache[i].Address - Address) < Length)) {
+            Handle->Cache[i].Address = SPINOR_CACHE_EMPTY;
+            Handle->Cache[i].Stamp = 0;
+        }
+    }
+#endif
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -271,6 +271,154 @@ uint16_t SSP_ReceiveData(SSP_TypeDef* SSPx)
     return (uint16_t) SSPx->DR;
 }
 
+/**
+ * @brief  Exchanges a burst of 8-bit frames.
+ * @note   The transmit FIFO is primed with up to SSP_FIFO_DEPTH frames, then
+ *         every received frame is followed by the next frame to send, so the
+ *         bus never waits for the CPU and the receive FIFO cannot overrun.
+ *         The SSP must be enabled in master mode with a 8-bit or smaller frame size.
+ * @param  SSPx: where x can be from 0 to 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  TxBuffer: frames to send.
+ * @param  RxBuffer: received frames, may be TxBuffer.
+ * @param  Length: number of frames.
+ * @retval None
+ */
+void SSP_TransmitReceive8(SSP_TypeDef* SSPx, const uint8_t* TxBuffer, uint8_t* RxBuffer, uint32_t Length)
+{
+    uint32_t tx = 0, rx = 0;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    /* Drop stale frames */
+    while (SSPx->SR & SSP_SR_RNE) {
+        (void) SSPx->DR;
+    }
+
+    while ((tx < Length) && (tx < SSP_FIFO_DEPTH)) {
+        SSPx->DR = TxBuffer[tx++];
+    }
+
+    while (rx < Length) {
+        if (SSPx->SR & SSP_SR_RNE) {
+            RxBuffer[rx++] = (uint8_t) SSPx->DR;
+            if (tx < Length) {
+                SSPx->DR = TxBuffer[tx++];
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Exchanges a burst of 16-bit frames.
+ * @note   The transmit FIFO is primed with up to SSP_FIFO_DEPTH frames, then
+ *         every received frame is followed by the next frame to send, so the
+ *         bus never waits for the CPU and the receive FIFO cannot overrun.
+ *         The SSP must be enabled in master mode with a 16-bit frame size.
+ * @param  SSPx: where x can be from 0 to 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  TxBuffer: frames to send.
+ * @param  RxBuffer: received frames, may be TxBuffer.
+ * @param  Length: number of frames.
+ * @retval None
+ */
+void SSP_TransmitReceive16(SSP_TypeDef* SSPx, const uint16_t* TxBuffer, uint16_t* RxBuffer, uint32_t Length)
+{
+    uint32_t tx = 0, rx = 0;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    /* Drop stale frames */
+    while (SSPx->SR & SSP_SR_RNE) {
+        (void) SSPx->DR;
+    }
+
+    while ((tx < Length) && (tx < SSP_FIFO_DEPTH)) {
+        SSPx->DR = TxBuffer[tx++];
+    }
+
+    while (rx < Length) {
+        if (SSPx->SR & SSP_SR_RNE) {
+            RxBuffer[rx++] = (uint16_t) SSPx->DR;
+            if (tx < Length) {
+                SSPx->DR = TxBuffer[tx++];
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Sends a burst of 8-bit frames, received frames are dropped.
+ * @note   Only the transmit FIFO is watched while sending; the receive FIFO
+ *         overruns and is emptied at the end, when the bus is idle.
+ * @param  SSPx: where x can be from 0 to 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  TxBuffer: frames to send.
+ * @param  Length: number of frames.
+ * @retval None
+ */
+void SSP_Transmit8(SSP_TypeDef* SSPx, const uint8_t* TxBuffer, uint32_t Length)
+{
+    uint32_t i;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    for (i = 0; i < Length; i++) {
+        while ((SSPx->SR & SSP_SR_TNF) == 0) {
+        }
+        SSPx->DR = TxBuffer[i];
+    }
+
+    while (SSPx->SR & SSP_SR_BSY) {
+    }
+    while (SSPx->SR & SSP_SR_RNE) {
+        (void) SSPx->DR;
+    }
+    SSPx->ICR = SSP_IT_ROR;
+}
+
+/**
+ * @brief  Sends a burst of 16-bit frames, received frames are dropped.
+ * @note   Only the transmit FIFO is watched while sending; the receive FIFO
+ *         overruns and is emptied at the end, when the bus is idle.
+ * @param  SSPx: where x can be from 0 to 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  TxBuffer: frames to send.
+ * @param  Length: number of frames.
+ * @retval None
+ */
+void SSP_Transmit16(SSP_TypeDef* SSPx, const uint16_t* TxBuffer, uint32_t Length)
+{
+    uint32_t i;
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    for (i = 0; i < Length; i++) {
+        while ((SSPx->SR & SSP_SR_TNF) == 0) {
+        }
+        SSPx->DR = TxBuffer[i];
+    }
+
+    while (SSPx->SR & SSP_SR_BSY) {
+    }
+    while (SSPx->SR & SSP_SR_RNE) {
+        (void) SSPx->DR;
+    }
+    SSPx->ICR = SSP_IT_ROR;
+}
+
 /**
  * @brief  Enables or disables the SSPx/I2Sx DMA interface.
  * @param  SSPx: where x can be from 0 to 1 to select the SSP peripheral.
@@ -0,0 +1,356 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_ssp_dma.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to run SSP transfers with
+ *          the DMA controller:
+ *           + Full-duplex transfers on a pair of TX/RX channels
+ *           + Transmit only transfers with a dummy receive sink
+ *           + Receive only transfers clocking out a fill value
+ *           + Completion callback
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_ssp_dma.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup SSPDMA
+ * @brief SSP DMA transfer driver modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    SSP_TypeDef* SSPx;
+    uint32_t TxChannel;
+    uint32_t RxChannel;
+    SSPDMA_CallbackTypeDef Callback;
+
+    const uint8_t* TxPtr;               /* 0 to clock out Fill         */
+    uint8_t* RxPtr;                     /* 0 to drop data into Sink    */
+    __IO uint32_t Left;
+    __IO uint8_t Busy;
+    uint32_t DataSize;
+
+    uint16_t Fill;
+    uint16_t Sink;
+} SSPDMA_HandleTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define SSPDMA_NUM                  2
+
+/* Both FIFO watermarks are at half of the 8 entries */
+#define SSPDMA_ARBITRATION          DMA_Arbitration_4
+
+/* Private macro -------------------------------------------------------------*/
+#define SSPDMA_HANDLE(SSPx)         (&SSPDMA_Handle[((SSPx) == SSP0) ? 0 : 1])
+
+/* Private variables ---------------------------------------------------------*/
+static SSPDMA_HandleTypeDef SSPDMA_Handle[SSPDMA_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+static void SSPDMA_DMACallback(uint32_t DMA_Channel, uint32_t DMA_Event);
+static void SSPDMA_Next(SSPDMA_HandleTypeDef* handle);
+static void SSPDMA_Stop(SSPDMA_HandleTypeDef* handle);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup SSPDMA_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Attaches the DMA channels of an SSP.
+ * @note   The SSP must be initialized and enabled first. The channels are given
+ *         by the DMA_Channel_SSPx_TX/RX mapping. The receive channel gets the
+ *         high priority so that the RX FIFO never overruns. Enable the DMA
+ *         interrupt in the NVIC and call DMA_IRQHandler() from DMA_Handler.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  Callback: completion callback, may be 0.
+ * @retval None
+ */
+void SSPDMA_Init(SSP_TypeDef* SSPx, SSPDMA_CallbackTypeDef Callback)
+{
+    SSPDMA_HandleTypeDef* handle = SSPDMA_HANDLE(SSPx);
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    handle->SSPx = SSPx;
+    handle->TxChannel = (SSPx == SSP0) ? DMA_Channel_SSP0_TX : DMA_Channel_SSP1_TX;
+    handle->RxChannel = (SSPx == SSP0) ? DMA_Channel_SSP0_RX : DMA_Channel_SSP1_RX;
+    handle->Callback = Callback;
+    handle->Busy = 0;
+    handle->Fill = 0xFFFF;
+
+    DMA_Cmd(ENABLE);
+    DMA_SetCallback(handle->TxChannel, SSPDMA_DMACallback);
+    DMA_SetCallback(handle->RxChannel, SSPDMA_DMACallback);
+    DMA_PriorityConfig(handle->RxChannel, ENABLE);
+}
+
+/**
+ * @brief  Detaches the DMA channels of an SSP.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @retval None
+ */
+void SSPDMA_DeInit(SSP_TypeDef* SSPx)
+{
+    SSPDMA_HandleTypeDef* handle = SSPDMA_HANDLE(SSPx);
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    SSPDMA_Stop(handle);
+    DMA_SetCallback(handle->TxChannel, 0);
+    DMA_SetCallback(handle->RxChannel, 0);
+    DMA_PriorityConfig(handle->RxChannel, DISABLE);
+    handle->SSPx = 0;
+}
+
+/**
+ * @brief  Sets the frame clocked out by SSPDMA_Receive().
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  Value: fill frame, 0xFFFF after SSPDMA_Init().
+ * @retval None
+ */
+void SSPDMA_SetFillValue(SSP_TypeDef* SSPx, uint16_t Value)
+{
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    SSPDMA_HANDLE(SSPx)->Fill = Value;
+}
+
+/**
+ * @brief  Starts a full-duplex transfer.
+ * @note   Frames of up to 8 bits are stored in bytes, wider frames in
+ *         half-words. Transfers longer than 1024 frames are chained from the
+ *         DMA interrupt. The buffers must stay valid until SSPDMA_Event_Done.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  TxBuffer: frames to send, or 0 to send the fill value.
+ * @param  RxBuffer: received frames, or 0 to drop them.
+ * @param  Length: number of frames.
+ * @retval SUCCESS if the transfer is started, ERROR if one is in progress.
+ */
+ErrorStatus SSPDMA_TransmitReceive(SSP_TypeDef* SSPx, const void* TxBuffer, void* RxBuffer, uint32_t Length)
+{
+    SSPDMA_HandleTypeDef* handle = SSPDMA_HANDLE(SSPx);
+
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    if ((Length == 0) || handle->Busy) {
+        return ERROR;
+    }
+
+    handle->TxPtr = (const uint8_t*) TxBuffer;
+    handle->RxPtr = (uint8_t*) RxBuffer;
+    handle->Left = Length;
+    handle->Busy = 1;
+    handle->DataSize = ((SSPx->CR0 & SSP_CR0_DSS) > SSP_DataSize_8b) ? DMA_DataSize_HalfWord : DMA_DataSize_Byte;
+
+    /* Drop stale frames so that RX stays aligned with TX */
+    while (SSP_GetFlagStatus(SSPx, SSP_FLAG_RNE) == SET) {
+        (void) SSP_ReceiveData(SSPx);
+    }
+
+    SSPDMA_Next(handle);
+    SSP_DMACmd(SSPx, SSP_DMAReq_Rx | SSP_DMAReq_Tx, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Starts a transmit only transfer, the received frames are dropped.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  TxBuffer: frames to send.
+ * @param  Length: number of frames.
+ * @retval SUCCESS if the transfer is started, ERROR if one is in progress.
+ */
+ErrorStatus SSPDMA_Transmit(SSP_TypeDef* SSPx, const void* TxBuffer, uint32_t Length)
+{
+    return SSPDMA_TransmitReceive(SSPx, TxBuffer, 0, Length);
+}
+
+/**
+ * @brief  Starts a receive only transfer clocking out the fill value.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @param  RxBuffer: received frames.
+ * @param  Length: number of frames.
+ * @retval SUCCESS if the transfer is started, ERROR if one is in progress.
+ */
+ErrorStatus SSPDMA_Receive(SSP_TypeDef* SSPx, void* RxBuffer, uint32_t Length)
+{
+    return SSPDMA_TransmitReceive(SSPx, 0, RxBuffer, Length);
+}
+
+/**
+ * @brief  Checks whether a transfer is in progress.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @retval SET until the last frame has been received.
+ */
+FlagStatus SSPDMA_GetStatus(SSP_TypeDef* SSPx)
+{
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    return SSPDMA_HANDLE(SSPx)->Busy ? SET : RESET;
+}
+
+/**
+ * @brief  Aborts the transfer in progress, no callback is called.
+ * @param  SSPx: where x can be 0 or 1 to select the SSP peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg SSP0
+ *            @arg SSP1
+ * @retval None
+ */
+void SSPDMA_Abort(SSP_TypeDef* SSPx)
+{
+    /* Check the parameters */
+    assert_param(IS_SSP_ALL_PERIPH(SSPx));
+
+    SSPDMA_Stop(SSPDMA_HANDLE(SSPx));
+}
+
+static void SSPDMA_DMACallback(uint32_t DMA_Channel, uint32_t DMA_Event)
+{
+    SSPDMA_HandleTypeDef* handle;
+    uint32_t i;
+
+    for (i = 0; i < SSPDMA_NUM; i++) {
+        handle = &SSPDMA_Handle[i];
+        if ((handle->SSPx == 0) || (handle->Busy == 0)) {
+            continue;
+        }
+        if ((DMA_Channel != handle->TxChannel) && (DMA_Channel != handle->RxChannel)) {
+            continue;
+        }
+
+        if (DMA_Event & DMA_Event_Error) {
+            SSPDMA_Stop(handle);
+            if (handle->Callback) {
+                handle->Callback(handle->SSPx, SSPDMA_Event_Error);
+            }
+        } else if ((DMA_Channel == handle->RxChannel) && (DMA_Event & DMA_Event_Done)) {
+            /* The last frame of the chunk is received, so it is also sent */
+            if (handle->Left) {
+                SSPDMA_Next(handle);
+            } else {
+                SSPDMA_Stop(handle);
+                if (handle->Callback) {
+                    handle->Callback(handle->SSPx, SSPDMA_Event_Done);
+                }
+            }
+        }
+    }
+}
+
+static void SSPDMA_Next(SSPDMA_HandleTypeDef* handle)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+    uint32_t count = (handle->Left > DMA_MAX_TRANSFER) ? DMA_MAX_TRANSFER : handle->Left;
+    uint32_t data = (uint32_t) &handle->SSPx->DR;
+
+    DMA_InitStructure.DMA_DataSize = handle->DataSize;
+    DMA_InitStructure.DMA_Arbitration = SSPDMA_ARBITRATION;
+    DMA_InitStructure.DMA_BufferSize = count;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Basic;
+
+    /* Receive channel first so that no frame is missed */
+    DMA_InitStructure.DMA_SrcAddr = data;
+    DMA_InitStructure.DMA_SrcInc = DMA_Inc_None;
+    if (handle->RxPtr != 0) {
+        DMA_InitStructure.DMA_DstAddr = (uint32_t) handle->RxPtr;
+        DMA_InitStructure.DMA_DstInc = handle->DataSize;
+        handle->RxPtr += count << handle->DataSize;
+    } else {
+        DMA_InitStructure.DMA_DstAddr = (uint32_t) &handle->Sink;
+        DMA_InitStructure.DMA_DstInc = DMA_Inc_None;
+    }
+    DMA_Init(handle->RxChannel, &DMA_InitStructure);
+
+    DMA_InitStructure.DMA_DstAddr = data;
+    DMA_InitStructure.DMA_DstInc = DMA_Inc_None;
+    if (handle->TxPtr != 0) {
+        DMA_InitStructure.DMA_SrcAddr = (uint32_t) handle->TxPtr;
+        DMA_InitStructure.DMA_SrcInc = handle->DataSize;
+        handle->TxPtr += count << handle->DataSize;
+    } else {
+        DMA_InitStructure.DMA_SrcAddr = (uint32_t) &handle->Fill;
+        DMA_InitStructure.DMA_SrcInc = DMA_Inc_None;
+    }
+    DMA_Init(handle->TxChannel, &DMA_InitStructure);
+
+    handle->Left -= count;
+
+    DMA_ChannelCmd(handle->RxChannel, ENABLE);
+    DMA_ChannelCmd(handle->TxChannel, ENABLE);
+}
+
+static void SSPDMA_Stop(SSPDMA_HandleTypeDef* handle)
+{
+    SSP_DMACmd(handle->SSPx, SSP_DMAReq_Rx | SSP_DMAReq_Tx, DISABLE);
+    DMA_ChannelCmd(handle->TxChannel, DISABLE);
+    DMA_ChannelCmd(handle->RxChannel, DISABLE);
+    handle->Left = 0;
+    handle->Busy = 0;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -39,8 +39,19 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+
+/* Accepted distance between a measured and a standard baud rate, in per mille */
+#define UART_AUTOBAUD_TOLERANCE     30
+
 /* Private macro -------------------------------------------------------------*/
+#define UART_CLOCK()                (GetSystemClock() / (1 << CRG->UARTCLK_PVSR))
+
 /* Private variables ---------------------------------------------------------*/
+static const uint32_t UART_StandardBaudRates[] = {
+    1200, 2400, 4800, 9600, 14400, 19200, 38400, 57600,
+    115200, 230400, 460800, 921600
+};
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -103,9 +114,7 @@ void UART_DeInit(UART_TypeDef *UARTx)
  */
 void UART_Init(UART_TypeDef *UARTx, UART_InitTypeDef* UART_InitStruct)
 {
-    float baud_divisor;
-    uint32_t tmpreg = 0x00, uartclock = 0x00;
-    uint32_t integer_baud = 0x00, fractional_baud = 0x00;
+    uint32_t tmpreg = 0x00;
 
     /* Check the parameters */
     assert_param(IS_UART_PERIPH(UARTx));
@@ -117,15 +126,8 @@ void UART_Init(UART_TypeDef *UARTx, UART_InitTypeDef* UART_InitStruct)
 
     UARTx->CR &= ~(UART_CR_UARTEN);
 
-    uartclock = GetSystemClock() / (1 << CRG->UARTCLK_PVSR);
-
     /*----------------------------- UARTx IBRD and FBRD Configuration ------------------------------*/
-    baud_divisor = ((float) uartclock / (16 * UART_InitStruct->UART_BaudRate));
-    integer_baud = (uint32_t) baud_divisor;
-    fractional_baud = (uint32_t) ((baud_divisor - integer_baud) * 64 + 0.5);
-
-    UARTx->IBRD = integer_baud;
-    UARTx->FBRD = fractional_baud;
+    UART_SetBaudRate(UARTx, UART_InitStruct->UART_BaudRate);
 
     tmpreg = UARTx->LCR_H;
     tmpreg &= ~(0x00EE);
@@ -240,6 +242,158 @@ void UART_SendBreak(UART_TypeDef* UARTx)
     UARTx->LCR_H |= UART_LCR_H_BRK;
 }
 
+/**
+ * @brief  Sets the baud rate divisors from the current UART clock.
+ * @note   The divisor is computed in fixed point, as 64 * UARTCLK / (16 * BaudRate)
+ *         rounded to the nearest integer, without floating point code.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  BaudRate: baud rate in bit/s.
+ * @retval SUCCESS, or ERROR if the baud rate cannot be generated from the
+ *         UART clock; the divisors are left unchanged then.
+ */
+ErrorStatus UART_SetBaudRate(UART_TypeDef* UARTx, uint32_t BaudRate)
+{
+    uint32_t divisor;
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    if (BaudRate == 0) {
+        return ERROR;
+    }
+
+    divisor = UART_BAUD_DIVISOR(UART_CLOCK(), BaudRate);
+    if (!IS_UART_BAUD_DIVISOR(divisor)) {
+        return ERROR;
+    }
+
+    UART_SetBaudRateDivisor(UARTx, divisor);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Sets precomputed baud rate divisors.
+ * @note   Use with UART_BAUD_DIVISOR() for a constant UART clock and baud rate
+ *         so that the divisors are computed by the compiler.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  Divisor: IBRD in bits 21:6 and FBRD in bits 5:0.
+ * @retval None
+ */
+void UART_SetBaudRateDivisor(UART_TypeDef* UARTx, uint32_t Divisor)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+    assert_param(IS_UART_BAUD_DIVISOR(Divisor));
+
+    UARTx->IBRD = Divisor >> 6;
+    UARTx->FBRD = Divisor & 0x3F;
+
+    /* The divisors are latched by a write to LCR_H */
+    UARTx->LCR_H = UARTx->LCR_H;
+}
+
+/**
+ * @brief  Returns the error of the programmed baud rate.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  BaudRate: expected baud rate in bit/s.
+ * @retval Signed error of the actual baud rate in parts per million.
+ */
+int32_t UART_GetBaudRateError(UART_TypeDef* UARTx, uint32_t BaudRate)
+{
+    uint32_t divisor;
+    int64_t error, period;
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    divisor = (UARTx->IBRD << 6) | (UARTx->FBRD & 0x3F);
+    if ((divisor == 0) || (BaudRate == 0)) {
+        return 0;
+    }
+
+    /* (actual - BaudRate) / BaudRate without truncating the actual rate */
+    period = (int64_t) BaudRate * divisor;
+    error = ((int64_t) 4 * UART_CLOCK() - period) * 1000000;
+    if (error >= 0) {
+        return (int32_t) ((error + period / 2) / period);
+    }
+    return (int32_t) -((-error + period / 2) / period);
+}
+
+/**
+ * @brief  Measures the baud rate of a 'U' (0x55) character on a GPIO pin.
+ * @note   The pin must be an input, usually the RXD pin of the UART still in
+ *         its GPIO function. A DualTimer runs free at the given clock while the
+ *         pin is polled: the first and the fifth falling edges of 0x55 are
+ *         8 bit times apart. Interrupts should be disabled while measuring.
+ *         The result is snapped to a standard rate within 3%.
+ * @param  GPIOx: where x can be (A..D) to select the GPIO peripheral.
+ * @param  GPIO_Pin: specifies the pin to watch.
+ * @param  DUALTIMERn: where n can be 0_0, 0_1, 1_0 and 1_1 to select the timer.
+ *         It is reprogrammed as a free running 32-bit counter.
+ * @param  TimerClock: clock of the timer in Hz.
+ * @param  Timeout: maximum wait for the character, in timer ticks.
+ * @retval The baud rate in bit/s, or 0 on timeout.
+ */
+uint32_t UART_AutoBaud(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, DUALTIMER_TypeDef* DUALTIMERn, uint32_t TimerClock, uint32_t Timeout)
+{
+    DUALTIMER_InitTypDef DUALTIMER_InitStructure;
+    uint32_t start, first = 0, ticks, baud, i;
+    uint8_t edges = 0;
+    uint32_t level, last;
+
+    /* Check the parameters */
+    assert_param(IS_GPIO_ALL_PERIPH(GPIOx));
+    assert_param(IS_DUALTIMER_PERIH(DUALTIMERn));
+
+    DUALTIMER_InitStructure.Timer_Load = 0xFFFFFFFF;
+    DUALTIMER_InitStructure.Timer_Wrapping = DUALTIMER_Free_Running;
+    DUALTIMER_InitStructure.Timer_Prescaler = DUALTIMER_Prescaler_1;
+    DUALTIMER_InitStructure.Timer_Size = DUALTIMER_Size_32;
+    DUALTIMER_InitStructure.Timer_Repetition = DUALTIMER_Wrapping;
+    DUALTIMER_Init(DUALTIMERn, &DUALTIMER_InitStructure);
+    DUALTIMER_Cmd(DUALTIMERn, ENABLE);
+
+    start = DUALTIMERn->VALUE;
+    last = GPIOx->DATA & GPIO_Pin;
+
+    /* The timer counts down */
+    while ((start - DUALTIMERn->VALUE) < Timeout) {
+        level = GPIOx->DATA & GPIO_Pin;
+        if ((level == 0) && (last != 0)) {
+            if (edges++ == 0) {
+                first = DUALTIMERn->VALUE;
+            } else if (edges == 5) {
+                ticks = first - DUALTIMERn->VALUE;
+                DUALTIMER_Cmd(DUALTIMERn, DISABLE);
+
+                baud = (uint32_t) (((uint64_t) TimerClock * 8 + ticks / 2) / ticks);
+                for (i = 0; i < sizeof(UART_StandardBaudRates) / sizeof(UART_StandardBaudRates[0]); i++) {
+                    if (((baud > UART_StandardBaudRates[i]) ? baud - UART_StandardBaudRates[i] : UART_StandardBaudRates[i] - baud)
+                            * 1000 <= UART_StandardBaudRates[i] * UART_AUTOBAUD_TOLERANCE) {
+                        return UART_StandardBaudRates[i];
+                    }
+                }
+                return baud;
+            }
+        }
+        last = level;
+    }
+
+    DUALTIMER_Cmd(DUALTIMERn, DISABLE);
+    return 0;
+}
+
 /**
  * @brief  Deinitializes the UART2 peripheral registers to their
  *         default reset values.
@@ -265,8 +419,8 @@ void S_UART_Init(uint32_t baud)
 
     uartclock = GetSystemClock();
 
-    /* Set (Calculate) integer_baud */
-    integer_baud = (uint32_t) (uartclock / baud);
+    /* Set (Calculate) integer_baud, rounded to the nearest divisor */
+    integer_baud = (uartclock + (baud / 2)) / baud;
 
     /* Write UART2 BAUDDIV */
     UART2->BDR = integer_baud;
@@ -678,7 +832,34 @@ void UART_DMA_Config(UART_TypeDef* UARTx, uint16_t UART_DMA_CONTROL)
 
     /*Set DMACR */
     UARTx->DMACR |= UART_DMA_CONTROL;
-    NVIC_EnableIRQ(UART1_IRQn);
+}
+
+/**
+ * @brief  Enables or disables the UART DMA interface.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  UART_DMA_CONTROL: specifies the DMA request.
+ *          This parameter can be any combination of the following values:
+ *            @arg UART_DMAControl_DMAONERR: DMA on error
+ *            @arg UART_DMAControl_TXDMAE:   Transmit DMA enable
+ *            @arg UART_DMAControl_RXDMAE:   Receive DMA enable
+ * @param  NewState: new state of the DMA request.
+ *          This parameter can be: ENABLE or DISABLE.
+ * @retval None
+ */
+void UART_DMACmd(UART_TypeDef* UARTx, uint16_t UART_DMA_CONTROL, FunctionalState NewState)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (NewState != DISABLE) {
+        UARTx->DMACR |= UART_DMA_CONTROL;
+    } else {
+        UARTx->DMACR &= ~UART_DMA_CONTROL;
+    }
 }
 
 /**
@@ -0,0 +1,934 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_uart_buf.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions for interrupt driven and
+ *          buffered UART0, UART1 and UART2 communication:
+ *           + Transmit and receive ring buffers
+ *           + FIFO threshold and receive timeout interrupts (UART0, UART1)
+ *           + Buffer full and empty interrupts (UART2)
+ *           + One port based API over the three UARTs
+ *           + Drop, block or overwrite policy on overflow
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_uart_buf.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup UARTBUF
+ * @brief Buffered UART driver modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint8_t* Buffer;
+    uint16_t Size;
+    __IO uint16_t Head;                 /* Next byte written */
+    __IO uint16_t Tail;                 /* Next byte read    */
+} UARTBUF_RingTypeDef;
+
+typedef struct
+{
+    uint32_t Port;
+    __IO uint8_t Active;
+    __IO uint8_t RxHeld;                /* RX interrupts off, bytes left in the FIFO */
+    UARTBUF_RingTypeDef Tx;
+    UARTBUF_RingTypeDef Rx;
+    uint32_t Policy;
+    __IO uint32_t Overflow;
+} UARTBUF_HandleTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define UARTBUF_NUM                 3
+
+#define S_UARTBUF_IT_ALL            (S_UART_CTRL_FLAG_RXOI | S_UART_CTRL_FLAG_TXOI | \
+                                     S_UART_CTRL_FLAG_RXI | S_UART_CTRL_FLAG_TXI)
+
+/* Private macro -------------------------------------------------------------*/
+#define UARTBUF_HANDLE(PORT)        (&UARTBUF_Handle[PORT])
+#define UARTBUF_UART(PORT)          (((PORT) == UARTPORT_0) ? UART0 : UART1)
+#define UARTBUF_NEXT(RING, IDX)     ((uint16_t) (((IDX) + 1 == (RING)->Size) ? 0 : (IDX) + 1))
+
+#define UARTBUF_LOCK(MASK)          do { (MASK) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define UARTBUF_UNLOCK(MASK)        __set_PRIMASK(MASK)
+
+/* Private variables ---------------------------------------------------------*/
+static UARTBUF_HandleTypeDef UARTBUF_Handle[UARTBUF_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+static void UARTBUF_TxFill(UARTBUF_HandleTypeDef* handle);
+static void UARTBUF_RxPut(UARTBUF_HandleTypeDef* handle, uint8_t Data);
+static void UARTBUF_RxRelease(UARTBUF_HandleTypeDef* handle);
+static uint16_t UARTBUF_Count(UARTBUF_RingTypeDef* ring);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup UARTBUF_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Starts buffered operation of a UART port.
+ * @note   The UART must be initialized and enabled first. On UART0 and UART1
+ *         the FIFOs are enabled with half full thresholds; UART2 has a single
+ *         byte buffer in each direction and interrupts on every byte. Enable
+ *         the UART interrupt in the NVIC and call UARTPORT_IRQHandler() from
+ *         its handler. A ring buffer holds one byte less than its size. The
+ *         overflow policy is UARTBUF_Policy_Drop.
+ * @param  UARTPORT: port to start.
+ *          This parameter can be one of the following values:
+ *            @arg UARTPORT_0: UART0
+ *            @arg UARTPORT_1: UART1
+ *            @arg UARTPORT_2: UART2 (S_UART)
+ * @param  TxBuffer: transmit ring buffer.
+ * @param  TxSize: size of TxBuffer, at least 2.
+ * @param  RxBuffer: receive ring buffer.
+ * @param  RxSize: size of RxBuffer, at least 2.
+ * @retval None
+ */
+void UARTPORT_Init(uint32_t UARTPORT, uint8_t* TxBuffer, uint16_t TxSize, uint8_t* RxBuffer, uint16_t RxSize)
+{
+    UARTBUF_HandleTypeDef* handle = UARTBUF_HANDLE(UARTPORT);
+    UART_TypeDef* UARTx;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+    assert_param((TxSize >= 2) && (RxSize >= 2));
+
+    UARTPORT_DeInit(UARTPORT);
+
+    handle->Port = UARTPORT;
+    handle->Tx.Buffer = TxBuffer;
+    handle->Tx.Size = TxSize;
+    handle->Tx.Head = 0;
+    handle->Tx.Tail = 0;
+    handle->Rx.Buffer = RxBuffer;
+    handle->Rx.Size = RxSize;
+    handle->Rx.Head = 0;
+    handle->Rx.Tail = 0;
+    handle->Policy = UARTBUF_Policy_Drop;
+    handle->Overflow = 0;
+    handle->RxHeld = 0;
+    handle->Active = 1;
+
+    if (UARTPORT == UARTPORT_2) {
+        UART2->SR = S_UART_FLAG_RXO | S_UART_FLAG_TXO;
+        UART2->INT.ICR = S_UART_IT_RXOI | S_UART_IT_TXOI | S_UART_IT_RXI | S_UART_IT_TXI;
+        UART2->CR |= S_UART_CTRL_FLAG_RXI | S_UART_CTRL_FLAG_RXOI;
+    } else {
+        UARTx = UARTBUF_UART(UARTPORT);
+        UART_FIFO_Enable(UARTx, UART_IFLS_RXIFLSEL1_2, UART_IFLS_TXIFLSEL1_2);
+        UART_ClearITPendingBit(UARTx, UART_IT_TXIM | UART_IT_RXIM | UART_IT_RTIM | UART_IT_OEIM);
+        UART_ITConfig(UARTx, UART_IT_RXIM | UART_IT_RTIM | UART_IT_OEIM, ENABLE);
+    }
+}
+
+/**
+ * @brief  Stops buffered operation of a UART port, pending bytes are discarded.
+ * @param  UARTPORT: port to stop.
+ *          This parameter can be one of the following values:
+ *            @arg UARTPORT_0: UART0
+ *            @arg UARTPORT_1: UART1
+ *            @arg UARTPORT_2: UART2 (S_UART)
+ * @retval None
+ */
+void UARTPORT_DeInit(uint32_t UARTPORT)
+{
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    if (UARTPORT == UARTPORT_2) {
+        UART2->CR &= ~S_UARTBUF_IT_ALL;
+    } else {
+        UART_ITConfig(UARTBUF_UART(UARTPORT), UART_IT_TXIM | UART_IT_RXIM | UART_IT_RTIM | UART_IT_OEIM, DISABLE);
+    }
+    UARTBUF_HANDLE(UARTPORT)->Active = 0;
+}
+
+/**
+ * @brief  Selects what happens when a ring buffer of a port is full.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  UARTBUF_Policy: overflow policy.
+ *          This parameter can be one of the following values:
+ *            @arg UARTBUF_Policy_Drop:      drop the new byte
+ *            @arg UARTBUF_Policy_Block:     wait for room; on UART0 and UART1
+ *                                           received bytes stay in the FIFO
+ *            @arg UARTBUF_Policy_Overwrite: drop the oldest byte
+ * @retval None
+ */
+void UARTPORT_SetPolicy(uint32_t UARTPORT, uint32_t UARTBUF_Policy)
+{
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+    assert_param(IS_UARTBUF_POLICY(UARTBUF_Policy));
+
+    UARTBUF_HANDLE(UARTPORT)->Policy = UARTBUF_Policy;
+}
+
+/**
+ * @brief  Queues bytes for transmission on a port.
+ * @note   UARTBUF_Policy_Block only waits in thread mode with interrupts
+ *         enabled; elsewhere it behaves as UARTBUF_Policy_Drop.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Data: bytes to send.
+ * @param  Length: number of bytes.
+ * @retval Number of bytes queued, 0 if the port is not started.
+ */
+uint16_t UARTPORT_Write(uint32_t UARTPORT, const uint8_t* Data, uint16_t Length)
+{
+    UARTBUF_HandleTypeDef* handle = UARTBUF_HANDLE(UARTPORT);
+    UARTBUF_RingTypeDef* ring = &handle->Tx;
+    uint32_t primask;
+    uint16_t next, i;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    /* Without UARTPORT_Init() there is no ring, and no interrupt would ever drain it */
+    if (handle->Active == 0) {
+        return 0;
+    }
+
+    for (i = 0; i < Length; i++) {
+        next = UARTBUF_NEXT(ring, ring->Head);
+        if (next == ring->Tail) {
+            if ((handle->Policy == UARTBUF_Policy_Block) && (__get_IPSR() == 0) && (__get_PRIMASK() == 0)) {
+                UARTBUF_LOCK(primask);
+                UARTBUF_TxFill(handle);
+                UARTBUF_UNLOCK(primask);
+                while (next == ring->Tail) {
+                }
+            } else if (handle->Policy == UARTBUF_Policy_Overwrite) {
+                UARTBUF_LOCK(primask);
+                if (next == ring->Tail) {
+                    ring->Tail = UARTBUF_NEXT(ring, ring->Tail);
+                }
+                UARTBUF_UNLOCK(primask);
+                handle->Overflow++;
+            } else {
+                handle->Overflow += Length - i;
+                break;
+            }
+        }
+        ring->Buffer[ring->Head] = Data[i];
+        ring->Head = next;
+    }
+
+    UARTBUF_LOCK(primask);
+    UARTBUF_TxFill(handle);
+    UARTBUF_UNLOCK(primask);
+
+    return i;
+}
+
+/**
+ * @brief  Gives direct access to free room in the transmit ring buffer of a port.
+ * @note   Fill the room and hand it over with UARTPORT_TxCommit(), the data is
+ *         not copied again.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Data: set to the first free byte.
+ * @retval Number of contiguous free bytes at Data, 0 if the port is not started.
+ */
+uint16_t UARTPORT_TxReserve(uint32_t UARTPORT, uint8_t** Data)
+{
+    UARTBUF_RingTypeDef* ring = &UARTBUF_HANDLE(UARTPORT)->Tx;
+    uint16_t head = ring->Head;
+    uint16_t tail = ring->Tail;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    if (UARTBUF_HANDLE(UARTPORT)->Active == 0) {
+        *Data = 0;
+        return 0;
+    }
+
+    *Data = &ring->Buffer[head];
+
+    /* One byte stays free to tell a full ring from an empty one */
+    if (tail > head) {
+        return tail - head - 1;
+    }
+    return (tail == 0) ? (ring->Size - head - 1) : (ring->Size - head);
+}
+
+/**
+ * @brief  Queues bytes written in the room returned by UARTPORT_TxReserve().
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Length: number of bytes, at most what UARTPORT_TxReserve() returned.
+ * @retval None
+ */
+void UARTPORT_TxCommit(uint32_t UARTPORT, uint16_t Length)
+{
+    UARTBUF_HandleTypeDef* handle = UARTBUF_HANDLE(UARTPORT);
+    UARTBUF_RingTypeDef* ring = &handle->Tx;
+    uint32_t primask;
+    uint32_t head;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    head = ring->Head + Length;
+    ring->Head = (head >= ring->Size) ? (head - ring->Size) : head;
+
+    UARTBUF_LOCK(primask);
+    UARTBUF_TxFill(handle);
+    UARTBUF_UNLOCK(primask);
+}
+
+/**
+ * @brief  Copies received bytes out of the receive ring buffer of a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Data: destination buffer.
+ * @param  Length: size of Data.
+ * @retval Number of bytes copied.
+ */
+uint16_t UARTPORT_Read(uint32_t UARTPORT, uint8_t* Data, uint16_t Length)
+{
+    UARTBUF_RingTypeDef* ring = &UARTBUF_HANDLE(UARTPORT)->Rx;
+    uint32_t primask;
+    uint16_t i = 0;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    /* The overwrite policy moves Tail from the interrupt */
+    UARTBUF_LOCK(primask);
+    while ((i < Length) && (ring->Tail != ring->Head)) {
+        Data[i++] = ring->Buffer[ring->Tail];
+        ring->Tail = UARTBUF_NEXT(ring, ring->Tail);
+    }
+    UARTBUF_RxRelease(UARTBUF_HANDLE(UARTPORT));
+    UARTBUF_UNLOCK(primask);
+
+    return i;
+}
+
+/**
+ * @brief  Gives direct access to the oldest received bytes of a port.
+ * @note   The bytes stay in the ring buffer until UARTPORT_RxSkip(). Not to
+ *         be used with UARTBUF_Policy_Overwrite, which moves the oldest byte.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Data: set to the first received byte.
+ * @retval Number of contiguous bytes at Data, the rest follows from the
+ *         start of the ring buffer once these are skipped.
+ */
+uint16_t UARTPORT_RxPeek(uint32_t UARTPORT, uint8_t** Data)
+{
+    UARTBUF_RingTypeDef* ring = &UARTBUF_HANDLE(UARTPORT)->Rx;
+    uint16_t head = ring->Head;
+    uint16_t tail = ring->Tail;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    *Data = &ring->Buffer[tail];
+    return (head >= tail) ? (head - tail) : (ring->Size - tail);
+}
+
+/**
+ * @brief  Removes bytes returned by UARTPORT_RxPeek() from the ring buffer.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Length: number of bytes, at most what UARTPORT_RxPeek() returned.
+ * @retval None
+ */
+void UARTPORT_RxSkip(uint32_t UARTPORT, uint16_t Length)
+{
+    UARTBUF_HandleTypeDef* handle = UARTBUF_HANDLE(UARTPORT);
+    UARTBUF_RingTypeDef* ring = &handle->Rx;
+    uint32_t primask;
+    uint32_t tail;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+    assert_param(Length <= UARTBUF_Count(ring));
+
+    UARTBUF_LOCK(primask);
+    tail = ring->Tail + Length;
+    ring->Tail = (tail >= ring->Size) ? (tail - ring->Size) : tail;
+    UARTBUF_RxRelease(handle);
+    UARTBUF_UNLOCK(primask);
+}
+
+/**
+ * @brief  Queues one byte for transmission on a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @param  Data: byte to send.
+ * @retval Data, or -1 if it was dropped.
+ */
+int UARTPORT_PutChar(uint32_t UARTPORT, uint8_t Data)
+{
+    return (UARTPORT_Write(UARTPORT, &Data, 1) == 1) ? Data : -1;
+}
+
+/**
+ * @brief  Reads one received byte from a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @retval The byte, or -1 if the receive ring buffer is empty.
+ */
+int UARTPORT_GetChar(uint32_t UARTPORT)
+{
+    uint8_t data;
+
+    return (UARTPORT_Read(UARTPORT, &data, 1) == 1) ? data : -1;
+}
+
+/**
+ * @brief  Returns the room left in the transmit ring buffer of a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @retval Number of bytes.
+ */
+uint16_t UARTPORT_GetTxFree(uint32_t UARTPORT)
+{
+    UARTBUF_RingTypeDef* ring = &UARTBUF_HANDLE(UARTPORT)->Tx;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    return ring->Size - 1 - UARTBUF_Count(ring);
+}
+
+/**
+ * @brief  Returns the number of bytes waiting in the receive ring buffer of a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @retval Number of bytes.
+ */
+uint16_t UARTPORT_GetRxCount(uint32_t UARTPORT)
+{
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    return UARTBUF_Count(&UARTBUF_HANDLE(UARTPORT)->Rx);
+}
+
+/**
+ * @brief  Returns the number of bytes lost by a full ring buffer or a
+ *         receive overrun on a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @retval Number of bytes.
+ */
+uint32_t UARTPORT_GetOverflowCount(uint32_t UARTPORT)
+{
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    return UARTBUF_HANDLE(UARTPORT)->Overflow;
+}
+
+/**
+ * @brief  Waits until every queued byte has left the ring buffer of a port.
+ * @note   UART0 and UART1 also wait for the line to be idle. UART2 has no busy
+ *         flag, its last byte may still be shifting out on return.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @retval None
+ */
+void UARTPORT_Flush(uint32_t UARTPORT)
+{
+    UARTBUF_RingTypeDef* ring = &UARTBUF_HANDLE(UARTPORT)->Tx;
+
+    /* Check the parameters */
+    assert_param(IS_UARTPORT(UARTPORT));
+
+    while (ring->Tail != ring->Head) {
+    }
+
+    if (UARTPORT == UARTPORT_2) {
+        while (UART2->SR & S_UART_FLAG_TXF) {
+        }
+    } else {
+        while (UART_GetFlagStatus(UARTBUF_UART(UARTPORT), UART_FLAG_BUSY) == SET) {
+        }
+    }
+}
+
+/**
+ * @brief  Moves data between the UART and the ring buffers of a port.
+ * @param  UARTPORT: UARTPORT_0, UARTPORT_1 or UARTPORT_2.
+ * @retval None
+ */
+void UARTPORT_IRQHandler(uint32_t UARTPORT)
+{
+    UARTBUF_HandleTypeDef* handle = UARTBUF_HANDLE(UARTPORT);
+    UART_TypeDef* UARTx;
+    uint32_t status;
+
+    if (handle->Active == 0) {
+        return;
+    }
+
+    if (UARTPORT == UARTPORT_2) {
+        /* Clear first, a byte arriving while draining raises a new interrupt */
+        status = UART2->INT.ISR;
+        UART2->INT.ICR = status;
+
+        if (status & S_UART_IT_RXI) {
+            while (UART2->SR & S_UART_FLAG_RXF) {
+                UARTBUF_RxPut(handle, (uint8_t) UART2->DR);
+            }
+        }
+
+        if (status & S_UART_IT_RXOI) {
+            UART2->SR = S_UART_FLAG_RXO;
+            handle->Overflow++;
+        }
+
+        if (status & S_UART_IT_TXI) {
+            UARTBUF_TxFill(handle);
+        }
+        return;
+    }
+
+    UARTx = UARTBUF_UART(UARTPORT);
+    status = UARTx->MIS;
+
+    if (status & (UART_IT_RXIM | UART_IT_RTIM)) {
+        while ((UARTx->FR & UART_FR_RXFE) == 0) {
+            if ((handle->Policy == UARTBUF_Policy_Block) && (UARTBUF_NEXT(&handle->Rx, handle->Rx.Head) == handle->Rx.Tail)) {
+                /* Leave the bytes in the FIFO, RTS flow control holds the sender */
+                UARTx->IMSC &= ~(UART_IT_RXIM | UART_IT_RTIM);
+                handle->RxHeld = 1;
+                break;
+            }
+            UARTBUF_RxPut(handle, (uint8_t) UARTx->DR);
+        }
+        UART_ClearITPendingBit(UARTx, UART_IT_RXIM | UART_IT_RTIM);
+    }
+
+    if (status & UART_IT_OEIM) {
+        UART_ClearITPendingBit(UARTx, UART_IT_OEIM);
+        handle->Overflow++;
+    }
+
+    if (status & UART_IT_TXIM) {
+        UARTBUF_TxFill(handle);
+    }
+}
+
+/**
+ * @brief  Starts buffered operation of a UART.
+ * @note   Same as UARTPORT_Init() with UARTPORT_FROM_UART(UARTx).
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  TxBuffer: transmit ring buffer.
+ * @param  TxSize: size of TxBuffer, at least 2.
+ * @param  RxBuffer: receive ring buffer.
+ * @param  RxSize: size of RxBuffer, at least 2.
+ * @retval None
+ */
+void UARTBUF_Init(UART_TypeDef* UARTx, uint8_t* TxBuffer, uint16_t TxSize, uint8_t* RxBuffer, uint16_t RxSize)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    UARTPORT_Init(UARTPORT_FROM_UART(UARTx), TxBuffer, TxSize, RxBuffer, RxSize);
+}
+
+/**
+ * @brief  Stops buffered operation of a UART, pending bytes are discarded.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval None
+ */
+void UARTBUF_DeInit(UART_TypeDef* UARTx)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    UARTPORT_DeInit(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Selects what happens when a ring buffer is full.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  UARTBUF_Policy: overflow policy, see UARTPORT_SetPolicy().
+ * @retval None
+ */
+void UARTBUF_SetPolicy(UART_TypeDef* UARTx, uint32_t UARTBUF_Policy)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    UARTPORT_SetPolicy(UARTPORT_FROM_UART(UARTx), UARTBUF_Policy);
+}
+
+/**
+ * @brief  Queues bytes for transmission.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  Data: bytes to send.
+ * @param  Length: number of bytes.
+ * @retval Number of bytes queued.
+ */
+uint16_t UARTBUF_Write(UART_TypeDef* UARTx, const uint8_t* Data, uint16_t Length)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    return UARTPORT_Write(UARTPORT_FROM_UART(UARTx), Data, Length);
+}
+
+/**
+ * @brief  Copies received bytes out of the receive ring buffer.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  Data: destination buffer.
+ * @param  Length: size of Data.
+ * @retval Number of bytes copied.
+ */
+uint16_t UARTBUF_Read(UART_TypeDef* UARTx, uint8_t* Data, uint16_t Length)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    return UARTPORT_Read(UARTPORT_FROM_UART(UARTx), Data, Length);
+}
+
+/**
+ * @brief  Queues one byte for transmission.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  Data: byte to send.
+ * @retval Data, or -1 if it was dropped.
+ */
+int UARTBUF_PutChar(UART_TypeDef* UARTx, uint8_t Data)
+{
+    return UARTPORT_PutChar(UARTPORT_FROM_UART(UARTx), Data);
+}
+
+/**
+ * @brief  Reads one received byte.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval The byte, or -1 if the receive ring buffer is empty.
+ */
+int UARTBUF_GetChar(UART_TypeDef* UARTx)
+{
+    return UARTPORT_GetChar(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Returns the room left in the transmit ring buffer.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval Number of bytes.
+ */
+uint16_t UARTBUF_GetTxFree(UART_TypeDef* UARTx)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    return UARTPORT_GetTxFree(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Returns the number of bytes waiting in the receive ring buffer.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval Number of bytes.
+ */
+uint16_t UARTBUF_GetRxCount(UART_TypeDef* UARTx)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    return UARTPORT_GetRxCount(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Returns the number of bytes lost by a full ring buffer or a
+ *         receive FIFO overrun.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval Number of bytes.
+ */
+uint32_t UARTBUF_GetOverflowCount(UART_TypeDef* UARTx)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    return UARTPORT_GetOverflowCount(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Waits until every queued byte has been sent on the line.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval None
+ */
+void UARTBUF_Flush(UART_TypeDef* UARTx)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    UARTPORT_Flush(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Moves data between the FIFOs and the ring buffers.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval None
+ */
+void UARTBUF_IRQHandler(UART_TypeDef* UARTx)
+{
+    UARTPORT_IRQHandler(UARTPORT_FROM_UART(UARTx));
+}
+
+/**
+ * @brief  Starts buffered operation of UART2.
+ * @note   Same as UARTPORT_Init() with UARTPORT_2. Call S_UARTBUF_IRQHandler()
+ *         from UART2_Handler.
+ * @param  TxBuffer: transmit ring buffer.
+ * @param  TxSize: size of TxBuffer, at least 2.
+ * @param  RxBuffer: receive ring buffer.
+ * @param  RxSize: size of RxBuffer, at least 2.
+ * @retval None
+ */
+void S_UARTBUF_Init(uint8_t* TxBuffer, uint16_t TxSize, uint8_t* RxBuffer, uint16_t RxSize)
+{
+    UARTPORT_Init(UARTPORT_2, TxBuffer, TxSize, RxBuffer, RxSize);
+}
+
+/**
+ * @brief  Stops buffered operation of UART2, pending bytes are discarded.
+ * @param  None
+ * @retval None
+ */
+void S_UARTBUF_DeInit(void)
+{
+    UARTPORT_DeInit(UARTPORT_2);
+}
+
+/**
+ * @brief  Selects what happens when a UART2 ring buffer is full.
+ * @param  UARTBUF_Policy: overflow policy, see UARTPORT_SetPolicy().
+ * @retval None
+ */
+void S_UARTBUF_SetPolicy(uint32_t UARTBUF_Policy)
+{
+    UARTPORT_SetPolicy(UARTPORT_2, UARTBUF_Policy);
+}
+
+/**
+ * @brief  Queues bytes for transmission on UART2.
+ * @param  Data: bytes to send.
+ * @param  Length: number of bytes.
+ * @retval Number of bytes queued.
+ */
+uint16_t S_UARTBUF_Write(const uint8_t* Data, uint16_t Length)
+{
+    return UARTPORT_Write(UARTPORT_2, Data, Length);
+}
+
+/**
+ * @brief  Copies bytes received on UART2 out of its ring buffer.
+ * @param  Data: destination buffer.
+ * @param  Length: size of Data.
+ * @retval Number of bytes copied.
+ */
+uint16_t S_UARTBUF_Read(uint8_t* Data, uint16_t Length)
+{
+    return UARTPORT_Read(UARTPORT_2, Data, Length);
+}
+
+/**
+ * @brief  Queues one byte for transmission on UART2.
+ * @param  Data: byte to send.
+ * @retval Data, or -1 if it was dropped.
+ */
+int S_UARTBUF_PutChar(uint8_t Data)
+{
+    return UARTPORT_PutChar(UARTPORT_2, Data);
+}
+
+/**
+ * @brief  Reads one byte received on UART2.
+ * @param  None
+ * @retval The byte, or -1 if the receive ring buffer is empty.
+ */
+int S_UARTBUF_GetChar(void)
+{
+    return UARTPORT_GetChar(UARTPORT_2);
+}
+
+/**
+ * @brief  Returns the room left in the UART2 transmit ring buffer.
+ * @param  None
+ * @retval Number of bytes.
+ */
+uint16_t S_UARTBUF_GetTxFree(void)
+{
+    return UARTPORT_GetTxFree(UARTPORT_2);
+}
+
+/**
+ * @brief  Returns the number of bytes waiting in the UART2 receive ring buffer.
+ * @param  None
+ * @retval Number of bytes.
+ */
+uint16_t S_UARTBUF_GetRxCount(void)
+{
+    return UARTPORT_GetRxCount(UARTPORT_2);
+}
+
+/**
+ * @brief  Returns the number of bytes lost on UART2.
+ * @param  None
+ * @retval Number of bytes.
+ */
+uint32_t S_UARTBUF_GetOverflowCount(void)
+{
+    return UARTPORT_GetOverflowCount(UARTPORT_2);
+}
+
+/**
+ * @brief  Waits until every byte queued on UART2 has been handed to the UART.
+ * @param  None
+ * @retval None
+ */
+void S_UARTBUF_Flush(void)
+{
+    UARTPORT_Flush(UARTPORT_2);
+}
+
+/**
+ * @brief  Moves data between UART2 and its ring buffers.
+ * @param  None
+ * @retval None
+ */
+void S_UARTBUF_IRQHandler(void)
+{
+    UARTPORT_IRQHandler(UARTPORT_2);
+}
+
+/* Fills the transmit FIFO, the TX interrupt stays on while bytes are queued */
+static void UARTBUF_TxFill(UARTBUF_HandleTypeDef* handle)
+{
+    UARTBUF_RingTypeDef* ring = &handle->Tx;
+    UART_TypeDef* UARTx;
+
+    if (handle->Port == UARTPORT_2) {
+        /* UART2 interrupts when its one byte buffer empties */
+        while ((ring->Tail != ring->Head) && ((UART2->SR & S_UART_FLAG_TXF) == 0)) {
+            UART2->DR = ring->Buffer[ring->Tail];
+            ring->Tail = UARTBUF_NEXT(ring, ring->Tail);
+        }
+
+        if (ring->Tail != ring->Head) {
+            UART2->CR |= S_UART_CTRL_FLAG_TXI;
+        } else {
+            UART2->CR &= ~S_UART_CTRL_FLAG_TXI;
+        }
+        return;
+    }
+
+    UARTx = UARTBUF_UART(handle->Port);
+    while ((ring->Tail != ring->Head) && ((UARTx->FR & UART_FR_TXFF) == 0)) {
+        UARTx->DR = ring->Buffer[ring->Tail];
+        ring->Tail = UARTBUF_NEXT(ring, ring->Tail);
+    }
+
+    if (ring->Tail != ring->Head) {
+        UARTx->IMSC |= UART_IT_TXIM;
+    } else {
+        UARTx->IMSC &= ~UART_IT_TXIM;
+    }
+}
+
+static void UARTBUF_RxPut(UARTBUF_HandleTypeDef* handle, uint8_t Data)
+{
+    UARTBUF_RingTypeDef* ring = &handle->Rx;
+    uint16_t next = UARTBUF_NEXT(ring, ring->Head);
+
+    if (next == ring->Tail) {
+        handle->Overflow++;
+        if (handle->Policy != UARTBUF_Policy_Overwrite) {
+            return;
+        }
+        ring->Tail = UARTBUF_NEXT(ring, ring->Tail);
+    }
+
+    ring->Buffer[ring->Head] = Data;
+    ring->Head = next;
+}
+
+/* Resumes reception held by UARTBUF_Policy_Block, called with interrupts disabled */
+static void UARTBUF_RxRelease(UARTBUF_HandleTypeDef* handle)
+{
+    UARTBUF_RingTypeDef* ring = &handle->Rx;
+
+    if (handle->RxHeld && (UARTBUF_NEXT(ring, ring->Head) != ring->Tail)) {
+        handle->RxHeld = 0;
+        UARTBUF_UART(handle->Port)->IMSC |= UART_IT_RXIM | UART_IT_RTIM;
+    }
+}
+
+static uint16_t UARTBUF_Count(UARTBUF_RingTypeDef* ring)
+{
+    uint16_t head = ring->Head;
+    uint16_t tail = ring->Tail;
+
+    return (head >= tail) ? (head - tail) : (ring->Size - tail + head);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
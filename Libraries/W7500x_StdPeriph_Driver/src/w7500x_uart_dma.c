@@ -0,0 +1,489 @@
+/**
+ ******************************************************************************
+ * @file    w7500x_uart_dma.c
+ * @author  WIZnet
+ * @brief   This file provides firmware functions to stream data through
+ *          UART0 and UART1 with the DMA controller:
+ *           + Buffer transmission completed by interrupt
+ *           + Continuous reception in a circular buffer (ping-pong cycle)
+ *           + Idle and receive timeout detection to flush partial data
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; COPYRIGHT 2018 WIZnet</center></h2>
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_uart_dma.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @defgroup UARTDMA
+ * @brief UART DMA streaming driver modules
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    UART_TypeDef* UARTx;
+    uint32_t TxChannel;
+    uint32_t RxChannel;
+    UARTDMA_CallbackTypeDef Callback;
+
+    const uint8_t* TxPtr;
+    __IO uint32_t TxLeft;
+    __IO uint8_t TxBusy;
+
+    uint8_t* RxBuffer;
+    uint16_t RxSize;
+    uint16_t RxHalf;
+    __IO uint32_t RxHalves;             /* Number of halves filled since the start */
+    uint32_t RxRead;                    /* Number of bytes read since the start    */
+    uint32_t RxLast;
+    uint32_t RxIdleMark;
+    uint8_t RxIdleTicks;
+} UARTDMA_HandleTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define UARTDMA_NUM                 2
+
+/* Private macro -------------------------------------------------------------*/
+#define UARTDMA_HANDLE(UARTx)       (&UARTDMA_Handle[((UARTx) == UART0) ? 0 : 1])
+
+/* Private variables ---------------------------------------------------------*/
+static UARTDMA_HandleTypeDef UARTDMA_Handle[UARTDMA_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+static void UARTDMA_DMACallback(uint32_t DMA_Channel, uint32_t DMA_Event);
+static void UARTDMA_TxNext(UARTDMA_HandleTypeDef* handle);
+static void UARTDMA_RxArm(UARTDMA_HandleTypeDef* handle, uint32_t DMA_Desc);
+static void UARTDMA_RxStart(UARTDMA_HandleTypeDef* handle);
+static uint32_t UARTDMA_RxProduced(UARTDMA_HandleTypeDef* handle);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** @defgroup UARTDMA_Private_Functions
+ * @{
+ */
+
+/**
+ * @brief  Starts DMA streaming on a UART.
+ * @note   The UART must be initialized and enabled first, preferably with its
+ *         FIFOs enabled. The DMA channels are given by the DMA_Channel_UARTx_TX/RX
+ *         mapping; UART0 and UART1 share them by default so only one of them can
+ *         stream at a time. Enable the UARTx and DMA interrupts in the NVIC and
+ *         call UARTDMA_IRQHandler() from UARTx_Handler and DMA_IRQHandler()
+ *         from DMA_Handler.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  RxBuffer: circular receive buffer, or 0 for transmit only.
+ * @param  RxSize: size of RxBuffer, even and up to 2048 bytes.
+ * @param  Callback: event callback, may be 0.
+ * @retval None
+ */
+void UARTDMA_Init(UART_TypeDef* UARTx, uint8_t* RxBuffer, uint16_t RxSize, UARTDMA_CallbackTypeDef Callback)
+{
+    UARTDMA_HandleTypeDef* handle = UARTDMA_HANDLE(UARTx);
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+    assert_param((RxBuffer == 0) || IS_UARTDMA_RX_SIZE(RxSize));
+
+    handle->UARTx = UARTx;
+    handle->TxChannel = (UARTx == UART0) ? DMA_Channel_UART0_TX : DMA_Channel_UART1_TX;
+    handle->RxChannel = (UARTx == UART0) ? DMA_Channel_UART0_RX : DMA_Channel_UART1_RX;
+    handle->Callback = Callback;
+    handle->TxBusy = 0;
+    handle->TxLeft = 0;
+    handle->RxBuffer = RxBuffer;
+    handle->RxSize = RxSize;
+    handle->RxHalf = RxSize / 2;
+
+    DMA_Cmd(ENABLE);
+    DMA_SetCallback(handle->TxChannel, UARTDMA_DMACallback);
+
+    if (RxBuffer != 0) {
+        DMA_SetCallback(handle->RxChannel, UARTDMA_DMACallback);
+        UARTDMA_RxStart(handle);
+
+        UART_ClearITPendingBit(UARTx, UART_IT_RTIM | UART_IT_OEIM);
+        UART_ITConfig(UARTx, UART_IT_RTIM | UART_IT_OEIM, ENABLE);
+        UART_DMACmd(UARTx, UART_DMAControl_RXDMAE, ENABLE);
+    }
+}
+
+/**
+ * @brief  Stops DMA streaming on a UART.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval None
+ */
+void UARTDMA_DeInit(UART_TypeDef* UARTx)
+{
+    UARTDMA_HandleTypeDef* handle = UARTDMA_HANDLE(UARTx);
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    UART_DMACmd(UARTx, UART_DMAControl_RXDMAE | UART_DMAControl_TXDMAE, DISABLE);
+    UART_ITConfig(UARTx, UART_IT_RTIM | UART_IT_OEIM, DISABLE);
+
+    DMA_ChannelCmd(handle->TxChannel, DISABLE);
+    DMA_SetCallback(handle->TxChannel, 0);
+    if (handle->RxBuffer != 0) {
+        DMA_ChannelCmd(handle->RxChannel, DISABLE);
+        DMA_SetCallback(handle->RxChannel, 0);
+    }
+
+    handle->UARTx = 0;
+    handle->RxBuffer = 0;
+    handle->TxBusy = 0;
+}
+
+/**
+ * @brief  Starts the transmission of a buffer.
+ * @note   The buffer must stay valid until UARTDMA_Event_TxDone.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  Buffer: data to send.
+ * @param  Length: number of bytes to send.
+ * @retval SUCCESS if the transmission is started, ERROR if one is in progress.
+ */
+ErrorStatus UARTDMA_Transmit(UART_TypeDef* UARTx, const uint8_t* Buffer, uint32_t Length)
+{
+    UARTDMA_HandleTypeDef* handle = UARTDMA_HANDLE(UARTx);
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    if ((Length == 0) || handle->TxBusy) {
+        return ERROR;
+    }
+
+    handle->TxPtr = Buffer;
+    handle->TxLeft = Length;
+    handle->TxBusy = 1;
+
+    UARTDMA_TxNext(handle);
+    UART_DMACmd(UARTx, UART_DMAControl_TXDMAE, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief  Checks whether a transmission is in progress.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval SET while the DMA is still feeding the transmit FIFO.
+ */
+FlagStatus UARTDMA_GetTxStatus(UART_TypeDef* UARTx)
+{
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    return UARTDMA_HANDLE(UARTx)->TxBusy ? SET : RESET;
+}
+
+/**
+ * @brief  Returns the number of received bytes not read yet.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval Number of bytes available.
+ */
+uint16_t UARTDMA_Available(UART_TypeDef* UARTx)
+{
+    UARTDMA_HandleTypeDef* handle = UARTDMA_HANDLE(UARTx);
+    uint32_t avail;
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    if (handle->RxBuffer == 0) {
+        return 0;
+    }
+
+    avail = UARTDMA_RxProduced(handle) - handle->RxRead;
+    return (avail > handle->RxSize) ? handle->RxSize : (uint16_t) avail;
+}
+
+/**
+ * @brief  Copies received bytes out of the circular buffer.
+ * @note   If the DMA has wrapped over unread data, the pending data is dropped
+ *         and 0 is returned.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @param  Buffer: destination buffer.
+ * @param  Length: size of Buffer.
+ * @retval Number of bytes copied.
+ */
+uint16_t UARTDMA_Read(UART_TypeDef* UARTx, uint8_t* Buffer, uint16_t Length)
+{
+    UARTDMA_HandleTypeDef* handle = UARTDMA_HANDLE(UARTx);
+    uint32_t produced, avail, pos, count, i;
+
+    /* Check the parameters */
+    assert_param(IS_UART_PERIPH(UARTx));
+
+    if (handle->RxBuffer == 0) {
+        return 0;
+    }
+
+    produced = UARTDMA_RxProduced(handle);
+    avail = produced - handle->RxRead;
+    if (avail > handle->RxSize) {
+        handle->RxRead = produced;
+        return 0;
+    }
+
+    count = (avail < Length) ? avail : Length;
+    pos = handle->RxRead % handle->RxSize;
+    for (i = 0; i < count; i++) {
+        Buffer[i] = handle->RxBuffer[pos];
+        if (++pos == handle->RxSize) {
+            pos = 0;
+        }
+    }
+    handle->RxRead += count;
+
+    return (uint16_t) count;
+}
+
+/**
+ * @brief  Handles the receive timeout and overrun interrupts of a streaming UART.
+ * @param  UARTx: where x can be from 0 to 1 to select the UART peripheral.
+ *          This parameter can be one of the following values:
+ *            @arg UART0
+ *            @arg UART1
+ * @retval None
+ */
+void UARTDMA_IRQHandler(UART_TypeDef* UARTx)
+{
+    UARTDMA_HandleTypeDef* handle = UARTDMA_HANDLE(UARTx);
+    uint32_t event = 0;
+
+    if (UART_GetITStatus(UARTx, UART_IT_RTIM) == SET) {
+        UART_ClearITPendingBit(UARTx, UART_IT_RTIM);
+        event |= UARTDMA_Event_RxIdle;
+    }
+    if (UART_GetITStatus(UARTx, UART_IT_OEIM) == SET) {
+        UART_ClearITPendingBit(UARTx, UART_IT_OEIM);
+        event |= UARTDMA_Event_RxOverrun;
+    }
+
+    if (event && handle->Callback) {
+        handle->Callback(UARTx, event);
+    }
+}
+
+/**
+ * @brief  Detects the end of a reception burst.
+ * @note   Call this function from a periodic timer. An idle event is reported
+ *         once when no byte has been received for UARTDMA_IDLE_TICKS ticks,
+ *         which flushes frames shorter than half of the receive buffer.
+ * @param  None
+ * @retval None
+ */
+void UARTDMA_TimeHandler(void)
+{
+    UARTDMA_HandleTypeDef* handle;
+    uint32_t produced, i;
+
+    for (i = 0; i < UARTDMA_NUM; i++) {
+        handle = &UARTDMA_Handle[i];
+        if (handle->RxBuffer == 0) {
+            continue;
+        }
+
+        produced = UARTDMA_RxProduced(handle);
+        if (produced != handle->RxLast) {
+            handle->RxLast = produced;
+            handle->RxIdleTicks = 0;
+        } else if ((produced != handle->RxIdleMark) && (++handle->RxIdleTicks >= UARTDMA_IDLE_TICKS)) {
+            handle->RxIdleMark = produced;
+            if (handle->Callback) {
+                handle->Callback(handle->UARTx, UARTDMA_Event_RxIdle);
+            }
+        }
+    }
+}
+
+static void UARTDMA_DMACallback(uint32_t DMA_Channel, uint32_t DMA_Event)
+{
+    UARTDMA_HandleTypeDef* handle;
+    uint32_t event, desc, i;
+
+    for (i = 0; i < UARTDMA_NUM; i++) {
+        handle = &UARTDMA_Handle[i];
+        if (handle->UARTx == 0) {
+            continue;
+        }
+        event = 0;
+
+        if ((DMA_Channel == handle->TxChannel) && handle->TxBusy) {
+            if (DMA_Event & DMA_Event_Error) {
+                handle->TxBusy = 0;
+                event |= UARTDMA_Event_Error;
+            } else if (DMA_Event & DMA_Event_Done) {
+                if (handle->TxLeft) {
+                    UARTDMA_TxNext(handle);
+                } else {
+                    handle->TxBusy = 0;
+                    UART_DMACmd(handle->UARTx, UART_DMAControl_TXDMAE, DISABLE);
+                    event |= UARTDMA_Event_TxDone;
+                }
+            }
+        }
+
+        if ((DMA_Channel == handle->RxChannel) && (handle->RxBuffer != 0)) {
+            /* The halves complete in order: primary after an even count */
+            for (desc = 0; desc < 2; desc++) {
+                if ((handle->RxHalves & 1) == 0) {
+                    if ((DMA_Event & DMA_Event_PrimaryDone) == 0) {
+                        break;
+                    }
+                    DMA_Event &= ~DMA_Event_PrimaryDone;
+                    UARTDMA_RxArm(handle, DMA_Desc_Primary);
+                } else {
+                    if ((DMA_Event & DMA_Event_AlternateDone) == 0) {
+                        break;
+                    }
+                    DMA_Event &= ~DMA_Event_AlternateDone;
+                    UARTDMA_RxArm(handle, DMA_Desc_Alternate);
+                }
+                handle->RxHalves++;
+                event |= UARTDMA_Event_RxHalf;
+            }
+
+            /* The half now being written still holds unread data */
+            if ((int32_t) ((handle->RxHalves * handle->RxHalf) - handle->RxRead) > (int32_t) handle->RxHalf) {
+                event |= UARTDMA_Event_RxOverrun;
+            }
+
+            /* Both halves filled before they were re-armed: the cycle stopped */
+            if (DMA_Event & (DMA_Event_Done | DMA_Event_Error)) {
+                event |= (DMA_Event & DMA_Event_Error) ? UARTDMA_Event_Error : UARTDMA_Event_RxOverrun;
+                UARTDMA_RxStart(handle);
+            }
+        }
+
+        if (event && handle->Callback) {
+            handle->Callback(handle->UARTx, event);
+        }
+    }
+}
+
+static void UARTDMA_TxNext(UARTDMA_HandleTypeDef* handle)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+    uint32_t count = (handle->TxLeft > DMA_MAX_TRANSFER) ? DMA_MAX_TRANSFER : handle->TxLeft;
+
+    DMA_InitStructure.DMA_SrcAddr = (uint32_t) handle->TxPtr;
+    DMA_InitStructure.DMA_DstAddr = (uint32_t) &handle->UARTx->DR;
+    DMA_InitStructure.DMA_SrcInc = DMA_Inc_Byte;
+    DMA_InitStructure.DMA_DstInc = DMA_Inc_None;
+    DMA_InitStructure.DMA_DataSize = DMA_DataSize_Byte;
+    DMA_InitStructure.DMA_Arbitration = DMA_Arbitration_1;
+    DMA_InitStructure.DMA_BufferSize = count;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Basic;
+    DMA_Init(handle->TxChannel, &DMA_InitStructure);
+
+    handle->TxPtr += count;
+    handle->TxLeft -= count;
+
+    DMA_ChannelCmd(handle->TxChannel, ENABLE);
+}
+
+static void UARTDMA_RxArm(UARTDMA_HandleTypeDef* handle, uint32_t DMA_Desc)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_InitStructure.DMA_SrcAddr = (uint32_t) &handle->UARTx->DR;
+    DMA_InitStructure.DMA_DstAddr = (uint32_t) handle->RxBuffer + ((DMA_Desc == DMA_Desc_Alternate) ? handle->RxHalf : 0);
+    DMA_InitStructure.DMA_SrcInc = DMA_Inc_None;
+    DMA_InitStructure.DMA_DstInc = DMA_Inc_Byte;
+    DMA_InitStructure.DMA_DataSize = DMA_DataSize_Byte;
+    DMA_InitStructure.DMA_Arbitration = DMA_Arbitration_1;
+    DMA_InitStructure.DMA_BufferSize = handle->RxHalf;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_PingPong;
+
+    DMA_SetDescriptor(handle->RxChannel, DMA_Desc, &DMA_InitStructure);
+}
+
+static void UARTDMA_RxStart(UARTDMA_HandleTypeDef* handle)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_ChannelCmd(handle->RxChannel, DISABLE);
+
+    /* Select the primary structure again */
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Stop;
+    DMA_Init(handle->RxChannel, &DMA_InitStructure);
+
+    handle->RxHalves = 0;
+    handle->RxRead = 0;
+    handle->RxLast = 0;
+    handle->RxIdleMark = 0;
+    handle->RxIdleTicks = 0;
+
+    UARTDMA_RxArm(handle, DMA_Desc_Primary);
+    UARTDMA_RxArm(handle, DMA_Desc_Alternate);
+
+    DMA_ChannelCmd(handle->RxChannel, ENABLE);
+}
+
+static uint32_t UARTDMA_RxProduced(UARTDMA_HandleTypeDef* handle)
+{
+    uint32_t halves = handle->RxHalves;
+    uint32_t active = DMA_GetActiveDescriptor(handle->RxChannel);
+
+    /* The controller moved to the next half before the interrupt was served */
+    if (active != ((halves & 1) ? DMA_Desc_Alternate : DMA_Desc_Primary)) {
+        halves++;
+    }
+
+    return (halves * handle->RxHalf) + (handle->RxHalf - DMA_GetRemaining(handle->RxChannel, active));
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************** (C) COPYRIGHT WIZnet *****END OF FILE********************/
@@ -0,0 +1,144 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "binlog.h"
+
+#define BINLOG_MASK			(BINLOG_RING_WORDS - 1)
+#define BINLOG_TICK_MASK	0x0FFFFFFF
+
+/* Largest UDP payload sent at once, keeps the datagram in one Ethernet frame */
+#define BINLOG_SEND_MAX		1472
+
+static uint32_t bl_ring[BINLOG_RING_WORDS];
+static volatile uint32_t bl_head;		/* Written by binlog_write() only */
+static volatile uint32_t bl_tail;		/* Written by the consumer only   */
+static volatile uint32_t bl_tick = 0;
+static volatile uint32_t bl_dropped;
+
+void binlog_init(void)
+{
+   bl_head = 0;
+   bl_tail = 0;
+   bl_dropped = 0;
+}
+
+int8_t binlog_write(const char* fmt, uint8_t nargs, const uint32_t* args)
+{
+   uint32_t primask, head, need, i;
+
+   /* BINLOG() refuses these at compile time, direct callers get the record dropped */
+   if(nargs > BINLOG_MAX_ARGS)
+   {
+      bl_dropped++;
+      return -1;
+   }
+   need = BINLOG_HDR_WORDS + nargs;
+
+   /* Records may come from interrupts : reserve and fill with them masked */
+   primask = __get_PRIMASK();
+   __disable_irq();
+   head = bl_head;
+   if(head - bl_tail + need > BINLOG_RING_WORDS)
+   {
+      bl_dropped++;
+      __set_PRIMASK(primask);
+      return -1;
+   }
+   bl_ring[head & BINLOG_MASK] = ((uint32_t)nargs << 28) | (bl_tick & BINLOG_TICK_MASK);
+   bl_ring[(head + 1) & BINLOG_MASK] = (uint32_t)fmt;
+   for(i = 0; i < nargs; i++)
+      bl_ring[(head + BINLOG_HDR_WORDS + i) & BINLOG_MASK] = args[i];
+   bl_head = head + need;
+   __set_PRIMASK(primask);
+
+   return 0;
+}
+
+void binlog_time_handler(void)
+{
+   bl_tick++;
+}
+
+uint16_t binlog_run(uint16_t max)
+{
+   uint32_t a[BINLOG_MAX_ARGS];
+   uint32_t tail, hdr, nargs, i;
+   const char* fmt;
+   uint16_t n = 0;
+
+   while(n < max && bl_tail != bl_head)
+   {
+      tail = bl_tail;
+      hdr = bl_ring[tail & BINLOG_MASK];
+      nargs = hdr >> 28;
+      fmt = (const char*)bl_ring[(tail + 1) & BINLOG_MASK];
+      for(i = 0; i < BINLOG_MAX_ARGS; i++)
+         a[i] = (i < nargs) ? bl_ring[(tail + BINLOG_HDR_WORDS + i) & BINLOG_MASK] : 0;
+      bl_tail = tail + BINLOG_HDR_WORDS + nargs;
+
+      /* Every argument is passed as a 32-bit word, unused ones are ignored by printf */
+      printf("[%lu] ", (unsigned long)(hdr & BINLOG_TICK_MASK));
+      printf(fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+      n++;
+   }
+   return n;
+}
+
+int32_t binlog_send(uint8_t sn, uint8_t* ip, uint16_t port)
+{
+   uint32_t rec[BINLOG_HDR_WORDS + BINLOG_MAX_ARGS];
+   uint32_t tail = bl_tail;
+   uint32_t head = bl_head;
+   uint32_t end, words, len, i;
+   int32_t ret;
+
+   if(tail == head) return 0;
+
+   len = BINLOG_HDR_WORDS + (bl_ring[tail & BINLOG_MASK] >> 28);
+   if((tail & BINLOG_MASK) + len > BINLOG_RING_WORDS)
+   {
+      /* The first record wraps around the end of the ring, send it alone */
+      for(i = 0; i < len; i++) rec[i] = bl_ring[(tail + i) & BINLOG_MASK];
+      ret = sendto(sn, (uint8_t*)rec, len * 4, ip, port);
+      words = len;
+   }
+   else
+   {
+      /* Whole records up to the end of the ring or the datagram size */
+      end = tail;
+      words = 0;
+      while(end != head)
+      {
+         len = BINLOG_HDR_WORDS + (bl_ring[end & BINLOG_MASK] >> 28);
+         if((tail & BINLOG_MASK) + words + len > BINLOG_RING_WORDS) break;
+         if((words + len) * 4 > BINLOG_SEND_MAX) break;
+         words += len;
+         end += len;
+      }
+      ret = sendto(sn, (uint8_t*)&bl_ring[tail & BINLOG_MASK], words * 4, ip, port);
+   }
+
+   if(ret < 0) return ret;
+   bl_tail = tail + words;
+#ifdef _BINLOG_DEBUG_
+   printf("%d:Binlog sent %lu words\r\n", sn, (unsigned long)words);
+#endif
+   return ret;
+}
+
+uint32_t binlog_get_dropped(void)
+{
+   return bl_dropped;
+}
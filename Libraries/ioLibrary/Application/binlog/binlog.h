@@ -0,0 +1,73 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _BINLOG_H_
+#define _BINLOG_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "W7500x_wztoe.h"
+
+
+/* Binlog debug message printout enable */
+//#define _BINLOG_DEBUG_
+
+/* Size of the record ring in 32-bit words, must be a power of 2 */
+#ifndef BINLOG_RING_WORDS
+	#define BINLOG_RING_WORDS		256
+#endif
+
+/* Maximum number of arguments of one record */
+#define BINLOG_MAX_ARGS				6
+
+/* Record layout in the ring, one 32-bit word each :
+ *   [0] nargs (4 bits) << 28 | tick (28 bits)
+ *   [1] address of the format string, it identifies the string in the ELF (.rodata)
+ *   [2..] the arguments, as 32-bit values
+ * binlog_send() ships records unchanged (little-endian) so that a host tool
+ * can look the format strings up in the ELF and do the formatting. */
+#define BINLOG_HDR_WORDS			2
+
+/* Record a log entry. fmt must be a string literal, the arguments integers
+ * (%d %u %x %c) or pointers to constant strings (%s) cast to uint32_t.
+ * Only the format address and raw arguments are stored; no formatting is done here.
+ * More than BINLOG_MAX_ARGS arguments is a compile error (negative array size).
+ * The _binlog_fmt symbols give the host decoder its string table, see Tests/Host/binlog_decode.c. */
+#define BINLOG(fmt, ...) \
+	do { \
+		static const char _binlog_fmt[] = fmt; \
+		const uint32_t _binlog_args[] = { 0, ##__VA_ARGS__ }; \
+		(void)sizeof(char[(sizeof(_binlog_args) / sizeof(uint32_t) - 1 <= BINLOG_MAX_ARGS) ? 1 : -1]); \
+		binlog_write(_binlog_fmt, (uint8_t)(sizeof(_binlog_args) / sizeof(uint32_t) - 1), &_binlog_args[1]); \
+	} while(0)
+
+void     binlog_init(void);
+
+/* Append one record, called by BINLOG(). Safe from interrupts.
+ * Returns 0, or -1 if the ring is full or nargs exceeds BINLOG_MAX_ARGS and the record is dropped. */
+int8_t   binlog_write(const char* fmt, uint8_t nargs, const uint32_t* args);
+
+/* Tick stored in the records, call from a timer interrupt */
+void     binlog_time_handler(void);
+
+/* Low priority task : format and printf up to max records. Returns the number printed. */
+uint16_t binlog_run(uint16_t max);
+
+/* Send the pending records as they are in one UDP datagram to the host decoder.
+ * Returns the number of bytes sent, 0 if there is nothing to send, or a socket error. */
+int32_t  binlog_send(uint8_t sn, uint8_t* ip, uint16_t port);
+
+/* Number of records dropped because the ring was full */
+uint32_t binlog_get_dropped(void);
+
+#endif
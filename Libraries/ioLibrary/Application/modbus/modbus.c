@@ -0,0 +1,523 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "modbus.h"
+#include "wizchip_conf.h"
+#include "w7500x_uart_buf.h"
+
+/* Silence ending an RTU frame : 3.5 characters of 11 bits, fixed to 1750us above 19200 bit/s */
+#define MODBUS_T35_US(BAUD)		(((BAUD) > 19200) ? 1750 : (38500000UL / (BAUD)))
+#define MODBUS_CHAR_US(BAUD)	(11000000UL / (BAUD))
+#define MODBUS_TICKS(MS)		(((uint32_t)(MS) * 1000 + MODBUS_TICK_US - 1) / MODBUS_TICK_US)
+
+#define MODBUS_SRC_NONE			0xFE	/* Client gone, the response is dropped */
+#define MODBUS_SRC_APP			0xFF	/* modbus_request() */
+
+#define MODBUS_EX_DEVICE_BUSY	0x06
+
+typedef struct
+{
+   uint8_t  src;			/* Socket of the TCP client, MODBUS_SRC_APP or MODBUS_SRC_NONE */
+   uint8_t  unit;
+   uint16_t tid;			/* MBAP transaction ID of the TCP client */
+   uint16_t len;
+   modbus_cbfunc cb;
+   void*    arg;
+   uint8_t  pdu[MODBUS_MAX_PDU];
+} mb_request;
+
+typedef enum
+{
+   MB_RTU_IDLE = 0,
+   MB_RTU_WAIT				/* Request sent, waiting for the response or the turnaround */
+} mb_rtu_state;
+
+static const uint16_t mb_crc_table[256] = {
+   0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+   0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+   0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+   0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+   0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+   0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+   0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+   0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+   0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+   0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+   0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+   0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+   0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+   0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+   0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+   0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+   0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+   0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+   0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+   0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+   0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+   0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+   0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+   0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+   0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+   0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+   0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+   0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+   0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+   0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+   0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+   0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+static const wiz_ModbusMap* mb_map;
+
+/* RTU side */
+static uint8_t  mb_rtu_on;
+static uint32_t mb_uart;
+static uint8_t  mb_slave_id;			/* 0 : master */
+static uint16_t mb_t35;					/* Ticks of silence ending a frame */
+static mb_rtu_state mb_state;
+static volatile uint16_t mb_rx_last;
+static volatile uint16_t mb_idle;		/* Ticks without a new byte */
+static volatile uint32_t mb_wait;		/* Ticks left for the response or the turnaround */
+static uint8_t  mb_adu[MODBUS_MAX_ADU];
+
+/* Requests for the RTU master */
+static mb_request mb_queue[MODBUS_QUEUE_SIZE];
+static uint8_t mb_q_head;
+static uint8_t mb_q_tail;
+static uint8_t mb_q_count;
+
+/* TCP server */
+static uint8_t  mb_tcp_sn;
+static uint8_t  mb_tcp_count;
+static uint16_t mb_tcp_port;
+static uint8_t  mb_tcp_unit;
+static uint8_t  mb_mbap[MODBUS_TCP_MAX_SOCK][MODBUS_MBAP_LEN];
+static uint8_t  mb_mbap_ok[MODBUS_TCP_MAX_SOCK];
+static uint8_t  mb_tcp_buf[MODBUS_MBAP_LEN + MODBUS_MAX_PDU];
+
+static uint8_t  mb_pdu[MODBUS_MAX_PDU];
+static uint8_t  mb_rsp[MODBUS_MAX_PDU];
+
+uint16_t modbus_crc16(const uint8_t* buf, uint16_t len)
+{
+   uint16_t crc = 0xFFFF;
+
+   while(len--) crc = (crc >> 8) ^ mb_crc_table[(crc ^ *buf++) & 0xFF];
+   return crc;
+}
+
+static uint16_t mb_exception(uint8_t fc, uint8_t ex, uint8_t* rsp)
+{
+   rsp[0] = fc | 0x80;
+   rsp[1] = ex;
+   return 2;
+}
+
+/* Answer a request PDU from the local data model, returns the response length */
+static uint16_t mb_process(const uint8_t* req, uint16_t len, uint8_t* rsp)
+{
+   uint8_t  fc = req[0];
+   uint8_t  ex = 0, bit;
+   uint16_t addr, qty, val, i;
+
+   if(mb_map == NULL) return mb_exception(fc, MODBUS_EX_GATEWAY_PATH, rsp);
+   if(len < 5) return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+
+   addr = ((uint16_t)req[1] << 8) | req[2];
+   qty  = ((uint16_t)req[3] << 8) | req[4];
+
+   switch(fc)
+   {
+      case 0x01 :
+      case 0x02 :
+         if(mb_map->read_bit == NULL) return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+         if(len != 5 || qty == 0 || qty > 2000) return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+         if((uint32_t)addr + qty > 0x10000) return mb_exception(fc, MODBUS_EX_ILLEGAL_ADDRESS, rsp);
+         rsp[1] = (qty + 7) / 8;
+         memset(&rsp[2], 0, rsp[1]);
+         for(i = 0; i < qty && ex == 0; i++)
+         {
+            bit = 0;
+            ex = mb_map->read_bit(fc, addr + i, &bit);
+            if(bit) rsp[2 + i / 8] |= 1 << (i % 8);
+         }
+         if(ex) return mb_exception(fc, ex, rsp);
+         rsp[0] = fc;
+         return 2 + rsp[1];
+      case 0x03 :
+      case 0x04 :
+         if(mb_map->read_reg == NULL) return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+         if(len != 5 || qty == 0 || qty > 125) return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+         if((uint32_t)addr + qty > 0x10000) return mb_exception(fc, MODBUS_EX_ILLEGAL_ADDRESS, rsp);
+         for(i = 0; i < qty && ex == 0; i++)
+         {
+            val = 0;
+            ex = mb_map->read_reg(fc, addr + i, &val);
+            rsp[2 + 2 * i] = val >> 8;
+            rsp[3 + 2 * i] = val & 0xFF;
+         }
+         if(ex) return mb_exception(fc, ex, rsp);
+         rsp[0] = fc;
+         rsp[1] = qty * 2;
+         return 2 + rsp[1];
+      case 0x05 :
+         if(mb_map->write_bit == NULL) return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+         if(len != 5 || (qty != 0xFF00 && qty != 0x0000)) return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+         ex = mb_map->write_bit(addr, qty != 0);
+         break;
+      case 0x06 :
+         if(mb_map->write_reg == NULL) return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+         if(len != 5) return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+         ex = mb_map->write_reg(addr, qty);
+         break;
+      case 0x0F :
+         if(mb_map->write_bit == NULL) return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+         if(len < 6 || qty == 0 || qty > 0x7B0 || req[5] != (qty + 7) / 8 || len != 6 + req[5])
+            return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+         if((uint32_t)addr + qty > 0x10000) return mb_exception(fc, MODBUS_EX_ILLEGAL_ADDRESS, rsp);
+         for(i = 0; i < qty && ex == 0; i++)
+            ex = mb_map->write_bit(addr + i, (req[6 + i / 8] >> (i % 8)) & 1);
+         break;
+      case 0x10 :
+         if(mb_map->write_reg == NULL) return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+         if(len < 6 || qty == 0 || qty > 123 || req[5] != qty * 2 || len != 6 + req[5])
+            return mb_exception(fc, MODBUS_EX_ILLEGAL_VALUE, rsp);
+         if((uint32_t)addr + qty > 0x10000) return mb_exception(fc, MODBUS_EX_ILLEGAL_ADDRESS, rsp);
+         for(i = 0; i < qty && ex == 0; i++)
+            ex = mb_map->write_reg(addr + i, ((uint16_t)req[6 + 2 * i] << 8) | req[7 + 2 * i]);
+         break;
+      default :
+         return mb_exception(fc, MODBUS_EX_ILLEGAL_FUNCTION, rsp);
+   }
+
+   if(ex) return mb_exception(fc, ex, rsp);
+   /* Write requests are answered with their first five bytes */
+   memcpy(rsp, req, 5);
+   return 5;
+}
+
+static void mb_rtu_send(uint8_t unit, const uint8_t* pdu, uint16_t len)
+{
+   uint16_t crc;
+
+   mb_adu[0] = unit;
+   memcpy(&mb_adu[1], pdu, len);
+   crc = modbus_crc16(mb_adu, len + 1);
+   mb_adu[len + 1] = crc & 0xFF;
+   mb_adu[len + 2] = crc >> 8;
+   UARTPORT_Write(mb_uart, mb_adu, len + 3);
+}
+
+/* Once 3.5 characters of silence ended a frame, read it into mb_adu and return its
+ * length. Frames too long or with a bad CRC are dropped. */
+static uint16_t mb_rtu_frame(void)
+{
+   uint16_t count = UARTPORT_GetRxCount(mb_uart);
+
+   if(count == 0 || mb_idle < mb_t35) return 0;
+   if(count > MODBUS_MAX_ADU)
+   {
+      while(UARTPORT_Read(mb_uart, mb_adu, sizeof(mb_adu)) != 0);
+      return 0;
+   }
+   UARTPORT_Read(mb_uart, mb_adu, count);
+   /* The CRC of a frame followed by its own CRC is 0 */
+   if(count < 4 || modbus_crc16(mb_adu, count) != 0)
+   {
+#ifdef _MODBUS_DEBUG_
+      printf("Modbus RTU frame dropped, %d bytes\r\n", count);
+#endif
+      return 0;
+   }
+   return count;
+}
+
+static void mb_tcp_reply(uint8_t sn, uint16_t tid, uint8_t unit, const uint8_t* pdu, uint16_t len)
+{
+   mb_tcp_buf[0] = tid >> 8;
+   mb_tcp_buf[1] = tid & 0xFF;
+   mb_tcp_buf[2] = 0;
+   mb_tcp_buf[3] = 0;
+   mb_tcp_buf[4] = (len + 1) >> 8;
+   mb_tcp_buf[5] = (len + 1) & 0xFF;
+   mb_tcp_buf[6] = unit;
+   memcpy(&mb_tcp_buf[MODBUS_MBAP_LEN], pdu, len);
+   send(sn, mb_tcp_buf, MODBUS_MBAP_LEN + len);
+}
+
+static int8_t mb_enqueue(uint8_t src, uint16_t tid, uint8_t unit, const uint8_t* pdu, uint16_t len,
+                         modbus_cbfunc cb, void* arg)
+{
+   mb_request* req;
+
+   if(mb_q_count == MODBUS_QUEUE_SIZE) return -1;
+   req = &mb_queue[mb_q_head];
+   req->src = src;
+   req->tid = tid;
+   req->unit = unit;
+   req->len = len;
+   req->cb = cb;
+   req->arg = arg;
+   memcpy(req->pdu, pdu, len);
+   mb_q_head = (mb_q_head + 1) % MODBUS_QUEUE_SIZE;
+   mb_q_count++;
+   return 0;
+}
+
+/* Hand the response of the oldest request back to its TCP client or callback */
+static void mb_complete(const uint8_t* pdu, uint16_t len)
+{
+   mb_request* req = &mb_queue[mb_q_tail];
+
+   if(req->src == MODBUS_SRC_APP)
+   {
+      if(req->cb) req->cb(req->arg, pdu, len);
+   }
+   else if(req->src != MODBUS_SRC_NONE && pdu != NULL)
+   {
+      mb_tcp_reply(req->src, req->tid, req->unit, pdu, len);
+   }
+   mb_q_tail = (mb_q_tail + 1) % MODBUS_QUEUE_SIZE;
+   mb_q_count--;
+   mb_state = MB_RTU_IDLE;
+}
+
+/* Forget the requests of a TCP client that went away */
+static void mb_tcp_drop(uint8_t sn)
+{
+   uint8_t i;
+
+   for(i = 0; i < MODBUS_QUEUE_SIZE; i++)
+   {
+      if(mb_queue[i].src == sn) mb_queue[i].src = MODBUS_SRC_NONE;
+   }
+}
+
+static void mb_rtu_master(void)
+{
+   mb_request* req = &mb_queue[mb_q_tail];
+   uint16_t len;
+
+   if(mb_state == MB_RTU_WAIT)
+   {
+      if(req->unit == MODBUS_BROADCAST)
+      {
+         if(mb_wait == 0) mb_complete(NULL, 0);
+         return;
+      }
+      len = mb_rtu_frame();
+      if(len != 0 && mb_adu[0] == req->unit)
+      {
+         mb_complete(&mb_adu[1], len - 3);
+      }
+      else if(mb_wait == 0)
+      {
+#ifdef _MODBUS_DEBUG_
+         printf("Modbus RTU unit %d no response\r\n", req->unit);
+#endif
+         mb_complete(mb_rsp, mb_exception(req->pdu[0], MODBUS_EX_GATEWAY_TARGET, mb_rsp));
+      }
+      return;
+   }
+
+   if(mb_q_count == 0) return;
+   if(req->src == MODBUS_SRC_NONE)
+   {
+      mb_complete(NULL, 0);
+      return;
+   }
+   /* Drop stray bytes, then wait for 3.5 characters of silence before sending */
+   if(UARTPORT_GetRxCount(mb_uart) != 0)
+   {
+      mb_rtu_frame();
+      return;
+   }
+   if(mb_idle < mb_t35) return;
+
+   mb_rtu_send(req->unit, req->pdu, req->len);
+   mb_wait = (req->unit == MODBUS_BROADCAST) ? MODBUS_TICKS(MODBUS_TURNAROUND_MS) : MODBUS_TICKS(MODBUS_RESPONSE_TIMEOUT_MS);
+   mb_state = MB_RTU_WAIT;
+}
+
+static void mb_rtu_slave(void)
+{
+   uint16_t len, rlen;
+
+   if((len = mb_rtu_frame()) == 0) return;
+   if(mb_adu[0] != mb_slave_id && mb_adu[0] != MODBUS_BROADCAST) return;
+
+   rlen = mb_process(&mb_adu[1], len - 3, mb_rsp);
+   if(mb_adu[0] != MODBUS_BROADCAST) mb_rtu_send(mb_slave_id, mb_rsp, rlen);
+}
+
+static void mb_tcp_request(uint8_t sn, uint16_t tid, uint8_t unit, const uint8_t* pdu, uint16_t len)
+{
+   uint8_t gateway = mb_rtu_on && (mb_slave_id == 0);
+
+   if(mb_map != NULL && (unit == mb_tcp_unit || unit == 0xFF || !gateway))
+   {
+      mb_tcp_reply(sn, tid, unit, mb_rsp, mb_process(pdu, len, mb_rsp));
+   }
+   else if(!gateway)
+   {
+      mb_tcp_reply(sn, tid, unit, mb_rsp, mb_exception(pdu[0], MODBUS_EX_GATEWAY_PATH, mb_rsp));
+   }
+   else if(mb_enqueue(sn, tid, unit, pdu, len, NULL, NULL) != 0)
+   {
+      mb_tcp_reply(sn, tid, unit, mb_rsp, mb_exception(pdu[0], MODBUS_EX_DEVICE_BUSY, mb_rsp));
+   }
+}
+
+static void mb_tcp_socket(uint8_t i)
+{
+   uint8_t  sn = mb_tcp_sn + i;
+   uint8_t* hdr = mb_mbap[i];
+   uint16_t len;
+
+   switch(getSn_SR(sn))
+   {
+      case SOCK_ESTABLISHED :
+         if(getSn_IR(sn) & Sn_IR_CON)
+         {
+            setSn_IR(sn, Sn_IR_CON);
+            mb_mbap_ok[i] = 0;
+         }
+         if(!mb_mbap_ok[i])
+         {
+            if(getSn_RX_RSR(sn) < MODBUS_MBAP_LEN) break;
+            if(recv(sn, hdr, MODBUS_MBAP_LEN) != MODBUS_MBAP_LEN) break;
+            mb_mbap_ok[i] = 1;
+         }
+         len = ((uint16_t)hdr[4] << 8) | hdr[5];
+         if(hdr[2] != 0 || hdr[3] != 0 || len < 2 || len > MODBUS_MAX_PDU + 1)
+         {
+            /* Not Modbus, the stream cannot be resynchronized */
+            mb_mbap_ok[i] = 0;
+            disconnect(sn);
+            break;
+         }
+         len -= 1;
+         if(getSn_RX_RSR(sn) < len) break;
+         if(recv(sn, mb_pdu, len) != len) break;
+         mb_mbap_ok[i] = 0;
+         mb_tcp_request(sn, ((uint16_t)hdr[0] << 8) | hdr[1], hdr[6], mb_pdu, len);
+         break;
+      case SOCK_CLOSE_WAIT :
+         mb_tcp_drop(sn);
+         mb_mbap_ok[i] = 0;
+         disconnect(sn);
+         break;
+      case SOCK_INIT :
+         listen(sn);
+         break;
+      case SOCK_CLOSED :
+         mb_tcp_drop(sn);
+         mb_mbap_ok[i] = 0;
+         socket(sn, Sn_MR_TCP, mb_tcp_port, 0x00);
+         break;
+      default :
+         break;
+   }
+}
+
+void modbus_set_map(const wiz_ModbusMap* map)
+{
+   mb_map = map;
+}
+
+int8_t modbus_rtu_init(uint32_t uart_port, uint32_t baud, uint8_t slave_id,
+                       uint8_t* txbuf, uint16_t txsize, uint8_t* rxbuf, uint16_t rxsize)
+{
+   if(baud == 0 || slave_id > 247) return SOCKERR_ARG;
+   if(txsize < MODBUS_MAX_ADU + 1 || rxsize < MODBUS_MAX_ADU + 1) return SOCKERR_ARG;
+
+   mb_rtu_on = 0;
+   mb_uart = uart_port;
+   mb_slave_id = slave_id;
+   /* The bytes are seen when they complete, so across a 3.5 character silence they are
+    * t3.5 plus one character apart. The idle count of that can be one tick short of it,
+    * depending on where the ticks fall. */
+   mb_t35 = (MODBUS_T35_US(baud) + MODBUS_CHAR_US(baud)) / MODBUS_TICK_US - 1;
+   if(mb_t35 < 2) mb_t35 = 2;
+   mb_state = MB_RTU_IDLE;
+   mb_q_head = mb_q_tail = mb_q_count = 0;
+
+   UARTPORT_Init(uart_port, txbuf, txsize, rxbuf, rxsize);
+   if(uart_port != UARTPORT_2)
+   {
+      /* The silence is timed on the ring buffer, so every byte has to reach it when it
+       * arrives. With the FIFO on, the bytes under the trigger level wait for the receive
+       * timeout (32 bits), long enough to end a frame early or join two frames : run the
+       * port without FIFO, it interrupts on each byte like UART2 */
+      UART_FIFO_Disable((uart_port == UARTPORT_0) ? UART0 : UART1);
+   }
+
+   mb_rx_last = 0;
+   mb_idle = mb_t35;
+   mb_wait = 0;
+   mb_rtu_on = 1;
+   return SOCK_OK;
+}
+
+int8_t modbus_tcp_init(uint8_t sn, uint8_t count, uint16_t port, uint8_t unit)
+{
+   uint8_t i;
+
+   if(count == 0 || count > MODBUS_TCP_MAX_SOCK || sn + count > _WIZCHIP_SOCK_NUM_) return SOCKERR_SOCKNUM;
+
+   mb_tcp_sn = sn;
+   mb_tcp_count = count;
+   mb_tcp_port = port;
+   mb_tcp_unit = unit;
+   for(i = 0; i < count; i++) mb_mbap_ok[i] = 0;
+   return SOCK_OK;
+}
+
+int8_t modbus_request(uint8_t unit, const uint8_t* pdu, uint16_t len, modbus_cbfunc cb, void* arg)
+{
+   if(!mb_rtu_on || mb_slave_id != 0) return -1;
+   if(len == 0 || len > MODBUS_MAX_PDU) return -1;
+   return mb_enqueue(MODBUS_SRC_APP, 0, unit, pdu, len, cb, arg);
+}
+
+void modbus_time_handler(void)
+{
+   uint16_t count;
+
+   if(!mb_rtu_on) return;
+
+   count = UARTPORT_GetRxCount(mb_uart);
+   if(count != mb_rx_last)
+   {
+      mb_rx_last = count;
+      mb_idle = 0;
+   }
+   else if(mb_idle != 0xFFFF) mb_idle++;
+
+   if(mb_wait) mb_wait--;
+}
+
+int32_t modbus_run(void)
+{
+   uint8_t i;
+
+   if(mb_rtu_on)
+   {
+      if(mb_slave_id == 0) mb_rtu_master();
+      else mb_rtu_slave();
+   }
+   for(i = 0; i < mb_tcp_count; i++) mb_tcp_socket(i);
+   return 1;
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _MODBUS_H_
+#define _MODBUS_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "W7500x_wztoe.h"
+
+
+/* Modbus debug message printout enable */
+//#define _MODBUS_DEBUG_
+
+/* Period of modbus_time_handler() in microseconds. Call it from a periodic DUALTIMER
+ * interrupt (DUALTIMER_Periodic, Timer_Load = timer clock / 1000000 * MODBUS_TICK_US);
+ * it times the 3.5 character silence that ends an RTU frame. */
+#ifndef MODBUS_TICK_US
+	#define MODBUS_TICK_US				100
+#endif
+
+/* RTU master : time allowed to a slave to answer, from the start of the request */
+#ifndef MODBUS_RESPONSE_TIMEOUT_MS
+	#define MODBUS_RESPONSE_TIMEOUT_MS	1000
+#endif
+
+/* RTU master : delay after a broadcast request before the next request */
+#ifndef MODBUS_TURNAROUND_MS
+	#define MODBUS_TURNAROUND_MS		100
+#endif
+
+/* Number of requests waiting for the RTU master, from TCP clients and modbus_request() */
+#ifndef MODBUS_QUEUE_SIZE
+	#define MODBUS_QUEUE_SIZE			4
+#endif
+
+/* Number of sockets of the Modbus TCP server */
+#ifndef MODBUS_TCP_MAX_SOCK
+	#define MODBUS_TCP_MAX_SOCK			2
+#endif
+
+#define MODBUS_MAX_PDU					253
+#define MODBUS_MAX_ADU					256		///< RTU : address, PDU and CRC
+#define MODBUS_MBAP_LEN					7		///< TCP : transaction, protocol, length, unit
+
+#define MODBUS_TCP_PORT					502
+#define MODBUS_BROADCAST				0
+
+/* Exception codes */
+#define MODBUS_EX_ILLEGAL_FUNCTION		0x01
+#define MODBUS_EX_ILLEGAL_ADDRESS		0x02
+#define MODBUS_EX_ILLEGAL_VALUE			0x03
+#define MODBUS_EX_DEVICE_FAILURE		0x04
+#define MODBUS_EX_GATEWAY_PATH			0x0A
+#define MODBUS_EX_GATEWAY_TARGET		0x0B
+
+/* Local data model, used by the RTU slave and the TCP server.
+ * Every function returns 0 or one of the MODBUS_EX_ codes; a NULL function makes its
+ * function codes answer MODBUS_EX_ILLEGAL_FUNCTION.
+ * fc is 0x01 (coils) or 0x02 (discrete inputs) for read_bit,
+ *       0x03 (holding registers) or 0x04 (input registers) for read_reg. */
+typedef struct wiz_ModbusMap_t
+{
+   uint8_t (*read_bit)(uint8_t fc, uint16_t addr, uint8_t* value);
+   uint8_t (*read_reg)(uint8_t fc, uint16_t addr, uint16_t* value);
+   uint8_t (*write_bit)(uint16_t addr, uint8_t value);
+   uint8_t (*write_reg)(uint16_t addr, uint16_t value);
+} wiz_ModbusMap;
+
+/* Completion of modbus_request(). pdu is the response PDU, an exception PDU
+ * (function code | 0x80, MODBUS_EX_GATEWAY_TARGET) on timeout, or NULL after a broadcast. */
+typedef void (*modbus_cbfunc)(void* arg, const uint8_t* pdu, uint16_t len);
+
+/* Table driven CRC16 of Modbus RTU (polynomial 0xA001, initial value 0xFFFF).
+ * The CRC is sent low byte first. */
+uint16_t modbus_crc16(const uint8_t* buf, uint16_t len);
+
+/* Set the local data model */
+void     modbus_set_map(const wiz_ModbusMap* map);
+
+/* Start Modbus RTU on a buffered UART port (UARTPORT_0, UARTPORT_1 or UARTPORT_2 of
+ * w7500x_uart_buf.h) already initialized at 'baud'. slave_id 0 makes this side an RTU
+ * master, which carries modbus_request() and the gateway traffic; 1..247 makes it a slave
+ * answering from the local data model. Call UARTPORT_IRQHandler(uart_port) from the UART
+ * interrupt handler. UART0 and UART1 run without FIFO, one interrupt per byte, so that
+ * the 3.5 character silence is timed on the bytes as they arrive. */
+int8_t   modbus_rtu_init(uint32_t uart_port, uint32_t baud, uint8_t slave_id,
+                         uint8_t* txbuf, uint16_t txsize, uint8_t* rxbuf, uint16_t rxsize);
+
+/* Start the Modbus TCP server on sockets sn .. sn + count - 1, all listening on 'port'.
+ * Requests for 'unit' are answered from the local data model, the others are forwarded
+ * to the RTU master (gateway) with their transaction ID restored on the response. */
+int8_t   modbus_tcp_init(uint8_t sn, uint8_t count, uint16_t port, uint8_t unit);
+
+/* Queue a request to an RTU slave. Returns 0, or -1 if the queue is full or the
+ * RTU side is not a master. */
+int8_t   modbus_request(uint8_t unit, const uint8_t* pdu, uint16_t len, modbus_cbfunc cb, void* arg);
+
+/* Tick of the RTU timing, every MODBUS_TICK_US */
+void     modbus_time_handler(void);
+
+/* Main loop handler, runs the RTU side and the TCP server. Returns 1. */
+int32_t  modbus_run(void);
+#endif
@@ -0,0 +1,244 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "netmgr.h"
+#include "dhcp.h"
+#include "w7500x_miim.h"
+
+typedef struct
+{
+   uint8_t  used;
+   uint8_t  sn;
+   uint8_t  ip[4];
+   uint16_t port;
+} netmgr_mcast;
+
+static wiz_NetInfo  netmgr_netinfo;
+static uint8_t      netmgr_dhcp_sn;
+static uint8_t*     netmgr_dhcp_buf;
+static netmgr_state netmgr_cur_state = NETMGR_LINK_DOWN;
+static netmgr_mcast netmgr_groups[NETMGR_MCAST_MAX];
+
+static volatile uint8_t  netmgr_link = PHY_LINK_OFF;
+static volatile uint8_t  netmgr_sample_req = 0;
+static volatile uint32_t netmgr_tick = 0;
+
+static void (*netmgr_link_changed)(uint8_t link) = 0;
+
+static int8_t netmgr_open_group(netmgr_mcast* group)
+{
+   uint8_t mcast_mac[6];
+
+   /* IPv4 multicast MAC : 01:00:5E + lower 23 bits of the group address */
+   mcast_mac[0] = 0x01;
+   mcast_mac[1] = 0x00;
+   mcast_mac[2] = 0x5E;
+   mcast_mac[3] = group->ip[1] & 0x7F;
+   mcast_mac[4] = group->ip[2];
+   mcast_mac[5] = group->ip[3];
+
+   close(group->sn);
+   setSn_DHAR(group->sn, mcast_mac);
+   setSn_DIPR(group->sn, group->ip);
+   setSn_DPORT(group->sn, group->port);
+#ifdef _NETMGR_DEBUG_
+   printf("%d:Join group %d.%d.%d.%d : %d\r\n", group->sn, group->ip[0], group->ip[1], group->ip[2], group->ip[3], group->port);
+#endif
+   return socket(group->sn, Sn_MR_UDP, group->port, SF_MULTI_ENABLE | SF_IGMP_VER2);
+}
+
+static void netmgr_rejoin_groups(void)
+{
+   uint8_t i;
+
+   for(i = 0; i < NETMGR_MCAST_MAX; i++)
+   {
+      if(netmgr_groups[i].used) netmgr_open_group(&netmgr_groups[i]);
+   }
+}
+
+/* Close every open socket except 'keep' (0xFF closes all) */
+static void netmgr_close_sockets(uint8_t keep)
+{
+   uint8_t sn;
+
+   for(sn = 0; sn < _WIZCHIP_SOCK_NUM_; sn++)
+   {
+      if(sn != keep && getSn_SR(sn) != SOCK_CLOSED) close(sn);
+   }
+}
+
+static void netmgr_link_up(void)
+{
+   if(netmgr_netinfo.dhcp == NETINFO_DHCP)
+   {
+      /* Addresses leased before the link was lost may no longer be valid */
+      DHCP_init(netmgr_dhcp_sn, netmgr_dhcp_buf);
+      netmgr_cur_state = NETMGR_CONFIGURING;
+   }
+   else
+   {
+      ctlnetwork(CN_SET_NETINFO, (void*)&netmgr_netinfo);
+      netmgr_rejoin_groups();
+      netmgr_cur_state = NETMGR_READY;
+   }
+}
+
+static void netmgr_link_down(void)
+{
+   if(netmgr_netinfo.dhcp == NETINFO_DHCP) DHCP_stop();
+   netmgr_close_sockets(0xFF);
+   netmgr_cur_state = NETMGR_LINK_DOWN;
+}
+
+void netmgr_init(wiz_NetInfo* pnetinfo, uint8_t dhcp_sn, uint8_t* dhcp_buf)
+{
+   memcpy(&netmgr_netinfo, pnetinfo, sizeof(wiz_NetInfo));
+   netmgr_dhcp_sn = dhcp_sn;
+   netmgr_dhcp_buf = dhcp_buf;
+   memset(netmgr_groups, 0, sizeof(netmgr_groups));
+
+   /* MAC is needed by DHCP, the remaining fields are applied on link up */
+   ctlnetwork(CN_SET_NETINFO, (void*)&netmgr_netinfo);
+
+   netmgr_link = PHY_LINK_OFF;
+   netmgr_cur_state = NETMGR_LINK_DOWN;
+   netmgr_tick = 0;
+   netmgr_sample_req = 1;
+}
+
+void netmgr_reg_cbfunc(void (*link_changed)(uint8_t link))
+{
+   netmgr_link_changed = link_changed;
+}
+
+int8_t netmgr_join_multicast(uint8_t sn, uint8_t* group_ip, uint16_t port)
+{
+   uint8_t i;
+   netmgr_mcast* group = 0;
+
+   if(sn >= _WIZCHIP_SOCK_NUM_) return SOCKERR_SOCKNUM;
+
+   for(i = 0; i < NETMGR_MCAST_MAX; i++)
+   {
+      if(netmgr_groups[i].used && netmgr_groups[i].sn == sn)
+      {
+         group = &netmgr_groups[i];
+         break;
+      }
+      if(!netmgr_groups[i].used && group == 0) group = &netmgr_groups[i];
+   }
+   if(group == 0) return SOCKERR_SOCKNUM;
+
+   group->used = 1;
+   group->sn = sn;
+   memcpy(group->ip, group_ip, 4);
+   group->port = port;
+
+   if(netmgr_cur_state == NETMGR_READY) netmgr_open_group(group);
+   return SOCK_OK;
+}
+
+int8_t netmgr_leave_multicast(uint8_t sn)
+{
+   uint8_t i;
+
+   for(i = 0; i < NETMGR_MCAST_MAX; i++)
+   {
+      if(netmgr_groups[i].used && netmgr_groups[i].sn == sn)
+      {
+         netmgr_groups[i].used = 0;
+         close(sn);
+         return SOCK_OK;
+      }
+   }
+   return SOCKERR_SOCKNUM;
+}
+
+void netmgr_time_handler(void)
+{
+   if(++netmgr_tick >= NETMGR_LINK_POLL_TICKS)
+   {
+      netmgr_tick = 0;
+      netmgr_sample_req = 1;
+   }
+}
+
+void netmgr_link_event(void)
+{
+   netmgr_sample_req = 1;
+}
+
+netmgr_state netmgr_run(void)
+{
+   uint8_t link;
+
+   /* MDIO is only driven here, never from the interrupt handlers */
+   if(netmgr_sample_req)
+   {
+      netmgr_sample_req = 0;
+      link = (PHY_GetLinkStatus() == SET) ? PHY_LINK_ON : PHY_LINK_OFF;
+
+      if(link != netmgr_link)
+      {
+         netmgr_link = link;
+#ifdef _NETMGR_DEBUG_
+         printf("Link %s\r\n", (link == PHY_LINK_ON) ? "Up" : "Down");
+#endif
+         if(link == PHY_LINK_ON) netmgr_link_up();
+         else                    netmgr_link_down();
+
+         if(netmgr_link_changed) netmgr_link_changed(link);
+      }
+   }
+
+   if(netmgr_cur_state != NETMGR_LINK_DOWN && netmgr_netinfo.dhcp == NETINFO_DHCP)
+   {
+      switch(DHCP_run())
+      {
+         case DHCP_IP_ASSIGN:
+         case DHCP_IP_CHANGED:
+            /* Sockets bound to the previous address are stale */
+            netmgr_close_sockets(netmgr_dhcp_sn);
+            netmgr_rejoin_groups();
+            netmgr_cur_state = NETMGR_READY;
+            break;
+         case DHCP_IP_LEASED:
+            if(netmgr_cur_state != NETMGR_READY)
+            {
+               netmgr_rejoin_groups();
+               netmgr_cur_state = NETMGR_READY;
+            }
+            break;
+         case DHCP_FAILED:
+            netmgr_cur_state = NETMGR_CONFIGURING;
+            break;
+         default:
+            break;
+      }
+   }
+
+   return netmgr_cur_state;
+}
+
+uint8_t netmgr_get_link(void)
+{
+   return netmgr_link;
+}
+
+netmgr_state netmgr_get_state(void)
+{
+   return netmgr_cur_state;
+}
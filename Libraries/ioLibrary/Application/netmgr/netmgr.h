@@ -0,0 +1,73 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _NETMGR_H_
+#define _NETMGR_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "wizchip_conf.h"
+#include "W7500x_wztoe.h"
+
+
+/* Network manager debug message printout enable */
+//#define _NETMGR_DEBUG_
+
+/* Number of netmgr_time_handler() calls between two PHY link samples.
+ * With the 1s DUALTIMER tick used by the examples the PHY is read once a second. */
+#ifndef NETMGR_LINK_POLL_TICKS
+	#define NETMGR_LINK_POLL_TICKS		1
+#endif
+
+/* Maximum number of multicast groups re-joined after a link up */
+#ifndef NETMGR_MCAST_MAX
+	#define NETMGR_MCAST_MAX			2
+#endif
+
+/* Network manager state */
+typedef enum
+{
+   NETMGR_LINK_DOWN = 0,   ///< No link, all sockets closed
+   NETMGR_CONFIGURING,     ///< Link up, waiting for an address from DHCP
+   NETMGR_READY            ///< Link up and network address configured
+} netmgr_state;
+
+/* Initialize the manager with the network information to apply on every link up.
+ * If pnetinfo->dhcp is NETINFO_DHCP, dhcp_sn and dhcp_buf are passed to DHCP_init(). */
+void netmgr_init(wiz_NetInfo* pnetinfo, uint8_t dhcp_sn, uint8_t* dhcp_buf);
+
+/* Register a callback called on every link transition with PHY_LINK_ON or PHY_LINK_OFF */
+void netmgr_reg_cbfunc(void (*link_changed)(uint8_t link));
+
+/* Register a multicast group on socket sn. It is joined when the network becomes ready
+ * and re-joined after every link down/up. Returns SOCK_OK or SOCKERR_SOCKNUM. */
+int8_t netmgr_join_multicast(uint8_t sn, uint8_t* group_ip, uint16_t port);
+
+/* Remove a multicast group registered by netmgr_join_multicast() and close its socket */
+int8_t netmgr_leave_multicast(uint8_t sn);
+
+/* Low-rate tick, call from a timer interrupt (e.g. next to DHCP_time_handler()) */
+void netmgr_time_handler(void);
+
+/* Request an immediate PHY sample, call from a link change interrupt */
+void netmgr_link_event(void);
+
+/* Main loop handler. Samples the PHY when requested and handles link transitions. */
+netmgr_state netmgr_run(void);
+
+/* Cached link status (PHY_LINK_ON or PHY_LINK_OFF), no MDIO access */
+uint8_t netmgr_get_link(void);
+
+/* Current network manager state */
+netmgr_state netmgr_get_state(void);
+#endif
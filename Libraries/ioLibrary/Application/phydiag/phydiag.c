@@ -0,0 +1,234 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "phydiag.h"
+#include "wizchip_conf.h"
+#include "w7500x_miim.h"
+
+/* BMCR */
+#define BMCR_SPEED100		0x2000
+#define BMCR_ANEG_EN		0x1000
+#define BMCR_DUPLEX			0x0100
+/* BMSR */
+#define BMSR_ANEG_DONE		0x0020
+#define BMSR_REMOTE_FAULT	0x0010
+#define BMSR_LINK			0x0004
+#define BMSR_JABBER			0x0002
+/* ANAR / ANLPAR */
+#define ANLPAR_100FULL		0x0100
+#define ANLPAR_100HALF		0x0080
+#define ANLPAR_10FULL		0x0040
+/* ANER */
+#define ANER_PDF			0x0010
+
+/* The snapshot always holds the latched BMSR and the error counter phydiag owns */
+#if PHYDIAG_RXERR_REG != 0xFF
+#define PHYDIAG_SNAPSHOT_MASK	(PHYDIAG_SNAPSHOT_REGS | (1UL << PHYDIAG_BMSR) | (1UL << PHYDIAG_RXERR_REG))
+#else
+#define PHYDIAG_SNAPSHOT_MASK	(PHYDIAG_SNAPSHOT_REGS | (1UL << PHYDIAG_BMSR))
+#endif
+
+static phydiag_status phydiag_stat;
+static uint8_t  phydiag_prev_link = 0;
+static uint16_t phydiag_win_flaps = 0;
+static uint16_t phydiag_win_errors = 0;
+static uint32_t phydiag_win_start = 0;
+
+static volatile uint32_t phydiag_tick_1s = 0;
+static volatile uint8_t  phydiag_sample_req = 0;
+
+static void put16(uint8_t* p, uint16_t v)
+{
+   p[0] = (uint8_t)(v >> 8);
+   p[1] = (uint8_t)v;
+}
+
+static void put32(uint8_t* p, uint32_t v)
+{
+   p[0] = (uint8_t)(v >> 24);
+   p[1] = (uint8_t)(v >> 16);
+   p[2] = (uint8_t)(v >> 8);
+   p[3] = (uint8_t)v;
+}
+
+static uint8_t phydiag_resolve_flags(const uint16_t* regs, uint16_t bmsr)
+{
+   uint8_t  flags = 0;
+   uint16_t common;
+
+   if(bmsr & BMSR_LINK)          flags |= PHYDIAG_FLAG_LINK;
+   if(bmsr & BMSR_ANEG_DONE)     flags |= PHYDIAG_FLAG_ANEG_DONE;
+   if(bmsr & BMSR_REMOTE_FAULT)  flags |= PHYDIAG_FLAG_REMOTE_FAULT;
+   if(bmsr & BMSR_JABBER)        flags |= PHYDIAG_FLAG_JABBER;
+   if(regs[PHYDIAG_ANER] & ANER_PDF) flags |= PHYDIAG_FLAG_PDF;
+
+   if((regs[PHYDIAG_BMCR] & BMCR_ANEG_EN) && (bmsr & BMSR_ANEG_DONE))
+   {
+      /* Highest common ability of the local and link partner advertisement */
+      common = regs[PHYDIAG_ANAR] & regs[PHYDIAG_ANLPAR];
+      if(common & ANLPAR_100FULL)      flags |= PHYDIAG_FLAG_100M | PHYDIAG_FLAG_FULL;
+      else if(common & ANLPAR_100HALF) flags |= PHYDIAG_FLAG_100M;
+      else if(common & ANLPAR_10FULL)  flags |= PHYDIAG_FLAG_FULL;
+   }
+   else
+   {
+      if(regs[PHYDIAG_BMCR] & BMCR_SPEED100) flags |= PHYDIAG_FLAG_100M;
+      if(regs[PHYDIAG_BMCR] & BMCR_DUPLEX)   flags |= PHYDIAG_FLAG_FULL;
+   }
+#if PHYDIAG_RXERR_REG != 0xFF
+   flags |= PHYDIAG_FLAG_RXERR_VALID;
+#endif
+   return flags;
+}
+
+static void phydiag_sample(void)
+{
+   uint16_t bmsr;
+
+   /* BMSR link bit is latched low : the snapshot tells whether the link dropped
+    * since the previous read, the second read gives the current state. */
+   PHY_GetSnapshot(phydiag_stat.regs, PHYDIAG_SNAPSHOT_MASK);
+   bmsr = PHY_ReadRegister(PHYDIAG_BMSR);
+
+   if(phydiag_prev_link && !(phydiag_stat.regs[PHYDIAG_BMSR] & BMSR_LINK))
+   {
+      phydiag_stat.link_down++;
+      phydiag_win_flaps++;
+      phydiag_prev_link = 0;
+   }
+   if(!phydiag_prev_link && (bmsr & BMSR_LINK))
+   {
+      phydiag_stat.link_up++;
+      phydiag_prev_link = 1;
+   }
+
+#if PHYDIAG_RXERR_REG != 0xFF
+   /* Vendor error counters are cleared on read */
+   phydiag_stat.rx_errors += phydiag_stat.regs[PHYDIAG_RXERR_REG];
+   phydiag_win_errors += phydiag_stat.regs[PHYDIAG_RXERR_REG];
+#endif
+
+   phydiag_stat.flags = phydiag_resolve_flags(phydiag_stat.regs, bmsr);
+
+#ifdef _PHYDIAG_DEBUG_
+   printf("PHY BMSR:%04X flags:%02X up:%d down:%d rxerr:%lu\r\n", bmsr, phydiag_stat.flags,
+          phydiag_stat.link_up, phydiag_stat.link_down, (unsigned long)phydiag_stat.rx_errors);
+#endif
+}
+
+void phydiag_init(void)
+{
+   memset(&phydiag_stat, 0, sizeof(phydiag_stat));
+   phydiag_prev_link = 0;
+   phydiag_win_flaps = 0;
+   phydiag_win_errors = 0;
+   phydiag_win_start = 0;
+   phydiag_tick_1s = 0;
+   phydiag_sample_req = 1;
+}
+
+void phydiag_time_handler(void)
+{
+   phydiag_tick_1s++;
+   if((phydiag_tick_1s % PHYDIAG_SAMPLE_SEC) == 0) phydiag_sample_req = 1;
+}
+
+const phydiag_status* phydiag_get_status(void)
+{
+   return &phydiag_stat;
+}
+
+uint16_t phydiag_build_frame(uint8_t* buf)
+{
+   uint8_t i;
+
+   put16(&buf[0], PHYDIAG_MAGIC);
+   buf[2] = PHYDIAG_VERSION;
+   buf[3] = phydiag_stat.flags;
+   put32(&buf[4], phydiag_stat.uptime);
+   put16(&buf[8], phydiag_stat.link_up);
+   put16(&buf[10], phydiag_stat.link_down);
+   put16(&buf[12], phydiag_stat.flap_rate);
+   put16(&buf[14], PHYDIAG_WINDOW_SEC);
+   put32(&buf[16], phydiag_stat.rx_errors);
+   put16(&buf[20], phydiag_stat.rx_error_rate);
+   put16(&buf[22], PHYDIAG_SAMPLE_SEC);
+   for(i = 0; i < 32; i++) put16(&buf[24 + 2 * i], phydiag_stat.regs[i]);
+
+   return PHYDIAG_FRAME_SIZE;
+}
+
+int32_t phydiag_run(uint8_t sn, uint8_t* buf, uint16_t port)
+{
+   int32_t  ret;
+   uint16_t size;
+   uint16_t remain;
+   uint8_t  header;
+   uint8_t  answer = 0;
+   uint8_t  destip[4] = {0, 0, 0, 0};
+   uint16_t destport = 0;
+
+   phydiag_stat.uptime = phydiag_tick_1s;
+
+   if(phydiag_sample_req)
+   {
+      phydiag_sample_req = 0;
+      phydiag_sample();
+   }
+
+   if((phydiag_stat.uptime - phydiag_win_start) >= PHYDIAG_WINDOW_SEC)
+   {
+      phydiag_win_start = phydiag_stat.uptime;
+      phydiag_stat.flap_rate = phydiag_win_flaps;
+      phydiag_stat.rx_error_rate = phydiag_win_errors;
+      phydiag_win_flaps = 0;
+      phydiag_win_errors = 0;
+   }
+
+   switch(getSn_SR(sn))
+   {
+      case SOCK_UDP :
+         /* The request content is ignored, only the peer address matters. Each datagram
+          * is read to its end, so that the next recvfrom() starts on a header, and only
+          * an address read from a header is answered. */
+         getsockopt(sn, SO_REMAINSIZE, &remain);
+         while((remain > 0) || (getSn_RX_RSR(sn) > 0))
+         {
+            header = (remain == 0);
+            ret = recvfrom(sn, buf, PHYDIAG_FRAME_SIZE, destip, &destport);
+            if(ret < 0) return ret;
+            if(header) answer = 1;
+
+            getsockopt(sn, SO_REMAINSIZE, &remain);
+            if((remain == 0) && answer)
+            {
+               answer = 0;
+               size = phydiag_build_frame(buf);
+               ret = sendto(sn, buf, size, destip, destport);
+               if(ret < 0) return ret;
+            }
+         }
+         break;
+      case SOCK_CLOSED :
+         if((ret = socket(sn, Sn_MR_UDP, port, 0x00)) != sn) return ret;
+#ifdef _PHYDIAG_DEBUG_
+         printf("%d:PHY diagnostics, port [%d]\r\n", sn, port);
+#endif
+         break;
+      default :
+         break;
+   }
+   return 1;
+}
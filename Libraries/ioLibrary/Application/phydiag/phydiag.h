@@ -0,0 +1,104 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _PHYDIAG_H_
+#define _PHYDIAG_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "W7500x_wztoe.h"
+
+
+/* PHY diagnostics debug message printout enable */
+//#define _PHYDIAG_DEBUG_
+
+/* Seconds between two PHY register snapshots */
+#ifndef PHYDIAG_SAMPLE_SEC
+	#define PHYDIAG_SAMPLE_SEC		1
+#endif
+
+/* Length of the window used for the link-flap and error rates, in seconds */
+#ifndef PHYDIAG_WINDOW_SEC
+	#define PHYDIAG_WINDOW_SEC		60
+#endif
+
+/* Registers of the periodic snapshot, bit n selects register n. Vendor registers
+ * are often cleared on read : only add the ones no other code uses. */
+#ifndef PHYDIAG_SNAPSHOT_REGS
+	#define PHYDIAG_SNAPSHOT_REGS	PHY_REGS_STANDARD
+#endif
+
+/* Vendor receive error counter register, 0xFF if the PHY has none.
+ * It is cleared on read : phydiag reads it once per snapshot and owns it.
+ * e.g. 0x15 (RECR) on DP83848, 0x1A (SECR) on LAN8720 */
+#ifndef PHYDIAG_RXERR_REG
+	#define PHYDIAG_RXERR_REG		0xFF
+#endif
+
+/* Standard MII registers */
+#define PHYDIAG_BMCR				0x00
+#define PHYDIAG_BMSR				0x01
+#define PHYDIAG_PHYID1				0x02
+#define PHYDIAG_PHYID2				0x03
+#define PHYDIAG_ANAR				0x04
+#define PHYDIAG_ANLPAR				0x05
+#define PHYDIAG_ANER				0x06
+
+/* Status endpoint : any datagram received on the socket is answered with the status frame.
+ * Frame layout, big-endian :
+ *   [0]  magic (2)       [2]  version (1)        [3]  flags (1)
+ *   [4]  uptime (4)      [8]  link up (2)        [10] link down (2)
+ *   [12] flap rate (2)   [14] window sec (2)     [16] rx errors (4)
+ *   [20] rx error rate (2)                       [22] sample sec (2)
+ *   [24] MII registers 0..31 (2 each), 0 for the ones not in the snapshot */
+#define PHYDIAG_MAGIC				0x5044	// "PD"
+#define PHYDIAG_VERSION				1
+#define PHYDIAG_FRAME_SIZE			(24 + 2 * 32)	// Header and counters followed by MII registers 0..31
+
+/* Status flags */
+#define PHYDIAG_FLAG_LINK			0x01
+#define PHYDIAG_FLAG_100M			0x02
+#define PHYDIAG_FLAG_FULL			0x04
+#define PHYDIAG_FLAG_ANEG_DONE		0x08
+#define PHYDIAG_FLAG_REMOTE_FAULT	0x10
+#define PHYDIAG_FLAG_JABBER			0x20
+#define PHYDIAG_FLAG_PDF			0x40	// Parallel detection fault
+#define PHYDIAG_FLAG_RXERR_VALID	0x80
+
+typedef struct
+{
+   uint32_t uptime;           ///< Seconds since phydiag_init()
+   uint8_t  flags;            ///< PHYDIAG_FLAG_xxx
+   uint16_t link_up;          ///< Number of link up transitions
+   uint16_t link_down;        ///< Number of link down transitions, including drops latched between samples
+   uint16_t flap_rate;        ///< Link down transitions in the last completed window
+   uint32_t rx_errors;        ///< Accumulated vendor receive error count
+   uint16_t rx_error_rate;    ///< Receive errors in the last completed window
+   uint16_t regs[32];         ///< Last snapshot of MII registers 0..31, PHYDIAG_SNAPSHOT_REGS and PHYDIAG_RXERR_REG
+} phydiag_status;
+
+/* Reset all counters */
+void phydiag_init(void);
+
+/* One second tick, call from a timer interrupt (e.g. next to DHCP_time_handler()) */
+void phydiag_time_handler(void);
+
+/* Main loop handler. Takes the periodic snapshot and serves the status endpoint on UDP socket sn. */
+int32_t phydiag_run(uint8_t sn, uint8_t* buf, uint16_t port);
+
+/* Last computed status */
+const phydiag_status* phydiag_get_status(void);
+
+/* Serialize the status frame (big-endian) into buf, returns the frame length */
+uint16_t phydiag_build_frame(uint8_t* buf);
+#endif
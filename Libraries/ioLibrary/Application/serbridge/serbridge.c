@@ -0,0 +1,247 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include "serbridge.h"
+#include "wizchip_conf.h"
+#include "w7500x_uart_buf.h"
+
+static uint8_t  sb_sn;
+static uint16_t sb_port;
+static uint32_t sb_uart;
+static uint8_t* sb_rxbuf;
+static uint16_t sb_rxsize;
+
+static uint16_t sb_pack_size;
+static int16_t  sb_delim = SERBRIDGE_NO_DELIM;
+static uint16_t sb_timeout;
+
+static volatile uint32_t sb_tick;
+static uint32_t sb_last_tick;		/* Tick of the last change of the pending count */
+static uint16_t sb_last_count;
+static uint16_t sb_scanned;			/* Pending bytes already searched for the delimiter */
+static uint8_t  sb_sending;			/* SEND issued, waiting for SENDOK */
+
+static uint32_t sb_to_net;
+static uint32_t sb_to_serial;
+
+/* Pending byte i, seg/len is the first contiguous part returned by UARTPORT_RxPeek() */
+static uint8_t sb_byte(uint16_t i, uint8_t* seg, uint16_t len)
+{
+   return (i < len) ? seg[i] : sb_rxbuf[i - len];
+}
+
+/* Number of pending serial bytes to send now, 0 to wait for more */
+static uint16_t sb_packet_len(void)
+{
+   uint8_t* seg;
+   uint16_t count, limit, len, i;
+
+   count = UARTPORT_GetRxCount(sb_uart);
+   if(count == 0)
+   {
+      sb_last_count = 0;
+      sb_scanned = 0;
+      return 0;
+   }
+   if(count != sb_last_count)
+   {
+      sb_last_count = count;
+      sb_last_tick = sb_tick;
+   }
+
+   if(sb_delim != SERBRIDGE_NO_DELIM)
+   {
+      len = UARTPORT_RxPeek(sb_uart, &seg);
+      for(i = sb_scanned; i < count; i++)
+      {
+         if(sb_byte(i, seg, len) == (uint8_t)sb_delim) return i + 1;
+      }
+      sb_scanned = count;
+   }
+
+   /* A full ring buffer is always sent, the UART is held otherwise */
+   limit = sb_rxsize - 1;
+   if(sb_pack_size != 0 && sb_pack_size < limit) limit = sb_pack_size;
+   if(count >= limit) return limit;
+
+   if(sb_timeout != 0 && (sb_tick - sb_last_tick) >= sb_timeout) return count;
+
+   if(sb_pack_size == 0 && sb_delim == SERBRIDGE_NO_DELIM && sb_timeout == 0) return count;
+   return 0;
+}
+
+/* Serial to socket, straight from the UART ring buffer into the socket TX memory */
+static int32_t sb_serial_to_net(void)
+{
+   uint8_t* seg;
+   uint16_t size, len, left;
+   uint8_t ir;
+
+   if(sb_sending)
+   {
+      ir = getSn_IR(sb_sn);
+      if(ir & Sn_IR_SENDOK)
+      {
+         setSn_IR(sb_sn, Sn_IR_SENDOK);
+         sb_sending = 0;
+      }
+      else if(ir & Sn_IR_TIMEOUT)
+      {
+         close(sb_sn);
+         return SOCKERR_TIMEOUT;
+      }
+      else return 0;
+   }
+
+   if((size = sb_packet_len()) == 0) return 0;
+   if(size > getSn_TxMAX(sb_sn)) size = getSn_TxMAX(sb_sn);
+   /* No room yet : the bytes stay in the ring buffer, which holds the UART when full */
+   if(getSn_TX_FSR(sb_sn) < size) return 0;
+
+   left = size;
+   while(left)
+   {
+      len = UARTPORT_RxPeek(sb_uart, &seg);
+      if(len > left) len = left;
+      wiz_send_data(sb_sn, seg, len);
+      UARTPORT_RxSkip(sb_uart, len);
+      left -= len;
+   }
+   setSn_CR(sb_sn, Sn_CR_SEND);
+   while(getSn_CR(sb_sn));
+   sb_sending = 1;
+
+   sb_scanned = (sb_scanned > size) ? (sb_scanned - size) : 0;
+   sb_last_count -= size;
+   sb_to_net += size;
+   return size;
+}
+
+/* Socket to serial, straight from the socket RX memory into the UART ring buffer */
+static int32_t sb_net_to_serial(void)
+{
+   uint8_t* room;
+   uint16_t size, len, done = 0;
+
+   if((size = getSn_RX_RSR(sb_sn)) == 0) return 0;
+
+   /* What does not fit stays in the socket, the TCP window closes */
+   while(done < size)
+   {
+      len = UARTPORT_TxReserve(sb_uart, &room);
+      if(len == 0) break;
+      if(len > size - done) len = size - done;
+      wiz_recv_data(sb_sn, room, len);
+      UARTPORT_TxCommit(sb_uart, len);
+      done += len;
+   }
+   if(done)
+   {
+      setSn_CR(sb_sn, Sn_CR_RECV);
+      while(getSn_CR(sb_sn));
+      sb_to_serial += done;
+   }
+   return done;
+}
+
+int8_t serbridge_init(uint8_t sn, uint16_t port, uint32_t uart_port,
+                      uint8_t* txbuf, uint16_t txsize, uint8_t* rxbuf, uint16_t rxsize)
+{
+   if(sn >= _WIZCHIP_SOCK_NUM_) return SOCKERR_SOCKNUM;
+   if(txsize < 2 || rxsize < 2) return SOCKERR_ARG;
+
+   sb_sn = sn;
+   sb_port = port;
+   sb_uart = uart_port;
+   sb_rxbuf = rxbuf;
+   sb_rxsize = rxsize;
+   sb_last_count = 0;
+   sb_scanned = 0;
+   sb_sending = 0;
+   sb_to_net = 0;
+   sb_to_serial = 0;
+
+   UARTPORT_Init(uart_port, txbuf, txsize, rxbuf, rxsize);
+   UARTPORT_SetPolicy(uart_port, UARTBUF_Policy_Block);
+   return SOCK_OK;
+}
+
+void serbridge_set_packing(uint16_t size, int16_t delimiter, uint16_t timeout)
+{
+   sb_pack_size = size;
+   sb_delim = delimiter;
+   sb_timeout = timeout;
+   sb_scanned = 0;
+}
+
+void serbridge_time_handler(void)
+{
+   sb_tick++;
+}
+
+int32_t serbridge_run(void)
+{
+   int32_t ret;
+
+   switch(getSn_SR(sb_sn))
+   {
+      case SOCK_ESTABLISHED :
+         if(getSn_IR(sb_sn) & Sn_IR_CON)
+         {
+#ifdef _SERBRIDGE_DEBUG_
+            uint8_t destip[4];
+            getSn_DIPR(sb_sn, destip);
+            printf("%d:Bridge connected - %d.%d.%d.%d : %d\r\n", sb_sn,
+                   destip[0], destip[1], destip[2], destip[3], getSn_DPORT(sb_sn));
+#endif
+            setSn_IR(sb_sn, Sn_IR_CON);
+            sb_sending = 0;
+         }
+         if((ret = sb_serial_to_net()) < 0) return ret;
+         sb_net_to_serial();
+         break;
+      case SOCK_CLOSE_WAIT :
+         /* Deliver what the peer sent before closing */
+         sb_net_to_serial();
+         if(getSn_RX_RSR(sb_sn) != 0) break;
+         if((ret = disconnect(sb_sn)) != SOCK_OK) return ret;
+#ifdef _SERBRIDGE_DEBUG_
+         printf("%d:Bridge closed\r\n", sb_sn);
+#endif
+         break;
+      case SOCK_INIT :
+         if((ret = listen(sb_sn)) != SOCK_OK) return ret;
+         break;
+      case SOCK_CLOSED :
+         sb_sending = 0;
+         if((ret = socket(sb_sn, Sn_MR_TCP, sb_port, 0x00)) != sb_sn) return ret;
+#ifdef _SERBRIDGE_DEBUG_
+         printf("%d:Bridge listen, port [%d]\r\n", sb_sn, sb_port);
+#endif
+         break;
+      default :
+         break;
+   }
+   return 1;
+}
+
+uint32_t serbridge_get_serial_to_net(void)
+{
+   return sb_to_net;
+}
+
+uint32_t serbridge_get_net_to_serial(void)
+{
+   return sb_to_serial;
+}
@@ -0,0 +1,54 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _SERBRIDGE_H_
+#define _SERBRIDGE_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "W7500x_wztoe.h"
+
+
+/* Serial bridge debug message printout enable */
+//#define _SERBRIDGE_DEBUG_
+
+/* Value of the delimiter argument of serbridge_set_packing() that disables it */
+#define SERBRIDGE_NO_DELIM			(-1)
+
+/* Start the bridge between a buffered UART port (UARTPORT_0, UARTPORT_1 or UARTPORT_2 of
+ * w7500x_uart_buf.h) and a TCP server on socket sn. The UART must be initialized; the
+ * bridge starts the port on the given ring buffers with UARTBUF_Policy_Block, so that with
+ * UART_HardwareFlowControl_RTS_CTS the serial sender is held while the TCP peer is slow,
+ * and socket data is left unread (closing the TCP window) while the serial line is slow.
+ * Call UARTPORT_IRQHandler(uart_port) from the UART interrupt handler. */
+int8_t  serbridge_init(uint8_t sn, uint16_t port, uint32_t uart_port,
+                       uint8_t* txbuf, uint16_t txsize, uint8_t* rxbuf, uint16_t rxsize);
+
+/* Serial data is sent to the socket when any condition is met :
+ *   size      bytes are pending (0 : no size limit, the ring buffer size is the limit),
+ *   delimiter is received, it is sent as the last byte (SERBRIDGE_NO_DELIM : none),
+ *   timeout   serbridge_time_handler() ticks passed without a new byte (0 : none).
+ * With no condition at all, pending bytes are sent on every serbridge_run(). */
+void    serbridge_set_packing(uint16_t size, int16_t delimiter, uint16_t timeout);
+
+/* Tick of the inter-character timeout, call from a timer interrupt (e.g. every 1ms) */
+void    serbridge_time_handler(void);
+
+/* Main loop handler, runs the TCP server and moves data both ways.
+ * Returns 1, or a SOCKERR_ code of the socket layer. */
+int32_t serbridge_run(void);
+
+/* Number of bytes forwarded from the serial line to the socket, and back */
+uint32_t serbridge_get_serial_to_net(void);
+uint32_t serbridge_get_net_to_serial(void);
+#endif
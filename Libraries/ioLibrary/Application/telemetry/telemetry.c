@@ -0,0 +1,196 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+
+static uint8_t  tm_sn;
+static uint8_t  tm_collector_ip[4];
+static uint16_t tm_collector_port;
+static uint32_t tm_period;
+static uint8_t  tm_channels;
+static uint16_t tm_seq;
+
+static uint8_t  tm_frame[TELEMETRY_FRAME_SIZE];
+static uint16_t tm_len;
+static uint8_t  tm_samples;
+static uint32_t tm_last_time;
+static int32_t  tm_prev[TELEMETRY_MAX_CHANNELS];
+
+static volatile uint32_t tm_tick = 0;
+static uint32_t tm_next_send;
+
+static uint8_t* put_varint(uint8_t* p, uint32_t v)
+{
+   while(v >= 0x80)
+   {
+      *p++ = (uint8_t)(v | 0x80);
+      v >>= 7;
+   }
+   *p++ = (uint8_t)v;
+   return p;
+}
+
+static const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint32_t* v)
+{
+   uint32_t val = 0;
+   uint8_t  shift = 0;
+
+   while(p < end && shift < 35)
+   {
+      val |= (uint32_t)(*p & 0x7F) << shift;
+      if(!(*p++ & 0x80))
+      {
+         *v = val;
+         return p;
+      }
+      shift += 7;
+   }
+   return 0;
+}
+
+/* Map signed deltas to unsigned so that small negative values stay short */
+#define ZIGZAG_ENC(x)	(((uint32_t)(x) << 1) ^ (uint32_t)((x) >> 31))
+#define ZIGZAG_DEC(x)	((int32_t)(((x) >> 1) ^ (~((x) & 1) + 1)))
+
+static void telemetry_begin(void)
+{
+   tm_frame[0] = TELEMETRY_MAGIC;
+   tm_frame[1] = TELEMETRY_VERSION;
+   tm_frame[2] = (uint8_t)(tm_seq >> 8);
+   tm_frame[3] = (uint8_t)tm_seq;
+   tm_frame[4] = tm_channels;
+   tm_frame[5] = 0;
+   tm_len = TELEMETRY_HDR_LEN;
+   tm_samples = 0;
+   memset(tm_prev, 0, sizeof(tm_prev));
+}
+
+int8_t telemetry_init(uint8_t sn, uint16_t port, uint8_t* collector_ip, uint16_t collector_port,
+                      uint32_t period, uint8_t channels)
+{
+   int8_t ret;
+
+   if(channels == 0 || channels > TELEMETRY_MAX_CHANNELS) return SOCKERR_ARG;
+
+   tm_sn = sn;
+   memcpy(tm_collector_ip, collector_ip, 4);
+   tm_collector_port = collector_port;
+   tm_period = period;
+   tm_channels = channels;
+   tm_seq = 0;
+   tm_next_send = tm_tick + period;
+   telemetry_begin();
+
+   if((ret = socket(sn, Sn_MR_UDP, port, 0x00)) != sn) return ret;
+#ifdef _TELEMETRY_DEBUG_
+   printf("%d:Telemetry to %d.%d.%d.%d : %d\r\n", sn, collector_ip[0], collector_ip[1], collector_ip[2], collector_ip[3], collector_port);
+#endif
+   return SOCK_OK;
+}
+
+int32_t telemetry_flush(void)
+{
+   int32_t ret;
+
+   if(tm_samples == 0) return 0;
+
+   tm_frame[5] = tm_samples;
+   ret = sendto(tm_sn, tm_frame, tm_len, tm_collector_ip, tm_collector_port);
+   tm_seq++;
+   telemetry_begin();
+   return ret;
+}
+
+int32_t telemetry_sample(const int32_t* values)
+{
+   uint32_t now = tm_tick;
+   uint8_t* p;
+   uint8_t  i;
+   int32_t  ret = 0;
+
+   /* Worst case : 5 bytes for the time delta and 5 per channel */
+   if(tm_samples == 0xFF || tm_len + 5 * (tm_channels + 1) > TELEMETRY_FRAME_SIZE)
+   {
+      if((ret = telemetry_flush()) < 0) return ret;
+   }
+
+   if(tm_samples == 0)
+   {
+      tm_frame[6] = (uint8_t)(now >> 24);
+      tm_frame[7] = (uint8_t)(now >> 16);
+      tm_frame[8] = (uint8_t)(now >> 8);
+      tm_frame[9] = (uint8_t)now;
+      tm_last_time = now;
+   }
+
+   p = &tm_frame[tm_len];
+   p = put_varint(p, now - tm_last_time);
+   for(i = 0; i < tm_channels; i++)
+   {
+      p = put_varint(p, ZIGZAG_ENC(values[i] - tm_prev[i]));
+      tm_prev[i] = values[i];
+   }
+   tm_len = (uint16_t)(p - tm_frame);
+   tm_last_time = now;
+   tm_samples++;
+
+   return ret;
+}
+
+void telemetry_time_handler(void)
+{
+   tm_tick++;
+}
+
+int32_t telemetry_run(void)
+{
+   if((int32_t)(tm_tick - tm_next_send) < 0) return 0;
+
+   tm_next_send += tm_period;
+   return telemetry_flush();
+}
+
+int32_t telemetry_decode(const uint8_t* frame, uint16_t len, uint16_t* seq,
+                         int32_t* values, uint32_t* times, uint16_t max_samples)
+{
+   const uint8_t* p = frame + TELEMETRY_HDR_LEN;
+   const uint8_t* end = frame + len;
+   uint8_t  channels, samples;
+   uint32_t t, v;
+   uint16_t s;
+   uint8_t  c;
+
+   if(len < TELEMETRY_HDR_LEN || frame[0] != TELEMETRY_MAGIC || frame[1] != TELEMETRY_VERSION) return -1;
+
+   *seq = ((uint16_t)frame[2] << 8) | frame[3];
+   channels = frame[4];
+   samples = frame[5];
+   t = ((uint32_t)frame[6] << 24) | ((uint32_t)frame[7] << 16) | ((uint32_t)frame[8] << 8) | frame[9];
+   /* The channel count comes from the wire, values[] only has room for TELEMETRY_MAX_CHANNELS */
+   if(channels == 0 || channels > TELEMETRY_MAX_CHANNELS || samples > max_samples) return -1;
+
+   for(s = 0; s < samples; s++)
+   {
+      if((p = get_varint(p, end, &v)) == 0) return -1;
+      t += v;
+      times[s] = t;
+      for(c = 0; c < channels; c++)
+      {
+         if((p = get_varint(p, end, &v)) == 0) return -1;
+         values[s * channels + c] = ((s == 0) ? 0 : values[(s - 1) * channels + c]) + ZIGZAG_DEC(v);
+      }
+   }
+   return samples;
+}
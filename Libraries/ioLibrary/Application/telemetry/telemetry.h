@@ -0,0 +1,65 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "W7500x_wztoe.h"
+
+
+/* Telemetry debug message printout enable */
+//#define _TELEMETRY_DEBUG_
+
+/* Maximum number of values per sample (ADC channels, GPIO ports, counters...) */
+#ifndef TELEMETRY_MAX_CHANNELS
+	#define TELEMETRY_MAX_CHANNELS	16
+#endif
+
+/* Largest frame handed to sendto(), kept below the Ethernet MTU */
+#ifndef TELEMETRY_FRAME_SIZE
+	#define TELEMETRY_FRAME_SIZE	512
+#endif
+
+/* Frame layout, multi-byte header fields are big-endian :
+ *   [0] magic 0xA5  [1] version  [2] sequence (2)  [4] channels  [5] samples  [6] t0 (4)
+ *   then for every sample : varint time delta, and for every channel the zigzag
+ *   varint of the difference with the previous sample (with 0 for the first one). */
+#define TELEMETRY_MAGIC				0xA5
+#define TELEMETRY_VERSION			1
+#define TELEMETRY_HDR_LEN			10
+
+/* Open the UDP socket and set the collector. period is the number of
+ * telemetry_time_handler() ticks between two frames, channels the values per sample. */
+int8_t  telemetry_init(uint8_t sn, uint16_t port, uint8_t* collector_ip, uint16_t collector_port,
+                       uint32_t period, uint8_t channels);
+
+/* Append one sample of 'channels' values. The frame is sent first if it is full. */
+int32_t telemetry_sample(const int32_t* values);
+
+/* Tick, call from a timer interrupt. Also used as the sample time base. */
+void    telemetry_time_handler(void);
+
+/* Main loop handler, sends the pending frame when the period has elapsed */
+int32_t telemetry_run(void);
+
+/* Send the pending frame now */
+int32_t telemetry_flush(void);
+
+/* Decode a frame back into values[samples][channels] and times[samples]. values must hold
+ * max_samples * TELEMETRY_MAX_CHANNELS entries, frames with more channels are rejected.
+ * Returns the number of samples, -1 if the frame is malformed. Uses no hardware. */
+int32_t telemetry_decode(const uint8_t* frame, uint16_t len, uint16_t* seq,
+                         int32_t* values, uint32_t* times, uint16_t max_samples);
+#endif
@@ -0,0 +1,435 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "tlssock.h"
+#include "wizchip_conf.h"
+#include "w7500x_rng.h"
+
+#define TLSSOCK_ST_IDLE			0
+#define TLSSOCK_ST_HANDSHAKE	1
+#define TLSSOCK_ST_OPEN			2
+
+#define TLSSOCK_VERSION_TLS12	0x0303
+#define TLSSOCK_VERSION_DTLS12	0xFEFD
+
+#define TLSSOCK_SEQ_MASK		0x0000FFFFFFFFFFFFULL	// DTLS sequence number is 48-bit
+
+typedef struct
+{
+   uint8_t  used;
+   uint8_t  sn;
+   uint8_t  dtls;
+   uint8_t  state;
+   const tlssock_backend* backend;
+   uint8_t  peer_ip[4];
+   uint16_t peer_port;
+   uint16_t rd_epoch;
+   uint16_t wr_epoch;
+   uint64_t rd_seq;
+   uint64_t wr_seq;
+   uint16_t in_len;        // DTLS : bytes of the current datagram held in 'in'
+   uint16_t in_off;        // DTLS : offset of the next record in the datagram
+   uint8_t* app;           // Decrypted application data not yet returned
+   uint16_t app_len;
+   uint8_t  in[TLSSOCK_RECORD_SIZE];
+   uint8_t  out[TLSSOCK_RECORD_SIZE];
+   uint32_t backend_ctx[TLSSOCK_BACKEND_CTX_SIZE / 4];
+} tlssock_ctx;
+
+static tlssock_ctx tlssock_ctxs[TLSSOCK_MAX];
+
+static tlssock_ctx* tlssock_get(uint8_t sn)
+{
+   uint8_t i;
+
+   for(i = 0; i < TLSSOCK_MAX; i++)
+   {
+      if(tlssock_ctxs[i].used && tlssock_ctxs[i].sn == sn) return &tlssock_ctxs[i];
+   }
+   return 0;
+}
+
+void tlssock_random(uint8_t* out, uint16_t len)
+{
+   uint32_t rn = 0;
+   uint16_t i;
+
+   for(i = 0; i < len; i++)
+   {
+      if((i & 0x3) == 0) rn = RNG_GetRandomNumber();
+      out[i] = (uint8_t)rn;
+      rn >>= 8;
+   }
+}
+
+/* Copy from the socket RX memory without moving Sn_RX_RD */
+static void tlssock_peek(uint8_t sn, uint8_t* buf, uint16_t len)
+{
+   WIZCHIP_READ_BUF((RXMEM_BASE) | ((sn & 0x7) << 18), getSn_RX_RD(sn), buf, len);
+}
+
+static uint16_t tlssock_hdr_len(tlssock_ctx* ctx)
+{
+   return ctx->dtls ? TLSSOCK_DTLS_HDR_LEN : TLSSOCK_TLS_HDR_LEN;
+}
+
+static void tlssock_build_hdr(tlssock_ctx* ctx, uint8_t* hdr, uint8_t type, uint16_t len)
+{
+   uint16_t version = ctx->dtls ? TLSSOCK_VERSION_DTLS12 : TLSSOCK_VERSION_TLS12;
+   uint8_t* p = hdr;
+   int8_t   i;
+
+   *p++ = type;
+   *p++ = (uint8_t)(version >> 8);
+   *p++ = (uint8_t)version;
+   if(ctx->dtls)
+   {
+      *p++ = (uint8_t)(ctx->wr_epoch >> 8);
+      *p++ = (uint8_t)ctx->wr_epoch;
+      for(i = 5; i >= 0; i--) *p++ = (uint8_t)(ctx->wr_seq >> (8 * i));
+   }
+   *p++ = (uint8_t)(len >> 8);
+   *p   = (uint8_t)len;
+}
+
+/* Protect and transmit one record whose payload is already in ctx->out after the header */
+static int32_t tlssock_write_record(tlssock_ctx* ctx, uint8_t type, uint16_t len)
+{
+   uint16_t hlen = tlssock_hdr_len(ctx);
+   uint8_t* hdr = ctx->out;
+   int32_t  ret;
+
+   tlssock_build_hdr(ctx, hdr, type, len);
+   if(ctx->wr_epoch)
+   {
+      ret = ctx->backend->seal(ctx->backend_ctx, ctx->wr_seq, hdr, hdr + hlen, len, TLSSOCK_RECORD_SIZE - hlen);
+      if(ret < 0) return ret;
+      len = (uint16_t)ret;
+      hdr[hlen - 2] = (uint8_t)(len >> 8);
+      hdr[hlen - 1] = (uint8_t)len;
+   }
+   ctx->wr_seq++;
+   len += hlen;
+
+   /* The sequence number is spent, so the record has to go out even in non-blocking mode */
+   do
+   {
+      if(ctx->dtls) ret = sendto(ctx->sn, ctx->out, len, ctx->peer_ip, ctx->peer_port);
+      else          ret = send(ctx->sn, ctx->out, len);
+   } while(ret == SOCK_BUSY);
+
+   return (ret < 0) ? ret : TLSSOCK_OK;
+}
+
+/* Fetch the next complete record into ctx->in. Partial TLS records are left in the
+ * socket RX memory until they are complete, so only one record is ever held in RAM.
+ * Returns a pointer to the record header, 0 if none is available, sets *ret on error. */
+static uint8_t* tlssock_fetch_record(tlssock_ctx* ctx, int32_t* ret)
+{
+   uint8_t* rec;
+   uint16_t hlen = tlssock_hdr_len(ctx);
+   uint16_t rlen;
+   int32_t  len;
+   uint8_t  addr[4];
+   uint16_t port;
+
+   *ret = TLSSOCK_BUSY;
+   if(ctx->dtls)
+   {
+      if(ctx->in_off >= ctx->in_len)
+      {
+         if(getSn_RX_RSR(ctx->sn) == 0) return 0;
+         len = recvfrom(ctx->sn, ctx->in, TLSSOCK_RECORD_SIZE, addr, &port);
+         if(len <= 0)
+         {
+            *ret = len;
+            return 0;
+         }
+         /* Datagrams from other hosts are not part of the session */
+         if(memcmp(addr, ctx->peer_ip, 4) != 0 || port != ctx->peer_port) return 0;
+         ctx->in_len = (uint16_t)len;
+         ctx->in_off = 0;
+      }
+      if(ctx->in_len - ctx->in_off < hlen)
+      {
+         ctx->in_off = ctx->in_len;
+         *ret = TLSSOCK_ERR_RECORD;
+         return 0;
+      }
+      rec = &ctx->in[ctx->in_off];
+      rlen = ((uint16_t)rec[hlen - 2] << 8) | rec[hlen - 1];
+      if(rlen > ctx->in_len - ctx->in_off - hlen)
+      {
+         ctx->in_off = ctx->in_len;
+         *ret = TLSSOCK_ERR_RECORD;
+         return 0;
+      }
+      ctx->in_off += hlen + rlen;
+      return rec;
+   }
+
+   if(getSn_RX_RSR(ctx->sn) < hlen) return 0;
+   tlssock_peek(ctx->sn, ctx->in, hlen);
+   rlen = ((uint16_t)ctx->in[hlen - 2] << 8) | ctx->in[hlen - 1];
+   if(rlen > TLSSOCK_RECORD_SIZE - hlen)
+   {
+      *ret = TLSSOCK_ERR_RECORD;
+      return 0;
+   }
+   if(getSn_RX_RSR(ctx->sn) < hlen + rlen) return 0;
+
+   len = recv(ctx->sn, ctx->in, hlen + rlen);
+   if(len != hlen + rlen)
+   {
+      *ret = (len < 0) ? len : TLSSOCK_ERR_RECORD;
+      return 0;
+   }
+   return ctx->in;
+}
+
+/* Read and unprotect one record. Returns its content type, 0 if none, < 0 on error. */
+static int32_t tlssock_read_record(tlssock_ctx* ctx, uint8_t** payload, uint16_t* plen)
+{
+   uint8_t* rec;
+   uint16_t hlen = tlssock_hdr_len(ctx);
+   uint16_t epoch;
+   uint64_t seq = 0;
+   int32_t  ret;
+   uint8_t  i;
+
+   rec = tlssock_fetch_record(ctx, &ret);
+   if(rec == 0) return ret;
+
+   *payload = rec + hlen;
+   *plen = ((uint16_t)rec[hlen - 2] << 8) | rec[hlen - 1];
+
+   if(ctx->dtls)
+   {
+      epoch = ((uint16_t)rec[3] << 8) | rec[4];
+      for(i = 5; i < 11; i++) seq = (seq << 8) | rec[i];
+      /* Records of another epoch and replayed records are silently dropped */
+      if(epoch != ctx->rd_epoch || (seq < ctx->rd_seq)) return TLSSOCK_BUSY;
+   }
+   else
+   {
+      seq = ctx->rd_seq;
+   }
+
+   if(ctx->rd_epoch)
+   {
+      ret = ctx->backend->open(ctx->backend_ctx, seq, rec, *payload, *plen);
+      if(ret < 0)
+      {
+         /* DTLS discards forged datagrams, TLS has to tear the connection down */
+         return ctx->dtls ? TLSSOCK_BUSY : TLSSOCK_ERR_AUTH;
+      }
+      *plen = (uint16_t)ret;
+   }
+   /* Only an authenticated record moves the replay window, a forged sequence number must not */
+   ctx->rd_seq = (seq + 1) & TLSSOCK_SEQ_MASK;
+
+   return rec[0];
+}
+
+int8_t tlssock_attach(uint8_t sn, const tlssock_backend* backend, uint8_t* peer_ip, uint16_t peer_port)
+{
+   tlssock_ctx* ctx;
+   uint8_t i;
+
+   if(sn >= _WIZCHIP_SOCK_NUM_) return SOCKERR_SOCKNUM;
+
+   ctx = tlssock_get(sn);
+   for(i = 0; ctx == 0 && i < TLSSOCK_MAX; i++)
+   {
+      if(!tlssock_ctxs[i].used) ctx = &tlssock_ctxs[i];
+   }
+   if(ctx == 0) return TLSSOCK_ERR_NOCTX;
+
+   memset(ctx, 0, sizeof(tlssock_ctx));
+   ctx->used = 1;
+   ctx->sn = sn;
+   ctx->dtls = ((getSn_MR(sn) & 0x0F) == Sn_MR_UDP) ? 1 : 0;
+   ctx->backend = backend;
+   if(peer_ip) memcpy(ctx->peer_ip, peer_ip, 4);
+   ctx->peer_port = peer_port;
+
+   if(backend->init(ctx->backend_ctx, ctx->dtls, tlssock_random) < 0)
+   {
+      ctx->used = 0;
+      return TLSSOCK_ERR_STATE;
+   }
+   ctx->state = TLSSOCK_ST_HANDSHAKE;
+   return TLSSOCK_OK;
+}
+
+int32_t tlssock_handshake(uint8_t sn)
+{
+   tlssock_ctx* ctx = tlssock_get(sn);
+   uint8_t* payload;
+   uint16_t plen;
+   uint8_t  type;
+   int32_t  ret;
+
+   if(ctx == 0) return TLSSOCK_ERR_NOCTX;
+   if(ctx->state == TLSSOCK_ST_OPEN) return TLSSOCK_OK;
+   if(ctx->state != TLSSOCK_ST_HANDSHAKE) return TLSSOCK_ERR_STATE;
+
+   /* Flush the pending flight */
+   while((ret = ctx->backend->hs_output(ctx->backend_ctx, &type, ctx->out + tlssock_hdr_len(ctx),
+                                        TLSSOCK_MAX_FRAGMENT)) > 0)
+   {
+      if((ret = tlssock_write_record(ctx, type, (uint16_t)ret)) < 0) return ret;
+      if(type == TLSSOCK_CT_CCS)
+      {
+         ctx->wr_epoch++;
+         ctx->wr_seq = 0;
+      }
+   }
+   if(ret < 0) return ret;
+
+   ret = tlssock_read_record(ctx, &payload, &plen);
+   if(ret <= 0) return ret;
+
+   type = (uint8_t)ret;
+   ret = ctx->backend->hs_input(ctx->backend_ctx, type, payload, plen);
+   if(type == TLSSOCK_CT_CCS)
+   {
+      ctx->rd_epoch++;
+      ctx->rd_seq = 0;
+   }
+   if(ret < 0 || type == TLSSOCK_CT_ALERT)
+   {
+#ifdef _TLSSOCK_DEBUG_
+      printf("%d:TLS handshake failed %ld\r\n", sn, (long)ret);
+#endif
+      tlssock_close(sn);
+      return (type == TLSSOCK_CT_ALERT) ? TLSSOCK_ERR_ALERT : ret;
+   }
+   if(ret == TLSSOCK_OK)
+   {
+      /* The last flight (e.g. client Finished) may still be pending */
+      while((ret = ctx->backend->hs_output(ctx->backend_ctx, &type, ctx->out + tlssock_hdr_len(ctx),
+                                           TLSSOCK_MAX_FRAGMENT)) > 0)
+      {
+         if((ret = tlssock_write_record(ctx, type, (uint16_t)ret)) < 0) return ret;
+      }
+      ctx->state = TLSSOCK_ST_OPEN;
+#ifdef _TLSSOCK_DEBUG_
+      printf("%d:TLS session established\r\n", sn);
+#endif
+      return TLSSOCK_OK;
+   }
+   return TLSSOCK_BUSY;
+}
+
+int32_t tlssock_send(uint8_t sn, uint8_t* buf, uint16_t len)
+{
+   tlssock_ctx* ctx = tlssock_get(sn);
+   uint16_t chunk;
+   uint16_t sent = 0;
+   int32_t  ret;
+
+   if(ctx == 0) return TLSSOCK_ERR_NOCTX;
+   if(ctx->state != TLSSOCK_ST_OPEN) return TLSSOCK_ERR_STATE;
+
+   while(sent < len)
+   {
+      chunk = len - sent;
+      if(chunk > TLSSOCK_MAX_FRAGMENT) chunk = TLSSOCK_MAX_FRAGMENT;
+      memcpy(ctx->out + tlssock_hdr_len(ctx), buf + sent, chunk);
+      if((ret = tlssock_write_record(ctx, TLSSOCK_CT_APPDATA, chunk)) < 0) return ret;
+      sent += chunk;
+   }
+   return sent;
+}
+
+int32_t tlssock_recv(uint8_t sn, uint8_t* buf, uint16_t len)
+{
+   tlssock_ctx* ctx = tlssock_get(sn);
+   uint8_t* payload;
+   uint16_t plen;
+   int32_t  ret;
+
+   if(ctx == 0) return TLSSOCK_ERR_NOCTX;
+   if(ctx->state != TLSSOCK_ST_OPEN) return TLSSOCK_ERR_STATE;
+
+   while(ctx->app_len == 0)
+   {
+      ret = tlssock_read_record(ctx, &payload, &plen);
+      if(ret <= 0) return ret;
+      if(ret == TLSSOCK_CT_ALERT)
+      {
+         tlssock_close(sn);
+         return TLSSOCK_ERR_ALERT;
+      }
+      if(ret == TLSSOCK_CT_APPDATA)
+      {
+         ctx->app = payload;
+         ctx->app_len = plen;
+      }
+      /* Post-handshake messages (e.g. HelloRequest) are ignored */
+   }
+
+   if(len > ctx->app_len) len = ctx->app_len;
+   memcpy(buf, ctx->app, len);
+   ctx->app += len;
+   ctx->app_len -= len;
+   return len;
+}
+
+int32_t tlssock_sendto(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t port)
+{
+   tlssock_ctx* ctx = tlssock_get(sn);
+
+   if(ctx == 0) return TLSSOCK_ERR_NOCTX;
+   if(!ctx->dtls) return SOCKERR_SOCKMODE;
+   /* A DTLS session is bound to a single peer */
+   if(memcmp(addr, ctx->peer_ip, 4) != 0 || port != ctx->peer_port) return SOCKERR_IPINVALID;
+   if(len > TLSSOCK_MAX_FRAGMENT) return SOCKERR_DATALEN;
+
+   return tlssock_send(sn, buf, len);
+}
+
+int32_t tlssock_recvfrom(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t* port)
+{
+   tlssock_ctx* ctx = tlssock_get(sn);
+   int32_t ret;
+
+   if(ctx == 0) return TLSSOCK_ERR_NOCTX;
+   if(!ctx->dtls) return SOCKERR_SOCKMODE;
+
+   ret = tlssock_recv(sn, buf, len);
+   if(ret > 0)
+   {
+      /* Datagram semantics : the unread part of the record is dropped */
+      ctx->app_len = 0;
+      memcpy(addr, ctx->peer_ip, 4);
+      *port = ctx->peer_port;
+   }
+   return ret;
+}
+
+int8_t tlssock_close(uint8_t sn)
+{
+   tlssock_ctx* ctx = tlssock_get(sn);
+
+   if(ctx)
+   {
+      memset(ctx->backend_ctx, 0, sizeof(ctx->backend_ctx));   // Wipe the session keys
+      ctx->used = 0;
+      ctx->state = TLSSOCK_ST_IDLE;
+   }
+   return close(sn);
+}
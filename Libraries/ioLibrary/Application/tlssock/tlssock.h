@@ -0,0 +1,105 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _TLSSOCK_H_
+#define _TLSSOCK_H_
+
+#include <stdint.h>
+#include "socket.h"
+#include "W7500x_wztoe.h"
+
+
+/* TLS socket debug message printout enable */
+//#define _TLSSOCK_DEBUG_
+
+/* Number of sockets that can run TLS/DTLS at the same time */
+#ifndef TLSSOCK_MAX
+	#define TLSSOCK_MAX				2
+#endif
+
+/* Largest plaintext fragment. Must match the max_fragment_length negotiated by the backend. */
+#ifndef TLSSOCK_MAX_FRAGMENT
+	#define TLSSOCK_MAX_FRAGMENT	1024
+#endif
+
+/* Room left in a record for the explicit nonce and the authentication tag */
+#ifndef TLSSOCK_MAX_EXPANSION
+	#define TLSSOCK_MAX_EXPANSION	32
+#endif
+
+/* Static state area handed to the crypto backend, per socket */
+#ifndef TLSSOCK_BACKEND_CTX_SIZE
+	#define TLSSOCK_BACKEND_CTX_SIZE	512
+#endif
+
+#define TLSSOCK_TLS_HDR_LEN			5
+#define TLSSOCK_DTLS_HDR_LEN		13
+#define TLSSOCK_RECORD_SIZE			(TLSSOCK_DTLS_HDR_LEN + TLSSOCK_MAX_FRAGMENT + TLSSOCK_MAX_EXPANSION)
+
+/* Record content types */
+#define TLSSOCK_CT_CCS				20
+#define TLSSOCK_CT_ALERT			21
+#define TLSSOCK_CT_HANDSHAKE		22
+#define TLSSOCK_CT_APPDATA			23
+
+/* Return values, errors of socket.c are passed through unchanged */
+#define TLSSOCK_OK					1
+#define TLSSOCK_BUSY				0
+#define TLSSOCK_ERR_NOCTX			-100	///< Socket is not attached or no free context
+#define TLSSOCK_ERR_STATE			-101	///< Operation not allowed in the current state
+#define TLSSOCK_ERR_RECORD			-102	///< Malformed or oversized record
+#define TLSSOCK_ERR_AUTH			-103	///< Record authentication failed
+#define TLSSOCK_ERR_ALERT			-104	///< Peer sent an alert, connection closed
+
+/* Random generator handed to the backend */
+typedef void (*tlssock_rng)(uint8_t* out, uint16_t len);
+
+/* Crypto backend. It implements a single fixed cipher suite (e.g. TLS_PSK_WITH_AES_128_CCM_8
+ * or TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8) and never touches the socket : tlssock owns record
+ * framing, sequence numbers, epochs and I/O. All state lives in the 'ctx' area.
+ * tlssock_psk.h provides TLS_PSK_WITH_AES_128_CCM_8. */
+typedef struct
+{
+   /* Prepare a new session. dtls is 1 for DTLS 1.2, 0 for TLS 1.2. */
+   int32_t (*init)(void* ctx, uint8_t dtls, tlssock_rng rng);
+   /* Next outgoing handshake fragment (handshake, CCS or alert). Returns its length
+    * and sets *type, 0 if nothing is pending, < 0 on error. */
+   int32_t (*hs_output)(void* ctx, uint8_t* type, uint8_t* out, uint16_t size);
+   /* Incoming handshake, CCS or alert payload. Returns TLSSOCK_OK once the session is
+    * established, TLSSOCK_BUSY while the handshake goes on, < 0 on error. */
+   int32_t (*hs_input)(void* ctx, uint8_t type, const uint8_t* in, uint16_t len);
+   /* Protect buf[0..len) in place for the record header hdr. Returns the protected length. */
+   int32_t (*seal)(void* ctx, uint64_t seq, const uint8_t* hdr, uint8_t* buf, uint16_t len, uint16_t size);
+   /* Verify and decrypt buf[0..len) in place. Returns the plaintext length or TLSSOCK_ERR_AUTH. */
+   int32_t (*open)(void* ctx, uint64_t seq, const uint8_t* hdr, uint8_t* buf, uint16_t len);
+} tlssock_backend;
+
+/* Attach a TLS (TCP socket) or DTLS (UDP socket) session to an opened socket.
+ * For DTLS, peer_ip/peer_port give the server address used during the handshake. */
+int8_t  tlssock_attach(uint8_t sn, const tlssock_backend* backend, uint8_t* peer_ip, uint16_t peer_port);
+
+/* Run the handshake, non-blocking. Returns TLSSOCK_OK once established, TLSSOCK_BUSY otherwise. */
+int32_t tlssock_handshake(uint8_t sn);
+
+/* Record-layer counterparts of send/recv/sendto/recvfrom */
+int32_t tlssock_send(uint8_t sn, uint8_t* buf, uint16_t len);
+int32_t tlssock_recv(uint8_t sn, uint8_t* buf, uint16_t len);
+int32_t tlssock_sendto(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t port);
+int32_t tlssock_recvfrom(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t* port);
+
+/* Release the session and close the socket */
+int8_t  tlssock_close(uint8_t sn);
+
+/* Fill out with random bytes from the RNG peripheral */
+void    tlssock_random(uint8_t* out, uint16_t len);
+#endif
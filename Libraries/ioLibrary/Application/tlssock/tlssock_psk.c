@@ -0,0 +1,738 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "tlssock_psk.h"
+
+/* Handshake states of the client */
+#define PSK_ST_HELLO			0	// ClientHello to send
+#define PSK_ST_SERVER_HELLO		1	// Waiting for ServerHello (or HelloVerifyRequest)
+#define PSK_ST_SERVER_DONE		2	// Waiting for ServerHelloDone
+#define PSK_ST_KEY_EXCHANGE		3	// ClientKeyExchange to send
+#define PSK_ST_CCS				4	// ChangeCipherSpec to send
+#define PSK_ST_FINISHED			5	// Finished to send
+#define PSK_ST_SERVER_CCS		6	// Waiting for the server ChangeCipherSpec
+#define PSK_ST_SERVER_FINISHED	7	// Waiting for the server Finished
+#define PSK_ST_OPEN				8
+
+/* Handshake message types */
+#define PSK_HS_HELLO_REQUEST	0
+#define PSK_HS_CLIENT_HELLO		1
+#define PSK_HS_SERVER_HELLO		2
+#define PSK_HS_HELLO_VERIFY		3
+#define PSK_HS_SERVER_KEY_EX	12
+#define PSK_HS_SERVER_DONE		14
+#define PSK_HS_CLIENT_KEY_EX	16
+#define PSK_HS_FINISHED			20
+
+#define PSK_SUITE				0xC0A8	// TLS_PSK_WITH_AES_128_CCM_8
+#define PSK_SCSV				0x00FF	// TLS_EMPTY_RENEGOTIATION_INFO_SCSV
+#define PSK_EXT_MAX_FRAGMENT	0x0001
+
+#define PSK_NONCE_LEN			8		// Explicit part of the CCM nonce, sent in each record
+#define PSK_TAG_LEN				8
+#define PSK_VERIFY_LEN			12
+
+/* max_fragment_length code (RFC 6066) for TLSSOCK_MAX_FRAGMENT, 0 to not send the extension */
+#if TLSSOCK_MAX_FRAGMENT <= 512
+	#define PSK_MFL_CODE		1
+#elif TLSSOCK_MAX_FRAGMENT <= 1024
+	#define PSK_MFL_CODE		2
+#elif TLSSOCK_MAX_FRAGMENT <= 2048
+	#define PSK_MFL_CODE		3
+#elif TLSSOCK_MAX_FRAGMENT <= 4096
+	#define PSK_MFL_CODE		4
+#else
+	#define PSK_MFL_CODE		0
+#endif
+
+typedef struct
+{
+   uint32_t h[8];
+   uint32_t len;           // Bytes hashed, handshake transcripts stay far below 4 GB
+   uint8_t  buf[64];
+} psk_sha256;
+
+typedef struct
+{
+   uint8_t  state;
+   uint8_t  dtls;
+   uint8_t  cookie_len;
+   uint16_t wr_msg_seq;    // DTLS message_seq of the next message sent
+   uint16_t rd_msg_seq;    // DTLS message_seq of the next message expected
+   tlssock_rng rng;
+   psk_sha256 transcript;
+   uint8_t  client_random[32];
+   uint8_t  server_random[32];
+   uint8_t  master[48];
+   uint8_t  client_key[16];
+   uint8_t  server_key[16];
+   uint8_t  client_iv[4];
+   uint8_t  server_iv[4];
+   uint8_t  cookie[TLSSOCK_PSK_MAX_COOKIE];
+} psk_ctx;
+
+/* The session state must fit the area tlssock hands to the backend */
+typedef char psk_ctx_fits[(sizeof(psk_ctx) <= TLSSOCK_BACKEND_CTX_SIZE) ? 1 : -1];
+
+static uint8_t psk_identity[TLSSOCK_PSK_MAX_IDENTITY];
+static uint8_t psk_identity_len;
+static uint8_t psk_key[TLSSOCK_PSK_MAX_KEY];
+static uint8_t psk_key_len;
+
+/*-------------------------------------------------------------------------------------------------
+ * AES-128, encryption only (CCM never decrypts blocks)
+ *-----------------------------------------------------------------------------------------------*/
+
+static const uint8_t psk_sbox[256] =
+{
+   0x63,0x7c,0x77,0x7b,0xf2,0x6b,0x6f,0xc5,0x30,0x01,0x67,0x2b,0xfe,0xd7,0xab,0x76,
+   0xca,0x82,0xc9,0x7d,0xfa,0x59,0x47,0xf0,0xad,0xd4,0xa2,0xaf,0x9c,0xa4,0x72,0xc0,
+   0xb7,0xfd,0x93,0x26,0x36,0x3f,0xf7,0xcc,0x34,0xa5,0xe5,0xf1,0x71,0xd8,0x31,0x15,
+   0x04,0xc7,0x23,0xc3,0x18,0x96,0x05,0x9a,0x07,0x12,0x80,0xe2,0xeb,0x27,0xb2,0x75,
+   0x09,0x83,0x2c,0x1a,0x1b,0x6e,0x5a,0xa0,0x52,0x3b,0xd6,0xb3,0x29,0xe3,0x2f,0x84,
+   0x53,0xd1,0x00,0xed,0x20,0xfc,0xb1,0x5b,0x6a,0xcb,0xbe,0x39,0x4a,0x4c,0x58,0xcf,
+   0xd0,0xef,0xaa,0xfb,0x43,0x4d,0x33,0x85,0x45,0xf9,0x02,0x7f,0x50,0x3c,0x9f,0xa8,
+   0x51,0xa3,0x40,0x8f,0x92,0x9d,0x38,0xf5,0xbc,0xb6,0xda,0x21,0x10,0xff,0xf3,0xd2,
+   0xcd,0x0c,0x13,0xec,0x5f,0x97,0x44,0x17,0xc4,0xa7,0x7e,0x3d,0x64,0x5d,0x19,0x73,
+   0x60,0x81,0x4f,0xdc,0x22,0x2a,0x90,0x88,0x46,0xee,0xb8,0x14,0xde,0x5e,0x0b,0xdb,
+   0xe0,0x32,0x3a,0x0a,0x49,0x06,0x24,0x5c,0xc2,0xd3,0xac,0x62,0x91,0x95,0xe4,0x79,
+   0xe7,0xc8,0x37,0x6d,0x8d,0xd5,0x4e,0xa9,0x6c,0x56,0xf4,0xea,0x65,0x7a,0xae,0x08,
+   0xba,0x78,0x25,0x2e,0x1c,0xa6,0xb4,0xc6,0xe8,0xdd,0x74,0x1f,0x4b,0xbd,0x8b,0x8a,
+   0x70,0x3e,0xb5,0x66,0x48,0x03,0xf6,0x0e,0x61,0x35,0x57,0xb9,0x86,0xc1,0x1d,0x9e,
+   0xe1,0xf8,0x98,0x11,0x69,0xd9,0x8e,0x94,0x9b,0x1e,0x87,0xe9,0xce,0x55,0x28,0xdf,
+   0x8c,0xa1,0x89,0x0d,0xbf,0xe6,0x42,0x68,0x41,0x99,0x2d,0x0f,0xb0,0x54,0xbb,0x16
+};
+
+static uint8_t psk_xtime(uint8_t x)
+{
+   return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+static void psk_aes_expand(const uint8_t* key, uint8_t* rk)
+{
+   uint8_t rcon = 0x01;
+   uint8_t t[4];
+   uint8_t i, j;
+
+   memcpy(rk, key, 16);
+   for(i = 4; i < 44; i++)
+   {
+      memcpy(t, &rk[(i - 1) * 4], 4);
+      if((i & 3) == 0)
+      {
+         uint8_t u = t[0];
+         t[0] = psk_sbox[t[1]] ^ rcon;
+         t[1] = psk_sbox[t[2]];
+         t[2] = psk_sbox[t[3]];
+         t[3] = psk_sbox[u];
+         rcon = psk_xtime(rcon);
+      }
+      for(j = 0; j < 4; j++) rk[i * 4 + j] = rk[(i - 4) * 4 + j] ^ t[j];
+   }
+}
+
+static void psk_aes_encrypt(const uint8_t* rk, uint8_t* b)
+{
+   uint8_t s[16];
+   uint8_t round, c, i;
+   uint8_t a0, a1, a2, a3, x;
+
+   for(i = 0; i < 16; i++) b[i] ^= rk[i];
+   for(round = 1; round <= 10; round++)
+   {
+      /* SubBytes and ShiftRows */
+      for(c = 0; c < 4; c++)
+      {
+         for(i = 0; i < 4; i++) s[c * 4 + i] = psk_sbox[b[((c + i) & 3) * 4 + i]];
+      }
+      /* MixColumns, skipped in the last round */
+      if(round != 10)
+      {
+         for(c = 0; c < 4; c++)
+         {
+            a0 = s[c * 4]; a1 = s[c * 4 + 1]; a2 = s[c * 4 + 2]; a3 = s[c * 4 + 3];
+            x = a0 ^ a1 ^ a2 ^ a3;
+            s[c * 4]     ^= x ^ psk_xtime(a0 ^ a1);
+            s[c * 4 + 1] ^= x ^ psk_xtime(a1 ^ a2);
+            s[c * 4 + 2] ^= x ^ psk_xtime(a2 ^ a3);
+            s[c * 4 + 3] ^= x ^ psk_xtime(a3 ^ a0);
+         }
+      }
+      for(i = 0; i < 16; i++) b[i] = s[i] ^ rk[round * 16 + i];
+   }
+}
+
+/*-------------------------------------------------------------------------------------------------
+ * AES-128-CCM with an 8 byte tag, 12 byte nonce and the 13 byte TLS additional data (RFC 6655)
+ *-----------------------------------------------------------------------------------------------*/
+
+/* Encrypts (decrypt = 0) or decrypts data[0..len) in place. Writes the tag on encryption,
+ * checks it on decryption. Returns 0 if the tag does not match. */
+static uint8_t psk_ccm(const uint8_t* key, const uint8_t* nonce, const uint8_t* aad,
+                       uint8_t* data, uint16_t len, uint8_t* tag, uint8_t decrypt)
+{
+   uint8_t  rk[176];
+   uint8_t  x[16];
+   uint8_t  ctr[16];
+   uint8_t  s[16];
+   uint16_t off, i, n;
+   uint8_t  diff = 0;
+
+   psk_aes_expand(key, rk);
+
+   /* B0 : flags (Adata, M = 8, L = 3), nonce, message length */
+   x[0] = 0x40 | (((PSK_TAG_LEN - 2) / 2) << 3) | (3 - 1);
+   memcpy(&x[1], nonce, 12);
+   x[13] = 0;
+   x[14] = (uint8_t)(len >> 8);
+   x[15] = (uint8_t)len;
+   psk_aes_encrypt(rk, x);
+
+   /* The 13 bytes of additional data with their 2 byte length fill exactly one block */
+   x[0] ^= 0;
+   x[1] ^= 13;
+   for(i = 0; i < 13; i++) x[2 + i] ^= aad[i];
+   psk_aes_encrypt(rk, x);
+
+   ctr[0] = 3 - 1;
+   memcpy(&ctr[1], nonce, 12);
+   ctr[13] = 0;
+   for(off = 0; off < len; off += 16)
+   {
+      n = (len - off < 16) ? (len - off) : 16;
+      i = (off >> 4) + 1;
+      ctr[14] = (uint8_t)(i >> 8);
+      ctr[15] = (uint8_t)i;
+      memcpy(s, ctr, 16);
+      psk_aes_encrypt(rk, s);
+      for(i = 0; i < n; i++)
+      {
+         if(decrypt) data[off + i] ^= s[i];
+         x[i] ^= data[off + i];
+         if(!decrypt) data[off + i] ^= s[i];
+      }
+      psk_aes_encrypt(rk, x);
+   }
+
+   ctr[14] = 0;
+   ctr[15] = 0;
+   psk_aes_encrypt(rk, ctr);
+   for(i = 0; i < PSK_TAG_LEN; i++)
+   {
+      x[i] ^= ctr[i];
+      if(decrypt) diff |= x[i] ^ tag[i];
+      else        tag[i] = x[i];
+   }
+   memset(rk, 0, sizeof(rk));
+   return (diff == 0) ? 1 : 0;
+}
+
+/*-------------------------------------------------------------------------------------------------
+ * SHA-256, HMAC-SHA256 and the TLS 1.2 PRF
+ *-----------------------------------------------------------------------------------------------*/
+
+static const uint32_t psk_k256[64] =
+{
+   0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+   0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+   0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+   0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+   0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+   0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+   0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+   0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
+
+#define PSK_ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+static void psk_sha256_block(psk_sha256* c, const uint8_t* p)
+{
+   uint32_t w[64];
+   uint32_t a, b, d, e, f, g, h, cc, t1, t2;
+   uint8_t  i;
+
+   for(i = 0; i < 16; i++)
+   {
+      w[i] = ((uint32_t)p[i * 4] << 24) | ((uint32_t)p[i * 4 + 1] << 16) | ((uint32_t)p[i * 4 + 2] << 8) | p[i * 4 + 3];
+   }
+   for(i = 16; i < 64; i++)
+   {
+      t1 = PSK_ROR(w[i - 2], 17) ^ PSK_ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      t2 = PSK_ROR(w[i - 15], 7) ^ PSK_ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      w[i] = t1 + w[i - 7] + t2 + w[i - 16];
+   }
+
+   a = c->h[0]; b = c->h[1]; cc = c->h[2]; d = c->h[3];
+   e = c->h[4]; f = c->h[5]; g = c->h[6]; h = c->h[7];
+   for(i = 0; i < 64; i++)
+   {
+      t1 = h + (PSK_ROR(e, 6) ^ PSK_ROR(e, 11) ^ PSK_ROR(e, 25)) + ((e & f) ^ (~e & g)) + psk_k256[i] + w[i];
+      t2 = (PSK_ROR(a, 2) ^ PSK_ROR(a, 13) ^ PSK_ROR(a, 22)) + ((a & b) ^ (a & cc) ^ (b & cc));
+      h = g; g = f; f = e; e = d + t1;
+      d = cc; cc = b; b = a; a = t1 + t2;
+   }
+   c->h[0] += a; c->h[1] += b; c->h[2] += cc; c->h[3] += d;
+   c->h[4] += e; c->h[5] += f; c->h[6] += g; c->h[7] += h;
+}
+
+static void psk_sha256_init(psk_sha256* c)
+{
+   static const uint32_t iv[8] =
+   {
+      0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+   };
+
+   memcpy(c->h, iv, sizeof(iv));
+   c->len = 0;
+}
+
+static void psk_sha256_update(psk_sha256* c, const uint8_t* p, uint16_t len)
+{
+   uint8_t used;
+
+   while(len)
+   {
+      used = (uint8_t)(c->len & 63);
+      c->buf[used] = *p++;
+      c->len++;
+      len--;
+      if(used == 63) psk_sha256_block(c, c->buf);
+   }
+}
+
+static void psk_sha256_final(psk_sha256* c, uint8_t* out)
+{
+   uint32_t bits = c->len << 3;
+   uint8_t  pad = 0x80;
+   uint8_t  i;
+
+   psk_sha256_update(c, &pad, 1);
+   pad = 0;
+   while((c->len & 63) != 56) psk_sha256_update(c, &pad, 1);
+   for(i = 0; i < 4; i++) psk_sha256_update(c, &pad, 1);     // Upper 32 bits of the bit count
+   for(i = 0; i < 4; i++)
+   {
+      pad = (uint8_t)(bits >> (24 - 8 * i));
+      psk_sha256_update(c, &pad, 1);
+   }
+   for(i = 0; i < 8; i++)
+   {
+      out[i * 4]     = (uint8_t)(c->h[i] >> 24);
+      out[i * 4 + 1] = (uint8_t)(c->h[i] >> 16);
+      out[i * 4 + 2] = (uint8_t)(c->h[i] >> 8);
+      out[i * 4 + 3] = (uint8_t)c->h[i];
+   }
+}
+
+/* HMAC-SHA256 over the concatenation of two strings, key of at most 64 bytes */
+static void psk_hmac(const uint8_t* key, uint8_t key_len, const uint8_t* m1, uint16_t l1,
+                     const uint8_t* m2, uint16_t l2, uint8_t* out)
+{
+   psk_sha256 c;
+   uint8_t pad[64];
+   uint8_t i;
+
+   for(i = 0; i < 64; i++) pad[i] = ((i < key_len) ? key[i] : 0) ^ 0x36;
+   psk_sha256_init(&c);
+   psk_sha256_update(&c, pad, 64);
+   psk_sha256_update(&c, m1, l1);
+   psk_sha256_update(&c, m2, l2);
+   psk_sha256_final(&c, out);
+
+   for(i = 0; i < 64; i++) pad[i] ^= 0x36 ^ 0x5C;
+   psk_sha256_init(&c);
+   psk_sha256_update(&c, pad, 64);
+   psk_sha256_update(&c, out, 32);
+   psk_sha256_final(&c, out);
+}
+
+/* P_SHA256(secret, label + seed), RFC 5246 section 5 */
+static void psk_prf(const uint8_t* secret, uint8_t secret_len, const char* label,
+                    const uint8_t* s1, const uint8_t* s2, uint16_t slen, uint8_t* out, uint8_t out_len)
+{
+   uint8_t seed[16 + 64];
+   uint8_t a[32];
+   uint8_t block[32];
+   uint8_t llen = (uint8_t)strlen(label);
+   uint16_t seed_len;
+   uint8_t n;
+
+   memcpy(seed, label, llen);
+   memcpy(seed + llen, s1, slen);
+   if(s2) memcpy(seed + llen + slen, s2, slen);
+   seed_len = llen + (s2 ? 2 * slen : slen);
+
+   psk_hmac(secret, secret_len, seed, seed_len, 0, 0, a);
+   while(out_len)
+   {
+      psk_hmac(secret, secret_len, a, 32, seed, seed_len, block);
+      n = (out_len < 32) ? out_len : 32;
+      memcpy(out, block, n);
+      out += n;
+      out_len -= n;
+      psk_hmac(secret, secret_len, a, 32, 0, 0, a);
+   }
+}
+
+/*-------------------------------------------------------------------------------------------------
+ * Handshake
+ *-----------------------------------------------------------------------------------------------*/
+
+static uint16_t psk_hs_hdr_len(psk_ctx* c)
+{
+   return c->dtls ? 12 : 4;
+}
+
+/* Write the handshake header in front of a body of blen bytes and add the message to the transcript */
+static int32_t psk_hs_finish(psk_ctx* c, uint8_t msg, uint8_t* out, uint16_t blen)
+{
+   uint8_t* p = out;
+
+   *p++ = msg;
+   *p++ = 0;
+   *p++ = (uint8_t)(blen >> 8);
+   *p++ = (uint8_t)blen;
+   if(c->dtls)
+   {
+      /* Single fragment : offset 0, fragment length = length */
+      *p++ = (uint8_t)(c->wr_msg_seq >> 8);
+      *p++ = (uint8_t)c->wr_msg_seq;
+      *p++ = 0; *p++ = 0; *p++ = 0;
+      *p++ = 0;
+      *p++ = (uint8_t)(blen >> 8);
+      *p++ = (uint8_t)blen;
+      c->wr_msg_seq++;
+   }
+   psk_sha256_update(&c->transcript, out, psk_hs_hdr_len(c) + blen);
+   return psk_hs_hdr_len(c) + blen;
+}
+
+static int32_t psk_client_hello(psk_ctx* c, uint8_t* out, uint16_t size)
+{
+   uint8_t* p = out + psk_hs_hdr_len(c);
+
+   if(size < psk_hs_hdr_len(c) + 60 + TLSSOCK_PSK_MAX_COOKIE) return TLSSOCK_ERR_RECORD;
+
+   *p++ = c->dtls ? 0xFE : 0x03;
+   *p++ = c->dtls ? 0xFD : 0x03;
+   memcpy(p, c->client_random, 32);
+   p += 32;
+   *p++ = 0;                                       // No session resumption
+   if(c->dtls)
+   {
+      *p++ = c->cookie_len;
+      memcpy(p, c->cookie, c->cookie_len);
+      p += c->cookie_len;
+   }
+   *p++ = 0; *p++ = 4;
+   *p++ = (uint8_t)(PSK_SUITE >> 8); *p++ = (uint8_t)PSK_SUITE;
+   *p++ = (uint8_t)(PSK_SCSV >> 8);  *p++ = (uint8_t)PSK_SCSV;
+   *p++ = 1; *p++ = 0;                             // Null compression only
+#if PSK_MFL_CODE
+   *p++ = 0; *p++ = 5;
+   *p++ = (uint8_t)(PSK_EXT_MAX_FRAGMENT >> 8); *p++ = (uint8_t)PSK_EXT_MAX_FRAGMENT;
+   *p++ = 0; *p++ = 1;
+   *p++ = PSK_MFL_CODE;
+#endif
+   return psk_hs_finish(c, PSK_HS_CLIENT_HELLO, out, (uint16_t)(p - out - psk_hs_hdr_len(c)));
+}
+
+static int32_t psk_client_key_exchange(psk_ctx* c, uint8_t* out)
+{
+   uint8_t* p = out + psk_hs_hdr_len(c);
+
+   *p++ = 0;
+   *p++ = psk_identity_len;
+   memcpy(p, psk_identity, psk_identity_len);
+   return psk_hs_finish(c, PSK_HS_CLIENT_KEY_EX, out, 2 + psk_identity_len);
+}
+
+/* verify_data of a Finished message over the transcript so far */
+static void psk_verify_data(psk_ctx* c, const char* label, uint8_t* out)
+{
+   psk_sha256 snap = c->transcript;
+   uint8_t hash[32];
+
+   psk_sha256_final(&snap, hash);
+   psk_prf(c->master, 48, label, hash, 0, 32, out, PSK_VERIFY_LEN);
+}
+
+static int32_t psk_client_finished(psk_ctx* c, uint8_t* out)
+{
+   psk_verify_data(c, "client finished", out + psk_hs_hdr_len(c));
+   return psk_hs_finish(c, PSK_HS_FINISHED, out, PSK_VERIFY_LEN);
+}
+
+/* Premaster secret of plain PSK (RFC 4279), then master secret and key block */
+static void psk_derive_keys(psk_ctx* c)
+{
+   uint8_t pms[4 + 2 * TLSSOCK_PSK_MAX_KEY];
+   uint8_t kb[40];
+   uint8_t n = psk_key_len;
+
+   memset(pms, 0, sizeof(pms));
+   pms[1] = n;
+   pms[2 + n + 1] = n;
+   memcpy(&pms[4 + n], psk_key, n);
+   psk_prf(pms, 4 + 2 * n, "master secret", c->client_random, c->server_random, 32, c->master, 48);
+   psk_prf(c->master, 48, "key expansion", c->server_random, c->client_random, 32, kb, sizeof(kb));
+   memcpy(c->client_key, kb, 16);
+   memcpy(c->server_key, kb + 16, 16);
+   memcpy(c->client_iv, kb + 32, 4);
+   memcpy(c->server_iv, kb + 36, 4);
+   memset(pms, 0, sizeof(pms));
+   memset(kb, 0, sizeof(kb));
+}
+
+static int32_t psk_server_hello(psk_ctx* c, const uint8_t* b, uint16_t len)
+{
+   uint16_t off;
+
+   if(len < 38) return TLSSOCK_ERR_RECORD;
+   if(b[0] != (c->dtls ? 0xFE : 0x03) || b[1] != (c->dtls ? 0xFD : 0x03)) return TLSSOCK_ERR_STATE;
+   memcpy(c->server_random, b + 2, 32);
+   off = 35 + b[34];                               // Skip the session id
+   if(off + 3 > len) return TLSSOCK_ERR_RECORD;
+   if((((uint16_t)b[off] << 8) | b[off + 1]) != PSK_SUITE || b[off + 2] != 0) return TLSSOCK_ERR_STATE;
+   /* Extensions (the max_fragment_length echo, renegotiation_info) need no action */
+   return TLSSOCK_BUSY;
+}
+
+static int32_t psk_input_message(psk_ctx* c, uint8_t msg, const uint8_t* b, uint16_t len,
+                                 const uint8_t* raw, uint16_t raw_len)
+{
+   uint8_t expect[PSK_VERIFY_LEN];
+   uint8_t diff = 0;
+   uint8_t i;
+
+   switch(msg)
+   {
+   case PSK_HS_HELLO_VERIFY:
+      if(!c->dtls || c->state != PSK_ST_SERVER_HELLO) return TLSSOCK_ERR_STATE;
+      if(len < 3 || b[2] > TLSSOCK_PSK_MAX_COOKIE || 3 + b[2] > len) return TLSSOCK_ERR_RECORD;
+      c->cookie_len = b[2];
+      memcpy(c->cookie, b + 3, b[2]);
+      /* The first ClientHello and HelloVerifyRequest are not part of the transcript */
+      psk_sha256_init(&c->transcript);
+      c->state = PSK_ST_HELLO;
+      return TLSSOCK_BUSY;
+   case PSK_HS_SERVER_HELLO:
+      if(c->state != PSK_ST_SERVER_HELLO) return TLSSOCK_ERR_STATE;
+      psk_sha256_update(&c->transcript, raw, raw_len);
+      c->state = PSK_ST_SERVER_DONE;
+      return psk_server_hello(c, b, len);
+   case PSK_HS_SERVER_KEY_EX:
+      /* Only carries the PSK identity hint, which is not used */
+      if(c->state != PSK_ST_SERVER_DONE) return TLSSOCK_ERR_STATE;
+      psk_sha256_update(&c->transcript, raw, raw_len);
+      return TLSSOCK_BUSY;
+   case PSK_HS_SERVER_DONE:
+      if(c->state != PSK_ST_SERVER_DONE) return TLSSOCK_ERR_STATE;
+      psk_sha256_update(&c->transcript, raw, raw_len);
+      psk_derive_keys(c);
+      c->state = PSK_ST_KEY_EXCHANGE;
+      return TLSSOCK_BUSY;
+   case PSK_HS_FINISHED:
+      if(c->state != PSK_ST_SERVER_FINISHED || len != PSK_VERIFY_LEN) return TLSSOCK_ERR_STATE;
+      psk_verify_data(c, "server finished", expect);
+      for(i = 0; i < PSK_VERIFY_LEN; i++) diff |= expect[i] ^ b[i];
+      if(diff) return TLSSOCK_ERR_AUTH;
+      c->state = PSK_ST_OPEN;
+      return TLSSOCK_OK;
+   case PSK_HS_HELLO_REQUEST:
+      return TLSSOCK_BUSY;
+   default:
+      return TLSSOCK_ERR_STATE;
+   }
+}
+
+/*-------------------------------------------------------------------------------------------------
+ * Backend interface
+ *-----------------------------------------------------------------------------------------------*/
+
+static int32_t psk_init(void* ctx, uint8_t dtls, tlssock_rng rng)
+{
+   psk_ctx* c = (psk_ctx*)ctx;
+
+   if(psk_key_len == 0) return TLSSOCK_ERR_STATE;
+   memset(c, 0, sizeof(psk_ctx));
+   c->dtls = dtls;
+   c->rng = rng;
+   c->state = PSK_ST_HELLO;
+   psk_sha256_init(&c->transcript);
+   /* The same random is sent again after a HelloVerifyRequest */
+   rng(c->client_random, 32);
+   return TLSSOCK_OK;
+}
+
+static int32_t psk_hs_output(void* ctx, uint8_t* type, uint8_t* out, uint16_t size)
+{
+   psk_ctx* c = (psk_ctx*)ctx;
+
+   *type = TLSSOCK_CT_HANDSHAKE;
+   switch(c->state)
+   {
+   case PSK_ST_HELLO:
+      c->state = PSK_ST_SERVER_HELLO;
+      return psk_client_hello(c, out, size);
+   case PSK_ST_KEY_EXCHANGE:
+      c->state = PSK_ST_CCS;
+      return psk_client_key_exchange(c, out);
+   case PSK_ST_CCS:
+      c->state = PSK_ST_FINISHED;
+      *type = TLSSOCK_CT_CCS;
+      out[0] = 1;
+      return 1;
+   case PSK_ST_FINISHED:
+      c->state = PSK_ST_SERVER_CCS;
+      return psk_client_finished(c, out);
+   default:
+      return 0;
+   }
+}
+
+static int32_t psk_hs_input(void* ctx, uint8_t type, const uint8_t* in, uint16_t len)
+{
+   psk_ctx* c = (psk_ctx*)ctx;
+   uint16_t hlen = psk_hs_hdr_len(c);
+   uint16_t blen, mseq;
+   int32_t  ret = TLSSOCK_BUSY;
+
+   if(type == TLSSOCK_CT_ALERT) return TLSSOCK_ERR_ALERT;
+   if(type == TLSSOCK_CT_CCS)
+   {
+      if(c->state != PSK_ST_SERVER_CCS || len != 1 || in[0] != 1) return TLSSOCK_ERR_STATE;
+      c->state = PSK_ST_SERVER_FINISHED;
+      return TLSSOCK_BUSY;
+   }
+   if(type != TLSSOCK_CT_HANDSHAKE) return TLSSOCK_ERR_STATE;
+
+   /* A record may carry several messages; a message split over records is not supported */
+   while(len && ret == TLSSOCK_BUSY)
+   {
+      if(len < hlen || in[1] != 0) return TLSSOCK_ERR_RECORD;
+      blen = ((uint16_t)in[2] << 8) | in[3];
+      if(blen > len - hlen) return TLSSOCK_ERR_RECORD;
+      if(c->dtls)
+      {
+         if(in[6] || in[7] || in[8] || in[9] != 0 || in[10] != in[2] || in[11] != in[3]) return TLSSOCK_ERR_RECORD;
+         mseq = ((uint16_t)in[4] << 8) | in[5];
+         /* Retransmitted messages are skipped, a gap means a lost flight */
+         if(mseq > c->rd_msg_seq) return TLSSOCK_ERR_STATE;
+         if(mseq < c->rd_msg_seq)
+         {
+            in += hlen + blen;
+            len -= hlen + blen;
+            continue;
+         }
+         c->rd_msg_seq++;
+      }
+      ret = psk_input_message(c, in[0], in + hlen, blen, in, hlen + blen);
+      in += hlen + blen;
+      len -= hlen + blen;
+   }
+   return ret;
+}
+
+/* Explicit nonce and sequence number of the additional data : the 64-bit TLS sequence number,
+ * or the DTLS epoch and sequence number as they appear in the record header */
+static void psk_record_seq(psk_ctx* c, uint64_t seq, const uint8_t* hdr, uint8_t* out)
+{
+   int8_t i;
+
+   if(c->dtls)
+   {
+      memcpy(out, hdr + 3, 8);
+      return;
+   }
+   for(i = 7; i >= 0; i--)
+   {
+      out[i] = (uint8_t)seq;
+      seq >>= 8;
+   }
+}
+
+static void psk_aad(const uint8_t* seq, const uint8_t* hdr, uint16_t len, uint8_t* aad)
+{
+   memcpy(aad, seq, 8);
+   aad[8] = hdr[0];
+   aad[9] = hdr[1];
+   aad[10] = hdr[2];
+   aad[11] = (uint8_t)(len >> 8);
+   aad[12] = (uint8_t)len;
+}
+
+static int32_t psk_seal(void* ctx, uint64_t seq, const uint8_t* hdr, uint8_t* buf, uint16_t len, uint16_t size)
+{
+   psk_ctx* c = (psk_ctx*)ctx;
+   uint8_t nonce[12];
+   uint8_t aad[13];
+
+   if(len + PSK_NONCE_LEN + PSK_TAG_LEN > size) return TLSSOCK_ERR_RECORD;
+
+   memcpy(nonce, c->client_iv, 4);
+   psk_record_seq(c, seq, hdr, nonce + 4);
+   psk_aad(nonce + 4, hdr, len, aad);
+
+   memmove(buf + PSK_NONCE_LEN, buf, len);
+   memcpy(buf, nonce + 4, PSK_NONCE_LEN);
+   psk_ccm(c->client_key, nonce, aad, buf + PSK_NONCE_LEN, len, buf + PSK_NONCE_LEN + len, 0);
+   return len + PSK_NONCE_LEN + PSK_TAG_LEN;
+}
+
+static int32_t psk_open(void* ctx, uint64_t seq, const uint8_t* hdr, uint8_t* buf, uint16_t len)
+{
+   psk_ctx* c = (psk_ctx*)ctx;
+   uint8_t  nonce[12];
+   uint8_t  aad[13];
+   uint8_t  rseq[8];
+   uint16_t plen;
+
+   if(len < PSK_NONCE_LEN + PSK_TAG_LEN) return TLSSOCK_ERR_AUTH;
+   plen = len - PSK_NONCE_LEN - PSK_TAG_LEN;
+
+   memcpy(nonce, c->server_iv, 4);
+   memcpy(nonce + 4, buf, PSK_NONCE_LEN);
+   psk_record_seq(c, seq, hdr, rseq);
+   psk_aad(rseq, hdr, plen, aad);
+
+   if(!psk_ccm(c->server_key, nonce, aad, buf + PSK_NONCE_LEN, plen, buf + PSK_NONCE_LEN + plen, 1))
+   {
+      return TLSSOCK_ERR_AUTH;
+   }
+   memmove(buf, buf + PSK_NONCE_LEN, plen);
+   return plen;
+}
+
+const tlssock_backend tlssock_psk_backend =
+{
+   psk_init,
+   psk_hs_output,
+   psk_hs_input,
+   psk_seal,
+   psk_open
+};
+
+int8_t tlssock_psk_set(const char* identity, const uint8_t* key, uint8_t key_len)
+{
+   size_t len = strlen(identity);
+
+   if(len > TLSSOCK_PSK_MAX_IDENTITY || key_len == 0 || key_len > TLSSOCK_PSK_MAX_KEY) return TLSSOCK_ERR_STATE;
+   memcpy(psk_identity, identity, len);
+   psk_identity_len = (uint8_t)len;
+   memcpy(psk_key, key, key_len);
+   psk_key_len = key_len;
+   return TLSSOCK_OK;
+}
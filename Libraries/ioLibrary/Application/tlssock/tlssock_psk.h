@@ -0,0 +1,46 @@
+/*******************************************************************************************************************************************************
+ * Copyright  2016 <WIZnet Co.,Ltd.> 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the Software), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+#ifndef _TLSSOCK_PSK_H_
+#define _TLSSOCK_PSK_H_
+
+#include <stdint.h>
+#include "tlssock.h"
+
+
+/* Largest pre-shared key, in bytes */
+#ifndef TLSSOCK_PSK_MAX_KEY
+	#define TLSSOCK_PSK_MAX_KEY			32
+#endif
+
+/* Largest PSK identity, in bytes */
+#ifndef TLSSOCK_PSK_MAX_IDENTITY
+	#define TLSSOCK_PSK_MAX_IDENTITY	32
+#endif
+
+/* Largest DTLS cookie accepted in a HelloVerifyRequest */
+#ifndef TLSSOCK_PSK_MAX_COOKIE
+	#define TLSSOCK_PSK_MAX_COOKIE		32
+#endif
+
+/* TLS_PSK_WITH_AES_128_CCM_8 (RFC 6655) client for TLS 1.2 and DTLS 1.2.
+ * AES-128, CCM-8, SHA-256 and the TLS 1.2 PRF are built in, so no crypto library is needed.
+ * The client offers max_fragment_length for TLSSOCK_MAX_FRAGMENT. DTLS handshake messages
+ * must not be fragmented and lost flights are not retransmitted : the caller bounds
+ * tlssock_handshake() with its own timeout and starts over. */
+extern const tlssock_backend tlssock_psk_backend;
+
+/* Set the identity and key of the next sessions. Returns TLSSOCK_OK, or TLSSOCK_ERR_STATE
+ * if they are too long. */
+int8_t tlssock_psk_set(const char* identity, const uint8_t* key, uint8_t key_len);
+#endif
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include "i2c.h"
 #include "W7500x_gpio.h"
+#include "system_w7500x.h"
 /** @addtogroup W7500x_StdPeriph_Examples
  * @{
  */
@@ -37,79 +38,117 @@
 /* Private typedef -----------------------------------------------------------*/
 GPIO_InitTypeDef GPIO_InitDef;
 /* Private define ------------------------------------------------------------*/
+/* Minimum SCL high and low times of the I2C specification, in ns */
+#define I2C_SM_HIGH_NS              4000    /* Standard-mode  */
+#define I2C_SM_LOW_NS               4700
+#define I2C_FM_HIGH_NS              600     /* Fast-mode      */
+#define I2C_FM_LOW_NS               1300
+#define I2C_FMP_HIGH_NS             260     /* Fast-mode Plus */
+#define I2C_FMP_LOW_NS              500
+
+/* Asynchronous engine states, one per tick */
+enum
+{
+    I2C_ST_IDLE = 0,
+    I2C_ST_START_A, I2C_ST_START_B, I2C_ST_START_C, I2C_ST_START_D,
+    I2C_ST_TX_HIGH, I2C_ST_TX_LOW, I2C_ST_TX_ACK_LOW, I2C_ST_TX_ACK_HIGH, I2C_ST_TX_ACK_END,
+    I2C_ST_RX_HIGH, I2C_ST_RX_SAMPLE, I2C_ST_RX_ACK_HIGH, I2C_ST_RX_ACK_END,
+    I2C_ST_STOP_A, I2C_ST_STOP_B, I2C_ST_STOP_C, I2C_ST_BUS_FREE
+};
+
 /* Private macro -------------------------------------------------------------*/
+/* SCL is driven through its masked data entry, SDA is open drain : its output
+ * data stays 0 and the output enable pulls the line low or releases it */
+#define SCL_HIGH(C)                 (*(C)->scl_reg = 0xFFFF)
+#define SCL_LOW(C)                  (*(C)->scl_reg = 0x0000)
+#define SDA_HIGH(C)                 ((C)->sda_gpio->OUTENCLR = (C)->sda_pin)
+#define SDA_LOW(C)                  ((C)->sda_gpio->OUTENSET = (C)->sda_pin)
+#define SDA_READ(C)                 (((C)->sda_gpio->DATA & (C)->sda_pin) ? 1 : 0)
+/* SCL low phase of the asynchronous engine, held for i2c_low_ticks ticks */
+#define SCL_LOW_PHASE(C)            do { SCL_LOW(C); i2c_hold = i2c_low_ticks - 1; } while (0)
+
+#define I2C_LOCK(MASK)              do { (MASK) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define I2C_UNLOCK(MASK)            __set_PRIMASK(MASK)
+
 /* Private variables ---------------------------------------------------------*/
-uint32_t scl_port_num;
-uint32_t scl_pin_index;
-uint32_t sda_port_num;
-uint32_t sda_pin_index;
+static GPIO_TypeDef* const i2c_ports[] = { GPIOA, GPIOB, GPIOC };
+
+static I2C_ConfigStruct* i2c_async_conf;    /* Bus of the asynchronous engine */
+static I2C_TickCmd i2c_tick_cmd;
+static I2C_Transaction* i2c_head;   /* Transaction on the bus */
+static I2C_Transaction* i2c_tail;
+static volatile uint8_t i2c_state = I2C_ST_IDLE;
+static uint8_t i2c_low_ticks;       /* Ticks of an SCL low phase */
+static uint8_t i2c_hold;            /* Ticks left of the SCL low phase */
+static uint8_t i2c_addr_phase;      /* Address byte of the segment on the bus */
+static uint8_t i2c_byte;
+static uint8_t i2c_bits;
+static uint32_t i2c_seg;
+static uint32_t i2c_pos;
+static int32_t i2c_result;
 /* Private function prototypes -----------------------------------------------*/
-
+static __IO uint32_t* i2c_masked_reg(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+static uint32_t i2c_timing(I2C_ConfigStruct* conf);
+static void i2c_wait(I2C_ConfigStruct* conf, uint32_t phase);
+static void i2c_clock(I2C_ConfigStruct* conf);
+static void i2c_async_begin(void);
+static void i2c_async_load(uint8_t byte);
+static void i2c_async_bit(void);
+static void i2c_async_next(void);
+static void i2c_async_done(void);
 
 
 /**
  * @brief  I2C Initialaze.
- * @param  conf :  Select the GPIO peripheral for use such as scl and sda of i2c.
+ * @note   The port pointer, pin masks and SCL phases are resolved here once into
+ *         conf, the other functions take them from there, so each bus has its own.
+ *         The phases are timed on SysTick, started free running when it is off; it
+ *         must count the core clock and reload less often than once per SCL period.
+ * @param  conf :  Select the GPIO peripheral for use such as scl and sda of i2c,
+ *                 and the SCL frequency (0 selects I2C_SPEED_STANDARD, at most
+ *                 I2C_SPEED_FAST_PLUS).
  * @retval  0 or  1
  */
 uint32_t I2C_Init(I2C_ConfigStruct* conf)
 {
-    scl_port_num = conf->scl_port;
-    scl_pin_index = conf->scl_pin;
-
-    sda_port_num = conf->sda_port;
-    sda_pin_index = conf->sda_pin;
-
-    //SCL setting
-   GPIO_InitDef.GPIO_Pin = scl_pin_index;
-   GPIO_InitDef.GPIO_Direction = GPIO_Direction_OUT;
- 	 GPIO_InitDef.GPIO_Pad = GPIO_PuPd_UP;
-	 GPIO_InitDef.GPIO_AF =  PAD_AF1;
-    if(scl_port_num == 0)
-    {
-        GPIO_Init(GPIOA, &GPIO_InitDef);
-        GPIO_SetBits(GPIOA, scl_pin_index);
-    }
-    else if(scl_port_num == 1)
-    {
-        GPIO_Init(GPIOB, &GPIO_InitDef);
-        GPIO_SetBits(GPIOB, scl_pin_index);
-    }
-    else if(scl_port_num == 2)
-    {
-        GPIO_Init(GPIOC, &GPIO_InitDef);
-        GPIO_SetBits(GPIOC, scl_pin_index);
-    }
-    else
+    if(conf->scl_port > PORT_PC)
     {
         printf("SCL pin Port number error\r\n");
         return 1;
     }
-    //SDA setting
-    GPIO_InitDef.GPIO_Pin = sda_pin_index;
-    GPIO_InitDef.GPIO_Direction = GPIO_Direction_IN;
-	GPIO_InitDef.GPIO_Pad = GPIO_PuPd_UP;
-	GPIO_InitDef.GPIO_AF =  PAD_AF1;
-    if(sda_port_num == 0)
-    {
-        GPIO_Init(GPIOA, &GPIO_InitDef);
-        GPIO_ResetBits(GPIOA, sda_pin_index);
-    }
-    else if(sda_port_num == 1)
+    if(conf->sda_port > PORT_PC)
     {
-        GPIO_Init(GPIOB, &GPIO_InitDef);
-        GPIO_ResetBits(GPIOB, sda_pin_index);
-    }
-    else if(sda_port_num == 2)
-    {
-        GPIO_Init(GPIOC, &GPIO_InitDef);
-        GPIO_ResetBits(GPIOC, sda_pin_index);
+        printf("SDA pin Port number error\r\n");
+        return 1;
     }
-    else
+    if(i2c_timing(conf) != 0)
     {
-        printf("SDA pin Port number error\r\n");
+        printf("I2C speed or SysTick setting error\r\n");
         return 1;
     }
+
+    conf->scl_reg = i2c_masked_reg(i2c_ports[conf->scl_port], conf->scl_pin);
+    conf->sda_gpio = i2c_ports[conf->sda_port];
+
+    //SCL setting
+    GPIO_InitDef.GPIO_Pin = conf->scl_pin;
+    GPIO_InitDef.GPIO_Direction = GPIO_Direction_OUT;
+    GPIO_InitDef.GPIO_Pad = GPIO_PuPd_UP;
+    GPIO_InitDef.GPIO_AF = PAD_AF1;
+    GPIO_Init(i2c_ports[conf->scl_port], &GPIO_InitDef);
+    SCL_HIGH(conf);
+
+    //SDA setting, released with its output data at 0
+    GPIO_InitDef.GPIO_Pin = conf->sda_pin;
+    GPIO_InitDef.GPIO_Direction = GPIO_Direction_IN;
+    GPIO_InitDef.GPIO_Pad = GPIO_PuPd_UP;
+    GPIO_InitDef.GPIO_AF = PAD_AF1;
+    GPIO_Init(conf->sda_gpio, &GPIO_InitDef);
+    *i2c_masked_reg(conf->sda_gpio, conf->sda_pin) = 0x0000;
+    SDA_HIGH(conf);
+
+    conf->mark = SysTick->VAL;
+
     return 0;
 }
 /**
@@ -120,63 +159,23 @@ uint32_t I2C_Init(I2C_ConfigStruct* conf)
  */
 void I2C_WriteBitSCL(I2C_ConfigStruct* conf, uint8_t data)
 {
-    if(scl_port_num == 0)
-    {
-        if(data == 1)
-			GPIO_SetBits(GPIOA, scl_pin_index);
-        else
-			GPIO_ResetBits(GPIOA, scl_pin_index);
-    }
-    else if(scl_port_num == 1)
-    {
-
-        if(data == 1)
-			GPIO_SetBits(GPIOB, scl_pin_index);
-        else
-			GPIO_ResetBits(GPIOB, scl_pin_index);
-    }
-    else if(scl_port_num == 2)
-    {
-        if(data == 1)
-			GPIO_SetBits(GPIOC, scl_pin_index);
-        else
-
-			GPIO_ResetBits(GPIOC, scl_pin_index);
-    }
+    if(data == 1)
+        SCL_HIGH(conf);
+    else
+        SCL_LOW(conf);
 }
 /**
  * @brief  I2C WriteBit SDA.
  * @param  conf :  Select the GPIO peripheral for use such as scl and sda of i2c.
- * @para   data : write data
+ * @para   data : write data, 1 releases the line
  * @retval  none
  */
 void I2C_WriteBitSDA(I2C_ConfigStruct* conf, uint8_t data)
 {
- 	if(sda_port_num == 0)
-    {
-        if(data == 1)
-			GPIO_SetBits(GPIOA, sda_pin_index);
-
-        else
-			GPIO_ResetBits(GPIOA, sda_pin_index);
-    }
-	else if(sda_port_num == 1)
-    {
-
-        if(data == 1)
-			GPIO_SetBits(GPIOB, sda_pin_index);
-        else
-			GPIO_ResetBits(GPIOB, sda_pin_index);
-    }
-	else if(sda_port_num == 2)
-    {
-        if(data == 1)
-			GPIO_SetBits(GPIOC, sda_pin_index);
-
-        else
-			GPIO_ResetBits(GPIOC, sda_pin_index);
-    }
-
+    if(data == 1)
+        SDA_HIGH(conf);
+    else
+        SDA_LOW(conf);
 }
 /**
  * @brief  I2C Readbit SDA
@@ -185,45 +184,25 @@ void I2C_WriteBitSDA(I2C_ConfigStruct* conf, uint8_t data)
  */
 uint8_t I2C_ReadBitSDA(I2C_ConfigStruct* conf)
 {
-    if(sda_port_num == 0)
-    {
-        if(GPIOA->DATA & sda_pin_index)
-            return 1;
-        else
-            return 0;
-    }
-    else if(sda_port_num == 1)
-    {
-        if(GPIOB->DATA & sda_pin_index)
-            return 1;
-        else
-            return 0;
-
-    }
-    else if(sda_port_num == 2)
-    {
-        if(GPIOC->DATA & sda_pin_index)
-            return 1;
-        else
-            return 0;
-    }
-    return 0;
+    return SDA_READ(conf);
 }
 /**
- * @brief  I2C Start Condition.
+ * @brief  I2C Start Condition, also a repeated start after a transfer without STOP.
  * @param  conf :  Select the GPIO peripheral for use such as scl and sda of i2c.
  * @retval  none
  */
 void I2C_Start(I2C_ConfigStruct* conf)
 {
-	I2C_SDA_MODE(conf , GPIO_Direction_OUT);
-
-    I2C_WriteBitSCL(conf, 1);
-    I2C_WriteBitSDA(conf, 1);
-
-    I2C_WriteBitSDA(conf, 0);
-    I2C_WriteBitSCL(conf, 0);
-
+    /* SDA is released while SCL is low, raising SCL first would make a STOP.
+     * The repeated START setup time is longer than tHIGH in Standard-mode. */
+    SDA_HIGH(conf);
+    i2c_wait(conf, conf->low);
+    SCL_HIGH(conf);
+    i2c_wait(conf, conf->low);
+
+    SDA_LOW(conf);
+    i2c_wait(conf, conf->high);
+    SCL_LOW(conf);
 }
 /**
  * @brief  I2C Stop Condition.
@@ -232,14 +211,14 @@ void I2C_Start(I2C_ConfigStruct* conf)
  */
 void I2C_Stop(I2C_ConfigStruct* conf)
 {
-	I2C_SDA_MODE(conf , GPIO_Direction_OUT);
-
-	I2C_WriteBitSCL(conf, 0);
-    I2C_WriteBitSDA(conf, 0);
-
-    I2C_WriteBitSCL(conf, 1);
-    I2C_WriteBitSDA(conf, 1);
-	I2C_SDA_MODE(conf , GPIO_Direction_IN);
+    SCL_LOW(conf);
+    SDA_LOW(conf);
+    i2c_wait(conf, conf->low);
+
+    SCL_HIGH(conf);
+    i2c_wait(conf, conf->high);
+    SDA_HIGH(conf);
+    i2c_wait(conf, conf->low);
 }
 /**
  * @brief  I2C Write Byte for 1byte transmission
@@ -248,34 +227,30 @@ void I2C_Stop(I2C_ConfigStruct* conf)
  */
 uint8_t I2C_WriteByte(I2C_ConfigStruct* conf, uint8_t data)
 {
-    int i;
+    uint32_t i;
     uint8_t ret;
-	uint8_t sda;
-
 
     //Write byte
-	I2C_SDA_MODE(conf , GPIO_Direction_OUT);
     for(i=0; i<8; i++)
     {
-
-        sda = ((data<<i) & 0x80) ;
-		if(sda == 0x80)
-			I2C_WriteBitSDA(conf, 1);
-		else
-			I2C_WriteBitSDA(conf, 0);
-
-        I2C_WriteBitSCL(conf, 1);
-        I2C_WriteBitSCL(conf, 0);
+        if(data & 0x80)
+            SDA_HIGH(conf);
+        else
+            SDA_LOW(conf);
+        data <<= 1;
+        i2c_clock(conf);
     }
-    //Make clk for receiving ack
-    I2C_SDA_MODE(conf , GPIO_Direction_IN);
-	I2C_WriteBitSCL(conf, 1);
 
+    //Make clk for receiving ack
+    SDA_HIGH(conf);
+    i2c_wait(conf, conf->low);
+    SCL_HIGH(conf);
+    i2c_wait(conf, conf->high);
 
     //Read Ack/Nack
-    ret = I2C_ReadBitSDA(conf);
+    ret = SDA_READ(conf);
 
-    I2C_WriteBitSCL(conf, 0);
+    SCL_LOW(conf);
 
     return ret;
 }
@@ -286,9 +261,9 @@ uint8_t I2C_WriteByte(I2C_ConfigStruct* conf, uint8_t data)
  */
 void I2C_SendACK(I2C_ConfigStruct* conf)
 {
-    I2C_WriteBitSDA(conf, 0);
-    I2C_WriteBitSCL(conf, 1);
-    I2C_WriteBitSCL(conf, 0);
+    SDA_LOW(conf);
+    i2c_clock(conf);
+    SDA_HIGH(conf);
 }
 /**
  * @brief  I2C Send NACK. When W7500x receive the wrong data or last data before send stop condition, it must send the NACK signal
@@ -297,9 +272,8 @@ void I2C_SendACK(I2C_ConfigStruct* conf)
  */
 void I2C_SendNACK(I2C_ConfigStruct* conf)
 {
-    I2C_WriteBitSDA(conf, 1);
-    I2C_WriteBitSCL(conf, 1);
-    I2C_WriteBitSCL(conf, 0);
+    SDA_HIGH(conf);
+    i2c_clock(conf);
 }
 /**
  * @brief  I2C Read Byte.
@@ -309,27 +283,25 @@ void I2C_SendNACK(I2C_ConfigStruct* conf)
  */
 uint8_t I2C_ReadByte(I2C_ConfigStruct* conf, ACK_TypeDef SetValue)
 {
-    int i;
+    uint32_t i;
     uint8_t ret = 0;
 
-	I2C_SDA_MODE(conf , GPIO_Direction_IN);
+    SDA_HIGH(conf);
 
     //Read byte
     for(i=0; i<8; i++)
     {
-        I2C_WriteBitSCL(conf, 1);
-        ret = (ret << 1) | (I2C_ReadBitSDA(conf));
-        I2C_WriteBitSCL(conf, 0);
+        i2c_wait(conf, conf->low);
+        SCL_HIGH(conf);
+        i2c_wait(conf, conf->high);
+        ret = (ret << 1) | SDA_READ(conf);
+        SCL_LOW(conf);
     }
-	I2C_SDA_MODE(conf , GPIO_Direction_OUT);
-
 
-	if(SetValue == NACK )
-		I2C_SendNACK(conf);
-	else
-		I2C_SendACK(conf);
-
-    I2C_SDA_MODE(conf , GPIO_Direction_IN);
+    if(SetValue == NACK)
+        I2C_SendNACK(conf);
+    else
+        I2C_SendACK(conf);
 
     return ret;
 }
@@ -343,8 +315,7 @@ uint8_t I2C_ReadByte(I2C_ConfigStruct* conf, ACK_TypeDef SetValue)
  */
 int I2C_Write(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
 {
-    int i;
-
+    uint32_t i;
 
     I2C_Start(conf);
 
@@ -352,12 +323,17 @@ int I2C_Write(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
     if(I2C_WriteByte(conf, addr) != 0)
     {
         printf("Received NACK at address phase!!\r\n");
+        I2C_Stop(conf);
         return -1;
     }
     //Write data
     for(i=0; i<len; i++)
     {
-        if(I2C_WriteByte(conf, data[i]))  return -1;
+        if(I2C_WriteByte(conf, data[i]))
+        {
+            I2C_Stop(conf);
+            return -1;
+        }
     }
     I2C_Stop(conf);
     return 0;//success
@@ -372,22 +348,26 @@ int I2C_Write(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
  */
 int I2C_WriteRepeated(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
 {
-    int i;
+    uint32_t i;
 
     I2C_Start(conf);
 
-
     //Write addr
     if(I2C_WriteByte(conf, addr) != 0)
     {
         printf("Received NACK at address phase!!\r\n");
+        I2C_Stop(conf);
         return -1;
     }
 
     //Write data
     for(i=0; i<len; i++)
     {
-        if(I2C_WriteByte(conf, data[i]))    return -1;
+        if(I2C_WriteByte(conf, data[i]))
+        {
+            I2C_Stop(conf);
+            return -1;
+        }
     }
     return 0;//success
 }
@@ -401,25 +381,21 @@ int I2C_WriteRepeated(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint3
  */
 int I2C_Read(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
 {
-    int i;
+    uint32_t i;
 
     I2C_Start(conf);
 
-
     //Write addr | read command
     if(I2C_WriteByte(conf, (addr | 1)) != 0)
     {
         printf("Received NACK at address phase!!\r\n");
+        I2C_Stop(conf);
         return -1;
     }
     //Read data
     for(i=0; i<len; i++)
     {
-        if( i == (len - 1))
-			data[i] = I2C_ReadByte(conf,NACK);
-        else
-			data[i] = I2C_ReadByte(conf,ACK);
-
+        data[i] = I2C_ReadByte(conf, (i == (len - 1)) ? NACK : ACK);
     }
     I2C_Stop(conf);
 
@@ -435,30 +411,27 @@ int I2C_Read(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
  */
 int I2C_ReadRepeated(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len)
 {
-    int i;
+    uint32_t i;
+
     I2C_Start(conf);
     //Write addr | read command
     if(I2C_WriteByte(conf, (addr | 1)) != 0)
     {
         printf("Received NACK at address phase!!\r\n");
+        I2C_Stop(conf);
         return -1;
     }
     //Read data
     for(i=0; i<len; i++)
     {
-        if( i == (len - 1))
-			data[i] = I2C_ReadByte(conf,NACK);
-        else
-			data[i] = I2C_ReadByte(conf,ACK);
-
-
-		I2C_SendACK(conf);
+        data[i] = I2C_ReadByte(conf, (i == (len - 1)) ? NACK : ACK);
     }
     return 0;//success
 }
 
 /**
- * @brief  I2C SDA Mode, it control the GPIO INPUT/OUTPUT (GPIOx->OUTENCLR : GPIO INPUT , GPIOx->OUTENSET : GPIO OUTPUT)
+ * @brief  I2C SDA Mode. SDA is open drain : input releases the line (GPIOx->OUTENCLR),
+ *         output only pulls it low from I2C_WriteBitSDA(conf, 0) (GPIOx->OUTENSET).
  * @param  conf :  Select the GPIO peripheral for use such as scl and sda of i2c.
  * @param  Set_VAULE : Select the data, it is 0 or 1.
  * @retval  none
@@ -466,27 +439,370 @@ int I2C_ReadRepeated(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32
 // GPIO MODE (Input/Output setting)
 void I2C_SDA_MODE(I2C_ConfigStruct* conf,GPIODirection_TypeDef Set_VAULE)
 {
-    if(sda_port_num == 0)
+    if(Set_VAULE == GPIO_Direction_IN)
+        SDA_HIGH(conf);
+}
+
+/**
+ * @brief  I2C asynchronous engine setup, after I2C_Init.
+ * @note   Call I2C_AsyncTick() from a DUALTIMER or PWM interrupt : each tick is an SCL
+ *         high phase, and an SCL low phase up to Standard-mode. Above it one tick would
+ *         be shorter than tLOW (1.3us in Fast-mode), so low phases take two ticks. Run
+ *         the tick at twice the SCL frequency up to 100kHz, three times above : 1.2MHz
+ *         for 400kHz gives tHIGH 0.83us and tLOW 1.67us. At 48MHz a 100kHz SCL takes
+ *         200k interrupts per second, slower buses leave more time to the main loop.
+ *         The engine drives one bus; the blocking functions must not use it while
+ *         transactions are queued.
+ * @param  conf : the bus, set up by I2C_Init.
+ * @param  tick_cmd : starts and stops the tick interrupt, e.g. with DUALTIMER_Cmd,
+ *                    so that it only runs during transactions. May be NULL.
+ * @retval  none
+ */
+void I2C_AsyncInit(I2C_ConfigStruct* conf, I2C_TickCmd tick_cmd)
+{
+    i2c_async_conf = conf;
+    i2c_tick_cmd = tick_cmd;
+    i2c_low_ticks = (conf->speed > I2C_SPEED_STANDARD) ? 2 : 1;
+    i2c_hold = 0;
+    i2c_head = 0;
+    i2c_tail = 0;
+    i2c_state = I2C_ST_IDLE;
+}
+/**
+ * @brief  I2C queue an asynchronous transaction. It belongs to the engine until its
+ *         status is not I2C_ASYNC_PENDING any more.
+ * @param  t : transaction, seg, count, callback and arg must be set.
+ * @retval  none
+ */
+void I2C_AsyncSubmit(I2C_Transaction* t)
+{
+    uint32_t primask;
+
+    t->status = I2C_ASYNC_PENDING;
+    t->next = 0;
+
+    I2C_LOCK(primask);
+    if(i2c_tail != 0)
+        i2c_tail->next = t;
+    else
+        i2c_head = t;
+    i2c_tail = t;
+
+    if(i2c_state == I2C_ST_IDLE)
     {
-        if(Set_VAULE == 0)
+        i2c_async_begin();
+        if(i2c_tick_cmd != 0) i2c_tick_cmd(ENABLE);
+    }
+    I2C_UNLOCK(primask);
+}
+/**
+ * @brief  I2C wait for the end of a queued transaction.
+ * @param  t : transaction.
+ * @retval  none
+ */
+void I2C_AsyncWait(I2C_Transaction* t)
+{
+    while(t->status == I2C_ASYNC_PENDING);
+}
+/**
+ * @brief  I2C asynchronous engine status.
+ * @retval  1 while transactions are queued, 0 otherwise
+ */
+uint8_t I2C_AsyncBusy(void)
+{
+    return (i2c_state != I2C_ST_IDLE) ? 1 : 0;
+}
+/**
+ * @brief  I2C asynchronous engine tick, one step of the bus per call.
+ * @retval  none
+ */
+void I2C_AsyncTick(void)
+{
+    I2C_ConfigStruct* conf = i2c_async_conf;
+    I2C_Segment* seg;
 
-			GPIOA->OUTENCLR = sda_pin_index; //(GPIO INPUT)
-        else
-			GPIOA->OUTENSET = sda_pin_index; //(GPIO OUTPUT)
+    if(i2c_hold != 0)                   // SCL kept low for tLOW
+    {
+        i2c_hold--;
+        return;
     }
-    else if(sda_port_num == 1)
+
+    switch(i2c_state)
     {
-        if(Set_VAULE == 0)
-			GPIOB->OUTENCLR = sda_pin_index;
-        else
-			GPIOB->OUTENSET = sda_pin_index;
+        case I2C_ST_START_A :           // SDA released while SCL is low (or idle high)
+            SDA_HIGH(conf);
+            i2c_state = I2C_ST_START_B;
+            break;
+        case I2C_ST_START_B :
+            SCL_HIGH(conf);
+            i2c_state = I2C_ST_START_C;
+            break;
+        case I2C_ST_START_C :           // START : SDA falls while SCL is high
+            SDA_LOW(conf);
+            i2c_state = I2C_ST_START_D;
+            break;
+        case I2C_ST_START_D :
+            SCL_LOW_PHASE(conf);
+            seg = &i2c_head->seg[i2c_seg];
+            i2c_addr_phase = 1;
+            i2c_async_load(seg->read ? (seg->addr | 1) : (seg->addr & 0xFE));
+            break;
+
+        case I2C_ST_TX_HIGH :
+            SCL_HIGH(conf);
+            i2c_state = (--i2c_bits != 0) ? I2C_ST_TX_LOW : I2C_ST_TX_ACK_LOW;
+            break;
+        case I2C_ST_TX_LOW :
+            SCL_LOW_PHASE(conf);
+            i2c_async_bit();
+            break;
+        case I2C_ST_TX_ACK_LOW :
+            SCL_LOW_PHASE(conf);
+            SDA_HIGH(conf);
+            i2c_state = I2C_ST_TX_ACK_HIGH;
+            break;
+        case I2C_ST_TX_ACK_HIGH :
+            SCL_HIGH(conf);
+            i2c_state = I2C_ST_TX_ACK_END;
+            break;
+        case I2C_ST_TX_ACK_END :
+            if(SDA_READ(conf))
+            {
+                SCL_LOW_PHASE(conf);
+                i2c_result = I2C_ASYNC_NACK;
+                i2c_state = I2C_ST_STOP_A;
+                break;
+            }
+            SCL_LOW_PHASE(conf);
+            seg = &i2c_head->seg[i2c_seg];
+            if(i2c_addr_phase)
+            {
+                i2c_addr_phase = 0;
+                i2c_pos = 0;
+                if(seg->read)
+                {
+                    i2c_byte = 0;
+                    i2c_bits = 8;
+                    i2c_state = I2C_ST_RX_HIGH;
+                    break;
+                }
+            }
+            if(i2c_pos < seg->len)
+                i2c_async_load(seg->data[i2c_pos++]);
+            else
+                i2c_async_next();
+            break;
+
+        case I2C_ST_RX_HIGH :
+            SCL_HIGH(conf);
+            i2c_state = I2C_ST_RX_SAMPLE;
+            break;
+        case I2C_ST_RX_SAMPLE :
+            i2c_byte = (i2c_byte << 1) | SDA_READ(conf);
+            SCL_LOW_PHASE(conf);
+            if(--i2c_bits != 0)
+            {
+                i2c_state = I2C_ST_RX_HIGH;
+                break;
+            }
+            seg = &i2c_head->seg[i2c_seg];
+            seg->data[i2c_pos++] = i2c_byte;
+            if(i2c_pos < seg->len)
+                SDA_LOW(conf);              // ACK, more bytes to come
+            i2c_state = I2C_ST_RX_ACK_HIGH;
+            break;
+        case I2C_ST_RX_ACK_HIGH :
+            SCL_HIGH(conf);
+            i2c_state = I2C_ST_RX_ACK_END;
+            break;
+        case I2C_ST_RX_ACK_END :
+            SCL_LOW_PHASE(conf);
+            SDA_HIGH(conf);
+            if(i2c_pos < i2c_head->seg[i2c_seg].len)
+            {
+                i2c_byte = 0;
+                i2c_bits = 8;
+                i2c_state = I2C_ST_RX_HIGH;
+            }
+            else
+                i2c_async_next();
+            break;
+
+        case I2C_ST_STOP_A :
+            SDA_LOW(conf);
+            i2c_state = I2C_ST_STOP_B;
+            break;
+        case I2C_ST_STOP_B :
+            SCL_HIGH(conf);
+            i2c_state = I2C_ST_STOP_C;
+            break;
+        case I2C_ST_STOP_C :            // STOP : SDA rises while SCL is high
+            SDA_HIGH(conf);
+            i2c_state = I2C_ST_BUS_FREE;
+            break;
+        case I2C_ST_BUS_FREE :
+            i2c_async_done();
+            break;
+
+        default :
+            break;
     }
+}
 
-    else if(sda_port_num == 2)
+static __IO uint32_t* i2c_masked_reg(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin < 256)
+        return &(GPIOx->LB_MASKED[(uint8_t) (GPIO_Pin)]);
+    else
+        return &(GPIOx->UB_MASKED[(uint8_t) ((GPIO_Pin) >> 8)]);
+}
+
+/* SCL phases in SysTick counts : the minimum tHIGH and tLOW of the mode, plus half
+ * of what is left of the period each. Half of that margin is the slack, the lateness
+ * a phase may pass on to the next one; the other half is left for the difference
+ * in the code run between a wait and its edge. */
+static uint32_t i2c_timing(I2C_ConfigStruct* conf)
+{
+    uint32_t speed = (conf->speed != 0) ? conf->speed : I2C_SPEED_STANDARD;
+    uint32_t khz = GetSystemClock() / 1000;
+    uint32_t period, high, low, spare;
+
+    if(speed > I2C_SPEED_FAST_PLUS)
+        return 1;
+    if(speed <= I2C_SPEED_STANDARD)
     {
-        if(Set_VAULE == 0)
-			GPIOC->OUTENCLR = sda_pin_index;
-        else
-			GPIOC->OUTENSET = sda_pin_index;
+        high = I2C_SM_HIGH_NS;
+        low = I2C_SM_LOW_NS;
+    }
+    else if(speed <= I2C_SPEED_FAST)
+    {
+        high = I2C_FM_HIGH_NS;
+        low = I2C_FM_LOW_NS;
+    }
+    else
+    {
+        high = I2C_FMP_HIGH_NS;
+        low = I2C_FMP_LOW_NS;
+    }
+
+    /* Rounded up, so that SCL never runs faster than speed */
+    high = (high * khz + 999999) / 1000000;
+    low = (low * khz + 999999) / 1000000;
+    period = (GetSystemClock() + speed - 1) / speed;
+    spare = (period > high + low) ? (period - high - low) : 0;
+
+    conf->high = high + spare / 2;
+    conf->low = low + spare - spare / 2;
+    conf->slack = spare / 4;
+
+    if((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0)
+    {
+        SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL = 0;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+    if((SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) == 0 || SysTick->LOAD < conf->high + conf->low)
+        return 1;
+
+    return 0;
+}
+
+/* Waits for the end of a phase, phase SysTick counts after the end of the previous
+ * one. Timing each phase from the previous deadline rather than from the return
+ * keeps the code run between the waits from adding up. A phase made later than
+ * the slack, by an interrupt, ends the chain : the next one is timed from now, so
+ * that it does not get shorter than tHIGH or tLOW. */
+static void i2c_wait(I2C_ConfigStruct* conf, uint32_t phase)
+{
+    uint32_t reload = SysTick->LOAD + 1;
+    uint32_t now, elapsed;
+
+    do
+    {
+        /* SysTick counts down and reloads from LOAD */
+        now = SysTick->VAL;
+        elapsed = (now <= conf->mark) ? (conf->mark - now) : (conf->mark + reload - now);
+    } while(elapsed < phase);
+
+    if(elapsed - phase > conf->slack)
+        conf->mark = now;
+    else
+        conf->mark = (conf->mark >= phase) ? (conf->mark - phase) : (conf->mark + reload - phase);
+}
+
+/* One SCL pulse for the bit already on SDA */
+static void i2c_clock(I2C_ConfigStruct* conf)
+{
+    i2c_wait(conf, conf->low);
+    SCL_HIGH(conf);
+    i2c_wait(conf, conf->high);
+    SCL_LOW(conf);
+}
+
+/* Starts the transaction at the head of the queue, called with interrupts disabled */
+static void i2c_async_begin(void)
+{
+    i2c_seg = 0;
+    i2c_result = I2C_ASYNC_DONE;
+    i2c_state = (i2c_head->count != 0) ? I2C_ST_START_A : I2C_ST_BUS_FREE;
+}
+
+/* Loads a byte to send and puts its first bit on SDA, SCL is low */
+static void i2c_async_load(uint8_t byte)
+{
+    i2c_byte = byte;
+    i2c_bits = 8;
+    i2c_async_bit();
+}
+
+static void i2c_async_bit(void)
+{
+    I2C_ConfigStruct* conf = i2c_async_conf;
+
+    if(i2c_byte & 0x80)
+        SDA_HIGH(conf);
+    else
+        SDA_LOW(conf);
+    i2c_byte <<= 1;
+    i2c_state = I2C_ST_TX_HIGH;
+}
+
+/* Repeated START for the next segment, or STOP after the last one */
+static void i2c_async_next(void)
+{
+    if(++i2c_seg < i2c_head->count)
+        i2c_state = I2C_ST_START_A;
+    else
+        i2c_state = I2C_ST_STOP_A;
+}
+
+/* Reports the transaction and starts the next one, or stops the tick when the queue is empty */
+static void i2c_async_done(void)
+{
+    I2C_Transaction* t = i2c_head;
+    uint32_t primask;
+
+    I2C_LOCK(primask);
+    i2c_head = t->next;
+    if(i2c_head == 0)
+    {
+        i2c_tail = 0;
+        i2c_state = I2C_ST_IDLE;
+        if(i2c_tick_cmd != 0) i2c_tick_cmd(DISABLE);
     }
+    else
+        i2c_async_begin();
+    I2C_UNLOCK(primask);
+
+    /* The callback may submit the next transaction */
+    t->status = i2c_result;
+    if(t->callback != 0) t->callback(t);
 }
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
@@ -61,7 +61,15 @@ typedef struct
 	uint32_t  scl_pin;
 	PORT_Type sda_port;
 	uint32_t sda_pin;
-
+	uint32_t speed;		// SCL frequency in Hz, 0 : I2C_SPEED_STANDARD
+
+	/* Set by I2C_Init, the other functions only use these */
+	__IO uint32_t* scl_reg;		// masked data entry of the SCL pin
+	GPIO_TypeDef* sda_gpio;		// port of SDA, sda_pin is its mask
+	uint32_t high;		// SCL high time in SysTick counts
+	uint32_t low;		// SCL low time in SysTick counts
+	uint32_t slack;		// lateness a phase may pass on to the next one
+	uint32_t mark;		// SysTick value at the end of the last phase
 }I2C_ConfigStruct;
 
 
@@ -70,7 +78,40 @@ typedef enum
 	NACK = 0,
 	ACK = 1
 }ACK_TypeDef;
+
+/* One part of an asynchronous transaction, sent after a (repeated) START */
+typedef struct
+{
+	uint8_t  addr;		// slave address as for I2C_Write, bit 0 is set for a read
+	uint8_t  read;		// 0 : write data, 1 : read data (len must not be 0)
+	uint8_t* data;
+	uint32_t len;
+}I2C_Segment;
+
+struct I2C_Transaction;
+typedef void (*I2C_AsyncCallback)(struct I2C_Transaction* t);
+
+/* Segments run back to back with repeated STARTs, then a STOP */
+typedef struct I2C_Transaction
+{
+	I2C_Segment* seg;
+	uint32_t count;
+	I2C_AsyncCallback callback;		// called from the tick interrupt, may be NULL
+	void* arg;
+	volatile int32_t status;		// I2C_ASYNC_PENDING until done
+	struct I2C_Transaction* next;	// used by the queue
+}I2C_Transaction;
+
+/* Starts (ENABLE) or stops (DISABLE) the interrupt calling I2C_AsyncTick() */
+typedef void (*I2C_TickCmd)(FunctionalState NewState);
 /* Exported constants --------------------------------------------------------*/
+#define I2C_SPEED_STANDARD		100000		// Standard-mode
+#define I2C_SPEED_FAST			400000		// Fast-mode
+#define I2C_SPEED_FAST_PLUS		1000000		// Fast-mode Plus
+
+#define I2C_ASYNC_DONE			0
+#define I2C_ASYNC_PENDING		1
+#define I2C_ASYNC_NACK			(-1)		// the slave did not acknowledge, STOP was sent
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 uint32_t I2C_Init(I2C_ConfigStruct* conf);
@@ -93,5 +134,12 @@ int I2C_WriteRepeated(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint3
 int I2C_Read(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len);
 int I2C_ReadRepeated(I2C_ConfigStruct* conf, uint8_t addr, uint8_t* data, uint32_t len);
 
+/*asynchronous transactions, clocked from a timer interrupt at twice the SCL frequency (three times above 100kHz)*/
+void I2C_AsyncInit(I2C_ConfigStruct* conf, I2C_TickCmd tick_cmd);
+void I2C_AsyncSubmit(I2C_Transaction* t);
+void I2C_AsyncWait(I2C_Transaction* t);
+uint8_t I2C_AsyncBusy(void);
+void I2C_AsyncTick(void);
+
 
  #endif
@@ -0,0 +1,333 @@
+/*******************************************************************************************************************************************************
+
+ * Copyright 2019 <WIZnet Co.,Ltd.>
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the ��Software��),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+/**
+  ******************************************************************************
+
+  * @file    GPIO_I2C/i2c_slave.c
+  * @author  WIZnet
+  * @brief   I2C slave register bank on GPIO, clocked by EXTI level interrupts
+  ******************************************************************************
+  *
+  ******************************************************************************
+  */
+/*include -------------------------------------*/
+#include <stdio.h>
+#include "i2c_slave.h"
+#include "W7500x_gpio.h"
+/** @addtogroup W7500x_StdPeriph_Examples
+ * @{
+ */
+
+/** @addtogroup GPIO_I2C
+ * @{
+ */
+
+/* Private typedef -----------------------------------------------------------*/
+enum
+{
+    SLV_IDLE = 0,       /* Not addressed, waiting for a START */
+    SLV_ADDR,           /* Receiving the address byte         */
+    SLV_RX,             /* Receiving a data byte              */
+    SLV_ACK_OUT,        /* Our ACK/NACK clock                 */
+    SLV_TX,             /* Sending a data byte                */
+    SLV_ACK_IN          /* Master ACK/NACK clock              */
+};
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Both lines are open drain : output data stays 0, the output enable pulls low */
+#define SCL_READ()                  ((slv_scl_port->DATA & slv_scl_mask) ? 1 : 0)
+#define SCL_HOLD()                  (slv_scl_port->OUTENSET = slv_scl_mask)
+#define SCL_RELEASE()               (slv_scl_port->OUTENCLR = slv_scl_mask)
+#define SDA_READ()                  ((slv_sda_port->DATA & slv_sda_mask) ? 1 : 0)
+#define SDA_LOW()                   (slv_sda_port->OUTENSET = slv_sda_mask)
+#define SDA_HIGH()                  (slv_sda_port->OUTENCLR = slv_sda_mask)
+
+/* Interrupt on the level opposite to the one last handled : a change stays pending
+ * until the handler runs, but a line that changes twice before then (a pulse) is
+ * back at the armed level and the pulse is not seen */
+#define ARM(REG, LEVEL)             (*(REG) = EXTI_EXTINT_IEN | ((LEVEL) ? EXTI_Trigger_Low_Level : EXTI_Trigger_High_Level))
+
+/* Private variables ---------------------------------------------------------*/
+static GPIO_TypeDef* const slv_ports[] = { GPIOA, GPIOB, GPIOC };
+static PORTX_TypeDef* const slv_exti[] = { EXTI_PA, EXTI_PB, EXTI_PC };
+
+static GPIO_TypeDef* slv_scl_port;
+static GPIO_TypeDef* slv_sda_port;
+static uint32_t slv_scl_mask;
+static uint32_t slv_sda_mask;
+static __IO uint32_t* slv_scl_exti;
+static __IO uint32_t* slv_sda_exti;
+
+static const I2C_SlaveMap* slv_map;
+static uint8_t slv_addr;
+static uint8_t slv_scl = 1;         /* Levels handled last */
+static uint8_t slv_sda = 1;
+static uint8_t slv_state = SLV_IDLE;
+static uint8_t slv_byte;
+static uint8_t slv_bits;
+static uint8_t slv_read;            /* Direction bit of the address */
+static uint8_t slv_nack;            /* We refused the last byte */
+static uint8_t slv_master_nack;
+static uint8_t slv_addressed;
+static uint8_t slv_reg_set;         /* Register pointer written in this transaction */
+static uint8_t slv_reg;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t slv_pin_index(uint32_t mask);
+static void slv_rise(uint8_t sda);
+static void slv_fall(void);
+static void slv_load(void);
+static void slv_put_bit(void);
+
+
+/**
+ * @brief  I2C slave Initialaze.
+ * @note   SCL and SDA get EXTI level interrupts; call I2C_SlaveIRQHandler() from
+ *         EXTI_Handler. The handler holds SCL low from the falling edges it takes
+ *         until the next bit is ready, so the master must support clock stretching.
+ *         The hold only starts once the handler runs : it covers the handler and
+ *         the callbacks, not the interrupt latency before them.
+ * @note   The handler works on pin levels, so a pulse or a START shorter than the
+ *         interrupt latency plus the handler is missed. SCL high, SCL low, the START
+ *         hold and the STOP setup times of the master must each be longer than that,
+ *         about 3us at 48MHz with short callbacks and no other interrupt in the way.
+ *         This allows Standard-mode, 100kHz at most (4.0us minimum times); the 0.6us
+ *         of Fast-mode are too short.
+ * @param  conf :  Select the GPIO peripheral for use such as scl and sda of i2c.
+ * @param  addr : slave address, as given to I2C_Write by the master (bit 0 ignored)
+ * @param  map : register map callbacks
+ * @retval  0 or  1
+ */
+uint32_t I2C_SlaveInit(I2C_ConfigStruct* conf, uint8_t addr, const I2C_SlaveMap* map)
+{
+    GPIO_InitTypeDef GPIO_InitDef;
+
+    if(conf->scl_port > PORT_PC || conf->sda_port > PORT_PC)
+    {
+        printf("I2C slave pin Port number error\r\n");
+        return 1;
+    }
+
+    slv_scl_port = slv_ports[conf->scl_port];
+    slv_sda_port = slv_ports[conf->sda_port];
+    slv_scl_mask = conf->scl_pin;
+    slv_sda_mask = conf->sda_pin;
+    slv_scl_exti = &slv_exti[conf->scl_port]->REGISTER[slv_pin_index(conf->scl_pin)];
+    slv_sda_exti = &slv_exti[conf->sda_port]->REGISTER[slv_pin_index(conf->sda_pin)];
+    slv_map = map;
+    slv_addr = addr & 0xFE;
+    slv_state = SLV_IDLE;
+    slv_addressed = 0;
+
+    //SCL and SDA released, output data at 0
+    GPIO_InitDef.GPIO_Direction = GPIO_Direction_IN;
+    GPIO_InitDef.GPIO_Pad = GPIO_PuPd_UP;
+    GPIO_InitDef.GPIO_AF = PAD_AF1;
+    GPIO_InitDef.GPIO_Pin = conf->scl_pin;
+    GPIO_Init(slv_scl_port, &GPIO_InitDef);
+    GPIO_ResetBits(slv_scl_port, conf->scl_pin);
+    GPIO_InitDef.GPIO_Pin = conf->sda_pin;
+    GPIO_Init(slv_sda_port, &GPIO_InitDef);
+    GPIO_ResetBits(slv_sda_port, conf->sda_pin);
+    SCL_RELEASE();
+    SDA_HIGH();
+
+    slv_scl = SCL_READ();
+    slv_sda = SDA_READ();
+    ARM(slv_scl_exti, slv_scl);
+    ARM(slv_sda_exti, slv_sda);
+    NVIC_EnableIRQ(EXTI_IRQn);
+
+    return 0;
+}
+/**
+ * @brief  I2C slave interrupt handler, one bus event per call from the pin levels
+ *         read on entry. The level interrupt stays pending while other changes wait;
+ *         two changes of one line between calls are not seen.
+ * @retval  none
+ */
+void I2C_SlaveIRQHandler(void)
+{
+    uint8_t scl = SCL_READ();
+    uint8_t sda = SDA_READ();
+
+    if(scl != slv_scl)
+    {
+        if(scl)
+        {
+            // SCL rising : an SDA change since the last event is the data setup
+            slv_sda = sda;
+            slv_scl = 1;
+            slv_rise(sda);
+        }
+        else
+        {
+            // SCL falling : held low while the next bit is prepared
+            SCL_HOLD();
+            slv_scl = 0;
+            slv_fall();
+            slv_sda = SDA_READ();
+            SCL_RELEASE();
+        }
+    }
+    else if(sda != slv_sda)
+    {
+        slv_sda = sda;
+        if(scl)
+        {
+            if(sda == 0)
+            {
+                // START or repeated START
+                slv_state = SLV_ADDR;
+                slv_byte = 0;
+                slv_bits = 0;
+                slv_reg_set = 0;
+            }
+            else
+            {
+                // STOP
+                if(slv_addressed && slv_map->stop != 0) slv_map->stop();
+                slv_addressed = 0;
+                slv_state = SLV_IDLE;
+            }
+            SDA_HIGH();
+        }
+    }
+
+    ARM(slv_scl_exti, slv_scl);
+    ARM(slv_sda_exti, slv_sda);
+}
+
+static uint32_t slv_pin_index(uint32_t mask)
+{
+    uint32_t i = 0;
+
+    while(i < 15 && (mask & (1UL << i)) == 0) i++;
+    return i;
+}
+
+/* SCL rising : the receiver samples SDA */
+static void slv_rise(uint8_t sda)
+{
+    if(slv_state == SLV_ADDR || slv_state == SLV_RX)
+    {
+        slv_byte = (slv_byte << 1) | sda;
+        slv_bits++;
+    }
+    else if(slv_state == SLV_ACK_IN)
+        slv_master_nack = sda;
+}
+
+/* SCL falling : the transmitter sets up the next bit */
+static void slv_fall(void)
+{
+    ACK_TypeDef ack = ACK;
+
+    switch(slv_state)
+    {
+        case SLV_ADDR :
+        case SLV_RX :
+            if(slv_bits < 8) break;
+
+            if(slv_state == SLV_ADDR)
+            {
+                if((slv_byte & 0xFE) != slv_addr)
+                {
+                    slv_state = SLV_IDLE;
+                    break;
+                }
+                slv_addressed = 1;
+                slv_read = slv_byte & 1;
+            }
+            else if(slv_reg_set == 0)
+            {
+                slv_reg = slv_byte;
+                slv_reg_set = 1;
+            }
+            else
+                ack = (slv_map->write != 0) ? slv_map->write(slv_reg++, slv_byte) : NACK;
+
+            slv_nack = (ack != ACK);
+            if(!slv_nack) SDA_LOW();
+            slv_state = SLV_ACK_OUT;
+            break;
+
+        case SLV_ACK_OUT :
+            SDA_HIGH();
+            if(slv_nack)
+                slv_state = SLV_IDLE;
+            else if(slv_read)
+                slv_load();
+            else
+            {
+                slv_state = SLV_RX;
+                slv_byte = 0;
+                slv_bits = 0;
+            }
+            break;
+
+        case SLV_TX :
+            if(slv_bits < 8)
+                slv_put_bit();
+            else
+            {
+                SDA_HIGH();
+                slv_state = SLV_ACK_IN;
+            }
+            break;
+
+        case SLV_ACK_IN :
+            if(slv_master_nack)
+            {
+                SDA_HIGH();
+                slv_state = SLV_IDLE;
+            }
+            else
+                slv_load();
+            break;
+
+        default :
+            break;
+    }
+}
+
+/* Next register value to send, its first bit goes on SDA */
+static void slv_load(void)
+{
+    slv_byte = slv_map->read(slv_reg++);
+    slv_bits = 0;
+    slv_state = SLV_TX;
+    slv_put_bit();
+}
+
+static void slv_put_bit(void)
+{
+    if(slv_byte & 0x80)
+        SDA_HIGH();
+    else
+        SDA_LOW();
+    slv_byte <<= 1;
+    slv_bits++;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,59 @@
+/*******************************************************************************************************************************************************
+
+ * Copyright 2019 <WIZnet Co.,Ltd.>
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the ��Software��),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+
+ * THE SOFTWARE IS PROVIDED AS IS, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************************************************************************************************/
+/**
+  ******************************************************************************
+
+  * @file    GPIO_I2C/i2c_slave.h
+  * @author  WIZnet
+  * @brief   I2C slave register bank on GPIO, clocked by EXTI level interrupts
+  ******************************************************************************
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __I2C_SLAVE_H
+#define __I2C_SLAVE_H
+/* Includes ------------------------------------------------------------------*/
+#include "i2c.h"
+
+/** @addtogroup W7500x_StdPeriph_Driver
+ * @{
+ */
+
+/** @addtogroup GPIO_I2C
+ * @{
+ */
+/* Exported types ------------------------------------------------------------*/
+
+/* Register map of the slave. The first byte written after the address sets the
+ * register pointer, the next ones are written from it and reads start from it;
+ * the pointer moves by one per byte. The functions are called from the EXTI
+ * interrupt, read and write while SCL is held low, stop on the STOP. */
+typedef struct
+{
+	uint8_t (*read)(uint8_t reg);					// value sent to the master
+	ACK_TypeDef (*write)(uint8_t reg, uint8_t value);	// NACK refuses the byte, may be NULL
+	void (*stop)(void);								// end of a transaction addressed to us, may be NULL
+}I2C_SlaveMap;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t I2C_SlaveInit(I2C_ConfigStruct* conf, uint8_t addr, const I2C_SlaveMap* map);
+void I2C_SlaveIRQHandler(void);
+
+ #endif
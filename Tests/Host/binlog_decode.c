@@ -0,0 +1,412 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/binlog_decode.c
+ * @author  WIZnet
+ * @brief   Host decoder of the binlog records.
+ *
+ *          The format strings never leave the device: a record carries the
+ *          address of its format, and the string table that maps addresses
+ *          back to formats is built from the ELF, from the _binlog_fmt
+ *          symbols that BINLOG() defines. Build it with the firmware:
+ *
+ *              binlog_decode -t firmware.elf > firmware.binlog
+ *
+ *          then decode captured datagrams, or listen for binlog_send():
+ *
+ *              binlog_decode firmware.binlog capture.bin
+ *              binlog_decode firmware.binlog -u 5514
+ *
+ *          The ELF itself can be given instead of the table; %s arguments
+ *          are then looked up in its read-only data as well.
+ *          32 and 64-bit little-endian ELF files are read.
+ ******************************************************************************
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#define BINLOG_HDR_WORDS    2
+#define BINLOG_TICK_MASK    0x0FFFFFFF
+#define MAX_STRINGS         4096
+#define MAX_SECTIONS        64
+
+typedef struct
+{
+    uint64_t addr;
+    char* str;
+} table_entry;
+
+typedef struct
+{
+    uint64_t addr;
+    uint64_t size;
+    const uint8_t* data;
+} elf_section;
+
+static table_entry table[MAX_STRINGS];
+static uint32_t table_len;
+static elf_section sections[MAX_SECTIONS];
+static uint32_t section_count;
+static uint8_t* elf_image;
+
+static uint8_t* read_file(const char* path, long* len)
+{
+    FILE* f = fopen(path, "rb");
+    uint8_t* buf;
+
+    if (f == NULL) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc(*len + 1);
+    if ((buf == NULL) || (fread(buf, 1, *len, f) != (size_t)*len)) {
+        fclose(f);
+        free(buf);
+        return NULL;
+    }
+    buf[*len] = 0;
+    fclose(f);
+    return buf;
+}
+
+static uint64_t get(const uint8_t* p, int size)
+{
+    uint64_t v = 0;
+    int i;
+
+    for (i = size - 1; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+/* String at a target address, from the ELF sections or the table */
+static const char* lookup(uint64_t addr)
+{
+    uint32_t i;
+
+    for (i = 0; i < table_len; i++) {
+        if (table[i].addr == addr) {
+            return table[i].str;
+        }
+    }
+    for (i = 0; i < section_count; i++) {
+        if ((addr >= sections[i].addr) && (addr < sections[i].addr + sections[i].size)) {
+            const char* s = (const char *)sections[i].data + (addr - sections[i].addr);
+
+            /* Only if the string ends inside the section */
+            if (memchr(s, 0, sections[i].addr + sections[i].size - addr) != NULL) {
+                return s;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int load_elf(const uint8_t* img, long len)
+{
+    int is64 = (img[4] == 2);
+    uint64_t shoff, sh, symoff, symsize, symentsize, stroff, name, value, sec_off, sec_addr, sec_size;
+    uint32_t shentsize, shnum, i, j, type, link, shndx;
+    const uint8_t* s;
+
+    if ((len < 64) || (memcmp(img, "\177ELF", 4) != 0) || (img[5] != 1)) {
+        return -1;
+    }
+    shoff = get(img + (is64 ? 0x28 : 0x20), is64 ? 8 : 4);
+    shentsize = (uint32_t)get(img + (is64 ? 0x3A : 0x2E), 2);
+    shnum = (uint32_t)get(img + (is64 ? 0x3C : 0x30), 2);
+    if (shoff + (uint64_t)shentsize * shnum > (uint64_t)len) {
+        return -1;
+    }
+
+    /* Allocated sections with contents, for %s arguments */
+    for (i = 0; i < shnum; i++) {
+        sh = shoff + (uint64_t)i * shentsize;
+        type = (uint32_t)get(img + sh + 4, 4);
+        if ((type == 1) && (get(img + sh + 8, is64 ? 8 : 4) & 0x2) && (section_count < MAX_SECTIONS)) {
+            sections[section_count].addr = get(img + sh + (is64 ? 0x10 : 0x0C), is64 ? 8 : 4);
+            sections[section_count].data = img + get(img + sh + (is64 ? 0x18 : 0x10), is64 ? 8 : 4);
+            sections[section_count].size = get(img + sh + (is64 ? 0x20 : 0x14), is64 ? 8 : 4);
+            section_count++;
+        }
+    }
+
+    /* The formats are the objects named _binlog_fmt (_binlog_fmt.N for GCC) */
+    for (i = 0; i < shnum; i++) {
+        sh = shoff + (uint64_t)i * shentsize;
+        if (get(img + sh + 4, 4) != 2) {
+            continue;
+        }
+        symoff = get(img + sh + (is64 ? 0x18 : 0x10), is64 ? 8 : 4);
+        symsize = get(img + sh + (is64 ? 0x20 : 0x14), is64 ? 8 : 4);
+        link = (uint32_t)get(img + sh + (is64 ? 0x28 : 0x18), 4);
+        symentsize = get(img + sh + (is64 ? 0x38 : 0x24), is64 ? 8 : 4);
+        stroff = get(img + shoff + (uint64_t)link * shentsize + (is64 ? 0x18 : 0x10), is64 ? 8 : 4);
+
+        for (j = 0; (symentsize != 0) && (j < symsize / symentsize); j++) {
+            s = img + symoff + j * symentsize;
+            name = get(s, 4);
+            value = get(s + (is64 ? 8 : 4), is64 ? 8 : 4);
+            shndx = (uint32_t)get(s + (is64 ? 6 : 14), 2);
+            if ((strncmp((const char *)img + stroff + name, "_binlog_fmt", 11) != 0) ||
+                (shndx == 0) || (shndx >= shnum) || (table_len >= MAX_STRINGS)) {
+                continue;
+            }
+            sh = shoff + (uint64_t)shndx * shentsize;
+            sec_addr = get(img + sh + (is64 ? 0x10 : 0x0C), is64 ? 8 : 4);
+            sec_off = get(img + sh + (is64 ? 0x18 : 0x10), is64 ? 8 : 4);
+            sec_size = get(img + sh + (is64 ? 0x20 : 0x14), is64 ? 8 : 4);
+            if ((value < sec_addr) || (value >= sec_addr + sec_size)) {
+                continue;
+            }
+            table[table_len].addr = value;
+            table[table_len].str = (char *)img + sec_off + (value - sec_addr);
+            table_len++;
+        }
+    }
+    return 0;
+}
+
+/* Table lines: hex address, a space, the string with \n \r \t \\ escaped */
+static void print_table(void)
+{
+    const char* p;
+    uint32_t i;
+
+    for (i = 0; i < table_len; i++) {
+        printf("%08llx ", (unsigned long long)table[i].addr);
+        for (p = table[i].str; *p; p++) {
+            switch (*p) {
+            case '\n': fputs("\\n", stdout); break;
+            case '\r': fputs("\\r", stdout); break;
+            case '\t': fputs("\\t", stdout); break;
+            case '\\': fputs("\\\\", stdout); break;
+            default: putchar(*p); break;
+            }
+        }
+        putchar('\n');
+    }
+}
+
+static int load_table(char* text)
+{
+    char* line = text;
+    char* next;
+    char* r;
+    char* w;
+
+    while ((line != NULL) && *line && (table_len < MAX_STRINGS)) {
+        next = strchr(line, '\n');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        table[table_len].addr = strtoull(line, &r, 16);
+        if (*r == ' ') {
+            r++;
+            table[table_len].str = w = r;
+            for (; *r; r++) {
+                if ((*r == '\\') && r[1]) {
+                    r++;
+                    *w++ = (*r == 'n') ? '\n' : (*r == 'r') ? '\r' : (*r == 't') ? '\t' : *r;
+                } else {
+                    *w++ = *r;
+                }
+            }
+            *w = '\0';
+            table_len++;
+        }
+        line = next;
+    }
+    return 0;
+}
+
+/* printf with each conversion taking one 32-bit word, as on the device */
+static void format(const char* fmt, const uint32_t* args, uint32_t nargs)
+{
+    char spec[32];
+    const char* str;
+    uint32_t used = 0;
+    uint32_t v;
+    size_t n;
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            if (*fmt != '\r') {
+                putchar(*fmt);
+            }
+            fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            putchar('%');
+            fmt += 2;
+            continue;
+        }
+
+        /* Flags, width and precision are kept, length modifiers dropped */
+        n = strspn(fmt + 1, "-+ #0123456789.");
+        if (n + 2 > sizeof(spec) - 4) {
+            break;
+        }
+        memcpy(spec, fmt, n + 1);
+        fmt += n + 1;
+        fmt += strspn(fmt, "hlzjt");
+        if (*fmt == '\0') {
+            break;
+        }
+        v = (used < nargs) ? args[used] : 0;
+        used++;
+
+        switch (*fmt) {
+        case 'd':
+        case 'i':
+            memcpy(spec + n + 1, "d", 2);
+            printf(spec, (int32_t)v);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            spec[n + 1] = *fmt;
+            spec[n + 2] = '\0';
+            printf(spec, v);
+            break;
+        case 's':
+            str = lookup(v);
+            if (str != NULL) {
+                memcpy(spec + n + 1, "s", 2);
+                printf(spec, str);
+            } else {
+                printf("<0x%08x>", v);
+            }
+            break;
+        default:
+            printf("<%%%c 0x%08x>", *fmt, v);
+            break;
+        }
+        fmt++;
+    }
+}
+
+/* Decodes the records of one datagram, returns the number of records */
+static int decode(const uint8_t* data, uint32_t len)
+{
+    uint32_t words = len / 4;
+    uint32_t args[16];
+    uint32_t pos = 0, hdr, nargs, addr, i;
+    const char* fmt;
+    int records = 0;
+
+    while (pos + BINLOG_HDR_WORDS <= words) {
+        hdr = (uint32_t)get(data + pos * 4, 4);
+        addr = (uint32_t)get(data + pos * 4 + 4, 4);
+        nargs = hdr >> 28;
+        if (pos + BINLOG_HDR_WORDS + nargs > words) {
+            fprintf(stderr, "truncated record\n");
+            break;
+        }
+        for (i = 0; i < nargs; i++) {
+            args[i] = (uint32_t)get(data + (pos + BINLOG_HDR_WORDS + i) * 4, 4);
+        }
+        pos += BINLOG_HDR_WORDS + nargs;
+
+        printf("[%lu] ", (unsigned long)(hdr & BINLOG_TICK_MASK));
+        fmt = lookup(addr);
+        if (fmt != NULL) {
+            format(fmt, args, nargs);
+        } else {
+            printf("<unknown format 0x%08x>", addr);
+            for (i = 0; i < nargs; i++) {
+                printf(" 0x%08x", args[i]);
+            }
+            putchar('\n');
+        }
+        records++;
+    }
+    fflush(stdout);
+    return records;
+}
+
+static int listen_udp(uint16_t port)
+{
+    struct sockaddr_in sa;
+    uint8_t buf[2048];
+    ssize_t n;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    sa.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0) {
+        fprintf(stderr, "cannot bind to port %u\n", port);
+        return 1;
+    }
+    for (;;) {
+        n = recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            decode(buf, (uint32_t)n);
+        }
+    }
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: binlog_decode -t firmware.elf           print the string table\n"
+            "       binlog_decode table|elf [capture]       decode a capture (or stdin)\n"
+            "       binlog_decode table|elf -u port         decode binlog_send() datagrams\n");
+}
+
+int main(int argc, char** argv)
+{
+    uint8_t buf[65536];
+    long len;
+    size_t n;
+    FILE* in = stdin;
+
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+
+    if (strcmp(argv[1], "-t") == 0) {
+        if ((argc < 3) || ((elf_image = read_file(argv[2], &len)) == NULL) || (load_elf(elf_image, len) != 0)) {
+            fprintf(stderr, "cannot read ELF file %s\n", (argc < 3) ? "" : argv[2]);
+            return 1;
+        }
+        print_table();
+        return 0;
+    }
+
+    if ((elf_image = read_file(argv[1], &len)) == NULL) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    if ((memcmp(elf_image, "\177ELF", 4) == 0) ? (load_elf(elf_image, len) != 0) : (load_table((char *)elf_image) != 0)) {
+        fprintf(stderr, "cannot load %s\n", argv[1]);
+        return 1;
+    }
+
+    if ((argc > 3) && (strcmp(argv[2], "-u") == 0)) {
+        return listen_udp((uint16_t)atoi(argv[3]));
+    }
+    if ((argc > 2) && ((in = fopen(argv[2], "rb")) == NULL)) {
+        fprintf(stderr, "cannot read %s\n", argv[2]);
+        return 1;
+    }
+    /* A capture is the datagrams one after the other, records never straddle them */
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        decode(buf, (uint32_t)n);
+    }
+    return 0;
+}
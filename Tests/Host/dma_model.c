@@ -0,0 +1,264 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/dma_model.c
+ * @author  WIZnet
+ * @brief   Host model of the PL230 DMA controller.
+ *
+ *          The set/clear register pairs, the software request register and
+ *          the error flag behave as on the device. The controller reads the
+ *          control table the driver built in RAM and moves the data with the
+ *          end pointer, increment and n_minus_1 rules of the PL230, writing
+ *          back n_minus_1 and the stop cycle type like the hardware does.
+ *          Addresses below 0x1000 answer with a bus error.
+ ******************************************************************************
+ */
+
+#include "dma_model.h"
+#include "host.h"
+#include "w7500x.h"
+
+#include <string.h>
+
+#define MODEL_CHANNELS      6
+#define MODEL_ALT_OFFSET    8
+#define MODEL_MAX_STEPS     100000
+
+#define CTRL_CYCLE(C)       ((C) & 0x7)
+#define CTRL_N(C)           ((((C) >> 4) & 0x3FF) + 1)
+#define CTRL_R(C)           (1UL << (((C) >> 14) & 0xF))
+#define CTRL_SRC_SIZE(C)    (((C) >> 24) & 0x3)
+#define CTRL_SRC_INC(C)     (((C) >> 26) & 0x3)
+#define CTRL_DST_SIZE(C)    (((C) >> 28) & 0x3)
+#define CTRL_DST_INC(C)     (((C) >> 30) & 0x3)
+#define CTRL_WRITEBACK(C, N, CYCLE) (((C) & ~((0x3FFUL << 4) | 0x7)) | (((N) - 1) << 4) | (CYCLE))
+
+typedef struct
+{
+    uint32_t cfg;
+    uint32_t base;
+    uint32_t useburst;
+    uint32_t reqmask;
+    uint32_t enable;
+    uint32_t prialt;
+    uint32_t priority;
+    uint32_t swreq;
+    uint32_t hwreq;
+    uint32_t err;
+    uint32_t done;
+} dma_model_state;
+
+static dma_model_state dma_model;
+
+uint32_t dma_model_items;
+uint8_t dma_model_order[64];
+uint32_t dma_model_order_len;
+
+static void dma_model_load(uint32_t addr, int write)
+{
+    uint32_t v = 0;
+
+    (void)write;
+    switch (addr & 0xFFC) {
+    case 0x00: v = (dma_model.cfg & 1) | ((MODEL_CHANNELS - 1) << 16); break;
+    case 0x08: v = dma_model.base; break;
+    case 0x0C: v = dma_model.base + (MODEL_ALT_OFFSET * 16); break;
+    case 0x18: v = dma_model.useburst; break;
+    case 0x20: v = dma_model.reqmask; break;
+    case 0x28: v = dma_model.enable; break;
+    case 0x30: v = dma_model.prialt; break;
+    case 0x38: v = dma_model.priority; break;
+    case 0x4C: v = dma_model.err; break;
+    default: break;
+    }
+    HOST_REG(addr & ~3UL) = v;
+}
+
+static void dma_model_store(uint32_t addr)
+{
+    uint32_t v = HOST_REG(addr & ~3UL) & 0x3F;
+
+    switch (addr & 0xFFC) {
+    case 0x04: dma_model.cfg = v & 1; break;
+    case 0x08: dma_model.base = HOST_REG(addr & ~3UL) & DMA_CTRL_BASE_PTR; break;
+    case 0x14: dma_model.swreq |= v; break;
+    case 0x18: dma_model.useburst |= v; break;
+    case 0x1C: dma_model.useburst &= ~v; break;
+    case 0x20: dma_model.reqmask |= v; break;
+    case 0x24: dma_model.reqmask &= ~v; break;
+    case 0x28: dma_model.enable |= v; break;
+    case 0x2C: dma_model.enable &= ~v; break;
+    case 0x30: dma_model.prialt |= v; break;
+    case 0x34: dma_model.prialt &= ~v; break;
+    case 0x38: dma_model.priority |= v; break;
+    case 0x3C: dma_model.priority &= ~v; break;
+    case 0x4C: if (v & 1) dma_model.err = 0; break;
+    default: break;
+    }
+}
+
+void dma_model_init(void)
+{
+    memset(&dma_model, 0, sizeof(dma_model));
+    dma_model_items = 0;
+    dma_model_order_len = 0;
+    host_mmio_unmap(DMA_BASE);
+    host_mmio_map(DMA_BASE, sizeof(DMA_TypeDef), dma_model_load, dma_model_store);
+}
+
+void dma_model_request(uint32_t Channel)
+{
+    dma_model.hwreq |= (1UL << Channel);
+}
+
+static volatile uint32_t* dma_model_desc(uint32_t ch, int alt)
+{
+    return (volatile uint32_t *)(uintptr_t)(dma_model.base + ((ch + (alt ? MODEL_ALT_OFFSET : 0)) * 16));
+}
+
+/* Moves count items of the structure, returns 0 on a bus error */
+static int dma_model_move(volatile uint32_t* desc, uint32_t count)
+{
+    uint32_t ctrl = desc[2];
+    uint32_t n = CTRL_N(ctrl);
+    uint32_t cycle = CTRL_CYCLE(ctrl);
+    uint32_t size = 1UL << CTRL_SRC_SIZE(ctrl);
+    uint32_t i, left, src, dst;
+
+    if (CTRL_SRC_SIZE(ctrl) != CTRL_DST_SIZE(ctrl)) {
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        left = n - i - 1;
+        src = (CTRL_SRC_INC(ctrl) == 3) ? desc[0] : desc[0] - (left << CTRL_SRC_INC(ctrl));
+        dst = (CTRL_DST_INC(ctrl) == 3) ? desc[1] : desc[1] - (left << CTRL_DST_INC(ctrl));
+        if ((cycle == DMA_Mode_MemScatterGather) || (cycle == DMA_Mode_PeriphScatterGather)) {
+            /* The primary writes each task into the 4 words of the alternate structure */
+            dst = desc[1] - ((left & 3) << 2);
+        }
+        if ((src < 0x1000) || (dst < 0x1000)) {
+            return 0;
+        }
+        memcpy((void *)(uintptr_t)dst, (const void *)(uintptr_t)src, size);
+        dma_model_items++;
+    }
+
+    return 1;
+}
+
+/* Runs one channel on one request until it waits for the next one */
+static void dma_model_service(uint32_t ch)
+{
+    uint32_t mask = 1UL << ch;
+    uint32_t steps, ctrl, cycle, n, count;
+    int alt;
+    volatile uint32_t* desc;
+
+    if (dma_model_order_len < sizeof(dma_model_order)) {
+        dma_model_order[dma_model_order_len++] = (uint8_t)ch;
+    }
+
+    for (steps = 0; steps < MODEL_MAX_STEPS; steps++) {
+        alt = (dma_model.prialt & mask) != 0;
+        desc = dma_model_desc(ch, alt);
+        ctrl = desc[2];
+        cycle = CTRL_CYCLE(ctrl);
+        n = CTRL_N(ctrl);
+
+        /* A stop structure ends the channel cycle */
+        if (cycle == DMA_Mode_Stop) {
+            dma_model.enable &= ~mask;
+            dma_model.done |= mask;
+            return;
+        }
+
+        /* Auto-request and memory scatter-gather complete on one request,
+           the other cycle types move 2^R items per request */
+        count = CTRL_R(ctrl);
+        if (count > n) {
+            count = n;
+        }
+        if ((cycle == DMA_Mode_AutoRequest) || (cycle == DMA_Mode_MemScatterGatherAlt)) {
+            count = n;
+        }
+
+        if (!dma_model_move(desc, count)) {
+            /* dma_err shares the combined DMA interrupt */
+            dma_model.err = 1;
+            dma_model.enable &= ~mask;
+            dma_model.done |= mask;
+            return;
+        }
+
+        if (count < n) {
+            desc[2] = CTRL_WRITEBACK(ctrl, n - count, cycle);
+            if ((cycle == DMA_Mode_MemScatterGather) || (cycle == DMA_Mode_PeriphScatterGather)) {
+                /* One task copied: the alternate structure performs it */
+                dma_model.prialt |= mask;
+                continue;
+            }
+            return;
+        }
+
+        desc[2] = CTRL_WRITEBACK(ctrl, 1, DMA_Mode_Stop);
+
+        switch (cycle) {
+        case DMA_Mode_MemScatterGather:
+        case DMA_Mode_PeriphScatterGather:
+            /* Last task copied */
+            dma_model.prialt |= mask;
+            continue;
+        case DMA_Mode_MemScatterGatherAlt:
+            dma_model.prialt &= ~mask;
+            continue;
+        case DMA_Mode_PeriphScatterGatherAlt:
+            dma_model.prialt &= ~mask;
+            return;
+        case DMA_Mode_PingPong:
+            dma_model.prialt ^= mask;
+            dma_model.done |= mask;
+            return;
+        default:
+            /* Basic and auto-request, also as the last scatter-gather task */
+            dma_model.enable &= ~mask;
+            dma_model.done |= mask;
+            return;
+        }
+    }
+}
+
+uint32_t dma_model_run(void)
+{
+    uint32_t ch, mask, pick, pending, done;
+
+    if ((dma_model.cfg & 1) == 0) {
+        return 0;
+    }
+
+    for (;;) {
+        pending = dma_model.enable & (dma_model.swreq | (dma_model.hwreq & ~dma_model.reqmask));
+        if (pending == 0) {
+            break;
+        }
+
+        /* High priority channels first, then the lowest channel number */
+        pick = (pending & dma_model.priority) ? (pending & dma_model.priority) : pending;
+        for (ch = 0; ch < MODEL_CHANNELS; ch++) {
+            mask = 1UL << ch;
+            if (pick & mask) {
+                dma_model.swreq &= ~mask;
+                dma_model.hwreq &= ~mask;
+                dma_model_service(ch);
+                break;
+            }
+        }
+    }
+
+    /* Requests of disabled channels are dropped by the controller */
+    dma_model.swreq = 0;
+    dma_model.hwreq &= dma_model.enable;
+
+    done = dma_model.done;
+    dma_model.done = 0;
+    return done;
+}
@@ -0,0 +1,32 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/dma_model.h
+ * @author  WIZnet
+ * @brief   Host model of the PL230 DMA controller: register file and the
+ *          channel control data structure semantics (basic, auto-request,
+ *          ping-pong, memory and peripheral scatter-gather).
+ ******************************************************************************
+ */
+
+#ifndef __DMA_MODEL_H
+#define __DMA_MODEL_H
+
+#include <stdint.h>
+
+/* Resets the model and claims the DMA register window */
+void dma_model_init(void);
+
+/* Asserts the peripheral request line (dma_req) of a channel */
+void dma_model_request(uint32_t Channel);
+
+/* Services the pending requests. Returns the channels that raised the DMA
+   interrupt (dma_done or a bus error) since the last call; the caller then
+   runs DMA_IRQHandler() as the NVIC would. */
+uint32_t dma_model_run(void);
+
+/* Items moved and channels serviced, in order, since dma_model_init() */
+extern uint32_t dma_model_items;
+extern uint8_t dma_model_order[64];
+extern uint32_t dma_model_order_len;
+
+#endif /* __DMA_MODEL_H */
@@ -0,0 +1,239 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/host.c
+ * @author  WIZnet
+ * @brief   Host test harness: maps the peripheral address space and traps
+ *          the register windows claimed by the models.
+ *
+ *          A trapped access faults, the handler calls the Load hook, opens
+ *          the window and single-steps the faulting instruction (x86-64 trap
+ *          flag). The trap handler then calls the Store hook for writes and
+ *          closes the window again.
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include "host.h"
+#include "w7500x.h"
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+#define HOST_PERIPH_BASE    0x40000000UL
+#define HOST_PERIPH_SIZE    0x06400000UL
+#define HOST_PAGE           0x1000UL
+#define HOST_REGIONS        16
+#define HOST_TRAP_FLAG      0x100
+#define HOST_PF_WRITE       0x2
+
+typedef struct
+{
+    uint32_t Base;
+    uint32_t Size;
+    host_load_fn Load;
+    host_store_fn Store;
+} host_region;
+
+static host_region host_regions[HOST_REGIONS];
+static host_region* host_pending;
+static uint32_t host_pending_addr;
+static int host_pending_write;
+static host_irq_fn host_irq;
+
+volatile uint32_t host_primask;
+volatile uint32_t host_ipsr;
+volatile uint32_t host_nvic_enabled;
+volatile uint32_t host_nvic_pending;
+uint32_t host_system_clock = 48000000;
+
+int host_failures;
+int host_checks;
+
+static host_region* host_find(uintptr_t addr)
+{
+    int i;
+
+    for (i = 0; i < HOST_REGIONS; i++) {
+        if (host_regions[i].Size && (addr >= host_regions[i].Base) && (addr - host_regions[i].Base < host_regions[i].Size)) {
+            return &host_regions[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void host_protect(host_region* r, int prot)
+{
+    if (mprotect((void *)(uintptr_t)r->Base, r->Size, prot) != 0) {
+        abort();
+    }
+}
+
+static void host_segv(int sig, siginfo_t* si, void* context)
+{
+    ucontext_t* uc = (ucontext_t *)context;
+    host_region* r = host_find((uintptr_t)si->si_addr);
+
+    (void)sig;
+    if ((r == NULL) || (host_pending != NULL)) {
+        /* A real fault: let it kill the test with the usual signal */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    host_protect(r, PROT_READ | PROT_WRITE);
+    host_pending = r;
+    host_pending_addr = (uint32_t)(uintptr_t)si->si_addr;
+    host_pending_write = (uc->uc_mcontext.gregs[REG_ERR] & HOST_PF_WRITE) != 0;
+    if (r->Load) {
+        r->Load(host_pending_addr, host_pending_write);
+    }
+    uc->uc_mcontext.gregs[REG_EFL] |= HOST_TRAP_FLAG;
+}
+
+static void host_trap(int sig, siginfo_t* si, void* context)
+{
+    ucontext_t* uc = (ucontext_t *)context;
+    host_region* r = host_pending;
+
+    (void)sig;
+    (void)si;
+    uc->uc_mcontext.gregs[REG_EFL] &= ~HOST_TRAP_FLAG;
+    if (r == NULL) {
+        return;
+    }
+
+    if (host_pending_write && r->Store) {
+        r->Store(host_pending_addr);
+    }
+    host_pending = NULL;
+    host_protect(r, PROT_NONE);
+}
+
+/* The interrupt: taken only where a Cortex-M0 could take it */
+static void host_alarm(int sig)
+{
+    (void)sig;
+    if ((host_irq != NULL) && (host_primask == 0) && (host_pending == NULL)) {
+        host_ipsr = 16;
+        host_irq();
+        host_ipsr = 0;
+    }
+}
+
+__attribute__((constructor)) static void host_init(void)
+{
+    struct sigaction sa;
+    void* p;
+
+    p = mmap((void *)HOST_PERIPH_BASE, HOST_PERIPH_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+    if (p != (void *)HOST_PERIPH_BASE) {
+        fprintf(stderr, "host: cannot map the peripheral space at 0x%08lx\n", HOST_PERIPH_BASE);
+        exit(2);
+    }
+
+    /* No interrupt between a trapped access and its single step */
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sigaddset(&sa.sa_mask, SIGALRM);
+    sa.sa_flags = SA_SIGINFO;
+    sa.sa_sigaction = host_segv;
+    sigaction(SIGSEGV, &sa, NULL);
+    sa.sa_sigaction = host_trap;
+    sigaction(SIGTRAP, &sa, NULL);
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+void host_mmio_map(uint32_t Base, uint32_t Size, host_load_fn Load, host_store_fn Store)
+{
+    int i;
+
+    for (i = 0; i < HOST_REGIONS; i++) {
+        if (host_regions[i].Size == 0) {
+            host_regions[i].Base = Base & ~(HOST_PAGE - 1);
+            host_regions[i].Size = ((Base + Size + HOST_PAGE - 1) & ~(HOST_PAGE - 1)) - host_regions[i].Base;
+            host_regions[i].Load = Load;
+            host_regions[i].Store = Store;
+            host_protect(&host_regions[i], PROT_NONE);
+            return;
+        }
+    }
+
+    abort();
+}
+
+void host_mmio_unmap(uint32_t Base)
+{
+    host_region* r = host_find(Base);
+
+    if (r != NULL) {
+        host_protect(r, PROT_READ | PROT_WRITE);
+        r->Size = 0;
+    }
+}
+
+void host_irq_attach(host_irq_fn Handler, uint32_t PeriodUs)
+{
+    struct itimerval it;
+    struct sigaction sa;
+
+    memset(&it, 0, sizeof(it));
+    setitimer(ITIMER_REAL, &it, NULL);
+    host_irq = Handler;
+    if (Handler == NULL) {
+        return;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = host_alarm;
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &sa, NULL);
+    it.it_interval.tv_usec = PeriodUs;
+    it.it_value.tv_usec = PeriodUs;
+    setitimer(ITIMER_REAL, &it, NULL);
+}
+
+uint64_t host_nanotime(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int host_report(const char* name)
+{
+    printf("%s: %d checks, %d failed\n", name, host_checks, host_failures);
+    return (host_failures == 0) ? 0 : 1;
+}
+
+void assert_failed(uint8_t* file, uint32_t line)
+{
+    printf("%s:%u: assert_param failed\n", (const char *)file, (unsigned)line);
+    abort();
+}
+
+uint32_t GetSystemClock(void)
+{
+    return host_system_clock;
+}
+
+uint32_t GetSourceClock(void)
+{
+    return host_system_clock;
+}
+
+void SystemInit(void)
+{
+}
+
+void SystemCoreClockUpdate(void)
+{
+}
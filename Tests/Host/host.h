@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/host.h
+ * @author  WIZnet
+ * @brief   Host test harness: peripheral address space, register models and
+ *          check macros.
+ *
+ *          The whole peripheral range (0x40000000 - 0x463FFFFF) is mapped as
+ *          plain memory, so registers without side effects just work. A model
+ *          claims a register window with host_mmio_map(): the window is then
+ *          protected and every access traps. Before the access the model's
+ *          Load hook stores the value the register reads as, after a write
+ *          its Store hook applies it (write-1-to-set pairs, FIFOs, commands).
+ *          The tests are built with -no-pie so that the drivers' 32-bit
+ *          address casts hold for static buffers.
+ ******************************************************************************
+ */
+
+#ifndef __HOST_H
+#define __HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Register model hooks. Write is set for stores and read-modify-writes. */
+typedef void (*host_load_fn)(uint32_t Addr, int Write);
+typedef void (*host_store_fn)(uint32_t Addr);
+
+void host_mmio_map(uint32_t Base, uint32_t Size, host_load_fn Load, host_store_fn Store);
+void host_mmio_unmap(uint32_t Base);
+
+/* Backing store of a register, for use inside the hooks only */
+#define HOST_REG(ADDR)      (*(volatile uint32_t *)(uintptr_t)(ADDR))
+#define HOST_REG8(ADDR)     (*(volatile uint8_t *)(uintptr_t)(ADDR))
+
+/* Interrupt source for drivers that wait on RAM for their interrupt: the
+   handler is called from a timer signal every PeriodUs while PRIMASK is
+   clear and no trapped access is in progress. NULL stops the timer. */
+typedef void (*host_irq_fn)(void);
+
+void host_irq_attach(host_irq_fn Handler, uint32_t PeriodUs);
+
+/* Monotonic time in nanoseconds, and the clock the drivers see */
+uint64_t host_nanotime(void);
+extern uint32_t host_system_clock;
+
+/* Checks: count the failures, report them and let the test carry on */
+extern int host_failures;
+extern int host_checks;
+
+#define CHECK(expr) \
+    do { \
+        host_checks++; \
+        if (!(expr)) { \
+            host_failures++; \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        long long _a = (long long)(a), _b = (long long)(b); \
+        host_checks++; \
+        if (_a != _b) { \
+            host_failures++; \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+        } \
+    } while (0)
+
+/* Prints the summary line and returns the process exit code */
+int host_report(const char* name);
+
+#endif /* __HOST_H */
@@ -0,0 +1,537 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/i2c_model.c
+ * @author  WIZnet
+ * @brief   Host model of I2C buses on GPIO pins.
+ *
+ *          Each access to a GPIO port or to SysTick moves the virtual clock
+ *          on by i2c_model_access_cycles. After a GPIO store or a change of
+ *          the external pulls, the lines are brought up to date: an SCL
+ *          change is handled before an SDA change, the device samples on SCL
+ *          rising and sets its SDA on SCL falling, and an SDA change while
+ *          SCL is high is a START or a STOP. SysTick counts down from LOAD
+ *          on the virtual clock once enabled.
+ ******************************************************************************
+ */
+
+#include "i2c_model.h"
+#include "host.h"
+#include "w7500x.h"
+
+#include <string.h>
+
+#define MODEL_PORTS         3
+#define MODEL_BUSES         4
+#define MODEL_NONE          0xFFFFFFFFUL
+
+enum
+{
+    DEV_IDLE = 0,
+    DEV_ADDR,
+    DEV_RX,
+    DEV_ACK_OUT,
+    DEV_TX,
+    DEV_ACK_IN
+};
+
+typedef struct
+{
+    uint32_t dataout;
+    uint32_t outen;
+} i2c_model_port;
+
+struct i2c_model_bus
+{
+    int used;
+    uint32_t scl_port;
+    uint32_t sda_port;
+    uint16_t scl_pin;
+    uint16_t sda_pin;
+    int ext_scl;
+    int ext_sda;
+    int scl;
+    int sda;
+
+    /* Device */
+    uint8_t addr;
+    uint8_t regs[256];
+    uint8_t reg;
+    int reg_set;
+    int state;
+    uint8_t byte;
+    int bits;
+    int read;
+    int nack;
+    int dev_sda;
+
+    /* Edges */
+    int busy;
+    int in_byte;
+    uint64_t t_rise;
+    uint64_t t_fall;
+    uint64_t t_start;
+    uint64_t t_stop;
+    i2c_model_stats stats;
+};
+
+static const uint32_t i2c_model_bases[MODEL_PORTS] = { GPIOA_BASE, GPIOB_BASE, GPIOC_BASE };
+static i2c_model_port i2c_model_ports[MODEL_PORTS];
+static i2c_model_bus i2c_model_buses[MODEL_BUSES];
+static uint64_t i2c_model_clock;
+static int i2c_model_mapped;
+
+/* SysTick: value base_val at base_time, frozen while disabled */
+static uint32_t i2c_model_tick_ctrl;
+static uint32_t i2c_model_tick_load;
+static uint32_t i2c_model_tick_val;
+static uint64_t i2c_model_tick_time;
+static uint32_t i2c_model_tick_reads;
+
+uint32_t i2c_model_access_cycles = 2;
+uint32_t i2c_model_stall_every;
+uint32_t i2c_model_stall_cycles;
+
+static uint32_t i2c_model_port_of(uint32_t Base)
+{
+    uint32_t i;
+
+    for (i = 0; i < MODEL_PORTS; i++) {
+        if (i2c_model_bases[i] == Base) {
+            return i;
+        }
+    }
+    return MODEL_NONE;
+}
+
+/* Level a pin drives: released as an input, the output data as an output */
+static int i2c_model_pin(uint32_t Port, uint16_t Pin)
+{
+    i2c_model_port* p = &i2c_model_ports[Port];
+
+    return ((p->outen & Pin) == 0) || ((p->dataout & Pin) != 0);
+}
+
+static void i2c_model_min(uint32_t* Min, uint64_t Cycles)
+{
+    if (Cycles < *Min) {
+        *Min = (uint32_t)Cycles;
+    }
+}
+
+/* Device: START, STOP and the two clock edges */
+static void i2c_model_dev_start(i2c_model_bus* b)
+{
+    b->dev_sda = 1;
+    b->state = b->addr ? DEV_ADDR : DEV_IDLE;
+    b->byte = 0;
+    b->bits = 0;
+    b->reg_set = 0;
+}
+
+static void i2c_model_dev_rise(i2c_model_bus* b)
+{
+    if ((b->state == DEV_ADDR) || (b->state == DEV_RX)) {
+        b->byte = (uint8_t)((b->byte << 1) | b->sda);
+        b->bits++;
+    } else if (b->state == DEV_ACK_IN) {
+        b->nack = b->sda;
+    }
+}
+
+static void i2c_model_dev_put(i2c_model_bus* b)
+{
+    b->dev_sda = (b->byte & 0x80) != 0;
+    b->byte <<= 1;
+    b->bits++;
+}
+
+static void i2c_model_dev_load(i2c_model_bus* b)
+{
+    b->byte = b->regs[b->reg++];
+    b->bits = 0;
+    b->state = DEV_TX;
+    i2c_model_dev_put(b);
+    b->stats.reads++;
+}
+
+static void i2c_model_dev_fall(i2c_model_bus* b)
+{
+    switch (b->state) {
+    case DEV_ADDR:
+    case DEV_RX:
+        if (b->bits < 8) {
+            break;
+        }
+        if (b->state == DEV_ADDR) {
+            if ((b->byte & 0xFE) != b->addr) {
+                b->state = DEV_IDLE;
+                break;
+            }
+            b->read = b->byte & 1;
+        } else if (!b->reg_set) {
+            b->reg = b->byte;
+            b->reg_set = 1;
+        } else {
+            b->regs[b->reg++] = b->byte;
+            b->stats.writes++;
+        }
+        b->dev_sda = 0;
+        b->state = DEV_ACK_OUT;
+        break;
+    case DEV_ACK_OUT:
+        b->dev_sda = 1;
+        if (b->read) {
+            i2c_model_dev_load(b);
+        } else {
+            b->state = DEV_RX;
+            b->byte = 0;
+            b->bits = 0;
+        }
+        break;
+    case DEV_TX:
+        if (b->bits < 8) {
+            i2c_model_dev_put(b);
+        } else {
+            b->dev_sda = 1;
+            b->state = DEV_ACK_IN;
+        }
+        break;
+    case DEV_ACK_IN:
+        if (b->nack) {
+            b->state = DEV_IDLE;
+        } else {
+            i2c_model_dev_load(b);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void i2c_model_rise(i2c_model_bus* b)
+{
+    uint64_t t = i2c_model_clock;
+    uint64_t period = t - b->t_rise;
+
+    if (b->t_fall != 0) {
+        i2c_model_min(&b->stats.min_low, t - b->t_fall);
+    }
+    if (b->in_byte) {
+        b->stats.periods++;
+        b->stats.period_sum += period;
+        i2c_model_min(&b->stats.min_period, period);
+        if (period > b->stats.max_period) {
+            b->stats.max_period = (uint32_t)period;
+        }
+    }
+    b->in_byte = b->busy;
+    b->t_rise = t;
+    b->stats.clocks++;
+    i2c_model_dev_rise(b);
+}
+
+static void i2c_model_fall(i2c_model_bus* b)
+{
+    uint64_t t = i2c_model_clock;
+
+    if (b->t_rise != 0) {
+        i2c_model_min(&b->stats.min_high, t - b->t_rise);
+    }
+    if (b->t_start != 0) {
+        i2c_model_min(&b->stats.min_hd_sta, t - b->t_start);
+        b->t_start = 0;
+    }
+    b->t_fall = t;
+    i2c_model_dev_fall(b);
+}
+
+static void i2c_model_start(i2c_model_bus* b)
+{
+    uint64_t t = i2c_model_clock;
+
+    if (b->busy) {
+        i2c_model_min(&b->stats.min_su_sta, t - b->t_rise);
+    } else if (b->t_stop != 0) {
+        i2c_model_min(&b->stats.min_buf, t - b->t_stop);
+    }
+    b->stats.starts++;
+    b->busy = 1;
+    b->in_byte = 0;
+    b->t_start = t;
+    i2c_model_dev_start(b);
+}
+
+static void i2c_model_stop(i2c_model_bus* b)
+{
+    uint64_t t = i2c_model_clock;
+
+    i2c_model_min(&b->stats.min_su_sto, t - b->t_rise);
+    b->stats.stops++;
+    b->busy = 0;
+    b->in_byte = 0;
+    b->t_stop = t;
+    b->dev_sda = 1;
+    b->state = DEV_IDLE;
+}
+
+static void i2c_model_update(i2c_model_bus* b)
+{
+    int scl, sda;
+
+    scl = i2c_model_pin(b->scl_port, b->scl_pin) && b->ext_scl;
+    if (scl != b->scl) {
+        b->scl = scl;
+        if (scl) {
+            i2c_model_rise(b);
+        } else {
+            i2c_model_fall(b);
+        }
+    }
+
+    /* After the device has set up its bit on SCL falling */
+    sda = i2c_model_pin(b->sda_port, b->sda_pin) && b->ext_sda && b->dev_sda;
+    if (sda != b->sda) {
+        b->sda = sda;
+        if (b->scl) {
+            if (sda) {
+                i2c_model_stop(b);
+            } else {
+                i2c_model_start(b);
+            }
+        }
+    }
+}
+
+static void i2c_model_update_port(uint32_t Port)
+{
+    uint32_t i;
+
+    for (i = 0; i < MODEL_BUSES; i++) {
+        if (i2c_model_buses[i].used &&
+            ((i2c_model_buses[i].scl_port == Port) || (i2c_model_buses[i].sda_port == Port))) {
+            i2c_model_update(&i2c_model_buses[i]);
+        }
+    }
+}
+
+/* DATA: the line of a bus pin, the pin itself otherwise */
+static uint32_t i2c_model_data(uint32_t Port)
+{
+    i2c_model_port* p = &i2c_model_ports[Port];
+    uint32_t v = ((p->dataout & p->outen) | ~p->outen) & 0xFFFF;
+    i2c_model_bus* b;
+    uint32_t i;
+
+    for (i = 0; i < MODEL_BUSES; i++) {
+        b = &i2c_model_buses[i];
+        if (!b->used) {
+            continue;
+        }
+        if (b->scl_port == Port) {
+            v = b->scl ? (v | b->scl_pin) : (v & ~(uint32_t)b->scl_pin);
+        }
+        if (b->sda_port == Port) {
+            v = b->sda ? (v | b->sda_pin) : (v & ~(uint32_t)b->sda_pin);
+        }
+    }
+    return v;
+}
+
+static void i2c_model_gpio_load(uint32_t addr, int write)
+{
+    uint32_t port = i2c_model_port_of(addr & ~0xFFFUL);
+    uint32_t offset = addr & 0xFFC;
+    i2c_model_port* p = &i2c_model_ports[port];
+    uint32_t v = 0;
+
+    (void)write;
+    i2c_model_clock += i2c_model_access_cycles;
+
+    if (offset == 0x00) {
+        v = i2c_model_data(port);
+    } else if (offset == 0x04) {
+        v = p->dataout;
+    } else if ((offset == 0x10) || (offset == 0x14)) {
+        v = p->outen;
+    } else if ((offset >= 0x400) && (offset < 0x800)) {
+        v = p->dataout & ((offset - 0x400) >> 2);
+    } else if ((offset >= 0x800) && (offset < 0xC00)) {
+        v = p->dataout & (((offset - 0x800) >> 2) << 8);
+    } else {
+        return;
+    }
+    HOST_REG(addr & ~3UL) = v;
+}
+
+static void i2c_model_gpio_store(uint32_t addr)
+{
+    uint32_t port = i2c_model_port_of(addr & ~0xFFFUL);
+    uint32_t offset = addr & 0xFFC;
+    i2c_model_port* p = &i2c_model_ports[port];
+    uint32_t v = HOST_REG(addr & ~3UL);
+    uint32_t mask;
+
+    if (offset == 0x04) {
+        p->dataout = v & 0xFFFF;
+    } else if (offset == 0x10) {
+        p->outen |= v & 0xFFFF;
+    } else if (offset == 0x14) {
+        p->outen &= ~v & 0xFFFF;
+    } else if ((offset >= 0x400) && (offset < 0xC00)) {
+        mask = (offset < 0x800) ? ((offset - 0x400) >> 2) : (((offset - 0x800) >> 2) << 8);
+        p->dataout = (p->dataout & ~mask) | (v & mask);
+    } else {
+        return;
+    }
+    i2c_model_update_port(port);
+}
+
+static uint32_t i2c_model_tick_now(void)
+{
+    uint64_t elapsed = i2c_model_clock - i2c_model_tick_time;
+
+    if (!(i2c_model_tick_ctrl & SysTick_CTRL_ENABLE_Msk)) {
+        return i2c_model_tick_val;
+    }
+    if (elapsed <= i2c_model_tick_val) {
+        return i2c_model_tick_val - (uint32_t)elapsed;
+    }
+    return i2c_model_tick_load - (uint32_t)((elapsed - i2c_model_tick_val - 1) % ((uint64_t)i2c_model_tick_load + 1));
+}
+
+static void i2c_model_tick_load_hook(uint32_t addr, int write)
+{
+    uint32_t offset = addr - HOST_SYSTICK_BASE;
+
+    i2c_model_clock += i2c_model_access_cycles;
+    if ((offset == 0x08) && !write && i2c_model_stall_every && ((++i2c_model_tick_reads % i2c_model_stall_every) == 0)) {
+        i2c_model_clock += i2c_model_stall_cycles;
+    }
+
+    SysTick->CTRL = i2c_model_tick_ctrl;
+    SysTick->LOAD = i2c_model_tick_load;
+    HOST_REG(HOST_SYSTICK_BASE + 0x08) = i2c_model_tick_now();
+}
+
+static void i2c_model_tick_store(uint32_t addr)
+{
+    uint32_t offset = addr - HOST_SYSTICK_BASE;
+
+    /* Restarts from the current value, a VAL write clears it */
+    i2c_model_tick_val = (offset == 0x08) ? 0 : i2c_model_tick_now();
+    i2c_model_tick_time = i2c_model_clock;
+    if (offset == 0x00) {
+        i2c_model_tick_ctrl = SysTick->CTRL & 0x7;
+    } else if (offset == 0x04) {
+        i2c_model_tick_load = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;
+    }
+}
+
+void i2c_model_init(void)
+{
+    uint32_t i;
+
+    if (i2c_model_mapped) {
+        for (i = 0; i < MODEL_PORTS; i++) {
+            host_mmio_unmap(i2c_model_bases[i]);
+        }
+        host_mmio_unmap(HOST_SYSTICK_BASE);
+    }
+    memset(i2c_model_ports, 0, sizeof(i2c_model_ports));
+    memset(i2c_model_buses, 0, sizeof(i2c_model_buses));
+    i2c_model_clock = 0;
+    i2c_model_tick_ctrl = 0;
+    i2c_model_tick_load = 0;
+    i2c_model_tick_val = 0;
+    i2c_model_tick_time = 0;
+    i2c_model_tick_reads = 0;
+    i2c_model_stall_every = 0;
+    i2c_model_stall_cycles = 0;
+
+    for (i = 0; i < MODEL_PORTS; i++) {
+        host_mmio_map(i2c_model_bases[i], sizeof(GPIO_TypeDef), i2c_model_gpio_load, i2c_model_gpio_store);
+    }
+    host_mmio_map(HOST_SYSTICK_BASE, sizeof(SysTick_Type), i2c_model_tick_load_hook, i2c_model_tick_store);
+    i2c_model_mapped = 1;
+}
+
+i2c_model_bus* i2c_model_attach(uint32_t SclBase, uint16_t SclPin, uint32_t SdaBase, uint16_t SdaPin, uint8_t Addr)
+{
+    i2c_model_bus* b;
+    uint32_t i;
+
+    for (i = 0; (i < MODEL_BUSES) && i2c_model_buses[i].used; i++) {
+    }
+    if ((i == MODEL_BUSES) || (i2c_model_port_of(SclBase) == MODEL_NONE) || (i2c_model_port_of(SdaBase) == MODEL_NONE)) {
+        return NULL;
+    }
+
+    b = &i2c_model_buses[i];
+    b->used = 1;
+    b->scl_port = i2c_model_port_of(SclBase);
+    b->sda_port = i2c_model_port_of(SdaBase);
+    b->scl_pin = SclPin;
+    b->sda_pin = SdaPin;
+    b->ext_scl = 1;
+    b->ext_sda = 1;
+    b->dev_sda = 1;
+    b->addr = Addr & 0xFE;
+    b->scl = i2c_model_pin(b->scl_port, SclPin);
+    b->sda = i2c_model_pin(b->sda_port, SdaPin);
+    i2c_model_clear(b);
+    return b;
+}
+
+uint8_t* i2c_model_regs(i2c_model_bus* Bus)
+{
+    return Bus->regs;
+}
+
+const i2c_model_stats* i2c_model_stats_of(i2c_model_bus* Bus)
+{
+    return &Bus->stats;
+}
+
+void i2c_model_clear(i2c_model_bus* Bus)
+{
+    memset(&Bus->stats, 0, sizeof(Bus->stats));
+    Bus->stats.min_high = MODEL_NONE;
+    Bus->stats.min_low = MODEL_NONE;
+    Bus->stats.min_hd_sta = MODEL_NONE;
+    Bus->stats.min_su_sta = MODEL_NONE;
+    Bus->stats.min_su_sto = MODEL_NONE;
+    Bus->stats.min_buf = MODEL_NONE;
+    Bus->stats.min_period = MODEL_NONE;
+    Bus->t_rise = 0;
+    Bus->t_fall = 0;
+    Bus->t_start = 0;
+    Bus->t_stop = 0;
+    Bus->in_byte = 0;
+}
+
+void i2c_model_pull(i2c_model_bus* Bus, int Scl, int Sda)
+{
+    Bus->ext_scl = Scl;
+    Bus->ext_sda = Sda;
+    i2c_model_update(Bus);
+}
+
+int i2c_model_scl(i2c_model_bus* Bus)
+{
+    return Bus->scl;
+}
+
+int i2c_model_sda(i2c_model_bus* Bus)
+{
+    return Bus->sda;
+}
+
+uint64_t i2c_model_now(void)
+{
+    return i2c_model_clock;
+}
+
+void i2c_model_run(uint32_t Cycles)
+{
+    i2c_model_clock += Cycles;
+}
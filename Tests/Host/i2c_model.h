@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/i2c_model.h
+ * @author  WIZnet
+ * @brief   Host model of I2C buses on GPIO pins, on a virtual clock counted
+ *          in core cycles, with SysTick counting that clock.
+ *
+ *          The GPIO ports A to C are trapped: a line is the wired AND of its
+ *          pin (low when the output is enabled with data 0, or driven from
+ *          the data when the output is enabled), of the device on the bus and
+ *          of an external pull the test controls. Every access to the GPIO
+ *          ports or to SysTick costs i2c_model_access_cycles. The timing of
+ *          the SCL and SDA edges is recorded per bus.
+ ******************************************************************************
+ */
+
+#ifndef __I2C_MODEL_H
+#define __I2C_MODEL_H
+
+#include <stdint.h>
+
+/* What a bus saw since the last i2c_model_clear(), times in core cycles */
+typedef struct
+{
+    uint32_t starts;            /* START and repeated START                  */
+    uint32_t stops;
+    uint32_t clocks;            /* SCL rising edges                         */
+    uint32_t writes;            /* Data bytes written to the device         */
+    uint32_t reads;             /* Data bytes the device sent               */
+    uint32_t min_high;          /* SCL high                                 */
+    uint32_t min_low;           /* SCL low                                  */
+    uint32_t min_hd_sta;        /* SDA falling to SCL falling, at START     */
+    uint32_t min_su_sta;        /* SCL rising to SDA falling, at a repeated START */
+    uint32_t min_su_sto;        /* SCL rising to SDA rising, at STOP        */
+    uint32_t min_buf;           /* STOP to START                            */
+    uint32_t periods;           /* SCL rising to rising, with no START between */
+    uint64_t period_sum;
+    uint32_t min_period;
+    uint32_t max_period;
+} i2c_model_stats;
+
+typedef struct i2c_model_bus i2c_model_bus;
+
+/* Claims the GPIO ports and SysTick, removes the buses, resets the clock */
+void i2c_model_init(void);
+
+/* A bus with SCL on pin SclPin of the GPIO port at SclBase and SDA on
+   SdaPin of SdaBase, both pulled up. A device at address Addr (as given to
+   I2C_Write, bit 0 ignored) answers on it: a register bank where the first
+   byte written sets the register pointer, the next ones are written from it
+   and reads start from it. Addr 0 puts no device on the bus. */
+i2c_model_bus* i2c_model_attach(uint32_t SclBase, uint16_t SclPin, uint32_t SdaBase, uint16_t SdaPin, uint8_t Addr);
+
+/* Register bank of the device */
+uint8_t* i2c_model_regs(i2c_model_bus* Bus);
+
+/* What the bus saw; the minimum times read 0xFFFFFFFF when not seen */
+const i2c_model_stats* i2c_model_stats_of(i2c_model_bus* Bus);
+void i2c_model_clear(i2c_model_bus* Bus);
+
+/* External pulls on the lines, 0 pulls low, 1 releases. The levels the
+   lines then have. */
+void i2c_model_pull(i2c_model_bus* Bus, int Scl, int Sda);
+int i2c_model_scl(i2c_model_bus* Bus);
+int i2c_model_sda(i2c_model_bus* Bus);
+
+/* Virtual time, moved on by the accesses and by i2c_model_run() */
+uint64_t i2c_model_now(void);
+void i2c_model_run(uint32_t Cycles);
+
+/* Cycles of one GPIO or SysTick access */
+extern uint32_t i2c_model_access_cycles;
+
+/* Interrupts: every i2c_model_stall_every SysTick reads the clock jumps
+   by i2c_model_stall_cycles, 0 for none */
+extern uint32_t i2c_model_stall_every;
+extern uint32_t i2c_model_stall_cycles;
+
+#endif /* __I2C_MODEL_H */
@@ -0,0 +1,2 @@
+/* Case forwarding header for hosts with case sensitive file systems */
+#include "w7500x_wztoe.h"
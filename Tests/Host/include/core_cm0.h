@@ -0,0 +1,82 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/include/core_cm0.h
+ * @author  WIZnet
+ * @brief   Host stand-in for the CMSIS Cortex-M0 core header.
+ *          PRIMASK, IPSR and NVIC are plain variables and SysTick is plain
+ *          memory, so that the drivers build with the host compiler and the
+ *          tests can observe and drive them.
+ ******************************************************************************
+ */
+
+#ifndef __CORE_CM0_H_GENERIC
+#define __CORE_CM0_H_GENERIC
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+#define __ASM           __asm
+#define __INLINE        inline
+#define __STATIC_INLINE static inline
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __I  uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << 16)
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << 2)
+#define SysTick_CTRL_TICKINT_Msk    (1UL << 1)
+#define SysTick_CTRL_ENABLE_Msk     (1UL << 0)
+#define SysTick_LOAD_RELOAD_Msk     (0xFFFFFFUL)
+#define SysTick_VAL_CURRENT_Msk     (0xFFFFFFUL)
+
+/* On a spare page of the peripheral space, so that a model can trap it
+   with host_mmio_map() to make it count */
+#define HOST_SYSTICK_BASE           (0x40010000UL)
+#define SysTick                     ((SysTick_Type *)HOST_SYSTICK_BASE)
+
+extern volatile uint32_t host_primask;
+extern volatile uint32_t host_ipsr;
+extern volatile uint32_t host_nvic_enabled;
+extern volatile uint32_t host_nvic_pending;
+
+__STATIC_INLINE void __enable_irq(void)         { host_primask = 0; }
+__STATIC_INLINE void __disable_irq(void)        { host_primask = 1; }
+__STATIC_INLINE uint32_t __get_PRIMASK(void)    { return host_primask; }
+__STATIC_INLINE void __set_PRIMASK(uint32_t m)  { host_primask = m; }
+__STATIC_INLINE uint32_t __get_IPSR(void)       { return host_ipsr; }
+__STATIC_INLINE void __NOP(void)                { }
+__STATIC_INLINE void __WFI(void)                { }
+__STATIC_INLINE void __DSB(void)                { }
+__STATIC_INLINE void __ISB(void)                { }
+
+__STATIC_INLINE void NVIC_EnableIRQ(IRQn_Type IRQn)        { host_nvic_enabled |= (1UL << ((uint32_t)IRQn & 0x1F)); }
+__STATIC_INLINE void NVIC_DisableIRQ(IRQn_Type IRQn)       { host_nvic_enabled &= ~(1UL << ((uint32_t)IRQn & 0x1F)); }
+__STATIC_INLINE void NVIC_SetPendingIRQ(IRQn_Type IRQn)    { host_nvic_pending |= (1UL << ((uint32_t)IRQn & 0x1F)); }
+__STATIC_INLINE void NVIC_ClearPendingIRQ(IRQn_Type IRQn)  { host_nvic_pending &= ~(1UL << ((uint32_t)IRQn & 0x1F)); }
+__STATIC_INLINE void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) { (void)IRQn; (void)priority; }
+
+__STATIC_INLINE uint32_t SysTick_Config(uint32_t ticks)
+{
+    SysTick->LOAD = (ticks - 1) & SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CORE_CM0_H_GENERIC */
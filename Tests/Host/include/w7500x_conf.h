@@ -0,0 +1,40 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/include/w7500x_conf.h
+ * @author  WIZnet
+ * @brief   Library configuration of the host tests. Same headers as the
+ *          template, with assert_param always expanded.
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __W7500X_CONF_H
+#define __W7500X_CONF_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "w7500x_adc.h"
+#include "w7500x_crg.h"
+#include "w7500x_dma.h"
+#include "w7500x_dualtimer.h"
+#include "w7500x_exti.h"
+#include "w7500x_flash.h"
+#include "w7500x_gpio.h"
+#include "w7500x_miim.h"
+#include "w7500x_misc.h"
+#include "w7500x_pwm.h"
+#include "w7500x_rng.h"
+#include "w7500x_rtc.h"
+#include "w7500x_ssp.h"
+#include "w7500x_uart.h"
+#include "w7500x_wdt.h"
+#include "w7500x_wztoe.h"
+
+/* Exported macro ------------------------------------------------------------*/
+#define USE_FULL_ASSERT    1
+
+#define assert_param(expr)  ((expr) ? (void)0 : assert_failed((uint8_t *)__FILE__,__LINE__))
+
+/* Exported functions ------------------------------------------------------- */
+void assert_failed(uint8_t* file, uint32_t line);
+
+#endif /* __W7500X_CONF_H */
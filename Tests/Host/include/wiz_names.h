@@ -0,0 +1,26 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/include/wiz_names.h
+ * @author  WIZnet
+ * @brief   Renames the BSD style socket API of ioLibrary (socket, close,
+ *          send, ...) in the code built for the device side, so that the
+ *          models and peers linked in the same test keep the host's.
+ ******************************************************************************
+ */
+
+#ifndef __WIZ_NAMES_H
+#define __WIZ_NAMES_H
+
+#define socket          wiz_socket
+#define close           wiz_close
+#define listen          wiz_listen
+#define connect         wiz_connect
+#define disconnect      wiz_disconnect
+#define send            wiz_send
+#define recv            wiz_recv
+#define sendto          wiz_sendto
+#define recvfrom        wiz_recvfrom
+#define setsockopt      wiz_setsockopt
+#define getsockopt      wiz_getsockopt
+
+#endif /* __WIZ_NAMES_H */
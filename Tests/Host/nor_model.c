@@ -0,0 +1,312 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/nor_model.c
+ * @author  WIZnet
+ * @brief   Host model of a serial NOR flash backed by a file.
+ *
+ *          The GPIO port window is trapped to follow the chip select: a
+ *          falling edge starts a command, the frames of the SSP model go
+ *          through nor_model_frame(), and a rising edge executes programs
+ *          and erases. The flash array is the file mapped shared, so that
+ *          it keeps its contents from one nor_model_init() to the next.
+ ******************************************************************************
+ */
+
+#include "nor_model.h"
+#include "ssp_model.h"
+#include "host.h"
+#include "w7500x.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define NOR_WREN            0x06
+#define NOR_RDSR            0x05
+#define NOR_READ            0x03
+#define NOR_READ_FAST       0x0B
+#define NOR_PP              0x02
+#define NOR_SE              0x20
+#define NOR_BE32K           0x52
+#define NOR_BE              0xD8
+#define NOR_CE              0xC7
+#define NOR_RDID            0x9F
+#define NOR_RES             0xAB
+
+#define NOR_PAGE            256
+
+typedef struct
+{
+    uint32_t gpio;
+    uint16_t cs_pin;
+    uint32_t dataout;
+    int selected;
+    uint8_t* data;
+    uint32_t size;
+    int fd;
+    int wel;
+    uint32_t pos;                   /* Frames since the chip select fell */
+    uint8_t cmd;
+    int ignored;
+    uint32_t addr;
+    uint8_t page[NOR_PAGE];
+    uint32_t page_len;
+} nor_model_state;
+
+static nor_model_state nor_model;
+
+uint32_t nor_model_program_polls = 3;
+uint32_t nor_model_erase_polls = 20;
+uint32_t nor_model_busy;
+int nor_model_busy_id;
+uint32_t nor_model_status_reads;
+uint32_t nor_model_read_bytes;
+uint32_t nor_model_programs;
+uint32_t nor_model_erases;
+uint32_t nor_model_errors;
+
+static uint8_t nor_model_capacity(void)
+{
+    uint8_t n = 0;
+
+    while ((1UL << n) < nor_model.size) {
+        n++;
+    }
+    return n;
+}
+
+static uint8_t nor_model_status(void)
+{
+    uint8_t status = (nor_model_busy ? 0x01 : 0x00) | (nor_model.wel ? 0x02 : 0x00);
+
+    nor_model_status_reads++;
+    if (nor_model_busy && (nor_model_busy != NOR_MODEL_STUCK)) {
+        nor_model_busy--;
+    }
+    return status;
+}
+
+static void nor_model_begin(void)
+{
+    nor_model.pos = 0;
+    nor_model.ignored = 0;
+    nor_model.addr = 0;
+    nor_model.page_len = 0;
+    memset(nor_model.page, 0xFF, sizeof(nor_model.page));
+}
+
+/* Executes the command once the chip select rises */
+static void nor_model_end(void)
+{
+    uint32_t size = 0;
+    uint32_t base, i;
+
+    if (nor_model.ignored || (nor_model.pos == 0)) {
+        return;
+    }
+
+    switch (nor_model.cmd) {
+    case NOR_WREN:
+        nor_model.wel = 1;
+        return;
+    case NOR_PP:
+        if (!nor_model.wel || (nor_model.pos < 4)) {
+            nor_model_errors++;
+            return;
+        }
+        if ((nor_model.addr & (NOR_PAGE - 1)) + nor_model.page_len > NOR_PAGE) {
+            nor_model_errors++;
+        }
+        base = nor_model.addr & (nor_model.size - 1) & ~(NOR_PAGE - 1);
+        for (i = 0; i < NOR_PAGE; i++) {
+            nor_model.data[base + i] &= nor_model.page[i];
+        }
+        nor_model_programs++;
+        nor_model.wel = 0;
+        nor_model_busy = nor_model_program_polls;
+        return;
+    case NOR_SE: size = 0x1000; break;
+    case NOR_BE32K: size = 0x8000; break;
+    case NOR_BE: size = 0x10000; break;
+    case NOR_CE: size = nor_model.size; break;
+    default:
+        return;
+    }
+
+    if (!nor_model.wel || ((nor_model.cmd != NOR_CE) && (nor_model.pos < 4))) {
+        nor_model_errors++;
+        return;
+    }
+    memset(&nor_model.data[nor_model.addr & (nor_model.size - 1) & ~(size - 1)], 0xFF, size);
+    nor_model_erases++;
+    nor_model.wel = 0;
+    nor_model_busy = nor_model_erase_polls;
+}
+
+/* One frame with the chip select low: MOSI in, MISO out */
+static uint16_t nor_model_frame(uint16_t Mosi)
+{
+    uint8_t in = (uint8_t)Mosi;
+    uint8_t out = 0xFF;
+    uint32_t pos = nor_model.pos++;
+
+    if ((nor_model.data == NULL) || !nor_model.selected) {
+        return 0xFF;
+    }
+
+    if (pos == 0) {
+        nor_model.cmd = in;
+        if (nor_model_busy && (in != NOR_RDSR) && !(nor_model_busy_id && (in == NOR_RDID))) {
+            nor_model.ignored = 1;
+            if ((in == NOR_WREN) || (in == NOR_PP) || (in == NOR_SE) || (in == NOR_BE32K) ||
+                (in == NOR_BE) || (in == NOR_CE)) {
+                nor_model_errors++;
+            }
+        }
+        return 0xFF;
+    }
+    if (nor_model.ignored) {
+        return 0xFF;
+    }
+
+    switch (nor_model.cmd) {
+    case NOR_RDSR:
+        out = nor_model_status();
+        break;
+    case NOR_RDID:
+        if (pos == 1) {
+            out = 0xEF;
+        } else if (pos == 2) {
+            out = 0x40;
+        } else if (pos == 3) {
+            out = nor_model_capacity();
+        }
+        break;
+    case NOR_READ:
+    case NOR_READ_FAST:
+    case NOR_PP:
+    case NOR_SE:
+    case NOR_BE32K:
+    case NOR_BE:
+        if (pos <= 3) {
+            nor_model.addr = (nor_model.addr << 8) | in;
+            break;
+        }
+        if (nor_model.cmd == NOR_PP) {
+            /* Past the end of the page the address wraps, the last byte sent wins */
+            nor_model.page[(nor_model.addr + nor_model.page_len) & (NOR_PAGE - 1)] = in;
+            nor_model.page_len++;
+        } else if ((nor_model.cmd == NOR_READ) || ((nor_model.cmd == NOR_READ_FAST) && (pos > 4))) {
+            out = nor_model.data[nor_model.addr++ & (nor_model.size - 1)];
+            nor_model_read_bytes++;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return out;
+}
+
+static void nor_model_gpio_load(uint32_t addr, int write)
+{
+    (void)write;
+
+    /* Only the data registers read back what the masked writes did */
+    if ((addr & 0xFFC) <= 0x04) {
+        HOST_REG(addr & ~3UL) = nor_model.dataout;
+    }
+}
+
+static void nor_model_gpio_store(uint32_t addr)
+{
+    uint32_t offset = addr & 0xFFC;
+    uint32_t v = HOST_REG(addr & ~3UL);
+    uint32_t mask;
+    int selected;
+
+    if (offset == 0x04) {
+        mask = 0xFFFF;
+    } else if ((offset >= 0x400) && (offset < 0x800)) {
+        mask = (offset - 0x400) >> 2;
+    } else if ((offset >= 0x800) && (offset < 0xC00)) {
+        mask = ((offset - 0x800) >> 2) << 8;
+    } else {
+        return;
+    }
+    nor_model.dataout = (nor_model.dataout & ~mask) | (v & mask);
+
+    selected = (nor_model.dataout & nor_model.cs_pin) == 0;
+    if (selected && !nor_model.selected) {
+        nor_model_begin();
+    } else if (!selected && nor_model.selected) {
+        nor_model_end();
+    }
+    nor_model.selected = selected;
+}
+
+int nor_model_init(uint32_t SspBase, uint32_t GpioBase, uint16_t CsPin, const char* Path, uint32_t Size)
+{
+    struct stat st;
+    uint32_t old;
+
+    nor_model_close();
+    memset(&nor_model, 0, sizeof(nor_model));
+    nor_model.fd = -1;
+    nor_model.gpio = GpioBase;
+    nor_model.cs_pin = CsPin;
+    nor_model.dataout = 0xFFFF;
+    nor_model_busy = 0;
+    nor_model_busy_id = 0;
+    nor_model_status_reads = 0;
+    nor_model_read_bytes = 0;
+    nor_model_programs = 0;
+    nor_model_erases = 0;
+    nor_model_errors = 0;
+
+    if (Path != NULL) {
+        nor_model.fd = open(Path, O_RDWR | O_CREAT, 0644);
+        if ((nor_model.fd < 0) || (fstat(nor_model.fd, &st) != 0)) {
+            return -1;
+        }
+        old = (st.st_size < Size) ? (uint32_t)st.st_size : Size;
+        if ((old < Size) && (ftruncate(nor_model.fd, Size) != 0)) {
+            return -1;
+        }
+        nor_model.data = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, nor_model.fd, 0);
+        if (nor_model.data == MAP_FAILED) {
+            nor_model.data = NULL;
+            return -1;
+        }
+        memset(nor_model.data + old, 0xFF, Size - old);
+        nor_model.size = Size;
+    }
+
+    ssp_model_init(SspBase);
+    ssp_model_slave = nor_model_frame;
+    host_mmio_unmap(GpioBase);
+    host_mmio_map(GpioBase, sizeof(GPIO_TypeDef), nor_model_gpio_load, nor_model_gpio_store);
+    return 0;
+}
+
+void nor_model_close(void)
+{
+    if (nor_model.data != NULL) {
+        munmap(nor_model.data, nor_model.size);
+        nor_model.data = NULL;
+    }
+    if (nor_model.fd > 0) {
+        close(nor_model.fd);
+        nor_model.fd = -1;
+    }
+    if (nor_model.gpio != 0) {
+        host_mmio_unmap(nor_model.gpio);
+    }
+}
+
+const uint8_t* nor_model_data(void)
+{
+    return nor_model.data;
+}
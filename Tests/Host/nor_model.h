@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/nor_model.h
+ * @author  WIZnet
+ * @brief   Host model of a serial NOR flash backed by a file, the slave of
+ *          the SSP model with its chip select on a GPIO pin.
+ *
+ *          The flash answers RDID (EF 40 log2(size)), RDSR, READ, FAST
+ *          READ, WREN, page program, 4K / 32K / 64K and chip erase, and
+ *          release from deep power down. After a program or an erase the
+ *          status reads busy for a number of status reads; while busy every
+ *          command but RDSR is ignored, as on a real part; parts that also
+ *          answer RDID while busy are modelled with nor_model_busy_id.
+ ******************************************************************************
+ */
+
+#ifndef __NOR_MODEL_H
+#define __NOR_MODEL_H
+
+#include <stdint.h>
+
+/* Plugs a flash of Size bytes, kept in the file at Path (created erased when
+   missing), into the SSP model at SspBase with its chip select on pin CsPin
+   of the GPIO port at GpioBase. A NULL Path leaves the socket empty: MISO is
+   pulled up and every frame reads 0xFF. */
+int nor_model_init(uint32_t SspBase, uint32_t GpioBase, uint16_t CsPin, const char* Path, uint32_t Size);
+void nor_model_close(void);
+
+/* Flash array as stored in the file */
+const uint8_t* nor_model_data(void);
+
+/* Status reads that see WIP set after a page program and after an erase */
+extern uint32_t nor_model_program_polls;
+extern uint32_t nor_model_erase_polls;
+
+/* Status reads left until WIP clears, set it for a flash busy from before
+   the reset; NOR_MODEL_STUCK never clears */
+extern uint32_t nor_model_busy;
+#define NOR_MODEL_STUCK     0xFFFFFFFFUL
+
+/* Set: RDID is answered while busy, like RDSR */
+extern int nor_model_busy_id;
+
+/* Counters since init. Errors are commands the flash ignored: sent while
+   busy, a program or an erase without WREN, a page program crossing a
+   page. */
+extern uint32_t nor_model_status_reads;
+extern uint32_t nor_model_read_bytes;
+extern uint32_t nor_model_programs;
+extern uint32_t nor_model_erases;
+extern uint32_t nor_model_errors;
+
+#endif /* __NOR_MODEL_H */
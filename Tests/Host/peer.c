@@ -0,0 +1,226 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/peer.c
+ * @author  WIZnet
+ * @brief   Host side peers of the network tests.
+ ******************************************************************************
+ */
+
+#include "peer.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+void peer_sleep_ms(uint32_t ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+uint16_t peer_free_port(int udp)
+{
+    struct sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+    uint16_t port = 0;
+    int fd = socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((bind(fd, (struct sockaddr *)&sa, sizeof(sa)) == 0) &&
+        (getsockname(fd, (struct sockaddr *)&sa, &len) == 0)) {
+        port = ntohs(sa.sin_port);
+    }
+    close(fd);
+    return port;
+}
+
+int peer_spawn(peer_proc* p, char* const argv[])
+{
+    int in[2], out[2];
+
+    memset(p, 0, sizeof(*p));
+    if ((pipe(in) != 0) || (pipe(out) != 0)) {
+        return -1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    p->pid = fork();
+    if (p->pid < 0) {
+        return -1;
+    }
+    if (p->pid == 0) {
+        dup2(in[0], 0);
+        dup2(out[1], 1);
+        dup2(out[1], 2);
+        close(in[0]);
+        close(in[1]);
+        close(out[0]);
+        close(out[1]);
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+
+    close(in[0]);
+    close(out[1]);
+    p->in_fd = in[1];
+    p->out_fd = out[0];
+    fcntl(p->out_fd, F_SETFL, O_NONBLOCK);
+    return 0;
+}
+
+int peer_expect(peer_proc* p, const char* text, uint32_t timeout_ms)
+{
+    struct pollfd pfd;
+    ssize_t n;
+    uint32_t waited;
+
+    for (waited = 0; ; waited += 10) {
+        p->out[p->out_len] = '\0';
+        if (strstr(p->out, text) != NULL) {
+            return 1;
+        }
+        if (waited >= timeout_ms) {
+            return 0;
+        }
+        pfd.fd = p->out_fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, 10) > 0) {
+            n = read(p->out_fd, p->out + p->out_len, sizeof(p->out) - 1 - p->out_len);
+            if (n > 0) {
+                p->out_len += (uint32_t)n;
+            } else if (n == 0) {
+                /* The child is gone, nothing more will come */
+                waited = timeout_ms;
+            }
+        }
+    }
+}
+
+void peer_write(peer_proc* p, const char* text)
+{
+    ssize_t n = write(p->in_fd, text, strlen(text));
+
+    (void)n;
+}
+
+void peer_stop(peer_proc* p)
+{
+    if (p->pid > 0) {
+        kill(p->pid, SIGTERM);
+        waitpid(p->pid, NULL, 0);
+        close(p->in_fd);
+        close(p->out_fd);
+    }
+    p->pid = 0;
+}
+
+uint16_t peer_relay_open(peer_relay* r, uint16_t server_port)
+{
+    struct sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+
+    memset(r, 0, sizeof(*r));
+    r->dev_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    r->srv_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(r->dev_fd, (struct sockaddr *)&sa, sizeof(sa));
+    getsockname(r->dev_fd, (struct sockaddr *)&sa, &len);
+
+    {
+        struct sockaddr_in srv = sa;
+
+        srv.sin_port = htons(server_port);
+        connect(r->srv_fd, (struct sockaddr *)&srv, sizeof(srv));
+    }
+    return ntohs(sa.sin_port);
+}
+
+void peer_relay_pump(peer_relay* r)
+{
+    uint8_t buf[2048];
+    socklen_t len;
+    ssize_t n;
+
+    for (;;) {
+        len = sizeof(r->dev_addr);
+        n = recvfrom(r->dev_fd, buf, sizeof(buf), 0, (struct sockaddr *)r->dev_addr, &len);
+        if (n < 0) {
+            break;
+        }
+        r->dev_known = 1;
+        send(r->srv_fd, buf, (size_t)n, 0);
+    }
+    for (;;) {
+        n = recv(r->srv_fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            break;
+        }
+        memcpy(r->last, buf, (size_t)n);
+        r->last_len = (uint32_t)n;
+        peer_relay_inject(r, buf, (uint32_t)n);
+    }
+}
+
+void peer_relay_inject(peer_relay* r, const uint8_t* data, uint32_t len)
+{
+    if (r->dev_known) {
+        sendto(r->dev_fd, data, len, 0, (struct sockaddr *)r->dev_addr, sizeof(struct sockaddr_in));
+    }
+}
+
+void peer_relay_close(peer_relay* r)
+{
+    close(r->dev_fd);
+    close(r->srv_fd);
+}
+
+int peer_udp_open(uint16_t* port, int any)
+{
+    struct sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(any ? INADDR_ANY : INADDR_LOOPBACK);
+    sa.sin_port = htons(*port);
+    if ((bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0) ||
+        (getsockname(fd, (struct sockaddr *)&sa, &len) != 0)) {
+        close(fd);
+        return -1;
+    }
+    *port = ntohs(sa.sin_port);
+    return fd;
+}
+
+int peer_udp_recv(int fd, uint8_t* buf, uint32_t size, uint32_t timeout_ms)
+{
+    struct pollfd pfd;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, (int)timeout_ms) <= 0) {
+        return -1;
+    }
+    return (int)recv(fd, buf, size, 0);
+}
+
+void peer_udp_close(int fd)
+{
+    close(fd);
+}
@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/peer.h
+ * @author  WIZnet
+ * @brief   Host side peers of the network tests: external processes (e.g.
+ *          openssl s_server) with piped stdio, and a UDP relay between the
+ *          device and such a process that can also inject datagrams.
+ ******************************************************************************
+ */
+
+#ifndef __PEER_H
+#define __PEER_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    int pid;
+    int in_fd;              /* Child's stdin */
+    int out_fd;             /* Child's stdout and stderr */
+    char out[16384];        /* Everything the child printed so far */
+    uint32_t out_len;
+} peer_proc;
+
+typedef struct
+{
+    int dev_fd;             /* Faces the device, its port is the peer port */
+    int srv_fd;             /* Connected to the server */
+    uint8_t dev_addr[16];   /* struct sockaddr_in of the device, once known */
+    int dev_known;
+    uint8_t last[2048];     /* Last datagram relayed from the server */
+    uint32_t last_len;
+} peer_relay;
+
+/* Free loopback TCP or UDP port */
+uint16_t peer_free_port(int udp);
+
+/* Starts argv[0] with piped stdin and stdout, returns 0 on success */
+int peer_spawn(peer_proc* p, char* const argv[]);
+
+/* Waits until the child's output contains text, returns 1 if it did in time */
+int peer_expect(peer_proc* p, const char* text, uint32_t timeout_ms);
+
+/* Writes text to the child's stdin */
+void peer_write(peer_proc* p, const char* text);
+
+/* Kills and reaps the child */
+void peer_stop(peer_proc* p);
+
+/* Relays UDP between the device and the server on server_port, returns the
+   port the device has to talk to */
+uint16_t peer_relay_open(peer_relay* r, uint16_t server_port);
+void peer_relay_pump(peer_relay* r);
+void peer_relay_inject(peer_relay* r, const uint8_t* data, uint32_t len);
+void peer_relay_close(peer_relay* r);
+
+/* Plain UDP endpoint, e.g. a collector, on the loopback interface or on all
+   of them (any). *port 0 picks a free port and returns it. */
+int peer_udp_open(uint16_t* port, int any);
+/* Next datagram, -1 if none arrived within timeout_ms */
+int peer_udp_recv(int fd, uint8_t* buf, uint32_t size, uint32_t timeout_ms);
+void peer_udp_close(int fd);
+
+/* Sleeps, for polling loops */
+void peer_sleep_ms(uint32_t ms);
+
+#endif /* __PEER_H */
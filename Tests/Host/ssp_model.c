@@ -0,0 +1,203 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/ssp_model.c
+ * @author  WIZnet
+ * @brief   Host model of an SSP (PL022) in SPI master mode.
+ *
+ *          Each access moves the virtual clock on by ssp_model_access_cycles
+ *          and then brings the bus up to date: the shifter completes frames
+ *          into the receive FIFO (or sets RORRIS when it is full) and takes
+ *          the next one from the transmit FIFO without a gap. A DR write to
+ *          an idle bus starts shifting at once. A frame lasts DSS + 1 bits of
+ *          CPSDVSR * (1 + SCR) PCLK cycles. RXRIS follows a half full
+ *          receive FIFO, RTRIS is raised by ssp_model_irq() once the bus has
+ *          gone idle with data left in the receive FIFO.
+ ******************************************************************************
+ */
+
+#include "ssp_model.h"
+#include "host.h"
+#include "w7500x.h"
+
+#include <string.h>
+
+#define MODEL_FIFO          8
+
+typedef struct
+{
+    uint32_t base;
+    uint64_t now;
+    uint32_t cr0;
+    uint32_t cr1;
+    uint32_t cpsr;
+    uint32_t imsc;
+    uint32_t ris;
+    uint16_t txq[MODEL_FIFO];
+    uint32_t tx_head;
+    uint32_t tx_count;
+    uint16_t rxq[MODEL_FIFO];
+    uint32_t rx_head;
+    uint32_t rx_count;
+    int shifting;
+    uint16_t shift_data;
+    uint64_t shift_end;
+} ssp_model_state;
+
+static ssp_model_state ssp_model;
+
+uint32_t ssp_model_access_cycles = 6;
+uint16_t (*ssp_model_slave)(uint16_t Mosi);
+uint32_t ssp_model_frames;
+uint32_t ssp_model_overruns;
+
+uint32_t ssp_model_frame_cycles(void)
+{
+    uint32_t bits = (ssp_model.cr0 & SSP_CR0_DSS) + 1;
+    uint32_t scr = (ssp_model.cr0 & SSP_CR0_SCR) >> 8;
+    uint32_t cpsdvsr = ssp_model.cpsr & 0xFE;
+
+    return bits * (cpsdvsr ? cpsdvsr : 2) * (1 + scr);
+}
+
+uint64_t ssp_model_now(void)
+{
+    return ssp_model.now;
+}
+
+static void ssp_model_start(uint64_t at)
+{
+    ssp_model.shift_data = ssp_model.txq[ssp_model.tx_head];
+    ssp_model.tx_head = (ssp_model.tx_head + 1) % MODEL_FIFO;
+    ssp_model.tx_count--;
+    ssp_model.shifting = 1;
+    ssp_model.shift_end = at + ssp_model_frame_cycles();
+}
+
+/* Completes the frames due by now, the next one follows without a gap */
+static void ssp_model_sync(void)
+{
+    uint32_t mask = (2UL << (ssp_model.cr0 & SSP_CR0_DSS)) - 1;
+    uint16_t miso;
+
+    if ((ssp_model.cr1 & SSP_CR1_SSE) == 0) {
+        return;
+    }
+    while (ssp_model.shifting && (ssp_model.shift_end <= ssp_model.now)) {
+        ssp_model_frames++;
+        miso = (ssp_model_slave != NULL) ? ssp_model_slave(ssp_model.shift_data) : ~ssp_model.shift_data;
+        if (ssp_model.rx_count == MODEL_FIFO) {
+            ssp_model.ris |= SSP_RIS_RORRIS;
+            ssp_model_overruns++;
+        } else {
+            ssp_model.rxq[(ssp_model.rx_head + ssp_model.rx_count) % MODEL_FIFO] = miso & mask;
+            ssp_model.rx_count++;
+        }
+        ssp_model.shifting = 0;
+        if (ssp_model.tx_count) {
+            ssp_model_start(ssp_model.shift_end);
+        }
+    }
+    if (!ssp_model.shifting && ssp_model.tx_count) {
+        ssp_model_start(ssp_model.now);
+    }
+    if (ssp_model.rx_count >= MODEL_FIFO / 2) {
+        ssp_model.ris |= SSP_RIS_RXRIS;
+    } else {
+        ssp_model.ris &= ~SSP_RIS_RXRIS;
+    }
+}
+
+static void ssp_model_load(uint32_t addr, int write)
+{
+    uint32_t v = 0;
+
+    ssp_model.now += ssp_model_access_cycles;
+    ssp_model_sync();
+
+    switch (addr & 0xFFC) {
+    case 0x00: v = ssp_model.cr0; break;
+    case 0x04: v = ssp_model.cr1; break;
+    case 0x08:
+        /* A store to DR must not pop the FIFO */
+        if (!write && ssp_model.rx_count) {
+            v = ssp_model.rxq[ssp_model.rx_head];
+            ssp_model.rx_head = (ssp_model.rx_head + 1) % MODEL_FIFO;
+            ssp_model.rx_count--;
+            ssp_model_sync();
+        }
+        break;
+    case 0x0C:
+        if (ssp_model.tx_count == 0) {
+            v |= SSP_SR_TFE;
+        }
+        if (ssp_model.tx_count < MODEL_FIFO) {
+            v |= SSP_SR_TNF;
+        }
+        if (ssp_model.rx_count) {
+            v |= SSP_SR_RNE;
+        }
+        if (ssp_model.rx_count == MODEL_FIFO) {
+            v |= SSP_SR_RFF;
+        }
+        if (ssp_model.shifting || ssp_model.tx_count) {
+            v |= SSP_SR_BSY;
+        }
+        break;
+    case 0x10: v = ssp_model.cpsr; break;
+    case 0x14: v = ssp_model.imsc; break;
+    case 0x18: v = ssp_model.ris; break;
+    case 0x1C: v = ssp_model.ris & ssp_model.imsc; break;
+    default: break;
+    }
+    HOST_REG(addr & ~3UL) = v;
+}
+
+static void ssp_model_store(uint32_t addr)
+{
+    uint32_t v = HOST_REG(addr & ~3UL);
+
+    switch (addr & 0xFFC) {
+    case 0x00: ssp_model.cr0 = v & 0xFFFF; break;
+    case 0x04: ssp_model.cr1 = v & 0xF; break;
+    case 0x08:
+        /* Writes to a full transmit FIFO are lost */
+        if (ssp_model.tx_count < MODEL_FIFO) {
+            ssp_model.txq[(ssp_model.tx_head + ssp_model.tx_count) % MODEL_FIFO] = (uint16_t)v;
+            ssp_model.tx_count++;
+        }
+        break;
+    case 0x10: ssp_model.cpsr = v & 0xFF; break;
+    case 0x14: ssp_model.imsc = v & 0xF; break;
+    case 0x20: ssp_model.ris &= ~(v & (SSP_RIS_RORRIS | SSP_RIS_RTRIS)); break;
+    default: break;
+    }
+    ssp_model_sync();
+}
+
+uint32_t ssp_model_irq(void)
+{
+    if ((ssp_model.ris & ssp_model.imsc) == 0) {
+        /* A disabled SSP holds its frame */
+        while (ssp_model.shifting && ((ssp_model.cr1 & SSP_CR1_SSE) != 0)) {
+            ssp_model.now = ssp_model.shift_end;
+            ssp_model_sync();
+        }
+        /* 32 bit times of an idle bus with data left */
+        if (((ssp_model.cr1 & SSP_CR1_SSE) != 0) && ssp_model.rx_count) {
+            ssp_model.now += 32 * (ssp_model_frame_cycles() / ((ssp_model.cr0 & SSP_CR0_DSS) + 1));
+            ssp_model.ris |= SSP_RIS_RTRIS;
+        }
+    }
+
+    return ssp_model.ris & ssp_model.imsc;
+}
+
+void ssp_model_init(uint32_t Base)
+{
+    memset(&ssp_model, 0, sizeof(ssp_model));
+    ssp_model.base = Base;
+    ssp_model_frames = 0;
+    ssp_model_overruns = 0;
+    host_mmio_unmap(Base);
+    host_mmio_map(Base, sizeof(SSP_TypeDef), ssp_model_load, ssp_model_store);
+}
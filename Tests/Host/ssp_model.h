@@ -0,0 +1,45 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/ssp_model.h
+ * @author  WIZnet
+ * @brief   Host model of an SSP (PL022) in SPI master mode, on a virtual
+ *          clock counted in PCLK cycles.
+ *
+ *          Every register access of the code under test costs the CPU
+ *          ssp_model_access_cycles. Frames shift out of the 8 deep transmit
+ *          FIFO back to back at the SCK rate set by CR0.SCR and CPSR, and the
+ *          slave answers each one with its complement unless a slave model
+ *          is plugged in.
+ ******************************************************************************
+ */
+
+#ifndef __SSP_MODEL_H
+#define __SSP_MODEL_H
+
+#include <stdint.h>
+
+/* Claims the register window of the SSP at Base, resets the clock */
+void ssp_model_init(uint32_t Base);
+
+/* CPU cycles of one register access, with the loop test and branch around it */
+extern uint32_t ssp_model_access_cycles;
+
+/* Virtual time, and the PCLK cycles of one frame at the current settings */
+uint64_t ssp_model_now(void);
+uint32_t ssp_model_frame_cycles(void);
+
+/* Slave on the bus, given each frame sent and returning the frame received,
+   NULL for the complement of the frame sent */
+extern uint16_t (*ssp_model_slave)(uint16_t Mosi);
+
+/* The CPU waits for the interrupt: the clock runs on until the frames in
+   flight are shifted, and the receive timeout is raised if data is left.
+   Returns the masked interrupt status (MIS). Call it where the interrupt
+   would be taken, e.g. from the host_irq_attach() handler. */
+uint32_t ssp_model_irq(void);
+
+/* Frames shifted and frames lost to a full receive FIFO since init */
+extern uint32_t ssp_model_frames;
+extern uint32_t ssp_model_overruns;
+
+#endif /* __SSP_MODEL_H */
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/telemetry_dump.c
+ * @author  WIZnet
+ * @brief   Host collector for the telemetry frames: listens on a UDP port and
+ *          prints every sample as a CSV line (sequence, time, values...).
+ *
+ *          build/telemetry_dump [port]
+ ******************************************************************************
+ */
+
+#include "peer.h"
+#include "telemetry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_SAMPLES     255
+
+static uint8_t frame[2048];
+static int32_t values[MAX_SAMPLES * TELEMETRY_MAX_CHANNELS];
+static uint32_t times[MAX_SAMPLES];
+
+int main(int argc, char** argv)
+{
+    uint16_t port = (argc > 1) ? (uint16_t)atoi(argv[1]) : 5000;
+    uint16_t seq;
+    int32_t n, s, c;
+    int fd, len;
+
+    fd = peer_udp_open(&port, 1);
+    if (fd < 0) {
+        fprintf(stderr, "cannot bind to port %u\n", port);
+        return 1;
+    }
+    fprintf(stderr, "listening on UDP port %u\n", port);
+
+    for (;;) {
+        len = peer_udp_recv(fd, frame, sizeof(frame), 1000);
+        if (len <= 0) {
+            continue;
+        }
+        n = telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_SAMPLES);
+        if (n < 0) {
+            fprintf(stderr, "malformed frame of %d bytes\n", len);
+            continue;
+        }
+        for (s = 0; s < n; s++) {
+            printf("%u,%u", seq, times[s]);
+            for (c = 0; c < frame[4]; c++) {
+                printf(",%d", values[s * frame[4] + c]);
+            }
+            printf("\n");
+        }
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,200 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_binlog.c
+ * @author  WIZnet
+ * @brief   binlog records sent over the WZTOE model and decoded on the host
+ *          by binlog_decode with the string table of this very ELF, the
+ *          argument count limit, and the cycles per call of BINLOG()
+ *          against snprintf().
+ *
+ *          Built with -DBINLOG_TOO_MANY_ARGS the test must not compile, see
+ *          the check target of the Makefile.
+ ******************************************************************************
+ */
+
+/* Before the CMSIS headers, whose __I clashes with the intrinsics' parameters */
+#include <x86intrin.h>
+
+#include "host.h"
+#include "peer.h"
+#include "wztoe_model.h"
+#include "w7500x.h"
+#include "binlog.h"
+
+#include <string.h>
+
+#define BENCH_ROUNDS    2000
+#define BENCH_BATCH     40
+
+static uint8_t loopback[4] = { 127, 0, 0, 1 };
+static uint8_t capture[8192];
+static const char* self_path;
+static uint16_t collector_port;
+
+/* Sends the pending records to the collector and appends them to capture[] */
+static void drain(int fd, uint32_t* len)
+{
+    int32_t n;
+
+    while (binlog_send(0, loopback, collector_port) > 0) {
+        n = peer_udp_recv(fd, capture + *len, sizeof(capture) - *len, 1000);
+        CHECK(n > 0);
+        if (n <= 0) {
+            return;
+        }
+        *len += n;
+    }
+}
+
+static int decoder_output(peer_proc* p, char* mode, char* file, const char* expect)
+{
+    char* argv[5];
+    int n = 0;
+    int ok;
+
+    argv[n++] = "build/binlog_decode";
+    argv[n++] = mode;
+    if (file != NULL) {
+        argv[n++] = file;
+    }
+    argv[n] = NULL;
+    if (peer_spawn(p, argv) != 0) {
+        return 0;
+    }
+    ok = peer_expect(p, expect, 2000);
+    return ok;
+}
+
+static void test_limits(void)
+{
+    static const uint32_t args[BINLOG_MAX_ARGS + 1] = { 1, 2, 3, 4, 5, 6, 7 };
+
+    binlog_init();
+    BINLOG("six %u %u %u %u %u %u\r\n", 1, 2, 3, 4, 5, 6);
+    CHECK_EQ(binlog_get_dropped(), 0);
+
+    /* Past BINLOG() the extra arguments are not silently cut off */
+    CHECK_EQ(binlog_write("seven %u %u %u %u %u %u %u\r\n", BINLOG_MAX_ARGS + 1, args), -1);
+    CHECK_EQ(binlog_get_dropped(), 1);
+    CHECK_EQ(binlog_write("six %u %u %u %u %u %u\r\n", BINLOG_MAX_ARGS, args), 0);
+
+#ifdef BINLOG_TOO_MANY_ARGS
+    BINLOG("seven %u %u %u %u %u %u %u\r\n", 1, 2, 3, 4, 5, 6, 7);
+#endif
+}
+
+static void test_decode(void)
+{
+    static char capture_path[] = "build/binlog_capture.bin";
+    static char table_path[] = "build/binlog_table.txt";
+    static peer_proc p;
+    uint32_t len = 0;
+    int fd = peer_udp_open(&collector_port, 0);
+    int i;
+    FILE* f;
+
+    wztoe_model_init();
+    CHECK_EQ(socket(0, Sn_MR_UDP, 5514, 0), 0);
+    binlog_init();
+
+    BINLOG("boot %d %s\r\n", 3, (uint32_t)"ok");
+    binlog_time_handler();
+    BINLOG("adc[%u] = %5d|%-4x|%c\r\n", 7, -42, 0xab, 'Z');
+    BINLOG("no arguments, 100%%\r\n");
+    for (i = 0; i < 100; i++) {
+        binlog_time_handler();
+        BINLOG("sample %u of %u\r\n", i, 100);
+        /* The ring wraps a few times and records straddle its end */
+        if (i % 30 == 29) {
+            drain(fd, &len);
+        }
+    }
+    drain(fd, &len);
+    CHECK_EQ(len, 4 * (4 + 6 + 2 + 100 * 4));
+    CHECK_EQ(binlog_get_dropped(), 0);
+
+    f = fopen(capture_path, "wb");
+    CHECK(f != NULL);
+    if (f == NULL) {
+        peer_udp_close(fd);
+        return;
+    }
+    fwrite(capture, 1, len, f);
+    fclose(f);
+
+    /* Decoded with the ELF: formats and %s strings come from its sections */
+    CHECK(decoder_output(&p, (char *)self_path, capture_path, "[101] sample 99 of 100\n"));
+    CHECK(strstr(p.out, "[0] boot 3 ok\n") != NULL);
+    CHECK(strstr(p.out, "[1] adc[7] =   -42|ab  |Z\n") != NULL);
+    CHECK(strstr(p.out, "[1] no arguments, 100%\n") != NULL);
+    CHECK(strstr(p.out, "[2] sample 0 of 100\n") != NULL);
+    peer_stop(&p);
+
+    /* The string table built from the ELF, then decoding with it alone */
+    CHECK(decoder_output(&p, "-t", (char *)self_path, "sample %u of %u\\r\\n\n"));
+    CHECK(strstr(p.out, "adc[%u] = %5d|%-4x|%c\\r\\n\n") != NULL);
+    f = fopen(table_path, "wb");
+    if (f != NULL) {
+        fwrite(p.out, 1, p.out_len, f);
+        fclose(f);
+    }
+    peer_stop(&p);
+    CHECK(decoder_output(&p, table_path, capture_path, "[101] sample 99 of 100\n"));
+    CHECK(strstr(p.out, "[1] adc[7] =   -42|ab  |Z\n") != NULL);
+    /* Without the ELF the string argument is only its address */
+    CHECK(strstr(p.out, "[0] boot 3 <0x") != NULL);
+    peer_stop(&p);
+
+    close(0);
+    peer_udp_close(fd);
+}
+
+/* Cycles per call of BINLOG() and of the snprintf() it replaces, same
+   format and arguments. The ring is emptied between batches. */
+static void bench(void)
+{
+    static char line[96];
+    uint64_t c0, bl_cycles = 0, sp_cycles = 0;
+    uint64_t t0, bl_ns = 0, sp_ns = 0;
+    uint32_t round, i;
+    uint32_t calls = BENCH_ROUNDS * BENCH_BATCH;
+
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        binlog_init();
+        t0 = host_nanotime();
+        c0 = __rdtsc();
+        for (i = 0; i < BENCH_BATCH; i++) {
+            BINLOG("adc[%u] = %d at %u\r\n", i, round, round + i);
+        }
+        bl_cycles += __rdtsc() - c0;
+        bl_ns += host_nanotime() - t0;
+
+        t0 = host_nanotime();
+        c0 = __rdtsc();
+        for (i = 0; i < BENCH_BATCH; i++) {
+            snprintf(line, sizeof(line), "adc[%u] = %d at %u\r\n", i, round, round + i);
+            __asm__ volatile("" : : "r"(line) : "memory");
+        }
+        sp_cycles += __rdtsc() - c0;
+        sp_ns += host_nanotime() - t0;
+    }
+    CHECK_EQ(binlog_get_dropped(), 0);
+
+    printf("bench: BINLOG %.1f cycles %.1f ns per call, snprintf %.1f cycles %.1f ns per call, %.1fx\n",
+           (double)bl_cycles / calls, (double)bl_ns / calls,
+           (double)sp_cycles / calls, (double)sp_ns / calls, (double)sp_cycles / bl_cycles);
+    /* Storing 5 words against formatting a line: holds on any host */
+    CHECK(bl_cycles < sp_cycles);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    self_path = argv[0];
+
+    test_limits();
+    test_decode();
+    bench();
+
+    return host_report("test_binlog");
+}
@@ -0,0 +1,333 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_dma.c
+ * @author  WIZnet
+ * @brief   Unit tests of w7500x_dma.c against the PL230 descriptor model.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "dma_model.h"
+#include "w7500x.h"
+#include "w7500x_dma.h"
+
+#include <string.h>
+
+/* Buffers are static: the controller only sees 32-bit addresses */
+static uint8_t src_buf[16384] __attribute__ ((aligned (4)));
+static uint8_t dst_buf[16384] __attribute__ ((aligned (4)));
+static uint32_t events[DMA_CHANNEL_NUM];
+static uint32_t event_count;
+
+static void callback(uint32_t ch, uint32_t event)
+{
+    events[ch] |= event;
+    event_count++;
+}
+
+static void setup(void)
+{
+    uint32_t ch;
+
+    dma_model_init();
+    DMA_DeInit();
+    DMA_Cmd(ENABLE);
+    for (ch = 0; ch < DMA_CHANNEL_NUM; ch++) {
+        DMA_SetCallback(ch, callback);
+        events[ch] = 0;
+    }
+    event_count = 0;
+}
+
+static void fill_pattern(uint8_t* buf, uint32_t size, uint8_t seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++) {
+        buf[i] = (uint8_t)(seed + i * 7 + (i >> 8));
+    }
+}
+
+/* Runs the controller and the interrupt handler like the NVIC would */
+static uint32_t run(void)
+{
+    uint32_t irq = dma_model_run();
+
+    if (irq) {
+        DMA_IRQHandler();
+    }
+    return irq;
+}
+
+static void test_copy_words(void)
+{
+    setup();
+    fill_pattern(src_buf, 256, 1);
+    memset(dst_buf, 0, 260);
+
+    CHECK(DMA_MemCopy(DMA_Channel_2, dst_buf, src_buf, 256) == SUCCESS);
+    CHECK(DMA_GetChannelStatus(DMA_Channel_2) == SET);
+    /* Word items, 64 of them, auto-request */
+    CHECK_EQ((DMA_GetDescriptor(DMA_Channel_2, DMA_Desc_Primary)->Control >> 24) & 0x3, DMA_DataSize_Word);
+    CHECK_EQ(DMA_GetRemaining(DMA_Channel_2, DMA_Desc_Primary), 64);
+
+    CHECK_EQ(run(), 1 << DMA_Channel_2);
+    CHECK(memcmp(dst_buf, src_buf, 256) == 0);
+    CHECK_EQ(dst_buf[256], 0);
+    CHECK_EQ(dma_model_items, 64);
+    CHECK_EQ(events[DMA_Channel_2], DMA_Event_Done);
+    CHECK(DMA_GetChannelStatus(DMA_Channel_2) == RESET);
+    CHECK_EQ(DMA_GetRemaining(DMA_Channel_2, DMA_Desc_Primary), 0);
+}
+
+static void test_copy_unaligned(void)
+{
+    setup();
+    fill_pattern(src_buf, 64, 3);
+    memset(dst_buf, 0xEE, 64);
+
+    /* Odd destination: byte items */
+    CHECK(DMA_MemCopy(DMA_Channel_0, dst_buf + 1, src_buf, 37) == SUCCESS);
+    CHECK_EQ((DMA_GetDescriptor(DMA_Channel_0, DMA_Desc_Primary)->Control >> 24) & 0x3, DMA_DataSize_Byte);
+    run();
+    CHECK(memcmp(dst_buf + 1, src_buf, 37) == 0);
+    CHECK_EQ(dst_buf[0], 0xEE);
+    CHECK_EQ(dst_buf[38], 0xEE);
+
+    /* Even addresses and size: half-word items */
+    CHECK(DMA_MemCopy(DMA_Channel_0, dst_buf + 2, src_buf + 2, 10) == SUCCESS);
+    CHECK_EQ((DMA_GetDescriptor(DMA_Channel_0, DMA_Desc_Primary)->Control >> 24) & 0x3, DMA_DataSize_HalfWord);
+    run();
+    CHECK(memcmp(dst_buf + 2, src_buf + 2, 10) == 0);
+}
+
+static void test_copy_scatter_gather(void)
+{
+    /* 3000 words: three tasks of a memory scatter-gather cycle */
+    setup();
+    fill_pattern(src_buf, 12000, 5);
+    memset(dst_buf, 0, 12004);
+
+    CHECK(DMA_MemCopy(DMA_Channel_1, dst_buf, src_buf, 12000) == SUCCESS);
+    CHECK_EQ(DMA_GetDescriptor(DMA_Channel_1, DMA_Desc_Primary)->Control & 0x7, DMA_Mode_MemScatterGather);
+    CHECK_EQ(run(), 1 << DMA_Channel_1);
+    CHECK(memcmp(dst_buf, src_buf, 12000) == 0);
+    CHECK_EQ(dst_buf[12000], 0);
+    CHECK_EQ(dma_model_items, 3000 + 3 * 4);
+    CHECK_EQ(events[DMA_Channel_1], DMA_Event_Done);
+    CHECK_EQ(event_count, 1);
+
+    /* 4 full tasks is the largest copy */
+    setup();
+    CHECK(DMA_MemCopy(DMA_Channel_1, dst_buf, src_buf, 16384) == SUCCESS);
+    run();
+    CHECK(memcmp(dst_buf, src_buf, 16384) == 0);
+}
+
+static void test_copy_errors(void)
+{
+    setup();
+    CHECK(DMA_MemCopy(DMA_Channel_0, dst_buf, src_buf, 0) == ERROR);
+    CHECK(DMA_MemCopy(DMA_Channel_0, dst_buf, src_buf, 16388) == ERROR);
+    CHECK(DMA_MemCopy(DMA_Channel_0, dst_buf + 1, src_buf, 4097) == ERROR);
+
+    /* Busy until the controller finishes */
+    CHECK(DMA_MemCopy(DMA_Channel_3, dst_buf, src_buf, 16) == SUCCESS);
+    CHECK(DMA_MemCopy(DMA_Channel_3, dst_buf, src_buf, 16) == ERROR);
+    run();
+    CHECK(DMA_MemCopy(DMA_Channel_3, dst_buf, src_buf, 16) == SUCCESS);
+    run();
+
+    /* Bus error: the channel is disabled and the error reported once */
+    CHECK(DMA_MemCopy(DMA_Channel_4, dst_buf, (const void *)0x10, 16) == SUCCESS);
+    CHECK_EQ(run(), 1 << DMA_Channel_4);
+    CHECK_EQ(events[DMA_Channel_4], DMA_Event_Error);
+    CHECK(DMA_GetErrorStatus() == RESET);
+    CHECK(DMA_GetChannelStatus(DMA_Channel_4) == RESET);
+}
+
+static void test_fill(void)
+{
+    static uint32_t word = 0xA5C3E1F0;
+    uint32_t i, ok;
+
+    setup();
+    memset(dst_buf, 0, 8200);
+    CHECK(DMA_MemFill(DMA_Channel_5, dst_buf, &word, 8192) == SUCCESS);
+    run();
+    for (i = 0, ok = 1; i < 8192; i += 4) {
+        ok &= (memcmp(dst_buf + i, &word, 4) == 0);
+    }
+    CHECK(ok);
+    CHECK_EQ(dst_buf[8192], 0);
+    CHECK_EQ(events[DMA_Channel_5], DMA_Event_Done);
+
+    /* Byte fill uses the low byte of the pattern */
+    memset(dst_buf, 0, 16);
+    CHECK(DMA_MemFill(DMA_Channel_5, dst_buf + 1, &word, 5) == SUCCESS);
+    run();
+    CHECK_EQ(dst_buf[0], 0);
+    for (i = 1, ok = 1; i < 6; i++) {
+        ok &= (dst_buf[i] == 0xF0);
+    }
+    CHECK(ok);
+    CHECK_EQ(dst_buf[6], 0);
+}
+
+static uint32_t pingpong_rearm;
+
+static void pingpong_callback(uint32_t ch, uint32_t event)
+{
+    DMA_InitTypeDef init;
+
+    events[ch] |= event;
+    event_count++;
+    if ((event & DMA_Event_PrimaryDone) && pingpong_rearm) {
+        pingpong_rearm--;
+        DMA_StructInit(&init);
+        init.DMA_SrcAddr = (uint32_t) src_buf + 16;
+        init.DMA_DstAddr = (uint32_t) dst_buf + 16;
+        init.DMA_BufferSize = 8;
+        init.DMA_Arbitration = DMA_Arbitration_8;
+        init.DMA_Mode = DMA_Mode_PingPong;
+        DMA_SetDescriptor(ch, DMA_Desc_Primary, &init);
+    }
+}
+
+static void test_pingpong(void)
+{
+    DMA_InitTypeDef init;
+
+    setup();
+    fill_pattern(src_buf, 32, 9);
+    memset(dst_buf, 0, 32);
+    DMA_SetCallback(DMA_Channel_1, pingpong_callback);
+    pingpong_rearm = 1;
+
+    DMA_StructInit(&init);
+    init.DMA_SrcAddr = (uint32_t) src_buf;
+    init.DMA_DstAddr = (uint32_t) dst_buf;
+    init.DMA_BufferSize = 8;
+    init.DMA_Arbitration = DMA_Arbitration_8;
+    init.DMA_Mode = DMA_Mode_PingPong;
+    DMA_Init(DMA_Channel_1, &init);
+    init.DMA_SrcAddr = (uint32_t) src_buf + 8;
+    init.DMA_DstAddr = (uint32_t) dst_buf + 8;
+    DMA_SetDescriptor(DMA_Channel_1, DMA_Desc_Alternate, &init);
+    DMA_ChannelCmd(DMA_Channel_1, ENABLE);
+
+    /* No request, nothing moves */
+    CHECK_EQ(run(), 0);
+
+    /* Masked peripheral requests are held off */
+    DMA_RequestMaskConfig(DMA_Channel_1, ENABLE);
+    dma_model_request(DMA_Channel_1);
+    CHECK_EQ(run(), 0);
+    DMA_RequestMaskConfig(DMA_Channel_1, DISABLE);
+
+    CHECK_EQ(run(), 1 << DMA_Channel_1);
+    CHECK_EQ(events[DMA_Channel_1], DMA_Event_PrimaryDone);
+    CHECK(memcmp(dst_buf, src_buf, 8) == 0);
+    CHECK_EQ(DMA_GetActiveDescriptor(DMA_Channel_1), DMA_Desc_Alternate);
+    CHECK(DMA_GetChannelStatus(DMA_Channel_1) == SET);
+
+    events[DMA_Channel_1] = 0;
+    dma_model_request(DMA_Channel_1);
+    run();
+    CHECK_EQ(events[DMA_Channel_1], DMA_Event_AlternateDone);
+    CHECK(memcmp(dst_buf + 8, src_buf + 8, 8) == 0);
+    CHECK_EQ(DMA_GetActiveDescriptor(DMA_Channel_1), DMA_Desc_Primary);
+
+    /* The re-armed primary half runs */
+    events[DMA_Channel_1] = 0;
+    dma_model_request(DMA_Channel_1);
+    run();
+    CHECK_EQ(events[DMA_Channel_1], DMA_Event_PrimaryDone);
+    CHECK(memcmp(dst_buf + 16, src_buf + 16, 8) == 0);
+
+    /* The alternate half was not re-armed: the cycle ends */
+    events[DMA_Channel_1] = 0;
+    dma_model_request(DMA_Channel_1);
+    run();
+    CHECK_EQ(events[DMA_Channel_1], DMA_Event_Done);
+    CHECK(DMA_GetChannelStatus(DMA_Channel_1) == RESET);
+    CHECK_EQ(dst_buf[24], 0);
+}
+
+static void test_basic_arbitration(void)
+{
+    DMA_InitTypeDef init;
+
+    /* A basic cycle moves 2^R items per peripheral request */
+    setup();
+    fill_pattern(src_buf, 10, 11);
+    memset(dst_buf, 0, 16);
+    DMA_StructInit(&init);
+    init.DMA_SrcAddr = (uint32_t) src_buf;
+    init.DMA_DstAddr = (uint32_t) dst_buf;
+    init.DMA_BufferSize = 10;
+    init.DMA_Arbitration = DMA_Arbitration_4;
+    DMA_Init(DMA_Channel_0, &init);
+    DMA_ChannelCmd(DMA_Channel_0, ENABLE);
+
+    dma_model_request(DMA_Channel_0);
+    CHECK_EQ(run(), 0);
+    CHECK_EQ(DMA_GetRemaining(DMA_Channel_0, DMA_Desc_Primary), 6);
+    CHECK(memcmp(dst_buf, src_buf, 4) == 0);
+    CHECK_EQ(dst_buf[4], 0);
+
+    dma_model_request(DMA_Channel_0);
+    run();
+    dma_model_request(DMA_Channel_0);
+    CHECK_EQ(run(), 1 << DMA_Channel_0);
+    CHECK(memcmp(dst_buf, src_buf, 10) == 0);
+    CHECK_EQ(events[DMA_Channel_0], DMA_Event_Done);
+
+    /* Peripheral to fixed address: non-incrementing destination keeps the last item */
+    setup();
+    DMA_StructInit(&init);
+    init.DMA_SrcAddr = (uint32_t) src_buf;
+    init.DMA_DstAddr = (uint32_t) dst_buf;
+    init.DMA_DstInc = DMA_Inc_None;
+    init.DMA_BufferSize = 3;
+    init.DMA_Arbitration = DMA_Arbitration_4;
+    DMA_Init(DMA_Channel_0, &init);
+    DMA_ChannelCmd(DMA_Channel_0, ENABLE);
+    dma_model_request(DMA_Channel_0);
+    run();
+    CHECK_EQ(dst_buf[0], src_buf[2]);
+}
+
+static void test_priority(void)
+{
+    setup();
+    DMA_PriorityConfig(DMA_Channel_4, ENABLE);
+    CHECK(DMA_MemCopy(DMA_Channel_1, dst_buf, src_buf, 8) == SUCCESS);
+    CHECK(DMA_MemCopy(DMA_Channel_4, dst_buf + 64, src_buf, 8) == SUCCESS);
+    CHECK_EQ(run(), (1 << DMA_Channel_1) | (1 << DMA_Channel_4));
+    CHECK_EQ(dma_model_order_len, 2);
+    CHECK_EQ(dma_model_order[0], DMA_Channel_4);
+    CHECK_EQ(dma_model_order[1], DMA_Channel_1);
+    CHECK_EQ(events[DMA_Channel_1], DMA_Event_Done);
+    CHECK_EQ(events[DMA_Channel_4], DMA_Event_Done);
+
+    /* Disabling a channel drops its request and reports nothing */
+    DMA_ChannelCmd(DMA_Channel_2, ENABLE);
+    DMA_ChannelCmd(DMA_Channel_2, DISABLE);
+    DMA_SoftwareRequest(DMA_Channel_2);
+    CHECK_EQ(run(), 0);
+}
+
+int main(void)
+{
+    test_copy_words();
+    test_copy_unaligned();
+    test_copy_scatter_gather();
+    test_copy_errors();
+    test_fill();
+    test_pingpong();
+    test_basic_arbitration();
+    test_priority();
+
+    return host_report("test_dma");
+}
@@ -0,0 +1,126 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_dma_mem.c
+ * @author  WIZnet
+ * @brief   Unit tests of w7500x_dma_mem.c against the PL230 descriptor model:
+ *          queued requests, block splitting and how DMA errors reach the
+ *          caller.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "dma_model.h"
+#include "w7500x.h"
+#include "w7500x_dma_mem.h"
+
+#include <string.h>
+
+static uint8_t src_buf[3][10000] __attribute__ ((aligned (4)));
+static uint8_t dst_buf[3][10000] __attribute__ ((aligned (4)));
+static uint8_t busy_buf[64] __attribute__ ((aligned (4)));
+static int done[3];
+static ErrorStatus status[3];
+
+static void callback(void* arg, ErrorStatus st)
+{
+    int i = (int)(uintptr_t)arg;
+
+    done[i]++;
+    status[i] = st;
+}
+
+static void setup(uint32_t channels)
+{
+    dma_model_init();
+    DMA_DeInit();
+    DMAMEM_Init(channels);
+    DMAMEM_SetThreshold(64);
+    memset(done, 0, sizeof(done));
+    memset(status, 0xFF, sizeof(status));
+}
+
+/* Runs the controller and the interrupt handler until the service is idle */
+static void run_all(void)
+{
+    int guard;
+
+    for (guard = 0; (guard < 100) && (DMAMEM_GetStatus() == SET); guard++) {
+        if (dma_model_run()) {
+            DMA_IRQHandler();
+        }
+    }
+}
+
+static void test_queue(void)
+{
+    int i, j;
+
+    setup((1 << DMA_Channel_0) | (1 << DMA_Channel_1));
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 10000; j++) {
+            src_buf[i][j] = (uint8_t)(i * 31 + j);
+        }
+        memset(dst_buf[i], 0, sizeof(dst_buf[i]));
+    }
+
+    /* Three blocks each, the third request waits for a channel */
+    for (i = 0; i < 3; i++) {
+        CHECK(DMAMEM_Copy(dst_buf[i], src_buf[i], 10000, callback, (void *)(uintptr_t)i) == SUCCESS);
+    }
+    run_all();
+    for (i = 0; i < 3; i++) {
+        CHECK_EQ(done[i], 1);
+        CHECK_EQ(status[i], SUCCESS);
+        CHECK(memcmp(dst_buf[i], src_buf[i], 10000) == 0);
+    }
+
+    /* Below the threshold the CPU does it before returning */
+    CHECK(DMAMEM_Set(dst_buf[0], 0x5A, 16, callback, (void *)0) == SUCCESS);
+    CHECK_EQ(done[0], 2);
+    CHECK_EQ(status[0], SUCCESS);
+    CHECK_EQ(dst_buf[0][15], 0x5A);
+}
+
+static void test_channel_busy(void)
+{
+    setup(1 << DMA_Channel_0);
+
+    /* A transfer the service does not know about holds its only channel */
+    CHECK(DMA_MemCopy(DMA_Channel_0, busy_buf, src_buf[0], 32) == SUCCESS);
+    CHECK(DMAMEM_Copy(dst_buf[0], src_buf[0], 1000, callback, (void *)0) == ERROR);
+    CHECK(DMAMEM_Set(dst_buf[0], 0, 1000, callback, (void *)0) == ERROR);
+    CHECK_EQ(done[0], 0);
+    CHECK(DMAMEM_GetStatus() == RESET);
+
+    /* Usable again once the channel is free */
+    if (dma_model_run()) {
+        DMA_IRQHandler();
+    }
+    memset(dst_buf[0], 0, 1000);
+    CHECK(DMAMEM_Copy(dst_buf[0], src_buf[0], 1000, callback, (void *)0) == SUCCESS);
+    run_all();
+    CHECK_EQ(done[0], 1);
+    CHECK_EQ(status[0], SUCCESS);
+    CHECK(memcmp(dst_buf[0], src_buf[0], 1000) == 0);
+}
+
+static void test_bus_error(void)
+{
+    setup(1 << DMA_Channel_0);
+
+    /* The model answers addresses below 0x1000 with a bus error */
+    CHECK(DMAMEM_Copy((void *)0x800, src_buf[0], 256, callback, (void *)1) == SUCCESS);
+    run_all();
+    CHECK_EQ(done[1], 1);
+    CHECK_EQ(status[1], ERROR);
+    CHECK(DMAMEM_GetStatus() == RESET);
+}
+
+int main(void)
+{
+    test_queue();
+    test_channel_busy();
+    test_bus_error();
+
+    return host_report("test_dma_mem");
+}
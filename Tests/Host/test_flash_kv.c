@@ -0,0 +1,338 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_flash_kv.c
+ * @author  WIZnet
+ * @brief   Flash key/value store on a simulated main flash: FLASH_IAP()
+ *          programs and erases a RAM array and counts the erases of each
+ *          block.
+ *
+ *          The power is cut at every IAP call of a run of writes and
+ *          deletes that goes through several compactions, once before the
+ *          call and once halfway through it. After each cut the store is
+ *          opened again: every key must hold its last value (the one being
+ *          written may hold either), a sector must be left erased, and the
+ *          store must take writes again. The erases must be spread evenly
+ *          over the sectors.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "w7500x.h"
+#include "w7500x_flash_kv.h"
+
+#include <setjmp.h>
+#include <string.h>
+
+#define SECTORS         4
+#define BLOCK           4096
+#define KEYS            8
+#define RUN             400
+#define NO_CUT          0xFFFFFFFFUL
+
+static uint8_t flash[SECTORS * FLASHKV_SECTOR_SIZE] __attribute__((aligned(BLOCK)));
+static uint32_t erases[SECTORS * FLASHKV_SECTOR_SIZE / BLOCK];
+
+/* Power cut: the IAP call number, and whether it is cut halfway */
+static uint32_t iap_calls;
+static uint32_t cut_at = NO_CUT;
+static int cut_half;
+static jmp_buf power_fail;
+
+/* Calls outside the array or misaligned */
+static uint32_t iap_errors;
+
+/* Longest value of the run, and its number of steps */
+static uint16_t max_length = FLASHKV_MAX_VALUE;
+static uint32_t run_steps = RUN;
+
+/* Last value of each key, by the step that wrote it, -1 when deleted */
+static int32_t expect[KEYS];
+
+void FLASH_IAP(uint32_t id, uint32_t dst_addr, uint8_t* src_addr, uint32_t size)
+{
+    uint8_t* dst = (uint8_t*)(uintptr_t)dst_addr;
+    uint32_t i;
+    int cut = (iap_calls++ == cut_at);
+
+    if (cut && !cut_half) {
+        longjmp(power_fail, 1);
+    }
+
+    switch (id) {
+    case IAP_ERAS_BLCK:
+    case IAP_ERAS_SECT:
+        size = (id == IAP_ERAS_BLCK) ? BLOCK : 256;
+        if ((dst < flash) || (dst + size > flash + sizeof(flash)) || (((dst - flash) % size) != 0)) {
+            iap_errors++;
+            return;
+        }
+        memset(dst, 0xFF, cut ? size / 2 : size);
+        if (!cut) {
+            erases[(dst - flash) / BLOCK]++;
+        }
+        break;
+    case IAP_PROG:
+        if ((dst < flash) || (dst + size > flash + sizeof(flash)) || ((dst_addr & 3) != 0)) {
+            iap_errors++;
+            return;
+        }
+        /* Programming clears bits only, a cut one stops after half of the words */
+        if (cut) {
+            size = (size / 2) & ~3UL;
+        }
+        for (i = 0; i < size; i++) {
+            dst[i] &= src_addr[i];
+        }
+        break;
+    default:
+        iap_errors++;
+        break;
+    }
+
+    if (cut) {
+        longjmp(power_fail, 1);
+    }
+}
+
+static uint32_t base(void)
+{
+    return (uint32_t)(uintptr_t)flash;
+}
+
+/* The first steps write the cold keys, which every compaction then has to
+   copy, the others go round the hot keys */
+static uint16_t key_of(uint32_t step)
+{
+    if (step < KEYS / 2) {
+        return (uint16_t)(KEYS / 2 + step);
+    }
+    return (uint16_t)(step % (KEYS / 2));
+}
+
+/* Value written by a step: its length and bytes follow the step number */
+static uint16_t value_of(uint32_t step, uint8_t* value)
+{
+    uint16_t length = (uint16_t)(1 + (step * 37) % max_length);
+    uint16_t i;
+
+    for (i = 0; i < length; i++) {
+        value[i] = (uint8_t)(step * 7 + i);
+    }
+    return length;
+}
+
+static int is_delete(uint32_t step)
+{
+    return (step >= KEYS / 2) && ((step % 13) == 12);
+}
+
+/* One write or delete of the run */
+static ErrorStatus step_run(uint32_t step)
+{
+    uint8_t value[FLASHKV_MAX_VALUE];
+    uint16_t length;
+
+    if (is_delete(step)) {
+        return FLASHKV_Delete(key_of(step));
+    }
+    length = value_of(step, value);
+    return FLASHKV_Write(key_of(step), value, length);
+}
+
+/* Whether a key holds what the step wrote, -1 for no value */
+static int key_holds(uint16_t key, int32_t step)
+{
+    uint8_t value[FLASHKV_MAX_VALUE];
+    uint8_t stored[FLASHKV_MAX_VALUE];
+    uint16_t length, stored_length;
+
+    if (FLASHKV_Read(key, stored, sizeof(stored), &stored_length) != SUCCESS) {
+        return step < 0;
+    }
+    if (step < 0) {
+        return 0;
+    }
+    length = value_of(step, value);
+    return (stored_length == length) && (memcmp(stored, value, length) == 0);
+}
+
+static uint32_t erased_sectors(void)
+{
+    uint32_t n = 0;
+    uint32_t s, i;
+
+    for (s = 0; s < SECTORS; s++) {
+        for (i = 0; i < FLASHKV_SECTOR_SIZE; i++) {
+            if (flash[s * FLASHKV_SECTOR_SIZE + i] != 0xFF) {
+                break;
+            }
+        }
+        n += (i == FLASHKV_SECTOR_SIZE);
+    }
+    return n;
+}
+
+static void power_on_blank(void)
+{
+    uint32_t i;
+
+    memset(flash, 0xFF, sizeof(flash));
+    memset(erases, 0, sizeof(erases));
+    for (i = 0; i < KEYS; i++) {
+        expect[i] = -1;
+    }
+    iap_calls = 0;
+    cut_at = NO_CUT;
+    CHECK_EQ(FLASHKV_Init(base(), SECTORS), SUCCESS);
+}
+
+/* Runs steps from First, returns the step cut by the power, or Last when none */
+static uint32_t run(uint32_t First, uint32_t Last)
+{
+    volatile uint32_t step;
+
+    for (step = First; step < Last; step++) {
+        if (setjmp(power_fail) != 0) {
+            return step;
+        }
+        CHECK_EQ(step_run(step), SUCCESS);
+        expect[key_of(step)] = is_delete(step) ? -1 : (int32_t)step;
+    }
+    return Last;
+}
+
+static void test_limits(void)
+{
+    uint8_t value[FLASHKV_MAX_VALUE + 1];
+
+    memset(value, 0x5A, sizeof(value));
+    power_on_blank();
+    CHECK_EQ(FLASHKV_Init(base() + 4, SECTORS), ERROR);
+    CHECK_EQ(FLASHKV_Init(base(), 1), ERROR);
+    CHECK_EQ(FLASHKV_Init(base(), SECTORS), SUCCESS);
+    CHECK_EQ(FLASHKV_Write(0, value, FLASHKV_MAX_VALUE + 1), ERROR);
+
+    /* The same value again does not touch the flash */
+    CHECK_EQ(FLASHKV_Write(1, value, 10), SUCCESS);
+    iap_calls = 0;
+    CHECK_EQ(FLASHKV_Write(1, value, 10), SUCCESS);
+    CHECK_EQ(iap_calls, 0);
+    CHECK_EQ(FLASHKV_Delete(2), SUCCESS);
+    CHECK_EQ(iap_calls, 0);
+}
+
+/* Long run: the values survive each reopen and the erases are even */
+static void test_wear(void)
+{
+    uint32_t i, min = 0xFFFFFFFF, max = 0;
+    uint16_t key;
+    int ok = 1;
+
+    power_on_blank();
+    for (i = 0; i < 10; i++) {
+        CHECK_EQ(run(i * RUN, (i + 1) * RUN), (i + 1) * RUN);
+        CHECK_EQ(FLASHKV_Init(base(), SECTORS), SUCCESS);
+        for (key = 0; key < KEYS; key++) {
+            ok &= key_holds(key, expect[key]);
+        }
+    }
+    CHECK(ok);
+    CHECK_EQ(erased_sectors(), 1);
+
+    for (i = 0; i < SECTORS * FLASHKV_SECTOR_SIZE / BLOCK; i++) {
+        min = (erases[i] < min) ? erases[i] : min;
+        max = (erases[i] > max) ? erases[i] : max;
+    }
+    printf("test_flash_kv: %u steps, erases per block %u to %u\n", 10 * RUN, (unsigned)min, (unsigned)max);
+    CHECK(min > 10);
+    CHECK(max - min <= 1);
+}
+
+/* The power cut at each IAP call of a run. With values of up to 4 bytes
+   the records copied by a compaction are 12 bytes, and a cut halfway leaves
+   the header of the copy broken. */
+static void test_power_loss(uint16_t MaxLength, uint32_t Steps)
+{
+    uint32_t calls, cut, stop, step;
+    uint32_t no_free = 0, cuts = 0, recovery_erases, total;
+    uint16_t key;
+    int32_t before;
+    int ok, holds;
+
+    max_length = MaxLength;
+    run_steps = Steps;
+
+    /* IAP calls of the whole run */
+    power_on_blank();
+    CHECK_EQ(run(0, run_steps), run_steps);
+    calls = iap_calls;
+    CHECK(calls > RUN);
+
+    for (cut = 0; cut < 2 * calls; cut++) {
+        power_on_blank();
+        cut_at = cut / 2;
+        cut_half = cut & 1;
+        stop = run(0, run_steps);
+        cut_at = NO_CUT;
+        if (stop == run_steps) {
+            continue;
+        }
+        cuts++;
+
+        /* The case of the review: the spare sector opened, the oldest one not yet erased */
+        no_free += (erased_sectors() == 0);
+
+        before = expect[key_of(stop)];
+        total = 0;
+        for (step = 0; step < SECTORS * FLASHKV_SECTOR_SIZE / BLOCK; step++) {
+            total += erases[step];
+        }
+        CHECK_EQ(FLASHKV_Init(base(), SECTORS), SUCCESS);
+        recovery_erases = 0;
+        for (step = 0; step < SECTORS * FLASHKV_SECTOR_SIZE / BLOCK; step++) {
+            recovery_erases += erases[step];
+        }
+        recovery_erases -= total;
+
+        ok = 1;
+        for (key = 0; key < KEYS; key++) {
+            if (key == key_of(stop)) {
+                holds = key_holds(key, before) || key_holds(key, is_delete(stop) ? -1 : (int32_t)stop);
+            } else {
+                holds = key_holds(key, expect[key]);
+            }
+            ok &= holds;
+        }
+        CHECK(ok);
+        CHECK(erased_sectors() >= 1);
+        CHECK(recovery_erases <= FLASHKV_SECTOR_SIZE / BLOCK);
+
+        /* The step again, then enough steps for two more compactions */
+        expect[key_of(stop)] = before;
+        CHECK_EQ(run(stop, stop + run_steps), stop + run_steps);
+        CHECK_EQ(FLASHKV_Init(base(), SECTORS), SUCCESS);
+        ok = 1;
+        for (key = 0; key < KEYS; key++) {
+            ok &= key_holds(key, expect[key]);
+        }
+        CHECK(ok);
+        if (!ok) {
+            printf("  cut at IAP call %u%s, step %u\n", (unsigned)(cut / 2), cut_half ? " halfway" : "", (unsigned)stop);
+        }
+    }
+
+    printf("test_flash_kv: values up to %u bytes, %u power cuts over %u IAP calls, %u left no sector erased\n",
+           (unsigned)MaxLength, (unsigned)cuts, (unsigned)calls, (unsigned)no_free);
+    CHECK(no_free > 0);
+}
+
+int main(void)
+{
+    test_limits();
+    test_wear();
+    test_power_loss(FLASHKV_MAX_VALUE, RUN);
+    test_power_loss(4, 3 * RUN);
+    CHECK_EQ(iap_errors, 0);
+
+    return host_report("test_flash_kv");
+}
@@ -0,0 +1,333 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_i2c.c
+ * @author  WIZnet
+ * @brief   GPIO I2C master of the GPIO_I2C example on the I2C bus model.
+ *
+ *          At 100 kHz, 400 kHz and 1 MHz on a 48 MHz core, transfers to a
+ *          register bank device must move the right bytes, keep the average
+ *          SCL frequency between 97% and 100% of the rate asked for, and
+ *          keep every SCL high and low time, START and STOP setup and hold
+ *          time and bus free time at or above the minimum of the I2C
+ *          specification, also when interrupts make the phases late. Two
+ *          buses must each keep their own pins and rate, and the
+ *          asynchronous engine must drive the bus it was given, with SCL
+ *          low for two ticks in Fast-mode.
+ *
+ *          The times are taken on the model's clock, where only the GPIO
+ *          and SysTick accesses cost cycles: they check the SysTick timing
+ *          of the phases, not how fast a Cortex-M0 runs the bit loops.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "i2c_model.h"
+#include "w7500x.h"
+#include "i2c.h"
+
+#include <string.h>
+
+#define DEV_ADDR        0x78
+#define DEV2_ADDR       0x50
+#define LENGTH          16
+
+/* Minimum times of the I2C specification, in ns */
+typedef struct
+{
+    uint32_t speed;
+    uint32_t high;
+    uint32_t low;
+    uint32_t hd_sta;
+    uint32_t su_sta;
+    uint32_t su_sto;
+    uint32_t buf;
+} i2c_spec;
+
+static const i2c_spec specs[] = {
+    { I2C_SPEED_STANDARD,  4000, 4700, 4000, 4700, 4000, 4700 },
+    { I2C_SPEED_FAST,       600, 1300,  600,  600,  600, 1300 },
+    { I2C_SPEED_FAST_PLUS,  260,  500,  260,  260,  260,  500 },
+};
+
+static uint8_t tx[LENGTH + 1];
+static uint8_t rx[LENGTH];
+static uint32_t callbacks;
+
+static uint32_t cycles(uint32_t ns)
+{
+    return (uint32_t)(((uint64_t)ns * host_system_clock + 999999999ULL) / 1000000000ULL);
+}
+
+static void setup(I2C_ConfigStruct* conf, PORT_Type port, uint16_t scl, uint16_t sda, uint32_t speed)
+{
+    memset(conf, 0, sizeof(*conf));
+    conf->scl_port = port;
+    conf->scl_pin = scl;
+    conf->sda_port = port;
+    conf->sda_pin = sda;
+    conf->speed = speed;
+}
+
+/* Writes LENGTH bytes from register Reg, reads them back after a repeated START */
+static void transfer(I2C_ConfigStruct* conf, i2c_model_bus* bus, uint8_t Reg, uint8_t Seed)
+{
+    uint32_t i;
+
+    tx[0] = Reg;
+    for (i = 0; i < LENGTH; i++) {
+        tx[i + 1] = (uint8_t)(Seed + i * 29);
+    }
+    memset(rx, 0, sizeof(rx));
+
+    CHECK_EQ(I2C_Write(conf, DEV_ADDR, tx, LENGTH + 1), 0);
+    CHECK(memcmp(&i2c_model_regs(bus)[Reg], &tx[1], LENGTH) == 0);
+    CHECK_EQ(I2C_WriteRepeated(conf, DEV_ADDR, tx, 1), 0);
+    CHECK_EQ(I2C_Read(conf, DEV_ADDR, rx, LENGTH), 0);
+    CHECK(memcmp(rx, &tx[1], LENGTH) == 0);
+}
+
+/* The times on the bus against the specification */
+static void check_timing(i2c_model_bus* bus, const i2c_spec* spec)
+{
+    const i2c_model_stats* st = i2c_model_stats_of(bus);
+
+    CHECK(st->periods > 0);
+    CHECK(st->min_high >= cycles(spec->high));
+    CHECK(st->min_low >= cycles(spec->low));
+    CHECK(st->min_hd_sta >= cycles(spec->hd_sta));
+    CHECK(st->min_su_sto >= cycles(spec->su_sto));
+    if (st->min_su_sta != 0xFFFFFFFFUL) {
+        CHECK(st->min_su_sta >= cycles(spec->su_sta));
+    }
+    if (st->min_buf != 0xFFFFFFFFUL) {
+        CHECK(st->min_buf >= cycles(spec->buf));
+    }
+}
+
+/* Average SCL rate, which must be within 3% under the rate asked for */
+static uint32_t check_rate(i2c_model_bus* bus, const i2c_spec* spec)
+{
+    const i2c_model_stats* st = i2c_model_stats_of(bus);
+    uint32_t rate = (uint32_t)(((uint64_t)host_system_clock * st->periods) / st->period_sum);
+
+    CHECK(rate <= spec->speed);
+    CHECK(rate >= spec->speed / 100 * 97);
+    return rate;
+}
+
+static void test_rates(void)
+{
+    I2C_ConfigStruct conf;
+    i2c_model_bus* bus;
+    const i2c_model_stats* st;
+    uint32_t i, rate;
+
+    for (i = 0; i < sizeof(specs) / sizeof(specs[0]); i++) {
+        i2c_model_init();
+        bus = i2c_model_attach(GPIOA_BASE, GPIO_Pin_9, GPIOA_BASE, GPIO_Pin_10, DEV_ADDR);
+        setup(&conf, PORT_PA, GPIO_Pin_9, GPIO_Pin_10, specs[i].speed);
+        CHECK_EQ(I2C_Init(&conf), 0);
+        i2c_model_clear(bus);
+
+        transfer(&conf, bus, 0x10, (uint8_t)i);
+        st = i2c_model_stats_of(bus);
+        CHECK_EQ(st->starts, 3);
+        CHECK_EQ(st->stops, 2);
+        CHECK_EQ(st->writes, LENGTH);
+        CHECK_EQ(st->reads, LENGTH);
+        /* Bytes of 9 clocks, one more for the repeated START and each STOP */
+        CHECK_EQ(st->clocks, 9 * (2 + LENGTH) + 9 * 2 + 9 * (1 + LENGTH) + 3);
+
+        check_timing(bus, &specs[i]);
+        rate = check_rate(bus, &specs[i]);
+        printf("test_i2c: %7u Hz asked, SCL %7u Hz, period %u to %u cycles, high %u low %u (min %u %u)\n",
+               (unsigned)specs[i].speed, (unsigned)rate, (unsigned)st->min_period, (unsigned)st->max_period,
+               (unsigned)st->min_high, (unsigned)st->min_low, (unsigned)cycles(specs[i].high),
+               (unsigned)cycles(specs[i].low));
+
+        /* Nobody at the address: NACK, then a STOP */
+        i2c_model_clear(bus);
+        CHECK_EQ(I2C_Write(&conf, 0x22, tx, 2), -1);
+        CHECK_EQ(st->stops, 1);
+        CHECK_EQ(st->writes, 0);
+    }
+}
+
+/* Interrupts of every length up to two SCL periods: no phase gets shorter
+   than the minimum, the SCL rate drops */
+static void test_late_phases(void)
+{
+    I2C_ConfigStruct conf;
+    i2c_model_bus* bus;
+    uint32_t i, stall, period;
+
+    for (i = 0; i < sizeof(specs) / sizeof(specs[0]); i++) {
+        i2c_model_init();
+        bus = i2c_model_attach(GPIOA_BASE, GPIO_Pin_9, GPIOA_BASE, GPIO_Pin_10, DEV_ADDR);
+        setup(&conf, PORT_PA, GPIO_Pin_9, GPIO_Pin_10, specs[i].speed);
+        CHECK_EQ(I2C_Init(&conf), 0);
+        period = host_system_clock / specs[i].speed;
+
+        for (stall = 1; stall <= 2 * period; stall += 1 + stall / 8) {
+            i2c_model_clear(bus);
+            i2c_model_stall_every = 7 + stall % 5;
+            i2c_model_stall_cycles = stall;
+            transfer(&conf, bus, (uint8_t)(stall % (256 - LENGTH)), (uint8_t)(stall * 3));
+            check_timing(bus, &specs[i]);
+        }
+    }
+}
+
+/* Two buses, each initialised before the other is used */
+static void test_two_buses(void)
+{
+    I2C_ConfigStruct conf_a, conf_c;
+    i2c_model_bus* bus_a;
+    i2c_model_bus* bus_c;
+    const i2c_model_stats* st_a;
+    const i2c_model_stats* st_c;
+
+    i2c_model_init();
+    bus_a = i2c_model_attach(GPIOA_BASE, GPIO_Pin_9, GPIOA_BASE, GPIO_Pin_10, DEV_ADDR);
+    bus_c = i2c_model_attach(GPIOC_BASE, GPIO_Pin_4, GPIOC_BASE, GPIO_Pin_5, DEV_ADDR);
+    setup(&conf_a, PORT_PA, GPIO_Pin_9, GPIO_Pin_10, I2C_SPEED_STANDARD);
+    setup(&conf_c, PORT_PC, GPIO_Pin_4, GPIO_Pin_5, I2C_SPEED_FAST_PLUS);
+    CHECK_EQ(I2C_Init(&conf_a), 0);
+    CHECK_EQ(I2C_Init(&conf_c), 0);
+    i2c_model_clear(bus_a);
+    i2c_model_clear(bus_c);
+    st_a = i2c_model_stats_of(bus_a);
+    st_c = i2c_model_stats_of(bus_c);
+
+    transfer(&conf_a, bus_a, 0x00, 0x11);
+    CHECK_EQ(st_a->writes, LENGTH);
+    CHECK_EQ(st_c->clocks, 0);
+    check_timing(bus_a, &specs[0]);
+    check_rate(bus_a, &specs[0]);
+
+    transfer(&conf_c, bus_c, 0x80, 0x22);
+    CHECK_EQ(st_c->writes, LENGTH);
+    CHECK_EQ(st_a->writes, LENGTH);
+    check_timing(bus_c, &specs[2]);
+    check_rate(bus_c, &specs[2]);
+}
+
+/* SysTick already running for the application, or unusable */
+static void test_systick(void)
+{
+    I2C_ConfigStruct conf;
+    i2c_model_bus* bus;
+    uint32_t i;
+
+    i2c_model_init();
+    bus = i2c_model_attach(GPIOA_BASE, GPIO_Pin_9, GPIOA_BASE, GPIO_Pin_10, DEV_ADDR);
+
+    setup(&conf, PORT_PA, GPIO_Pin_9, GPIO_Pin_10, 2000000);
+    CHECK_EQ(I2C_Init(&conf), 1);
+
+    /* Reloads shorter than an SCL period */
+    SysTick_Config(host_system_clock / 200000);
+    setup(&conf, PORT_PA, GPIO_Pin_9, GPIO_Pin_10, I2C_SPEED_STANDARD);
+    CHECK_EQ(I2C_Init(&conf), 1);
+
+    /* Not on the core clock */
+    SysTick->CTRL = SysTick_CTRL_ENABLE_Msk;
+    CHECK_EQ(I2C_Init(&conf), 1);
+
+    /* The 1 ms tick: the transfers take several reloads */
+    SysTick_Config(host_system_clock / 1000);
+    CHECK_EQ(I2C_Init(&conf), 0);
+    i2c_model_clear(bus);
+    for (i = 0; i < 4; i++) {
+        transfer(&conf, bus, (uint8_t)(i * 32), (uint8_t)i);
+    }
+    CHECK(i2c_model_now() > 4 * host_system_clock / 1000);
+    check_timing(bus, &specs[0]);
+    check_rate(bus, &specs[0]);
+}
+
+static void done(I2C_Transaction* t)
+{
+    (void)t;
+    callbacks++;
+}
+
+/* The asynchronous engine drives the bus given to I2C_AsyncInit(). At
+   400 kHz it ticks at 1.2 MHz: tHIGH is one tick, 0.83 us, and tLOW two,
+   1.67 us, above the 1.3 us minimum */
+static void test_async(void)
+{
+    I2C_ConfigStruct conf_a, conf_c;
+    i2c_model_bus* bus_a;
+    i2c_model_bus* bus_c;
+    I2C_Segment seg[2];
+    I2C_Transaction t;
+    uint8_t reg = 0x40;
+    uint32_t ticks = 0;
+    uint32_t low = 0, high = 0;
+    uint32_t min_low = 0xFFFFFFFF, min_high = 0xFFFFFFFF;
+
+    i2c_model_init();
+    bus_a = i2c_model_attach(GPIOA_BASE, GPIO_Pin_9, GPIOA_BASE, GPIO_Pin_10, DEV_ADDR);
+    bus_c = i2c_model_attach(GPIOC_BASE, GPIO_Pin_4, GPIOC_BASE, GPIO_Pin_5, DEV2_ADDR);
+    setup(&conf_a, PORT_PA, GPIO_Pin_9, GPIO_Pin_10, I2C_SPEED_STANDARD);
+    setup(&conf_c, PORT_PC, GPIO_Pin_4, GPIO_Pin_5, I2C_SPEED_FAST);
+    CHECK_EQ(I2C_Init(&conf_c), 0);
+    CHECK_EQ(I2C_Init(&conf_a), 0);
+    i2c_model_clear(bus_a);
+    i2c_model_clear(bus_c);
+    memcpy(&i2c_model_regs(bus_c)[reg], "\x12\x34\x56\x78", 4);
+
+    I2C_AsyncInit(&conf_c, NULL);
+    seg[0].addr = DEV2_ADDR;
+    seg[0].read = 0;
+    seg[0].data = &reg;
+    seg[0].len = 1;
+    seg[1].addr = DEV2_ADDR;
+    seg[1].read = 1;
+    seg[1].data = rx;
+    seg[1].len = 4;
+    t.seg = seg;
+    t.count = 2;
+    t.callback = done;
+    t.arg = NULL;
+    callbacks = 0;
+
+    I2C_AsyncSubmit(&t);
+    while ((t.status == I2C_ASYNC_PENDING) && (ticks < 1000)) {
+        I2C_AsyncTick();
+        ticks++;
+        if (i2c_model_scl(bus_c) == 0) {
+            if ((high != 0) && (high < min_high)) {
+                min_high = high;
+            }
+            high = 0;
+            low++;
+        } else {
+            if ((low != 0) && (low < min_low)) {
+                min_low = low;
+            }
+            low = 0;
+            high++;
+        }
+    }
+    CHECK_EQ(t.status, I2C_ASYNC_DONE);
+    CHECK_EQ(min_low, 2);
+    CHECK_EQ(min_high, 1);
+    CHECK_EQ(callbacks, 1);
+    CHECK(memcmp(rx, "\x12\x34\x56\x78", 4) == 0);
+    CHECK_EQ(i2c_model_stats_of(bus_c)->starts, 2);
+    CHECK_EQ(i2c_model_stats_of(bus_c)->reads, 4);
+    CHECK_EQ(i2c_model_stats_of(bus_a)->clocks, 0);
+}
+
+int main(void)
+{
+    test_rates();
+    test_late_phases();
+    test_two_buses();
+    test_systick();
+    test_async();
+
+    return host_report("test_i2c");
+}
@@ -0,0 +1,274 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_i2c_slave.c
+ * @author  WIZnet
+ * @brief   GPIO I2C slave of the example, against bus traces replayed on the
+ *          bus model: the trace sets the master's pulls on SCL and SDA one
+ *          line change at a time, and I2C_SlaveIRQHandler() is called while
+ *          the level its EXTI entries are armed for is on a line.
+ *
+ *          A trace is a string of tokens. S is a START (a repeated START
+ *          inside a transaction), P a STOP, two hex digits a byte written by
+ *          the master, R and N a byte read with ACK and with NACK. =digits
+ *          are raw samples, scl * 2 + sda, a '.' after a sample holds the
+ *          interrupt back until the next change, like a latency longer than
+ *          the sample. The replay returns the ACK (A) or NACK (N) of each
+ *          byte written and the value of each byte read.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "i2c_model.h"
+#include "i2c_slave.h"
+#include "w7500x.h"
+
+#include <string.h>
+
+#define SLAVE           0x78
+#define READ_ONLY       0xF0    /* Writes from here are refused */
+
+static I2C_ConfigStruct conf;
+static i2c_model_bus* bus;
+static uint8_t regs[256];
+static uint32_t writes, reads, stops;
+static uint32_t held;           /* Callbacks that ran with the slave holding SCL low */
+static char result[256];
+
+static void count_hold(void)
+{
+    held += ((GPIOA->OUTENSET & GPIO_Pin_9) != 0) && (i2c_model_scl(bus) == 0);
+}
+
+static uint8_t map_read(uint8_t reg)
+{
+    count_hold();
+    reads++;
+    return regs[reg];
+}
+
+static ACK_TypeDef map_write(uint8_t reg, uint8_t value)
+{
+    count_hold();
+    if (reg >= READ_ONLY) {
+        return NACK;
+    }
+    regs[reg] = value;
+    writes++;
+    return ACK;
+}
+
+static void map_stop(void)
+{
+    stops++;
+}
+
+static const I2C_SlaveMap map = { map_read, map_write, map_stop };
+
+/* Whether an EXTI entry armed by the slave sees its level on the line */
+static int pending(uint32_t Reg, int Level)
+{
+    return ((Reg & EXTI_EXTINT_IEN) != 0) && (Level == (((Reg & EXTI_EXTINT_POL) != 0) ? 0 : 1));
+}
+
+/* The interrupt, taken until no armed level is left */
+static void serve(void)
+{
+    int calls;
+
+    for (calls = 0; calls < 4; calls++) {
+        if (((host_nvic_enabled & (1UL << EXTI_IRQn)) == 0) ||
+            (!pending(EXTI_PA->REGISTER[9], i2c_model_scl(bus)) && !pending(EXTI_PA->REGISTER[10], i2c_model_sda(bus)))) {
+            return;
+        }
+        I2C_SlaveIRQHandler();
+    }
+    CHECK(calls < 4);
+}
+
+/* One line change of the master, then the interrupt unless held back */
+static void sample(int Scl, int Sda, int Serve)
+{
+    i2c_model_pull(bus, Scl, Sda);
+    if (Serve) {
+        serve();
+    }
+}
+
+/* One SCL pulse with the master's SDA at Bit, returns the level of SDA
+   while SCL is high */
+static int clock_bit(int Bit)
+{
+    int sda;
+
+    sample(0, Bit, 1);
+    sample(1, Bit, 1);
+    sda = i2c_model_sda(bus);
+    sample(0, Bit, 1);
+    return sda;
+}
+
+static void append(const char* Text)
+{
+    if (result[0] != 0) {
+        strcat(result, " ");
+    }
+    strcat(result, Text);
+}
+
+static const char* replay(const char* Trace)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    const char* p = Trace;
+    char text[3];
+    uint8_t byte;
+    int i;
+
+    result[0] = 0;
+    while (*p != 0) {
+        if (*p == ' ') {
+            p++;
+        } else if (*p == 'S') {
+            /* SDA released with SCL low, SCL up, SDA down, SCL down */
+            sample(i2c_model_scl(bus) ? 1 : 0, 1, 1);
+            sample(1, 1, 1);
+            sample(1, 0, 1);
+            sample(0, 0, 1);
+            p++;
+        } else if (*p == 'P') {
+            sample(0, 0, 1);
+            sample(1, 0, 1);
+            sample(1, 1, 1);
+            p++;
+        } else if ((*p == 'R') || (*p == 'N')) {
+            byte = 0;
+            for (i = 0; i < 8; i++) {
+                byte = (uint8_t)((byte << 1) | clock_bit(1));
+            }
+            clock_bit(*p == 'N');
+            text[0] = hex[byte >> 4];
+            text[1] = hex[byte & 15];
+            text[2] = 0;
+            append(text);
+            p++;
+        } else if (*p == '=') {
+            for (p++; (*p >= '0') && (*p <= '3'); p++) {
+                sample((*p >> 1) & 1, *p & 1, p[1] != '.');
+                if (p[1] == '.') {
+                    p++;
+                }
+            }
+        } else {
+            byte = (uint8_t)(((strchr(hex, p[0]) - hex) << 4) | (strchr(hex, p[1]) - hex));
+            for (i = 7; i >= 0; i--) {
+                clock_bit((byte >> i) & 1);
+            }
+            append(clock_bit(1) ? "N" : "A");
+            p += 2;
+        }
+    }
+    return result;
+}
+
+/* The slave on PA9/PA10 and a bus with no other device, both lines idle */
+static void power_on(void)
+{
+    i2c_model_init();
+    bus = i2c_model_attach(GPIOA_BASE, GPIO_Pin_9, GPIOA_BASE, GPIO_Pin_10, 0);
+    host_nvic_enabled = 0;
+    memset(&conf, 0, sizeof(conf));
+    conf.scl_port = PORT_PA;
+    conf.scl_pin = GPIO_Pin_9;
+    conf.sda_port = PORT_PA;
+    conf.sda_pin = GPIO_Pin_10;
+    CHECK_EQ(I2C_SlaveInit(&conf, SLAVE, &map), 0);
+    writes = reads = stops = held = 0;
+}
+
+static void check_released(void)
+{
+    CHECK_EQ(i2c_model_scl(bus), 1);
+    CHECK_EQ(i2c_model_sda(bus), 1);
+}
+
+static void test_write(void)
+{
+    power_on();
+    CHECK(strcmp(replay("S 78 10 A5 5A P"), "A A A A") == 0);
+    CHECK_EQ(regs[0x10], 0xA5);
+    CHECK_EQ(regs[0x11], 0x5A);
+    CHECK_EQ(writes, 2);
+    CHECK_EQ(stops, 1);
+    CHECK_EQ(held, 2);
+    check_released();
+}
+
+/* The register pointer is kept across the repeated START */
+static void test_read(void)
+{
+    power_on();
+    regs[0x20] = 0x12;
+    regs[0x21] = 0x34;
+    regs[0x22] = 0x56;
+    CHECK(strcmp(replay("S 78 20 S 79 R R N P"), "A A A 12 34 56") == 0);
+    CHECK_EQ(reads, 3);
+    CHECK_EQ(held, 3);
+    CHECK_EQ(stops, 1);
+    check_released();
+
+    /* Two transactions in a row, the second starts at the first register */
+    CHECK(strcmp(replay("S 78 30 01 02 P S 78 30 S 79 R N P"), "A A A A A A A 01 02") == 0);
+    CHECK_EQ(stops, 3);
+    check_released();
+}
+
+/* Other addresses and refused bytes get a NACK, and nothing else */
+static void test_nack(void)
+{
+    power_on();
+    CHECK(strcmp(replay("S 50 10 A5 P"), "N N N") == 0);
+    CHECK(strcmp(replay("S 51 N P"), "N FF") == 0);
+    CHECK_EQ(writes + reads + stops, 0);
+    check_released();
+
+    CHECK(strcmp(replay("S 78 EF 11 22 33 P"), "A A A N N") == 0);
+    CHECK_EQ(regs[0xEF], 0x11);
+    CHECK_EQ(writes, 1);
+    CHECK_EQ(stops, 1);
+    check_released();
+}
+
+/* Events shorter than the interrupt latency are missed */
+static void test_latency(void)
+{
+    power_on();
+
+    /* START: SCL falls before the handler sees SDA low */
+    CHECK(strcmp(replay("=32.0 78 10 P"), "N N") == 0);
+    CHECK(strcmp(replay("=320 78 10 P"), "A A") == 0);
+    CHECK_EQ(stops, 1);
+
+    /* STOP: SDA rises before the handler sees SCL high, a data bit for the slave */
+    CHECK(strcmp(replay("S 78 10 44 =02.3"), "A A A") == 0);
+    CHECK_EQ(stops, 1);
+    CHECK(strcmp(replay("=1 P"), "") == 0);
+    CHECK_EQ(stops, 2);
+
+    /* A pulse of SCL: the slave loses the bit and ACKs one bit late */
+    CHECK(strcmp(replay("S 78 =0202.020202020202 =13"), "A") == 0);
+    CHECK_EQ(i2c_model_sda(bus), 1);
+    CHECK(strcmp(replay("=1 =3"), "") == 0);
+    CHECK_EQ(i2c_model_sda(bus), 0);
+    CHECK(strcmp(replay("=1 P"), "") == 0);
+    CHECK_EQ(writes, 1);
+    check_released();
+}
+
+int main(void)
+{
+    test_write();
+    test_read();
+    test_nack();
+    test_latency();
+
+    return host_report("test_i2c_slave");
+}
@@ -0,0 +1,203 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_modbus.c
+ * @author  WIZnet
+ * @brief   Modbus RTU over UART0 wired to a pseudo terminal: the test writes
+ *          and reads the frames on the pty like a Modbus tool on a serial
+ *          port would, while the UART model clocks them in at 9600 and
+ *          115200 bit/s. Frames of odd length and frames just over 3.5
+ *          characters apart must be delimited as they were sent.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "uart_model.h"
+#include "w7500x.h"
+#include "w7500x_uart_buf.h"
+#include "modbus.h"
+
+#include <string.h>
+
+#define SLAVE_ID        17
+#define CHAR_BITS       11
+
+static uint8_t tx_ring[MODBUS_MAX_ADU + 64];
+static uint8_t rx_ring[MODBUS_MAX_ADU + 64];
+static uint16_t regs[32];
+static uint8_t reply[MODBUS_MAX_ADU];
+static uint32_t reply_len;
+static uint8_t done_pdu[MODBUS_MAX_PDU];
+static int32_t done_len;
+
+static uint8_t read_reg(uint8_t fc, uint16_t addr, uint16_t* value)
+{
+    (void)fc;
+    if (addr >= 32) {
+        return MODBUS_EX_ILLEGAL_ADDRESS;
+    }
+    *value = regs[addr];
+    return 0;
+}
+
+static uint8_t write_reg(uint16_t addr, uint16_t value)
+{
+    if (addr >= 32) {
+        return MODBUS_EX_ILLEGAL_ADDRESS;
+    }
+    regs[addr] = value;
+    return 0;
+}
+
+static const wiz_ModbusMap map = { NULL, read_reg, NULL, write_reg };
+
+static void request_done(void* arg, const uint8_t* pdu, uint16_t len)
+{
+    (void)arg;
+    done_len = len;
+    if (pdu != NULL) {
+        memcpy(done_pdu, pdu, len);
+    }
+}
+
+/* One MODBUS_TICK_US: the line, the UART interrupt, the timer, the main loop */
+static void run_us(uint32_t us)
+{
+    uint32_t t;
+
+    for (t = 0; t < us; t += MODBUS_TICK_US) {
+        if (uart_model_advance(MODBUS_TICK_US)) {
+            UARTPORT_IRQHandler(UARTPORT_0);
+        }
+        modbus_time_handler();
+        modbus_run();
+        reply_len += uart_model_peer_read(reply + reply_len, sizeof(reply) - reply_len);
+    }
+}
+
+/* Writes unit, PDU and CRC on the line, returns the ADU length */
+static uint16_t peer_send(uint8_t unit, const uint8_t* pdu, uint16_t len)
+{
+    static uint8_t adu[MODBUS_MAX_ADU];
+    uint16_t crc;
+
+    adu[0] = unit;
+    memcpy(&adu[1], pdu, len);
+    crc = modbus_crc16(adu, len + 1);
+    adu[len + 1] = crc & 0xFF;
+    adu[len + 2] = crc >> 8;
+    uart_model_peer_write(adu, len + 3);
+    return len + 3;
+}
+
+static uint32_t char_us(uint32_t baud)
+{
+    return (CHAR_BITS * 1000000 + baud - 1) / baud;
+}
+
+/* Half a character more than the silence that ends a frame: 4 characters up to
+   19200 bit/s, 1750us + half a character above */
+static uint32_t gap_us(uint32_t baud)
+{
+    return ((baud > 19200) ? 1750 : (38500000 + baud - 1) / baud) + char_us(baud) / 2;
+}
+
+static void start(uint32_t baud, uint8_t slave_id)
+{
+    uart_model_close();
+    CHECK_EQ(uart_model_init(UART0_BASE, baud, CHAR_BITS), 0);
+    modbus_set_map(&map);
+    CHECK_EQ(modbus_rtu_init(UARTPORT_0, baud, slave_id, tx_ring, sizeof(tx_ring), rx_ring, sizeof(rx_ring)), SOCK_OK);
+    reply_len = 0;
+    run_us(10000);
+}
+
+static void test_crc(void)
+{
+    static const uint8_t req[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x0A };
+
+    /* Reference frame 01 03 00 00 00 0A C5 CD */
+    CHECK_EQ(modbus_crc16(req, sizeof(req)), 0xCDC5);
+}
+
+static void test_slave(uint32_t baud)
+{
+    /* Write Multiple Registers, one register: 11 bytes on the line */
+    static const uint8_t write1[] = { 0x10, 0x00, 0x05, 0x00, 0x01, 0x02, 0x12, 0x34 };
+    static const uint8_t write1_other[] = { 0x10, 0x00, 0x06, 0x00, 0x01, 0x02, 0x56, 0x78 };
+    static const uint8_t read2[] = { 0x03, 0x00, 0x05, 0x00, 0x02 };
+    uint16_t len;
+
+    start(baud, SLAVE_ID);
+    memset(regs, 0, sizeof(regs));
+
+    /* Odd length: the last byte must not wait behind a FIFO trigger level */
+    len = peer_send(SLAVE_ID, write1, sizeof(write1));
+    run_us(len * char_us(baud) + 20000);
+    CHECK_EQ(regs[5], 0x1234);
+    CHECK_EQ(reply_len, 8);
+    CHECK(memcmp(reply, "\x11\x10\x00\x05\x00\x01", 6) == 0);
+    CHECK_EQ(modbus_crc16(reply, reply_len), 0);
+
+    /* A frame for another slave, just over 3.5 characters of silence, one for
+       this slave: two frames, the first ignored, the second answered */
+    reply_len = 0;
+    len = peer_send(SLAVE_ID + 1, write1_other, sizeof(write1_other));
+    run_us(len * char_us(baud) + gap_us(baud));
+    regs[6] = 0x4321;
+    len = peer_send(SLAVE_ID, read2, sizeof(read2));
+    run_us(len * char_us(baud) + 20000);
+    CHECK_EQ(regs[6], 0x4321);
+    CHECK_EQ(reply_len, 9);
+    CHECK(memcmp(reply, "\x11\x03\x04\x12\x34\x43\x21", 7) == 0);
+    CHECK_EQ(modbus_crc16(reply, reply_len), 0);
+}
+
+static void test_master(uint32_t baud)
+{
+    static const uint8_t read1[] = { 0x03, 0x00, 0x02, 0x00, 0x01 };
+    static const uint8_t answer[] = { 0x03, 0x02, 0xBE, 0xEF };
+
+    start(baud, 0);
+
+    /* The request goes out on the line */
+    done_len = -1;
+    CHECK_EQ(modbus_request(SLAVE_ID, read1, sizeof(read1), request_done, NULL), 0);
+    run_us(20000);
+    CHECK_EQ(reply_len, 8);
+    CHECK_EQ(reply[0], SLAVE_ID);
+    CHECK(memcmp(&reply[1], read1, sizeof(read1)) == 0);
+    CHECK_EQ(modbus_crc16(reply, reply_len), 0);
+
+    /* A 7 byte response ends with an odd byte */
+    peer_send(SLAVE_ID, answer, sizeof(answer));
+    run_us(7 * char_us(baud) + 20000);
+    CHECK_EQ(done_len, sizeof(answer));
+    CHECK(memcmp(done_pdu, answer, sizeof(answer)) == 0);
+
+    /* No response at all: the gateway target exception after the timeout */
+    reply_len = 0;
+    done_len = -1;
+    CHECK_EQ(modbus_request(SLAVE_ID, read1, sizeof(read1), request_done, NULL), 0);
+    run_us(MODBUS_RESPONSE_TIMEOUT_MS * 1000 / 2);
+    CHECK_EQ(done_len, -1);
+    run_us(MODBUS_RESPONSE_TIMEOUT_MS * 1000 / 2 + 20000);
+    CHECK_EQ(done_len, 2);
+    CHECK_EQ(done_pdu[0], 0x83);
+    CHECK_EQ(done_pdu[1], MODBUS_EX_GATEWAY_TARGET);
+    CHECK_EQ(uart_model_overruns, 0);
+}
+
+int main(void)
+{
+    CHECK_EQ(uart_model_init(UART0_BASE, 9600, CHAR_BITS), 0);
+    printf("test_modbus: UART0 on %s\n", uart_model_pty());
+
+    test_crc();
+    test_slave(9600);
+    test_slave(115200);
+    test_master(9600);
+    test_master(115200);
+    uart_model_close();
+
+    return host_report("test_modbus");
+}
@@ -0,0 +1,315 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_spi_nor.c
+ * @author  WIZnet
+ * @brief   SPI NOR driver on SPIBUS, against the file-backed flash model on
+ *          SSP0 with its chip select on PA5. The SSP interrupt is taken from
+ *          the harness timer while the driver waits.
+ *
+ *          SPINOR_Init() must return ERROR, and return at once, with an
+ *          empty socket (MISO pulled up, the status reads busy), wait for a
+ *          flash busy from before the reset, and give up after
+ *          SPINOR_INIT_POLLS status reads on a flash that stays busy, whether
+ *          it answers the ID read while busy or not. Reads,
+ *          programs and erases must match the flash array, through the
+ *          cache and after a power cycle.
+ *
+ *          The SCK divisors must follow the SSPCLK source and prescaler, and
+ *          SPIBUS_DeInit() must end the running and queued transfers with
+ *          SPIBUS_Status_Aborted.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "nor_model.h"
+#include "ssp_model.h"
+#include "w7500x.h"
+#include "w7500x_spi_nor.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FLASH_SIZE      0x20000
+#define RDSR            0x05
+
+static SPIBUS_DeviceTypeDef dev;
+static SPINOR_HandleTypeDef nor;
+static char path[] = "/tmp/test_spi_nor.XXXXXX";
+static uint8_t buf[1024];
+static uint8_t pattern[1024];
+static uint32_t callbacks;
+static uint32_t aborted;
+
+static void ssp_irq(void)
+{
+    if (ssp_model_irq()) {
+        SPIBUS_IRQHandler(SSP0);
+    }
+}
+
+static void done(SPINOR_HandleTypeDef* Handle)
+{
+    (void)Handle;
+    callbacks++;
+}
+
+static void abandon(SPIBUS_TransferTypeDef* Transfer)
+{
+    aborted += (Transfer->Status == SPIBUS_Status_Aborted);
+}
+
+/* Power on: the flash model, the bus and the device, SSPCLK = MCLK */
+static void power_on(const char* file)
+{
+    SPIBUS_DeviceInitTypeDef init;
+
+    CHECK_EQ(nor_model_init(SSP0_BASE, GPIOA_BASE, GPIO_Pin_5, file, FLASH_SIZE), 0);
+    CRG->SSPCLK_SSR = CRG_SSPCLK_SSR_SSPCSS_0;
+    CRG->SSPCLK_PVSR = 0;
+    SPIBUS_Init(SSP0);
+    SPIBUS_DeviceStructInit(&init);
+    init.SPIBUS_ClockSpeed = 12000000;
+    /* Mode 3: the mode 0 constants are ~ of a long, which does not compare
+       equal once stored in a uint32_t on a 64-bit host */
+    init.SPIBUS_CPOL = SSP_CPOL_High;
+    init.SPIBUS_CPHA = SSP_CPHA_2Edge;
+    CHECK_EQ(SPIBUS_DeviceInit(&dev, SSP0, &init), SUCCESS);
+}
+
+static void test_absent(void)
+{
+    uint64_t start;
+
+    power_on(NULL);
+    start = host_nanotime();
+    CHECK_EQ(SPINOR_Init(&nor, &dev), ERROR);
+    CHECK(host_nanotime() - start < 1000000000ULL);
+    CHECK_EQ(nor.ManufacturerID, 0xFF);
+    CHECK_EQ(nor.Size, 0);
+    CHECK_EQ(SPINOR_GetBusy(&nor), RESET);
+    CHECK_EQ(SPINOR_Read(&nor, 0, buf, 1), ERROR);
+}
+
+static void test_busy_at_reset(void)
+{
+    power_on(path);
+    nor_model_busy = 50;
+    CHECK_EQ(SPINOR_Init(&nor, &dev), SUCCESS);
+    CHECK_EQ(nor_model_busy, 0);
+    CHECK_EQ(nor.ManufacturerID, 0xEF);
+    CHECK_EQ(nor.DeviceID, 0x4011);
+    CHECK_EQ(nor.Size, FLASH_SIZE);
+    CHECK_EQ(SPINOR_GetBusy(&nor), RESET);
+
+    /* Stays busy: ERROR after the bounded wait */
+    power_on(path);
+    nor_model_busy = NOR_MODEL_STUCK;
+    CHECK_EQ(SPINOR_Init(&nor, &dev), ERROR);
+    CHECK_EQ(nor_model_status_reads, SPINOR_INIT_POLLS);
+    CHECK_EQ(nor.Size, 0);
+    CHECK_EQ(SPINOR_GetBusy(&nor), RESET);
+
+    /* Answers the ID read while busy: the same waits */
+    power_on(path);
+    nor_model_busy = 50;
+    nor_model_busy_id = 1;
+    CHECK_EQ(SPINOR_Init(&nor, &dev), SUCCESS);
+    CHECK_EQ(nor_model_busy, 0);
+    CHECK_EQ(nor.Size, FLASH_SIZE);
+
+    power_on(path);
+    nor_model_busy = NOR_MODEL_STUCK;
+    nor_model_busy_id = 1;
+    CHECK_EQ(SPINOR_Init(&nor, &dev), ERROR);
+    CHECK_EQ(nor_model_status_reads, SPINOR_INIT_POLLS);
+    CHECK_EQ(nor.ManufacturerID, 0xEF);
+    CHECK_EQ(nor.Size, 0);
+    CHECK_EQ(SPINOR_GetBusy(&nor), RESET);
+}
+
+static void test_read_write(void)
+{
+    const uint8_t* flash;
+    uint32_t i, misses;
+
+    power_on(path);
+    CHECK_EQ(SPINOR_Init(&nor, &dev), SUCCESS);
+    flash = nor_model_data();
+
+    CHECK_EQ(SPINOR_Erase(&nor, 0x1000, SPINOR_Erase_4KB), SUCCESS);
+    CHECK_EQ(SPINOR_Erase(&nor, 0x1234, SPINOR_Erase_4KB), ERROR);
+    CHECK_EQ(nor_model_erases, 1);
+
+    /* Across three pages, the last one partly */
+    CHECK_EQ(SPINOR_Program(&nor, 0x10F0, pattern, 600), SUCCESS);
+    CHECK_EQ(SPINOR_GetBusy(&nor), SET);
+    CHECK_EQ(SPINOR_Read(&nor, 0x10F0, buf, 600), SUCCESS);
+    CHECK_EQ(SPINOR_GetBusy(&nor), RESET);
+    CHECK(memcmp(buf, pattern, 600) == 0);
+    CHECK(memcmp(&flash[0x10F0], pattern, 600) == 0);
+    CHECK_EQ(nor_model_programs, 4);
+    CHECK_EQ(flash[0x10EF], 0xFF);
+    CHECK_EQ(flash[0x10F0 + 600], 0xFF);
+
+    /* Small reads of one page: one miss, then hits */
+    misses = nor.CacheMisses;
+    for (i = 0; i < 16; i++) {
+        CHECK_EQ(SPINOR_Read(&nor, 0x1200 + i * 4, buf, 4), SUCCESS);
+        CHECK(memcmp(buf, &flash[0x1200 + i * 4], 4) == 0);
+    }
+    CHECK_EQ(nor.CacheMisses, misses + 1);
+    CHECK(nor.CacheHits >= 15);
+
+    /* The cached page follows programs and erases */
+    buf[0] = 0x0F;
+    CHECK_EQ(SPINOR_Program(&nor, 0x1200, buf, 1), SUCCESS);
+    CHECK_EQ(SPINOR_Read(&nor, 0x1200, buf, 1), SUCCESS);
+    CHECK_EQ(buf[0], pattern[0x1200 - 0x10F0] & 0x0F);
+    CHECK_EQ(buf[0], flash[0x1200]);
+    CHECK_EQ(SPINOR_Erase(&nor, 0x1000, SPINOR_Erase_4KB), SUCCESS);
+    CHECK_EQ(SPINOR_Read(&nor, 0x1200, buf, 2), SUCCESS);
+    CHECK_EQ(buf[0], 0xFF);
+    CHECK_EQ(buf[1], 0xFF);
+
+    CHECK_EQ(SPINOR_Read(&nor, FLASH_SIZE - 1, buf, 2), ERROR);
+    CHECK_EQ(SPINOR_Program(&nor, FLASH_SIZE, buf, 1), ERROR);
+    CHECK_EQ(nor_model_errors, 0);
+}
+
+static void test_async_erase(void)
+{
+    uint32_t ticks = 0;
+
+    power_on(path);
+    CHECK_EQ(SPINOR_Init(&nor, &dev), SUCCESS);
+    SPINOR_SetCallback(&nor, done);
+    callbacks = 0;
+
+    CHECK_EQ(SPINOR_EraseStart(&nor, 0x10000, SPINOR_Erase_64KB), SUCCESS);
+    CHECK_EQ(SPINOR_GetBusy(&nor), SET);
+    while ((SPINOR_GetBusy(&nor) == SET) && (ticks < 1000)) {
+        SPINOR_TimeHandler(&nor);
+        SPIBUS_Wait(&nor.Poll);
+        ticks++;
+    }
+    CHECK_EQ(SPINOR_GetBusy(&nor), RESET);
+    CHECK_EQ(callbacks, 1);
+    CHECK_EQ(ticks, nor_model_erase_polls + 1);
+
+    /* Kept for the power cycle */
+    CHECK_EQ(SPINOR_Program(&nor, 0x10000, pattern, 256), SUCCESS);
+    SPINOR_WaitReady(&nor);
+    CHECK_EQ(callbacks, 2);
+    CHECK_EQ(nor_model_errors, 0);
+}
+
+/* SCK = SSPCLK / (CPSDVSR * (1 + SCR)) at 1MHz */
+static void test_bus_clock(void)
+{
+    SPIBUS_DeviceInitTypeDef init;
+    SPIBUS_DeviceTypeDef slow;
+
+    power_on(NULL);
+    SPIBUS_DeviceStructInit(&init);
+    init.SPIBUS_CPOL = SSP_CPOL_High;
+    init.SPIBUS_CPHA = SSP_CPHA_2Edge;
+
+    /* MCLK, 48MHz */
+    CHECK_EQ(SPIBUS_DeviceInit(&slow, SSP0, &init), SUCCESS);
+    CHECK_EQ(slow.CPSR, 2);
+    CHECK_EQ((slow.CR0 >> 8) & 0xFF, 23);
+
+    /* RCLK, 8MHz, then divided by 2 */
+    CRG->SSPCLK_SSR = CRG_SSPCLK_SSR_SSPCSS_1;
+    CHECK_EQ(SPIBUS_DeviceInit(&slow, SSP0, &init), SUCCESS);
+    CHECK_EQ(slow.CPSR, 2);
+    CHECK_EQ((slow.CR0 >> 8) & 0xFF, 3);
+    CRG->SSPCLK_PVSR = 1;
+    CHECK_EQ(SPIBUS_DeviceInit(&slow, SSP0, &init), SUCCESS);
+    CHECK_EQ((slow.CR0 >> 8) & 0xFF, 1);
+
+    /* OCLK without OCLK_VALUE, and SSPCLK off */
+    CRG->SSPCLK_SSR = CRG_SSPCLK_SSR_SSPCSS;
+    CHECK_EQ(SPIBUS_DeviceInit(&slow, SSP0, &init), ERROR);
+    CRG->SSPCLK_SSR = 0;
+    CHECK_EQ(SPIBUS_DeviceInit(&slow, SSP0, &init), ERROR);
+}
+
+/* A running and a queued transfer, both ended by the bus stop */
+static void test_bus_stop(void)
+{
+    SPIBUS_TransferTypeDef first, second;
+    uint8_t cmd[64];
+    uint8_t status[2];
+
+    power_on(path);
+    memset(cmd, RDSR, sizeof(cmd));
+    first.Device = &dev;
+    first.TxBuffer = cmd;
+    first.RxBuffer = buf;
+    first.Length = sizeof(cmd);
+    first.Flags = 0;
+    first.Callback = abandon;
+    first.Context = 0;
+    second = first;
+    aborted = 0;
+
+    __disable_irq();
+    SPIBUS_Submit(&first);
+    SPIBUS_Submit(&second);
+    CHECK_EQ(first.Status, SPIBUS_Status_Busy);
+    CHECK_EQ(second.Status, SPIBUS_Status_Queued);
+    SPIBUS_DeInit(SSP0);
+    __enable_irq();
+
+    CHECK_EQ(aborted, 2);
+    CHECK_EQ(SPIBUS_Wait(&first), ERROR);
+    CHECK_EQ(SPIBUS_Wait(&second), ERROR);
+    CHECK_EQ(SPIBUS_GetStatus(SSP0), RESET);
+
+    /* The chip select was released, the next command starts afresh */
+    SPIBUS_Init(SSP0);
+    CHECK_EQ(SSP0->SR & SSP_SR_RNE, 0);
+    status[1] = 0xFF;
+    CHECK_EQ(SPIBUS_Transfer(&dev, cmd, status, 2, 0), SUCCESS);
+    CHECK_EQ(status[1], 0);
+}
+
+static void test_power_cycle(void)
+{
+    power_on(path);
+    CHECK_EQ(SPINOR_Init(&nor, &dev), SUCCESS);
+    CHECK_EQ(SPINOR_Read(&nor, 0x10000, buf, 256), SUCCESS);
+    CHECK(memcmp(buf, pattern, 256) == 0);
+    CHECK_EQ(SPINOR_Read(&nor, 0x10100, buf, 16), SUCCESS);
+    CHECK_EQ(buf[0], 0xFF);
+}
+
+int main(void)
+{
+    uint32_t i;
+    int fd;
+
+    for (i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)(i * 13 + 5);
+    }
+    fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+    host_irq_attach(ssp_irq, 20);
+
+    test_absent();
+    test_busy_at_reset();
+    test_read_write();
+    test_async_erase();
+    test_bus_clock();
+    test_bus_stop();
+    test_power_cycle();
+
+    host_irq_attach(NULL, 0);
+    nor_model_close();
+    unlink(path);
+
+    return host_report("test_spi_nor");
+}
@@ -0,0 +1,161 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_ssp.c
+ * @author  WIZnet
+ * @brief   SSP burst helpers against the polled SSP_SendData() /
+ *          SSP_GetFlagStatus(SSP_FLAG_RNE) / SSP_ReceiveData() loop, on the
+ *          cycle counted SSP model: received data, overruns, and the PCLK
+ *          cycles per frame and bus utilisation of each variant at SCK =
+ *          PCLK/2, /4 and /8.
+ *
+ *          The cycle counts come from the model, 6 cycles per register
+ *          access, not from a Cortex-M0: they show how far each loop keeps
+ *          the bus busy, the absolute figures are estimates.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "ssp_model.h"
+#include "w7500x.h"
+#include "w7500x_ssp.h"
+
+#include <string.h>
+
+#define FRAMES          512
+
+typedef void (*ssp_variant)(uint32_t Length);
+
+static uint8_t tx8[FRAMES];
+static uint8_t rx8[FRAMES];
+static uint16_t tx16[FRAMES];
+static uint16_t rx16[FRAMES];
+
+static void naive8(uint32_t Length)
+{
+    uint32_t i;
+
+    for (i = 0; i < Length; i++) {
+        SSP_SendData(SSP0, tx8[i]);
+        while (SSP_GetFlagStatus(SSP0, SSP_FLAG_RNE) == RESET) {
+        }
+        rx8[i] = (uint8_t)SSP_ReceiveData(SSP0);
+    }
+}
+
+static void naive16(uint32_t Length)
+{
+    uint32_t i;
+
+    for (i = 0; i < Length; i++) {
+        SSP_SendData(SSP0, tx16[i]);
+        while (SSP_GetFlagStatus(SSP0, SSP_FLAG_RNE) == RESET) {
+        }
+        rx16[i] = SSP_ReceiveData(SSP0);
+    }
+}
+
+static void burst8(uint32_t Length)
+{
+    SSP_TransmitReceive8(SSP0, tx8, rx8, Length);
+}
+
+static void burst16(uint32_t Length)
+{
+    SSP_TransmitReceive16(SSP0, tx16, rx16, Length);
+}
+
+static void write8(uint32_t Length)
+{
+    SSP_Transmit8(SSP0, tx8, Length);
+}
+
+static void write16(uint32_t Length)
+{
+    SSP_Transmit16(SSP0, tx16, Length);
+}
+
+/* SPI master, DSS + 1 bits, SCK = PCLK / (2 * (1 + scr)) */
+static void setup(uint32_t bits, uint32_t scr)
+{
+    ssp_model_init(SSP0_BASE);
+    SSP0->CPSR = 2;
+    SSP0->CR0 = (bits - 1) | (scr << 8);
+    SSP0->CR1 = SSP_CR1_SSE;
+}
+
+/* Runs one variant, returns its bus utilisation in percent */
+static uint32_t run(const char* name, ssp_variant fn, uint32_t bits, uint32_t scr, int reads)
+{
+    uint32_t mask = (1UL << bits) - 1;
+    uint64_t start, cycles;
+    uint32_t i, ok = 1, busy;
+
+    setup(bits, scr);
+    memset(rx8, 0, sizeof(rx8));
+    memset(rx16, 0, sizeof(rx16));
+
+    start = ssp_model_now();
+    fn(FRAMES);
+    cycles = ssp_model_now() - start;
+    busy = (uint32_t)((100ULL * FRAMES * ssp_model_frame_cycles()) / cycles);
+
+    CHECK_EQ(ssp_model_frames, FRAMES);
+    if (reads) {
+        /* The slave answers every frame with its complement */
+        for (i = 0; i < FRAMES; i++) {
+            ok &= (bits == 8) ? (rx8[i] == (~tx8[i] & mask)) : (rx16[i] == (~tx16[i] & mask));
+        }
+        CHECK(ok);
+        CHECK_EQ(ssp_model_overruns, 0);
+    } else {
+        /* Write only: the bus is idle, nothing left to read, the overrun cleared */
+        CHECK_EQ(SSP0->SR & (SSP_SR_BSY | SSP_SR_RNE), 0);
+        CHECK_EQ(SSP0->RIS & SSP_RIS_RORRIS, 0);
+    }
+
+    printf("  %-22s %6.1f cycles per frame, bus busy %3u%%\n", name, (double)cycles / FRAMES, busy);
+    return busy;
+}
+
+static void bench(uint32_t scr)
+{
+    uint32_t naive, burst, write;
+
+    setup(8, scr);
+    printf("bench SCK = PCLK/%u, %u cycles per 8-bit frame, %u cycles per register access:\n",
+           (unsigned)(2 * (1 + scr)), (unsigned)ssp_model_frame_cycles(), (unsigned)ssp_model_access_cycles);
+
+    naive = run("polled 8-bit", naive8, 8, scr, 1);
+    burst = run("SSP_TransmitReceive8", burst8, 8, scr, 1);
+    write = run("SSP_Transmit8", write8, 8, scr, 0);
+    CHECK(burst > naive);
+    CHECK(write >= burst);
+    /* From PCLK/4 on, the bus is the limit and not the CPU */
+    if (scr > 0) {
+        CHECK(burst >= 95);
+        CHECK(write >= 95);
+    }
+
+    naive = run("polled 16-bit", naive16, 16, scr, 1);
+    burst = run("SSP_TransmitReceive16", burst16, 16, scr, 1);
+    write = run("SSP_Transmit16", write16, 16, scr, 0);
+    CHECK(burst > naive);
+    CHECK(burst >= 95);
+    CHECK(write >= 95);
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < FRAMES; i++) {
+        tx8[i] = (uint8_t)(i * 7 + 3);
+        tx16[i] = (uint16_t)(i * 1031 + 17);
+    }
+
+    bench(0);
+    bench(1);
+    bench(3);
+
+    return host_report("test_ssp");
+}
@@ -0,0 +1,199 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_telemetry.c
+ * @author  WIZnet
+ * @brief   telemetry over the WZTOE model to a host collector: round trip
+ *          through telemetry_decode(), malformed frames, and the bytes and
+ *          CPU per sample against the sprintf/HTML path of the WebServer
+ *          example.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "peer.h"
+#include "wztoe_model.h"
+#include "w7500x.h"
+#include "telemetry.h"
+
+#include <string.h>
+
+#define CHANNELS        8
+#define SAMPLES         2000
+#define MAX_FRAME_SAMPLES 255
+
+static uint8_t loopback[4] = { 127, 0, 0, 1 };
+static int32_t sent[SAMPLES][CHANNELS];
+static uint32_t sent_time[SAMPLES];
+static int32_t values[MAX_FRAME_SAMPLES * TELEMETRY_MAX_CHANNELS];
+static uint32_t times[MAX_FRAME_SAMPLES];
+static uint8_t frame[TELEMETRY_FRAME_SIZE];
+
+/* 12-bit ADC readings: slow drift plus a little noise */
+static void make_samples(void)
+{
+    uint32_t noise = 1;
+    int s, c;
+
+    for (s = 0; s < SAMPLES; s++) {
+        for (c = 0; c < CHANNELS; c++) {
+            noise = noise * 1103515245 + 12345;
+            sent[s][c] = 2048 + c * 100 + (s / 16) % 200 + (int32_t)((noise >> 16) & 7) - 4;
+        }
+    }
+}
+
+static void test_round_trip(void)
+{
+    uint16_t port = 0;
+    uint16_t seq, expect_seq = 0;
+    int fd = peer_udp_open(&port, 0);
+    int32_t n, len;
+    int s = 0, i, c;
+    int ok = 1;
+
+    wztoe_model_init();
+    CHECK_EQ(telemetry_init(0, 5000, loopback, port, 1000, CHANNELS), SOCK_OK);
+
+    for (i = 0; i < SAMPLES; i++) {
+        if (i % 3 == 0) {
+            telemetry_time_handler();
+        }
+        CHECK(telemetry_sample(sent[i]) >= 0);
+    }
+    CHECK(telemetry_flush() > 0);
+
+    while ((len = peer_udp_recv(fd, frame, sizeof(frame), 100)) > 0) {
+        n = telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_FRAME_SAMPLES);
+        CHECK(n > 0);
+        CHECK_EQ(seq, expect_seq);
+        CHECK_EQ(frame[4], CHANNELS);
+        expect_seq++;
+        for (i = 0; i < n && s < SAMPLES; i++, s++) {
+            sent_time[s] = times[i];
+            for (c = 0; c < CHANNELS; c++) {
+                ok &= (values[i * CHANNELS + c] == sent[s][c]);
+            }
+        }
+    }
+    CHECK_EQ(s, SAMPLES);
+    CHECK(ok);
+    /* One tick every third sample */
+    CHECK_EQ(sent_time[SAMPLES - 1] - sent_time[0], (SAMPLES - 1) / 3);
+
+    peer_udp_close(fd);
+}
+
+static void test_malformed(void)
+{
+    static const int32_t one[CHANNELS] = { 1, -2, 3, -4, 5, -6, 7, -8 };
+    uint16_t port = 0;
+    uint16_t seq;
+    int fd = peer_udp_open(&port, 0);
+    int32_t len;
+
+    wztoe_model_init();
+    CHECK_EQ(telemetry_init(0, 5000, loopback, port, 1000, CHANNELS), SOCK_OK);
+    telemetry_sample(one);
+    telemetry_sample(one);
+    telemetry_flush();
+    len = peer_udp_recv(fd, frame, sizeof(frame), 1000);
+    CHECK(len > TELEMETRY_HDR_LEN);
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_FRAME_SAMPLES), 2);
+    CHECK_EQ(values[CHANNELS + 7], -8);
+
+    /* Channel counts that do not fit values[] */
+    frame[4] = 0;
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_FRAME_SAMPLES), -1);
+    frame[4] = TELEMETRY_MAX_CHANNELS + 1;
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_FRAME_SAMPLES), -1);
+    frame[4] = 0xFF;
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_FRAME_SAMPLES), -1);
+    frame[4] = CHANNELS;
+
+    /* A well formed frame of one sample with one channel too many */
+    {
+        static uint8_t wide[TELEMETRY_HDR_LEN + 1 + TELEMETRY_MAX_CHANNELS + 1] = { TELEMETRY_MAGIC, TELEMETRY_VERSION };
+
+        wide[4] = TELEMETRY_MAX_CHANNELS + 1;
+        wide[5] = 1;
+        CHECK_EQ(telemetry_decode(wide, sizeof(wide), &seq, values, times, MAX_FRAME_SAMPLES), -1);
+        wide[4] = TELEMETRY_MAX_CHANNELS;
+        CHECK_EQ(telemetry_decode(wide, sizeof(wide) - 1, &seq, values, times, MAX_FRAME_SAMPLES), 1);
+    }
+
+    /* Truncated, too many samples for the caller, bad magic */
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)(len - 1), &seq, values, times, MAX_FRAME_SAMPLES), -1);
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)len, &seq, values, times, 1), -1);
+    CHECK_EQ(telemetry_decode(frame, TELEMETRY_HDR_LEN - 1, &seq, values, times, MAX_FRAME_SAMPLES), -1);
+    frame[0] ^= 0xFF;
+    CHECK_EQ(telemetry_decode(frame, (uint16_t)len, &seq, values, times, MAX_FRAME_SAMPLES), -1);
+
+    peer_udp_close(fd);
+}
+
+/* The WebServer example sends one line per channel. Both sides are timed per
+   sample and without the socket calls: samples of which telemetry_sample()
+   sent a frame are left out of its time. */
+static void bench(void)
+{
+    static char line[64];
+    uint64_t t0, t1, html_ns = 0, tm_ns = 0;
+    uint32_t html_bytes = 0, tm_timed = 0;
+    uint32_t tm_bytes, tm_frames, packets;
+    uint16_t port = 0;
+    int fd = peer_udp_open(&port, 0);
+    int s, c, round;
+
+    for (round = 0; round < 10; round++) {
+        for (s = 0; s < SAMPLES; s++) {
+            t0 = host_nanotime();
+            for (c = 0; c < CHANNELS; c++) {
+                sprintf(line, "analog input %d is %d<br />\r\n", c, (int)sent[s][c]);
+                html_bytes += strlen(line);
+            }
+            html_ns += host_nanotime() - t0;
+        }
+    }
+
+    wztoe_model_init();
+    telemetry_init(0, 5000, loopback, port, 1000, CHANNELS);
+    for (round = 0; round < 10; round++) {
+        for (s = 0; s < SAMPLES; s++) {
+            telemetry_time_handler();
+            packets = wztoe_model_tx_packets;
+            t0 = host_nanotime();
+            telemetry_sample(sent[s]);
+            t1 = host_nanotime();
+            if (packets == wztoe_model_tx_packets) {
+                tm_ns += t1 - t0;
+                tm_timed++;
+            }
+        }
+    }
+    telemetry_flush();
+    tm_bytes = wztoe_model_tx_bytes;
+    tm_frames = wztoe_model_tx_packets;
+
+    printf("bench %d channels: html %.1f bytes %.0f ns per sample, telemetry %.1f bytes %.0f ns per sample"
+           " (%u frames), %.1fx fewer bytes, %.1fx less CPU\n",
+           CHANNELS,
+           html_bytes / (10.0 * SAMPLES), html_ns / (10.0 * SAMPLES),
+           tm_bytes / (10.0 * SAMPLES), (double)tm_ns / tm_timed, tm_frames,
+           (double)html_bytes / tm_bytes, (html_ns / (10.0 * SAMPLES)) / ((double)tm_ns / tm_timed));
+    /* Bytes are deterministic, the time depends on the host and is only reported */
+    CHECK(html_bytes >= 5 * tm_bytes);
+
+    while (peer_udp_recv(fd, frame, sizeof(frame), 0) > 0) {
+    }
+    peer_udp_close(fd);
+}
+
+int main(void)
+{
+    make_samples();
+    test_round_trip();
+    test_malformed();
+    bench();
+
+    return host_report("test_telemetry");
+}
@@ -0,0 +1,248 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_tlssock.c
+ * @author  WIZnet
+ * @brief   tlssock with the PSK backend against openssl s_server, over the
+ *          WZTOE model: a TLS 1.2 echo, a DTLS 1.2 exchange through a relay,
+ *          and forged and replayed DTLS records injected by the relay.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "peer.h"
+#include "wztoe_model.h"
+#include "w7500x.h"
+#include "tlssock_psk.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define OPENSSL_DEFAULT     "openssl"
+#define PSK_IDENTITY        "w7500x"
+#define PSK_HEX             "0102030405060708090a0b0c0d0e0f10"
+#define TIMEOUT_MS          5000
+
+static const uint8_t psk_key[16] =
+{
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10
+};
+
+static uint8_t loopback[4] = { 127, 0, 0, 1 };
+static uint32_t rng_state = 0x12345678;
+
+/* RNG->RN reads as a fresh xorshift value */
+static void rng_load(uint32_t addr, int write)
+{
+    (void)write;
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    HOST_REG(RNG_BASE + 0x10) = rng_state;
+    (void)addr;
+}
+
+static const char* openssl_path(void)
+{
+    const char* path = getenv("OPENSSL");
+
+    return path ? path : OPENSSL_DEFAULT;
+}
+
+static int start_server(peer_proc* srv, int dtls, uint16_t port)
+{
+    char accept[32];
+    char* argv[20];
+    int n = 0;
+
+    snprintf(accept, sizeof(accept), "127.0.0.1:%u", port);
+    argv[n++] = (char *)openssl_path();
+    argv[n++] = "s_server";
+    argv[n++] = "-nocert";
+    argv[n++] = "-psk";
+    argv[n++] = PSK_HEX;
+    argv[n++] = "-psk_identity";
+    argv[n++] = PSK_IDENTITY;
+    argv[n++] = "-cipher";
+    argv[n++] = "PSK-AES128-CCM8:@SECLEVEL=0";
+    if (dtls) {
+        /* Stateless cookie exchange first, application data over stdio */
+        argv[n++] = "-dtls1_2";
+        argv[n++] = "-listen";
+    } else {
+        /* Echoes every line back reversed */
+        argv[n++] = "-tls1_2";
+        argv[n++] = "-rev";
+    }
+    argv[n++] = "-naccept";
+    argv[n++] = "1";
+    argv[n++] = "-accept";
+    argv[n++] = accept;
+    argv[n] = NULL;
+
+    if (peer_spawn(srv, argv) != 0) {
+        return 0;
+    }
+    return peer_expect(srv, "ACCEPT", TIMEOUT_MS);
+}
+
+static int32_t handshake(uint8_t sn, peer_relay* relay)
+{
+    uint64_t end = host_nanotime() + (uint64_t)TIMEOUT_MS * 1000000ULL;
+    int32_t ret;
+
+    do {
+        if (relay) {
+            peer_relay_pump(relay);
+        }
+        ret = tlssock_handshake(sn);
+        if (ret != TLSSOCK_BUSY) {
+            return ret;
+        }
+        peer_sleep_ms(1);
+    } while (host_nanotime() < end);
+    return TLSSOCK_BUSY;
+}
+
+/* Receives until len bytes arrived or the timeout expires */
+static int32_t receive(uint8_t sn, peer_relay* relay, uint8_t* buf, uint16_t len)
+{
+    uint64_t end = host_nanotime() + (uint64_t)TIMEOUT_MS * 1000000ULL;
+    uint8_t addr[4];
+    uint16_t port;
+    int32_t got = 0;
+    int32_t ret;
+
+    do {
+        if (relay) {
+            peer_relay_pump(relay);
+            ret = tlssock_recvfrom(sn, buf + got, len - got, addr, &port);
+        } else {
+            ret = tlssock_recv(sn, buf + got, len - got);
+        }
+        if (ret < 0) {
+            return ret;
+        }
+        got += ret;
+        if (got >= len) {
+            break;
+        }
+        peer_sleep_ms(1);
+    } while (host_nanotime() < end);
+    return got;
+}
+
+static void test_tls_echo(void)
+{
+    static const char msg[] = "hello from tlssock\n";
+    static const char rev[] = "kcosslt morf olleh";
+    uint8_t buf[64];
+    uint16_t port = peer_free_port(0);
+    peer_proc srv;
+
+    if (!start_server(&srv, 0, port)) {
+        printf("test_tls_echo: cannot start %s s_server\n", openssl_path());
+        CHECK(0);
+        peer_stop(&srv);
+        return;
+    }
+
+    wztoe_model_init();
+    CHECK_EQ(socket(0, Sn_MR_TCP, 0, 0), 0);
+    CHECK_EQ(connect(0, loopback, port), SOCK_OK);
+    CHECK_EQ(tlssock_attach(0, &tlssock_psk_backend, 0, 0), TLSSOCK_OK);
+    CHECK_EQ(handshake(0, NULL), TLSSOCK_OK);
+
+    CHECK_EQ(tlssock_send(0, (uint8_t *)msg, sizeof(msg) - 1), sizeof(msg) - 1);
+    memset(buf, 0, sizeof(buf));
+    CHECK_EQ(receive(0, NULL, buf, sizeof(rev) - 1), sizeof(rev) - 1);
+    CHECK(memcmp(buf, rev, sizeof(rev) - 1) == 0);
+
+    tlssock_close(0);
+    peer_stop(&srv);
+}
+
+static void test_dtls(void)
+{
+    static uint8_t forged[2048];
+    static uint8_t replay[2048];
+    uint32_t replay_len;
+    uint8_t buf[64];
+    uint8_t addr[4];
+    uint16_t port = peer_free_port(1);
+    uint16_t relay_port;
+    peer_relay relay;
+    peer_proc srv;
+    uint32_t i;
+
+    if (!start_server(&srv, 1, port)) {
+        printf("test_dtls: cannot start %s s_server\n", openssl_path());
+        CHECK(0);
+        peer_stop(&srv);
+        return;
+    }
+    relay_port = peer_relay_open(&relay, port);
+
+    wztoe_model_init();
+    CHECK_EQ(socket(1, Sn_MR_UDP, 0, 0), 1);
+    CHECK_EQ(tlssock_attach(1, &tlssock_psk_backend, loopback, relay_port), TLSSOCK_OK);
+    CHECK_EQ(handshake(1, &relay), TLSSOCK_OK);
+
+    CHECK_EQ(tlssock_sendto(1, (uint8_t *)"1 from device\n", 14, loopback, relay_port), 14);
+    peer_relay_pump(&relay);
+    CHECK(peer_expect(&srv, "1 from device", TIMEOUT_MS));
+
+    peer_write(&srv, "2 from server\n");
+    memset(buf, 0, sizeof(buf));
+    CHECK_EQ(receive(1, &relay, buf, 14), 14);
+    CHECK(memcmp(buf, "2 from server\n", 14) == 0);
+    CHECK(relay.last_len > TLSSOCK_DTLS_HDR_LEN);
+    replay_len = relay.last_len;
+    memcpy(replay, relay.last, replay_len);
+
+    /* A forged record far ahead in the window must not move it: the records
+       that follow still authenticate and get through */
+    memcpy(forged, replay, replay_len);
+    forged[5] = 0x00;
+    forged[6] = 0x00;
+    forged[7] = 0x10;
+    for (i = TLSSOCK_DTLS_HDR_LEN; i < replay_len; i++) {
+        forged[i] ^= 0x5A;
+    }
+    peer_relay_inject(&relay, forged, replay_len);
+    peer_sleep_ms(20);
+    CHECK_EQ(tlssock_recvfrom(1, buf, sizeof(buf), addr, &port), TLSSOCK_BUSY);
+
+    /* A genuine record received before is dropped as a replay */
+    peer_relay_inject(&relay, replay, replay_len);
+    peer_sleep_ms(20);
+    CHECK_EQ(tlssock_recvfrom(1, buf, sizeof(buf), addr, &port), TLSSOCK_BUSY);
+
+    peer_write(&srv, "3 from server\n");
+    memset(buf, 0, sizeof(buf));
+    CHECK_EQ(receive(1, &relay, buf, 14), 14);
+    CHECK(memcmp(buf, "3 from server\n", 14) == 0);
+
+    tlssock_close(1);
+    peer_relay_close(&relay);
+    peer_stop(&srv);
+}
+
+static void test_no_key(void)
+{
+    /* Sizes are checked before anything is kept */
+    CHECK_EQ(tlssock_psk_set("0123456789012345678901234567890123456789", psk_key, 16), TLSSOCK_ERR_STATE);
+    CHECK_EQ(tlssock_psk_set(PSK_IDENTITY, psk_key, 0), TLSSOCK_ERR_STATE);
+}
+
+int main(void)
+{
+    host_mmio_map(RNG_BASE, sizeof(RNG_TypeDef), rng_load, NULL);
+
+    test_no_key();
+    CHECK_EQ(tlssock_psk_set(PSK_IDENTITY, psk_key, sizeof(psk_key)), TLSSOCK_OK);
+    test_tls_echo();
+    test_dtls();
+
+    return host_report("test_tlssock");
+}
@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/test_uart_buf.c
+ * @author  WIZnet
+ * @brief   Unit tests of w7500x_uart_buf.c: writes before the port is started
+ *          and the transmit path into the UART FIFO. The baud rate error of
+ *          w7500x_uart.c, to the ppm of the programmed divisor.
+ ******************************************************************************
+ */
+
+#include "host.h"
+#include "w7500x.h"
+#include "w7500x_uart_buf.h"
+
+#include <string.h>
+
+/* Truncating 4 * 8MHz / 26667 to 1199 bit/s would give -833 ppm */
+#if UART_BAUD_ERROR_PPM(8000000, 1200) != 12
+#error "UART_BAUD_ERROR_PPM(8000000, 1200) must be 12"
+#endif
+
+static uint8_t tx_ring[32];
+static uint8_t rx_ring[32];
+static uint8_t wire[256];
+static uint32_t wire_len;
+
+/* UART1 with a transmit FIFO that never fills: DR writes go to the wire */
+static void uart_store(uint32_t addr)
+{
+    if ((addr & 0xFFF) == 0x000) {
+        if (wire_len < sizeof(wire)) {
+            wire[wire_len++] = (uint8_t)HOST_REG(UART1_BASE);
+        }
+    }
+}
+
+static void test_not_started(void)
+{
+    uint8_t* room = (uint8_t *)1;
+
+    /* Nothing to queue into and no interrupt to drain it: no hang, no write */
+    UARTPORT_SetPolicy(UARTPORT_1, UARTBUF_Policy_Block);
+    CHECK_EQ(UARTPORT_Write(UARTPORT_1, (const uint8_t *)"hello", 5), 0);
+    CHECK_EQ(UARTPORT_PutChar(UARTPORT_1, 'x'), -1);
+    CHECK_EQ(UARTPORT_TxReserve(UARTPORT_1, &room), 0);
+    CHECK(room == 0);
+    CHECK_EQ(wire_len, 0);
+}
+
+static void test_write(void)
+{
+    UARTPORT_Init(UARTPORT_1, tx_ring, sizeof(tx_ring), rx_ring, sizeof(rx_ring));
+    CHECK_EQ(UARTPORT_Write(UARTPORT_1, (const uint8_t *)"hello", 5), 5);
+    CHECK_EQ(wire_len, 5);
+    CHECK(memcmp(wire, "hello", 5) == 0);
+
+    UARTPORT_DeInit(UARTPORT_1);
+    CHECK_EQ(UARTPORT_Write(UARTPORT_1, (const uint8_t *)"bye", 3), 0);
+    CHECK_EQ(wire_len, 5);
+}
+
+/* The divisor is rounded, the error follows it to the ppm */
+static void test_baud_error(void)
+{
+    uint32_t clock = host_system_clock;
+
+    host_system_clock = 8000000;
+    CHECK_EQ(UART_SetBaudRate(UART0, 1200), SUCCESS);
+    CHECK_EQ((UART0->IBRD << 6) | UART0->FBRD, 26667);
+    CHECK_EQ(UART_GetBaudRateError(UART0, 1200), -12);
+    CHECK_EQ(UART_BAUD_ACTUAL(8000000, 1200), 1200);
+
+    host_system_clock = 48000000;
+    CHECK_EQ(UART_SetBaudRate(UART0, 921600), SUCCESS);
+    CHECK_EQ(UART_GetBaudRateError(UART0, 921600), 1603);
+    CHECK_EQ(UART_BAUD_ERROR_PPM(48000000, 921600), 1603);
+    host_system_clock = clock;
+}
+
+int main(void)
+{
+    host_mmio_map(UART1_BASE, sizeof(UART_TypeDef), NULL, uart_store);
+
+    test_not_started();
+    test_write();
+    test_baud_error();
+
+    return host_report("test_uart_buf");
+}
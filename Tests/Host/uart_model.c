@@ -0,0 +1,268 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/uart_model.c
+ * @author  WIZnet
+ * @brief   Host model of UART0 or UART1 (PL011) wired to a pseudo terminal.
+ *
+ *          Bytes read from the pty master are queued on the line and each
+ *          one completes BitsPerChar bit times after the previous one, or
+ *          after it was read if the line was idle. A completed byte enters
+ *          the receive FIFO (16 deep with LCR_H.FEN, a holding register
+ *          without), or is lost to an overrun. RXRIS follows the FIFO level
+ *          against the IFLS trigger, RTRIS is raised once the FIFO has held
+ *          data for 32 bit times without a new byte. The transmit FIFO never
+ *          fills: DR writes go to the pty right away and TXRIS stays set.
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include "uart_model.h"
+#include "host.h"
+#include "w7500x.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define MODEL_FIFO          16
+#define MODEL_LINE          1024
+#define MODEL_TIMEOUT_BITS  32
+
+typedef struct
+{
+    uint32_t base;
+    int master;
+    int slave;
+    uint64_t now;                   /* Virtual time, ns */
+    uint64_t bit_ns;
+    uint64_t char_ns;
+    uint64_t line_free;             /* When the last queued byte completes */
+    uint64_t last_rx;               /* When the last byte entered the FIFO */
+    int rt_armed;                   /* No receive timeout since that byte */
+    uint8_t line[MODEL_LINE];
+    uint64_t line_done[MODEL_LINE];
+    uint32_t line_head;
+    uint32_t line_tail;
+    uint8_t fifo[MODEL_FIFO];
+    uint32_t fifo_head;
+    uint32_t fifo_count;
+    uint32_t lcr_h;
+    uint32_t cr;
+    uint32_t ifls;
+    uint32_t imsc;
+    uint32_t ris;
+} uart_model_state;
+
+static uart_model_state uart_model;
+
+uint32_t uart_model_overruns;
+
+static uint32_t uart_model_depth(void)
+{
+    return (uart_model.lcr_h & UART_LCR_H_FEN) ? MODEL_FIFO : 1;
+}
+
+/* RXIFLSEL 0..4 select 1/8, 1/4, 1/2, 3/4 and 7/8 of the FIFO */
+static uint32_t uart_model_trigger(void)
+{
+    static const uint32_t level[8] = { 2, 4, 8, 12, 14, 14, 14, 14 };
+
+    return (uart_model.lcr_h & UART_LCR_H_FEN) ? level[(uart_model.ifls >> 3) & 7] : 1;
+}
+
+static void uart_model_update(void)
+{
+    uart_model.ris |= UART_RIS_TXIM;
+    if (uart_model.fifo_count >= uart_model_trigger()) {
+        uart_model.ris |= UART_RIS_RXIM;
+    } else {
+        uart_model.ris &= ~UART_RIS_RXIM;
+    }
+    if (uart_model.fifo_count == 0) {
+        uart_model.ris &= ~UART_RIS_RTIM;
+    }
+}
+
+static void uart_model_load(uint32_t addr, int write)
+{
+    uint32_t v = 0;
+
+    switch (addr & 0xFFC) {
+    case 0x00:
+        /* A store to DR must not pop the FIFO */
+        if (!write && uart_model.fifo_count) {
+            v = uart_model.fifo[uart_model.fifo_head];
+            uart_model.fifo_head = (uart_model.fifo_head + 1) % MODEL_FIFO;
+            uart_model.fifo_count--;
+            uart_model_update();
+        }
+        break;
+    case 0x18:
+        v = UART_FR_TXFE;
+        if (uart_model.fifo_count == 0) {
+            v |= UART_FR_RXFE;
+        }
+        if (uart_model.fifo_count == uart_model_depth()) {
+            v |= UART_FR_RXFF;
+        }
+        break;
+    case 0x2C: v = uart_model.lcr_h; break;
+    case 0x30: v = uart_model.cr; break;
+    case 0x34: v = uart_model.ifls; break;
+    case 0x38: v = uart_model.imsc; break;
+    case 0x3C: v = uart_model.ris; break;
+    case 0x40: v = uart_model.ris & uart_model.imsc; break;
+    default: break;
+    }
+    HOST_REG(addr & ~3UL) = v;
+}
+
+static void uart_model_store(uint32_t addr)
+{
+    uint32_t v = HOST_REG(addr & ~3UL);
+    uint8_t c = (uint8_t)v;
+
+    switch (addr & 0xFFC) {
+    case 0x00:
+        if (write(uart_model.master, &c, 1) != 1) {
+            abort();
+        }
+        break;
+    case 0x2C:
+        /* Turning the FIFO on or off flushes it, as on the PL011 */
+        if ((v ^ uart_model.lcr_h) & UART_LCR_H_FEN) {
+            uart_model.fifo_count = 0;
+        }
+        uart_model.lcr_h = v;
+        break;
+    case 0x30: uart_model.cr = v; break;
+    case 0x34: uart_model.ifls = v; break;
+    case 0x38: uart_model.imsc = v; break;
+    case 0x44: uart_model.ris &= ~v; break;
+    default: break;
+    }
+    uart_model_update();
+}
+
+int uart_model_init(uint32_t Base, uint32_t Baud, uint32_t BitsPerChar)
+{
+    struct termios tio;
+
+    memset(&uart_model, 0, sizeof(uart_model));
+    uart_model_overruns = 0;
+    uart_model.base = Base;
+    uart_model.bit_ns = 1000000000ULL / Baud;
+    uart_model.char_ns = (1000000000ULL * BitsPerChar) / Baud;
+    uart_model.lcr_h = UART_LCR_H_FEN;
+    uart_model.ifls = UART_IFLS_RXIFLSEL1_2 | UART_IFLS_TXIFLSEL1_2;
+
+    uart_model.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((uart_model.master < 0) || (grantpt(uart_model.master) != 0) || (unlockpt(uart_model.master) != 0)) {
+        return -1;
+    }
+    fcntl(uart_model.master, F_SETFL, O_NONBLOCK);
+
+    /* The peer's end: raw, nothing added or swallowed on the way */
+    uart_model.slave = open(ptsname(uart_model.master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (uart_model.slave < 0) {
+        return -1;
+    }
+    tcgetattr(uart_model.slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(uart_model.slave, TCSANOW, &tio);
+    tcgetattr(uart_model.master, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(uart_model.master, TCSANOW, &tio);
+
+    uart_model_update();
+    host_mmio_unmap(Base);
+    host_mmio_map(Base, sizeof(UART_TypeDef), uart_model_load, uart_model_store);
+    return 0;
+}
+
+void uart_model_close(void)
+{
+    host_mmio_unmap(uart_model.base);
+    close(uart_model.slave);
+    close(uart_model.master);
+}
+
+const char* uart_model_pty(void)
+{
+    return ptsname(uart_model.master);
+}
+
+/* Queues what the peer wrote, starting at the current virtual time */
+static void uart_model_poll(void)
+{
+    uint8_t buf[256];
+    ssize_t n, i;
+    uint64_t start;
+
+    while ((n = read(uart_model.master, buf, sizeof(buf))) > 0) {
+        for (i = 0; i < n; i++) {
+            if (uart_model.line_head - uart_model.line_tail == MODEL_LINE) {
+                abort();
+            }
+            start = (uart_model.line_free > uart_model.now) ? uart_model.line_free : uart_model.now;
+            uart_model.line_free = start + uart_model.char_ns;
+            uart_model.line[uart_model.line_head % MODEL_LINE] = buf[i];
+            uart_model.line_done[uart_model.line_head % MODEL_LINE] = uart_model.line_free;
+            uart_model.line_head++;
+        }
+    }
+}
+
+int uart_model_advance(uint32_t us)
+{
+    uint64_t end = uart_model.now + (uint64_t)us * 1000;
+    uint32_t slot;
+
+    uart_model_poll();
+    while ((uart_model.line_tail != uart_model.line_head) &&
+           (uart_model.line_done[uart_model.line_tail % MODEL_LINE] <= end)) {
+        slot = uart_model.line_tail % MODEL_LINE;
+        uart_model.now = uart_model.line_done[slot];
+        uart_model.last_rx = uart_model.now;
+        uart_model.rt_armed = 1;
+        if (uart_model.fifo_count == uart_model_depth()) {
+            uart_model.ris |= UART_RIS_OEIM;
+            uart_model_overruns++;
+        } else {
+            uart_model.fifo[(uart_model.fifo_head + uart_model.fifo_count) % MODEL_FIFO] = uart_model.line[slot];
+            uart_model.fifo_count++;
+        }
+        uart_model.line_tail++;
+        uart_model_update();
+    }
+    uart_model.now = end;
+
+    /* Raised once per idle period, a new byte restarts the timeout */
+    if (uart_model.fifo_count && uart_model.rt_armed && (end - uart_model.last_rx >= MODEL_TIMEOUT_BITS * uart_model.bit_ns)) {
+        uart_model.ris |= UART_RIS_RTIM;
+        uart_model.rt_armed = 0;
+    }
+
+    return (uart_model.ris & uart_model.imsc) != 0;
+}
+
+uint64_t uart_model_now_us(void)
+{
+    return uart_model.now / 1000;
+}
+
+void uart_model_peer_write(const uint8_t* data, uint32_t len)
+{
+    if (write(uart_model.slave, data, len) != (ssize_t)len) {
+        abort();
+    }
+}
+
+uint32_t uart_model_peer_read(uint8_t* buf, uint32_t size)
+{
+    ssize_t n = read(uart_model.slave, buf, size);
+
+    return (n > 0) ? (uint32_t)n : 0;
+}
@@ -0,0 +1,40 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/uart_model.h
+ * @author  WIZnet
+ * @brief   Host model of UART0 or UART1 (PL011) wired to a pseudo terminal.
+ *
+ *          What the other end writes to the pty is clocked into the receive
+ *          FIFO at the baud rate, on a virtual clock that the test advances,
+ *          with the FIFO trigger levels and the 32 bit receive timeout of the
+ *          PL011. Transmitted bytes go to the pty at once.
+ ******************************************************************************
+ */
+
+#ifndef __UART_MODEL_H
+#define __UART_MODEL_H
+
+#include <stdint.h>
+
+/* Claims the register window of the UART at Base and opens the pty. Returns 0,
+   or -1 if no pty could be opened. */
+int uart_model_init(uint32_t Base, uint32_t Baud, uint32_t BitsPerChar);
+void uart_model_close(void);
+
+/* Name of the other end, e.g. for a Modbus tool */
+const char* uart_model_pty(void);
+
+/* Moves the virtual clock on, returns 1 if the UART interrupt is pending */
+int uart_model_advance(uint32_t us);
+
+/* Virtual time in microseconds since uart_model_init() */
+uint64_t uart_model_now_us(void);
+
+/* The other end of the line, through the pty */
+void uart_model_peer_write(const uint8_t* data, uint32_t len);
+uint32_t uart_model_peer_read(uint8_t* buf, uint32_t size);
+
+/* Bytes lost to a full receive FIFO */
+extern uint32_t uart_model_overruns;
+
+#endif /* __UART_MODEL_H */
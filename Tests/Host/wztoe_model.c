@@ -0,0 +1,410 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/wztoe_model.c
+ * @author  WIZnet
+ * @brief   Host model of the WZTOE socket engine.
+ *
+ *          Each hardware socket is backed by a POSIX socket. Commands written
+ *          to Sn_CR run synchronously and Sn_CR reads back 0. Reading Sn_SR
+ *          or Sn_RX_RSR polls the host socket and moves what arrived into the
+ *          socket RX memory, with the 8 byte header for UDP, exactly where
+ *          socket.c expects it. Sn_CR_SEND sends what lies between Sn_TX_RD
+ *          and Sn_TX_WR. Host socket errors show up as Sn_IR_TIMEOUT.
+ ******************************************************************************
+ */
+
+#include "wztoe_model.h"
+#include "host.h"
+#include "w7500x.h"
+
+/* w7500x_wztoe.h defines these for the chip, the host sockets need their own */
+#undef SOCK_STREAM
+#undef SOCK_DGRAM
+#undef IPPROTO_IP
+#undef IPPROTO_ICMP
+#undef IPPROTO_IGMP
+#undef IPPROTO_GGP
+#undef IPPROTO_TCP
+#undef IPPROTO_PUP
+#undef IPPROTO_UDP
+#undef IPPROTO_IDP
+#undef IPPROTO_ND
+#undef IPPROTO_RAW
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MODEL_SOCKETS       8
+#define MODEL_WINDOW        0x300
+
+#define REG_MR              0x000
+#define REG_CR              0x010
+#define REG_ISR             0x020
+#define REG_ICR             0x028
+#define REG_SR              0x030
+#define REG_PORT            0x114
+#define REG_DPORT           0x120
+#define REG_DIPR            0x124
+#define REG_TXBUF_SIZE      0x200
+#define REG_TX_FSR          0x204
+#define REG_TX_RD           0x208
+#define REG_TX_WR           0x20C
+#define REG_RXBUF_SIZE      0x220
+#define REG_RX_RSR          0x224
+#define REG_RX_RD           0x228
+#define REG_RX_WR           0x22C
+
+#define SOCK_CLOSE_WAIT_SR  0x1C
+
+typedef struct
+{
+    int fd;
+    int listen_fd;
+    uint8_t sr;
+    uint8_t ir;
+    uint16_t tx_rd;
+    uint16_t rx_wr;
+    uint16_t port;
+} wztoe_model_sock;
+
+static wztoe_model_sock wztoe_model_socks[MODEL_SOCKETS];
+static int wztoe_model_ready;
+
+uint32_t wztoe_model_tx_packets;
+uint32_t wztoe_model_tx_bytes;
+
+static uint32_t wztoe_model_base(uint8_t sn)
+{
+    return WZTOE_BASE + 0x00010000 + ((uint32_t)sn << 18);
+}
+
+static uint16_t wztoe_model_rxmax(uint8_t sn)
+{
+    return (uint16_t)(HOST_REG8(wztoe_model_base(sn) + REG_RXBUF_SIZE) << 10);
+}
+
+static uint16_t wztoe_model_txmax(uint8_t sn)
+{
+    return (uint16_t)(HOST_REG8(wztoe_model_base(sn) + REG_TXBUF_SIZE) << 10);
+}
+
+static uint16_t wztoe_model_rx_used(uint8_t sn)
+{
+    return (uint16_t)(wztoe_model_socks[sn].rx_wr - (HOST_REG(wztoe_model_base(sn) + REG_RX_RD) & 0xFFFF));
+}
+
+static void wztoe_model_rx_put(uint8_t sn, const uint8_t* data, uint16_t len)
+{
+    wztoe_model_sock* s = &wztoe_model_socks[sn];
+    uint32_t rxmem = RXMEM_BASE | ((uint32_t)sn << 18);
+    uint16_t i;
+
+    for (i = 0; i < len; i++) {
+        HOST_REG8(rxmem + ((s->rx_wr + i) & 0xFFFF)) = data[i];
+    }
+    s->rx_wr += len;
+}
+
+static void wztoe_model_close_fds(wztoe_model_sock* s)
+{
+    if (s->fd >= 0) {
+        close(s->fd);
+    }
+    if (s->listen_fd >= 0) {
+        close(s->listen_fd);
+    }
+    s->fd = -1;
+    s->listen_fd = -1;
+}
+
+static void wztoe_model_dest(uint8_t sn, struct sockaddr_in* sa)
+{
+    uint32_t base = wztoe_model_base(sn);
+
+    memset(sa, 0, sizeof(*sa));
+    sa->sin_family = AF_INET;
+    /* Sn_DIPR holds the first address byte in its most significant byte */
+    sa->sin_addr.s_addr = htonl(HOST_REG(base + REG_DIPR));
+    sa->sin_port = htons((uint16_t)HOST_REG(base + REG_DPORT));
+}
+
+static int wztoe_model_bind(int fd, uint16_t port)
+{
+    struct sockaddr_in sa;
+    int one = 1;
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port = htons(port);
+    return bind(fd, (struct sockaddr *)&sa, sizeof(sa));
+}
+
+static uint16_t wztoe_model_local_port(int fd)
+{
+    struct sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+
+    if (getsockname(fd, (struct sockaddr *)&sa, &len) != 0) {
+        return 0;
+    }
+    return ntohs(sa.sin_port);
+}
+
+static void wztoe_model_poll(uint8_t sn)
+{
+    wztoe_model_sock* s = &wztoe_model_socks[sn];
+    uint8_t buf[2048 + 8];
+    struct sockaddr_in sa;
+    socklen_t salen;
+    uint16_t space;
+    ssize_t n;
+    int fd;
+
+    if ((s->sr == SOCK_LISTEN) && (s->listen_fd >= 0)) {
+        fd = accept(s->listen_fd, NULL, NULL);
+        if (fd >= 0) {
+            s->fd = fd;
+            s->sr = SOCK_ESTABLISHED;
+            s->ir |= Sn_IR_CON;
+        }
+        return;
+    }
+
+    if (s->fd < 0) {
+        return;
+    }
+
+    space = wztoe_model_rxmax(sn) - wztoe_model_rx_used(sn);
+    if (s->sr == SOCK_ESTABLISHED) {
+        if (space == 0) {
+            return;
+        }
+        n = recv(s->fd, buf, (space < sizeof(buf)) ? space : sizeof(buf), MSG_DONTWAIT);
+        if (n > 0) {
+            wztoe_model_rx_put(sn, buf, (uint16_t)n);
+            s->ir |= Sn_IR_RECV;
+        } else if (n == 0) {
+            s->sr = SOCK_CLOSE_WAIT_SR;
+            s->ir |= Sn_IR_DISCON;
+        }
+    } else if (s->sr == SOCK_UDP) {
+        for (;;) {
+            n = recv(s->fd, buf + 8, sizeof(buf) - 8, MSG_PEEK | MSG_DONTWAIT);
+            if ((n < 0) || (space < n + 8)) {
+                return;
+            }
+            salen = sizeof(sa);
+            n = recvfrom(s->fd, buf + 8, sizeof(buf) - 8, MSG_DONTWAIT, (struct sockaddr *)&sa, &salen);
+            if (n < 0) {
+                return;
+            }
+            memcpy(buf, &sa.sin_addr.s_addr, 4);
+            buf[4] = (uint8_t)(ntohs(sa.sin_port) >> 8);
+            buf[5] = (uint8_t)ntohs(sa.sin_port);
+            buf[6] = (uint8_t)(n >> 8);
+            buf[7] = (uint8_t)n;
+            wztoe_model_rx_put(sn, buf, (uint16_t)(n + 8));
+            s->ir |= Sn_IR_RECV;
+            space -= (uint16_t)(n + 8);
+        }
+    }
+}
+
+static void wztoe_model_send(uint8_t sn)
+{
+    wztoe_model_sock* s = &wztoe_model_socks[sn];
+    uint32_t base = wztoe_model_base(sn);
+    uint32_t txmem = TXMEM_BASE | ((uint32_t)sn << 18);
+    uint16_t tx_wr = (uint16_t)HOST_REG(base + REG_TX_WR);
+    uint16_t len = (uint16_t)(tx_wr - s->tx_rd);
+    uint8_t buf[0x10000];
+    struct sockaddr_in sa;
+    uint16_t i;
+    ssize_t n;
+
+    for (i = 0; i < len; i++) {
+        buf[i] = HOST_REG8(txmem + ((s->tx_rd + i) & 0xFFFF));
+    }
+    s->tx_rd = tx_wr;
+
+    if (s->sr == SOCK_UDP) {
+        wztoe_model_dest(sn, &sa);
+        n = sendto(s->fd, buf, len, 0, (struct sockaddr *)&sa, sizeof(sa));
+    } else {
+        n = send(s->fd, buf, len, MSG_NOSIGNAL);
+    }
+
+    if (n == (ssize_t)len) {
+        s->ir |= Sn_IR_SENDOK;
+        wztoe_model_tx_packets++;
+        wztoe_model_tx_bytes += len;
+    } else {
+        s->ir |= Sn_IR_TIMEOUT;
+    }
+}
+
+static void wztoe_model_command(uint8_t sn, uint8_t cmd)
+{
+    wztoe_model_sock* s = &wztoe_model_socks[sn];
+    uint32_t base = wztoe_model_base(sn);
+    struct sockaddr_in sa;
+    int one = 1;
+
+    switch (cmd) {
+    case Sn_CR_OPEN:
+        wztoe_model_close_fds(s);
+        s->ir = 0;
+        s->tx_rd = 0;
+        s->rx_wr = 0;
+        HOST_REG(base + REG_TX_WR) = 0;
+        HOST_REG(base + REG_RX_RD) = 0;
+        s->port = (uint16_t)HOST_REG(base + REG_PORT);
+        if ((HOST_REG8(base + REG_MR) & 0x0F) == Sn_MR_UDP) {
+            s->fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if (wztoe_model_bind(s->fd, s->port) != 0) {
+                wztoe_model_bind(s->fd, 0);
+            }
+            s->port = wztoe_model_local_port(s->fd);
+            s->sr = SOCK_UDP;
+        } else if ((HOST_REG8(base + REG_MR) & 0x0F) == Sn_MR_TCP) {
+            s->sr = SOCK_INIT;
+        } else {
+            s->sr = SOCK_CLOSED;
+        }
+        break;
+    case Sn_CR_LISTEN:
+        s->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if ((wztoe_model_bind(s->listen_fd, s->port) != 0) && (wztoe_model_bind(s->listen_fd, 0) != 0)) {
+            s->sr = SOCK_CLOSED;
+            break;
+        }
+        listen(s->listen_fd, 1);
+        s->port = wztoe_model_local_port(s->listen_fd);
+        s->sr = SOCK_LISTEN;
+        break;
+    case Sn_CR_CONNECT:
+        s->fd = socket(AF_INET, SOCK_STREAM, 0);
+        setsockopt(s->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        wztoe_model_dest(sn, &sa);
+        if (connect(s->fd, (struct sockaddr *)&sa, sizeof(sa)) == 0) {
+            s->sr = SOCK_ESTABLISHED;
+            s->ir |= Sn_IR_CON;
+        } else {
+            wztoe_model_close_fds(s);
+            s->sr = SOCK_CLOSED;
+            s->ir |= Sn_IR_TIMEOUT;
+        }
+        break;
+    case Sn_CR_SEND:
+        wztoe_model_send(sn);
+        break;
+    case Sn_CR_RECV:
+        wztoe_model_poll(sn);
+        break;
+    case Sn_CR_DISCON:
+        if (s->fd >= 0) {
+            shutdown(s->fd, SHUT_RDWR);
+        }
+        wztoe_model_close_fds(s);
+        s->sr = SOCK_CLOSED;
+        s->ir |= Sn_IR_DISCON;
+        break;
+    case Sn_CR_CLOSE:
+        wztoe_model_close_fds(s);
+        s->sr = SOCK_CLOSED;
+        break;
+    default:
+        break;
+    }
+}
+
+static void wztoe_model_load(uint32_t addr, int write)
+{
+    uint8_t sn = (uint8_t)((addr >> 18) & 0x7);
+    uint32_t base = wztoe_model_base(sn);
+    wztoe_model_sock* s = &wztoe_model_socks[sn];
+
+    if (write) {
+        return;
+    }
+
+    switch ((addr - base) & ~3UL) {
+    case REG_ISR:
+        HOST_REG(base + REG_ISR) = s->ir;
+        break;
+    case REG_SR:
+        wztoe_model_poll(sn);
+        HOST_REG(base + REG_SR) = s->sr;
+        break;
+    case REG_RX_RSR:
+        wztoe_model_poll(sn);
+        HOST_REG(base + REG_RX_RSR) = wztoe_model_rx_used(sn);
+        break;
+    case REG_RX_WR:
+        HOST_REG(base + REG_RX_WR) = s->rx_wr;
+        break;
+    case REG_TX_FSR:
+        HOST_REG(base + REG_TX_FSR) = (uint16_t)(wztoe_model_txmax(sn) - (uint16_t)(HOST_REG(base + REG_TX_WR) - s->tx_rd));
+        break;
+    case REG_TX_RD:
+        HOST_REG(base + REG_TX_RD) = s->tx_rd;
+        break;
+    default:
+        break;
+    }
+}
+
+static void wztoe_model_store(uint32_t addr)
+{
+    uint8_t sn = (uint8_t)((addr >> 18) & 0x7);
+    uint32_t base = wztoe_model_base(sn);
+
+    switch ((addr - base) & ~3UL) {
+    case REG_CR:
+        wztoe_model_command(sn, HOST_REG8(base + REG_CR));
+        HOST_REG(base + REG_CR) = 0;
+        break;
+    case REG_ICR:
+        wztoe_model_socks[sn].ir &= ~HOST_REG8(base + REG_ICR);
+        HOST_REG(base + REG_ICR) = 0;
+        break;
+    default:
+        break;
+    }
+}
+
+void wztoe_model_init(void)
+{
+    uint8_t sn;
+    uint32_t base;
+
+    for (sn = 0; sn < MODEL_SOCKETS; sn++) {
+        base = wztoe_model_base(sn);
+        host_mmio_unmap(base);
+        if (wztoe_model_ready) {
+            wztoe_model_close_fds(&wztoe_model_socks[sn]);
+        }
+        memset(&wztoe_model_socks[sn], 0, sizeof(wztoe_model_sock));
+        wztoe_model_socks[sn].fd = -1;
+        wztoe_model_socks[sn].listen_fd = -1;
+        memset((void *)(uintptr_t)base, 0, MODEL_WINDOW);
+        HOST_REG(base + REG_TXBUF_SIZE) = 2;
+        HOST_REG(base + REG_RXBUF_SIZE) = 2;
+        host_mmio_map(base, MODEL_WINDOW, wztoe_model_load, wztoe_model_store);
+    }
+    wztoe_model_ready = 1;
+    wztoe_model_tx_packets = 0;
+    wztoe_model_tx_bytes = 0;
+}
+
+uint16_t wztoe_model_port(uint8_t sn)
+{
+    return wztoe_model_socks[sn].port;
+}
@@ -0,0 +1,26 @@
+/**
+ ******************************************************************************
+ * @file    Tests/Host/wztoe_model.h
+ * @author  WIZnet
+ * @brief   Host model of the WZTOE socket engine over POSIX sockets, so that
+ *          socket.c and the services above it talk to real peers on the
+ *          loopback interface.
+ ******************************************************************************
+ */
+
+#ifndef __WZTOE_MODEL_H
+#define __WZTOE_MODEL_H
+
+#include <stdint.h>
+
+/* Resets all the sockets (2 KB buffers each) and claims their register windows */
+void wztoe_model_init(void);
+
+/* Local port a socket is bound to on the host, e.g. to aim a test peer at it */
+uint16_t wztoe_model_port(uint8_t sn);
+
+/* Datagrams and bytes sent by the SEND commands since wztoe_model_init() */
+extern uint32_t wztoe_model_tx_packets;
+extern uint32_t wztoe_model_tx_bytes;
+
+#endif /* __WZTOE_MODEL_H */
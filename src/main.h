@@ -48,6 +48,16 @@
 #endif
 #endif
 
+/* Uncomment the line below to send printf output through the interrupt driven
+ UART ring buffers (w7500x_uart_buf.c) instead of waiting for each character.
+ main() then has to start the port before the first printf, after UART_Init()
+ or S_UART_Init():
+     UARTPORT_Init(UARTPORT_x, tx_buf, sizeof(tx_buf), rx_buf, sizeof(rx_buf));
+     NVIC_EnableIRQ(UARTx_IRQn);
+ Output written before that is dropped.
+ */
+//#define USING_UART_BUFFER
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
@@ -27,7 +27,19 @@
 #include "w7500x_uart.h"
 #include "main.h"
 
+#if defined (USING_UART_BUFFER) && (defined (USING_UART0) || defined (USING_UART1) || defined (USING_UART2))
+#include "w7500x_uart_buf.h"
+
 #if defined (USING_UART0)
+#define UART_BUFFERED       UARTPORT_0
+#elif defined (USING_UART1)
+#define UART_BUFFERED       UARTPORT_1
+#else
+#define UART_BUFFERED       UARTPORT_2
+#endif
+#define UART_SEND_BYTE(ch)  UartBufPutc(UART_BUFFERED, ch)
+#define UART_RECV_BYTE()    UartBufGetc(UART_BUFFERED)
+#elif defined (USING_UART0)
 #define UART_SEND_BYTE(ch)  UartPutc(UART0, ch)
 #define UART_RECV_BYTE()    UartGetc(UART0)
 #elif defined (USING_UART1)
@@ -44,6 +56,10 @@ uint8_t UartGetc(UART_TypeDef* UARTx);
 uint8_t S_UartPutc(uint8_t ch);
 void S_UartPuts(uint8_t *str);
 uint8_t S_UartGetc(void);
+#if defined (UART_BUFFERED)
+uint8_t UartBufPutc(uint32_t port, uint8_t ch);
+uint8_t UartBufGetc(uint32_t port);
+#endif
 
 #if defined ( __CC_ARM   )
 /******************************************************************************/
@@ -86,10 +102,15 @@ void _sys_exit(int return_code) {
 
 __attribute__ ((used)) int _write(int fd, char *ptr, int len)
 {
+#if defined (UART_BUFFERED)
+    /* Queue the whole string at once, bytes dropped by the overflow policy are not retried */
+    UARTPORT_Write(UART_BUFFERED, (const uint8_t*) ptr, len);
+#else
     size_t i;
     for (i = 0; i < len; i++) {
         UART_SEND_BYTE(ptr[i]);  // call character output function
     }
+#endif
     return len;
 }
 #else //using TOOLCHAIN_IAR
@@ -137,6 +158,25 @@ uint8_t UartGetc(UART_TypeDef* UARTx)
     return (UARTx->DR & 0xFF);
 }
 
+#if defined (UART_BUFFERED)
+uint8_t UartBufPutc(uint32_t port, uint8_t ch)
+{
+    UARTPORT_PutChar(port, ch);
+
+    return (ch);
+}
+
+uint8_t UartBufGetc(uint32_t port)
+{
+    int ch;
+
+    while ((ch = UARTPORT_GetChar(port)) < 0)
+        ;
+
+    return (uint8_t) ch;
+}
+#endif
+
 uint8_t S_UartPutc(uint8_t ch)
 {
     S_UART_SendData(ch);
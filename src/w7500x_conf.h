@@ -32,6 +32,7 @@
 /* Comment the line below to disable peripheral header file inclusion */
 #include "w7500x_adc.h"
 #include "w7500x_crg.h"
+#include "w7500x_dma.h"
 #include "w7500x_dualtimer.h"
 #include "w7500x_exti.h"
 #include "w7500x_flash.h"
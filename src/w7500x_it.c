@@ -28,6 +28,10 @@
 /* Includes ------------------------------------------------------------------*/
 #include <stdio.h>
 #include "w7500x_it.h"
+#include "main.h"
+#if defined (USING_UART_BUFFER)
+#include "w7500x_uart_buf.h"
+#endif
 
 /** @addtogroup W7500x_StdPeriph_Examples
  * @{
@@ -119,6 +123,9 @@ void SSP1_Handler(void)
  */
 void UART0_Handler(void)
 {
+#if defined (USING_UART_BUFFER)
+    UARTBUF_IRQHandler(UART0);
+#endif
 }
 
 /**
@@ -128,6 +135,9 @@ void UART0_Handler(void)
  */
 void UART1_Handler(void)
 {
+#if defined (USING_UART_BUFFER)
+    UARTBUF_IRQHandler(UART1);
+#endif
 }
 
 /**
@@ -137,6 +147,9 @@ void UART1_Handler(void)
  */
 void UART2_Handler(void)
 {
+#if defined (USING_UART_BUFFER)
+    S_UARTBUF_IRQHandler();
+#endif
 }
 
 /**